@@ -0,0 +1,50 @@
+#!/bin/bash
+
+if [ $# -ne 2 ]; then
+	echo "USAGE $0 SOURCE_DIR BUILD_DIR"
+	exit
+fi
+
+SOURCE_DIR=$1
+BUILD_DIR=$2
+
+# results dir is named by git revision (with "+" suffix for not committed changes),
+# so results of different commits can be compared via devel-tools/compareBenchmarks.py
+
+REVISION=`cd $SOURCE_DIR && git rev-parse --short HEAD`
+if [ "`cd $SOURCE_DIR && git status --porcelain --untracked-files=no`" != "" ]; then
+	REVISION="$REVISION+"
+fi
+RESULTS_DIR="$BUILD_DIR/benchmarks/$REVISION"
+mkdir -p "$RESULTS_DIR"
+
+cd $BUILD_DIR
+
+
+# microbenchmarks (standalone executables)
+
+for b in $BUILD_DIR/bench_*; do
+	[ -x "$b" ] || continue
+	NAME=`basename $b`
+	echo "run $NAME ..."
+	$b --json "$RESULTS_DIR/${NAME#bench_}.json" || echo "$NAME FAILED"
+done
+
+
+# macrobenchmarks (scenarios executed by headless engine)
+# default main config autostarts modules requiring window and input (GUI, camera control, ...),
+# so use main config for headless mode (generated by cmake from resources-src/ConfigFiles/MGEConfig-headless.xml.in)
+
+if [ -x "$BUILD_DIR/Game" -a -f "$BUILD_DIR/conf/MGEConfig-headless.xml" ]; then
+	for s in $SOURCE_DIR/engine-benchmarks/scenarios/*.py; do
+		NAME=`basename $s .py`
+		[ "$NAME" = "mgeBenchmark" ] && continue
+		echo "run scenario $NAME ..."
+		MGE_BENCHMARK_DIR="$SOURCE_DIR/engine-benchmarks/scenarios" \
+		MGE_BENCHMARK_OUTPUT="$RESULTS_DIR/scenario_$NAME.json" \
+		MGE_BENCHMARK_REVISION="`cd $SOURCE_DIR && git rev-parse HEAD`" \
+			./Game --headless --config-file conf/MGEConfig-headless.xml --fixed-dt 0.016 --exec-script "$s" || echo "scenario $NAME FAILED"
+	done
+fi
+
+echo "results in: $RESULTS_DIR"
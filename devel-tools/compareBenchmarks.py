@@ -0,0 +1,55 @@
+#!/usr/bin/python3
+
+#
+# compare two sets of benchmark results (JSON files written by engine-benchmarks executables and scenarios)
+#
+# USAGE: compareBenchmarks.py  OLD_RESULTS  NEW_RESULTS  [THRESHOLD_PERCENT]
+#        OLD_RESULTS and NEW_RESULTS can be JSON file or directory with JSON files (e.g. build/benchmarks/<git revision>)
+#        return 1 when some median time is worse by more than THRESHOLD_PERCENT (default 10)
+#
+
+import json, os, sys
+
+def loadResults(path):
+	files = [path]
+	if os.path.isdir(path):
+		files = sorted(os.path.join(path, f) for f in os.listdir(path) if f.endswith(".json"))
+	
+	results = {}
+	for f in files:
+		data = json.load(open(f))
+		for r in data["results"]:
+			paramsStr = "".join("/" + k + "=" + str(v) for k, v in r["params"].items())
+			results[data["suite"] + "." + r["name"] + paramsStr] = r
+	return results
+
+if len(sys.argv) < 3:
+	print("USAGE: " + sys.argv[0] + "  OLD_RESULTS  NEW_RESULTS  [THRESHOLD_PERCENT]", file=sys.stderr)
+	exit(1)
+
+oldResults = loadResults(sys.argv[1])
+newResults = loadResults(sys.argv[2])
+threshold  = float(sys.argv[3]) if len(sys.argv) > 3 else 10.0
+
+regressions = 0
+print("%-60s %14s %14s %9s %9s" % ("benchmark", "old median", "new median", "median", "p99"))
+for name in sorted(set(oldResults) | set(newResults)):
+	if not name in newResults:
+		print("%-60s %14.1f %14s" % (name, oldResults[name]["median"], "(removed)"))
+		continue
+	if not name in oldResults:
+		print("%-60s %14s %14.1f" % (name, "(new)", newResults[name]["median"]))
+		continue
+	
+	old, new = oldResults[name], newResults[name]
+	medianDiff = 100.0 * (new["median"] - old["median"]) / old["median"] if old["median"] else 0.0
+	p99Diff    = 100.0 * (new["p99"] - old["p99"]) / old["p99"] if old["p99"] else 0.0
+	mark = ""
+	if medianDiff > threshold:
+		mark = "  <-- REGRESSION"
+		regressions += 1
+	elif medianDiff < -threshold:
+		mark = "  <-- improvement"
+	print("%-60s %14.1f %14.1f %+8.1f%% %+8.1f%%%s" % (name, old["median"], new["median"], medianDiff, p99Diff, mark))
+
+exit(1 if regressions else 0)
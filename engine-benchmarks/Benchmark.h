@@ -0,0 +1,339 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma   once
+
+/**
+ * @file
+ * @brief Minimal (header-only) framework for engine benchmarks.
+ * 
+ * Each benchmark executable is single .cpp file from `engine-benchmarks` directory:
+	\code{.cpp}
+		#define MGE_BENCHMARK_SUITE ListenerSet
+		#include "Benchmark.h"
+		
+		MGE_BENCHMARK( callAll ) {
+			for (int count : {1, 16, 256}) {
+				// ... prepare scenario with @a count listeners ...
+				bench.run({{"listeners", count}}, [&]() {
+					listenerSet.callAll(13);
+				});
+			}
+		}
+	\endcode
+ * 
+ * Each call of @ref MGE::Benchmark::Runner::run is one scenario (benchmark name + set of parameters). Runner:
+ *   - calibrate number of iterations per sample (body is called in loop until sample time reach `--min-time`),
+ *   - do one warm-up sample,
+ *   - collect `--samples` samples and calculate per operation (single body call) time statistics: min, median, p99 and mean.
+ * 
+ * Results are printed as table on stdout and (when `--json FILE` is used) written as JSON document:
+	\code{.json}
+		{
+			"suite": "ListenerSet", "revision": "<git commit id>", "unit": "ns",
+			"results": [
+				{"name": "callAll", "params": {"listeners": 16}, "samples": 31, "iterations": 40960, "min": 30.1, "median": 30.7, "p99": 33.9, "mean": 30.9}
+			]
+		}
+	\endcode
+ * This format is used by `devel-tools/compareBenchmarks.py` to compare results between commits
+ * (benchmark is identified by suite, name and params).
+ * 
+ * Supported command line options:
+ *   - `--json FILE`      write results to FILE
+ *   - `--filter STRING`  run only benchmarks with name containing STRING
+ *   - `--samples N`      number of measured samples per scenario (default 31)
+ *   - `--min-time MS`    minimal time of single sample in milliseconds (default 2)
+ *   - `--list`           print names of benchmarks and exit
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifndef MGE_BENCHMARK_SUITE
+#error "MGE_BENCHMARK_SUITE must be defined before include Benchmark.h"
+#endif
+
+#define MGE_BENCHMARK_STRINGIFY2(x) #x
+#define MGE_BENCHMARK_STRINGIFY(x)  MGE_BENCHMARK_STRINGIFY2(x)
+
+namespace MGE { namespace Benchmark {
+
+/// clock used for all measurements
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Prevent compiler from optimise out computation of @a value.
+ */
+template <typename T> inline void doNotOptimize(T&& value) {
+	#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+	#else
+	static volatile const void* sink;
+	sink = &value;
+	#endif
+}
+
+/**
+ * @brief Scenario parameters (name → value), used to identify scenario in results.
+ */
+typedef std::vector< std::pair<std::string, long long> > Params;
+
+/**
+ * @brief Result of single scenario.
+ */
+struct Result {
+	/// benchmark name
+	std::string name;
+	/// scenario parameters
+	Params      params;
+	/// number of measured samples
+	int         samples;
+	/// number of body calls in single sample
+	uint64_t    iterations;
+	/// time of single body call (in nanoseconds)
+	double      min, median, p99, mean;
+};
+
+/**
+ * @brief Benchmark runner (measure and collect results of scenarios).
+ */
+class Runner {
+public:
+	/// number of measured samples for each scenario
+	int     samples = 31;
+	
+	/// minimal time of single sample (used for calibrate number of iterations)
+	std::chrono::nanoseconds minSampleTime = std::chrono::milliseconds(2);
+	
+	/// collected results
+	std::vector<Result> results;
+	
+	/**
+	 * @brief Measure @a body (functor without arguments) as scenario of current benchmark with parameters @a params.
+	 */
+	template <typename Body> void run(const Params& params, Body&& body) {
+		uint64_t iterations = 1;
+		while (true) {
+			auto time = measureSample(body, iterations);
+			if (time >= minSampleTime || iterations >= (1ull << 40))
+				break;
+			iterations *= 2;
+		}
+		
+		measureSample(body, iterations); // warm-up
+		
+		std::vector<double> times;
+		times.reserve(samples);
+		for (int i = 0; i < samples; ++i) {
+			times.push_back( static_cast<double>(measureSample(body, iterations).count()) / iterations );
+		}
+		addResult(params, iterations, times);
+	}
+	
+	/**
+	 * @brief Measure @a body as scenario of current benchmark with parameters @a params,
+	 *        call @a setUp (not measured) before each call of @a body.
+	 * 
+	 * @note Use for operations that change state, so need prepare before each call (e.g. load, spawn, ...).
+	 *       Each sample contains single call of @a body, so this should be used for "long" (at least few microseconds) operations.
+	 */
+	template <typename SetUp, typename Body> void run(const Params& params, SetUp&& setUp, Body&& body) {
+		setUp();
+		measureSample(body, 1); // warm-up
+		
+		std::vector<double> times;
+		times.reserve(samples);
+		for (int i = 0; i < samples; ++i) {
+			setUp();
+			times.push_back( static_cast<double>(measureSample(body, 1).count()) );
+		}
+		addResult(params, 1, times);
+	}
+	
+	/// @copydoc run(const Params& params, Body&& body)
+	template <typename Body> void run(Body&& body) {
+		run(Params(), std::forward<Body>(body));
+	}
+	
+	/// name of currently executed benchmark (used as name of results of @ref run)
+	std::string_view currentName;
+	
+protected:
+	template <typename Body> static std::chrono::nanoseconds measureSample(Body& body, uint64_t iterations) {
+		auto start = Clock::now();
+		for (uint64_t i = 0; i < iterations; ++i) {
+			body();
+		}
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+	}
+	
+	void addResult(const Params& params, uint64_t iterations, std::vector<double>& times) {
+		std::sort(times.begin(), times.end());
+		double sum = 0;
+		for (auto t : times)
+			sum += t;
+		
+		Result res;
+		res.name       = currentName;
+		res.params     = params;
+		res.samples    = times.size();
+		res.iterations = iterations;
+		res.min        = times.front();
+		res.median     = (times.size() % 2) ? times[times.size()/2] : (times[times.size()/2 - 1] + times[times.size()/2]) / 2;
+		res.p99        = times[ std::min<size_t>(times.size() - 1, std::ceil(0.99 * times.size()) - 1) ];
+		res.mean       = sum / times.size();
+		
+		std::cout << std::left << std::setw(40) << (res.name + paramsToString(res.params, "/", "="))
+		          << std::right << std::fixed << std::setprecision(1)
+		          << "  min=" << std::setw(12) << res.min << " ns"
+		          << "  median=" << std::setw(12) << res.median << " ns"
+		          << "  p99=" << std::setw(12) << res.p99 << " ns"
+		          << "  (" << res.samples << " x " << res.iterations << ")" << std::endl;
+		
+		results.push_back(std::move(res));
+	}
+	
+public:
+	/// return @a params as string (used in text and JSON output)
+	static std::string paramsToString(const Params& params, std::string_view separator, std::string_view assign, std::string_view quote = "") {
+		std::string str;
+		for (auto& p : params) {
+			str += separator;
+			str += quote;
+			str += p.first;
+			str += quote;
+			str += assign;
+			str += std::to_string(p.second);
+		}
+		return str;
+	}
+	
+	/// write results as JSON document to @a out
+	void writeJSON(std::ostream& out, std::string_view suite) const {
+		out << "{\n\t\"suite\": \"" << suite << "\", \"revision\": \"" << ENGINE_GIT_VERSION << "\", \"unit\": \"ns\",\n\t\"results\": [";
+		out << std::fixed << std::setprecision(3);
+		for (size_t i = 0; i < results.size(); ++i) {
+			auto& r = results[i];
+			auto params = paramsToString(r.params, ", ", ": ", "\"");
+			out << (i ? ",\n\t\t" : "\n\t\t")
+			    << "{\"name\": \"" << r.name << "\", \"params\": {" << (params.empty() ? params : params.substr(2)) << "}"
+			    << ", \"samples\": " << r.samples << ", \"iterations\": " << r.iterations
+			    << ", \"min\": " << r.min << ", \"median\": " << r.median << ", \"p99\": " << r.p99 << ", \"mean\": " << r.mean << "}";
+		}
+		out << "\n\t]\n}\n";
+	}
+};
+
+/**
+ * @brief Registry of benchmarks functions (filled by @ref MGE_BENCHMARK).
+ */
+struct Registry {
+	typedef void (*Function)(Runner& bench);
+	
+	static std::vector< std::pair<const char*, Function> >& get() {
+		static std::vector< std::pair<const char*, Function> > benchmarks;
+		return benchmarks;
+	}
+	
+	Registry(const char* name, Function func) {
+		get().emplace_back(name, func);
+	}
+};
+
+/**
+ * @brief Benchmarks executable main function (parse command line, run benchmarks, write results).
+ */
+inline int main(int argc, char* argv[], std::string_view suite) {
+	Runner      runner;
+	const char* jsonPath = nullptr;
+	const char* filter   = nullptr;
+	
+	for (int i = 1; i < argc; ++i) {
+		bool hasArg = i + 1 < argc;
+		if (!strcmp(argv[i], "--json") && hasArg) {
+			jsonPath = argv[++i];
+		} else if (!strcmp(argv[i], "--filter") && hasArg) {
+			filter = argv[++i];
+		} else if (!strcmp(argv[i], "--samples") && hasArg) {
+			runner.samples = std::max(1, atoi(argv[++i]));
+		} else if (!strcmp(argv[i], "--min-time") && hasArg) {
+			runner.minSampleTime = std::chrono::microseconds( static_cast<long long>(atof(argv[++i]) * 1000) );
+		} else if (!strcmp(argv[i], "--list")) {
+			for (auto& b : Registry::get())
+				std::cout << b.first << std::endl;
+			return 0;
+		} else {
+			std::cerr << "Usage: " << argv[0] << " [--json FILE] [--filter STRING] [--samples N] [--min-time MS] [--list]" << std::endl;
+			return 1;
+		}
+	}
+	
+	std::cout << "Benchmark suite: " << suite << "  (revision: " << ENGINE_GIT_VERSION << ")" << std::endl;
+	for (auto& b : Registry::get()) {
+		if (filter && !strstr(b.first, filter))
+			continue;
+		runner.currentName = b.first;
+		b.second(runner);
+	}
+	
+	if (jsonPath) {
+		std::ofstream out(jsonPath);
+		runner.writeJSON(out, suite);
+		if (!out) {
+			std::cerr << "Can't write results to: " << jsonPath << std::endl;
+			return 2;
+		}
+	}
+	return 0;
+}
+
+} }
+
+/**
+ * @brief Define and register benchmark function with name @a name.
+ *        Inside function body @ref MGE::Benchmark::Runner is available as @c bench.
+ */
+#define MGE_BENCHMARK(name) \
+	static void mge_benchmark_##name(MGE::Benchmark::Runner& bench); \
+	static MGE::Benchmark::Registry mge_benchmark_registry_##name(#name, &mge_benchmark_##name); \
+	static void mge_benchmark_##name([[maybe_unused]] MGE::Benchmark::Runner& bench)
+
+#ifndef MGE_BENCHMARK_NO_MAIN
+int main(int argc, char* argv[]) {
+	return MGE::Benchmark::main(argc, argv, MGE_BENCHMARK_STRINGIFY(MGE_BENCHMARK_SUITE));
+}
+#endif
@@ -0,0 +1,123 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define MGE_BENCHMARK_SUITE ListenerSet
+#include "Benchmark.h"
+
+#include "ListenerSet.h"
+
+namespace {
+	int counter = 0;
+	
+	bool functionListener(int x) {
+		counter += x;
+		return false;
+	}
+	
+	struct ListenerClass {
+		int value = 0;
+		virtual bool update(float step) {
+			value += step > 0;
+			return false;
+		}
+		virtual ~ListenerClass() = default;
+	};
+}
+
+MGE_BENCHMARK( functionCallAll ) {
+	for (int count : {1, 16, 256}) {
+		MGE::FunctionListenerSet<bool (*)(int), int> listenerSet;
+		for (int i = 0; i < count; ++i) {
+			listenerSet.listeners.insert({i % 8, &functionListener}); // duplicated listener pointers are OK for benchmark
+		}
+		bench.run({{"listeners", count}}, [&]() {
+			MGE::Benchmark::doNotOptimize( listenerSet.callAll(1) );
+		});
+	}
+}
+
+MGE_BENCHMARK( classCallAll ) {
+	for (int count : {1, 16, 64, 256}) {
+		std::vector<ListenerClass> objects(count);
+		MGE::ClassPtrListenerSet<ListenerClass, int> listenerSet;
+		for (int i = 0; i < count; ++i) {
+			listenerSet.addListener(&objects[i], (i * 37) % 400);
+		}
+		bench.run({{"listeners", count}}, [&]() {
+			MGE::Benchmark::doNotOptimize( listenerSet.callAll(&ListenerClass::update, 0.016f) );
+		});
+	}
+}
+
+MGE_BENCHMARK( flatClassCallAll ) {
+	for (int count : {1, 16, 64, 256}) {
+		std::vector<ListenerClass> objects(count);
+		MGE::ClassPtrListenerSet<ListenerClass, int, int, MGE::FlatListenerMap> listenerSet;
+		for (int i = 0; i < count; ++i) {
+			listenerSet.addListener(&objects[i], (i * 37) % 400);
+		}
+		bench.run({{"listeners", count}}, [&]() {
+			MGE::Benchmark::doNotOptimize( listenerSet.callAll(&ListenerClass::update, 0.016f) );
+		});
+	}
+}
+
+MGE_BENCHMARK( classCallAllWithKey ) {
+	for (int count : {16, 256}) {
+		std::vector<ListenerClass> objects(count);
+		MGE::ClassPtrListenerSet<ListenerClass, int> listenerSet;
+		for (int i = 0; i < count; ++i) {
+			listenerSet.addListener(&objects[i], i % 16);
+		}
+		bench.run({{"listeners", count}}, [&]() {
+			MGE::Benchmark::doNotOptimize( listenerSet.callAllWithKey(7, &ListenerClass::update, 0.016f) );
+		});
+	}
+}
+
+MGE_BENCHMARK( addRemove ) {
+	for (int count : {16, 256}) {
+		std::vector<ListenerClass> objects(count + 1);
+		MGE::ClassPtrListenerSet<ListenerClass, int> listenerSet;
+		for (int i = 0; i < count; ++i) {
+			listenerSet.addListener(&objects[i], (i * 37) % 400);
+		}
+		bench.run({{"listeners", count}}, [&]() {
+			listenerSet.addListener(&objects[count], 200);
+			listenerSet.remListener(&objects[count]);
+		});
+	}
+}
+
+MGE_BENCHMARK( flatAddRemove ) {
+	for (int count : {16, 256}) {
+		std::vector<ListenerClass> objects(count + 1);
+		MGE::ClassPtrListenerSet<ListenerClass, int, int, MGE::FlatListenerMap> listenerSet;
+		for (int i = 0; i < count; ++i) {
+			listenerSet.addListener(&objects[i], (i * 37) % 400);
+		}
+		bench.run({{"listeners", count}}, [&]() {
+			listenerSet.addListener(&objects[count], 200);
+			listenerSet.remListener(&objects[count]);
+		});
+	}
+}
@@ -0,0 +1,135 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define MGE_BENCHMARK_SUITE MessagesSystem
+#include "Benchmark.h"
+
+#include "MessagesSystem.h"
+#include "LogSystem.h"
+
+namespace MGE {
+	Log* defaultLog = new Log("", false, false);
+}
+
+namespace {
+	struct BenchMsg : MGE::EventMsg {
+		inline static constexpr std::string_view MsgType = "BenchMsg";
+		inline static constexpr uint32_t MsgTypeID = MGE::EventMsg::hashType(MsgType);
+		const std::string_view getType() const override final {
+			return MsgType;
+		}
+		uint32_t getTypeID() const override final {
+			return MsgTypeID;
+		}
+	};
+	
+	struct OtherMsg : MGE::EventMsg {
+		std::string type;
+		const std::string_view getType() const override final {
+			return type;
+		}
+	};
+	
+	int received = 0;
+	
+	void receiver(const MGE::EventMsg*, void*) {
+		++received;
+	}
+	
+	/// register @a types message types with single receiver (to fill receivers map)
+	void addOtherTypes(MGE::MessagesSystem& messagesSystem, int types) {
+		for (int i = 0; i < types; ++i) {
+			messagesSystem.registerReceiver("OtherMsg_" + std::to_string(i), &receiver, reinterpret_cast<void*>(i + 1));
+		}
+	}
+}
+
+MGE_BENCHMARK( dispatch ) {
+	for (int count : {0, 1, 8, 64}) {
+		for (int types : {1, 100}) {
+			MGE::MessagesSystem messagesSystem;
+			addOtherTypes(messagesSystem, types - 1);
+			for (int i = 0; i < count; ++i) {
+				messagesSystem.registerReceiver(BenchMsg::MsgType, &receiver, reinterpret_cast<void*>(i + 1));
+			}
+			BenchMsg msg;
+			bench.run({{"receivers", count}, {"types", types}}, [&]() {
+				messagesSystem.sendMessage(&msg);
+			});
+		}
+	}
+}
+
+MGE_BENCHMARK( dispatchFiltered ) {
+	for (int count : {8, 64}) {
+		MGE::MessagesSystem messagesSystem;
+		int senders[64];
+		for (int i = 0; i < count; ++i) {
+			messagesSystem.registerReceiver(BenchMsg::MsgType, &receiver, reinterpret_cast<void*>(i + 1), nullptr, &senders[i]);
+		}
+		BenchMsg msg;
+		bench.run({{"receivers", count}}, [&]() {
+			messagesSystem.sendMessage(&msg, &senders[0]);
+		});
+	}
+}
+
+MGE_BENCHMARK( dispatchDynamicType ) {
+	for (int types : {1, 100}) {
+		MGE::MessagesSystem messagesSystem;
+		addOtherTypes(messagesSystem, types);
+		OtherMsg msg;
+		msg.type = "OtherMsg_0";
+		bench.run({{"types", types}}, [&]() {
+			messagesSystem.sendMessage(&msg);
+		});
+	}
+}
+
+MGE_BENCHMARK( registerUnregister ) {
+	for (int count : {1, 64}) {
+		MGE::MessagesSystem messagesSystem;
+		for (int i = 0; i < count; ++i) {
+			messagesSystem.registerReceiver(BenchMsg::MsgType, &receiver, reinterpret_cast<void*>(i + 1));
+		}
+		void* owner = reinterpret_cast<void*>(count + 1);
+		bench.run({{"receivers", count}}, [&]() {
+			messagesSystem.registerReceiver(BenchMsg::MsgType, &receiver, owner);
+			messagesSystem.unregisterReceiver(BenchMsg::MsgType, &receiver, owner);
+		});
+	}
+}
+
+MGE_BENCHMARK( postAndDispatch ) {
+	for (int count : {1, 64}) {
+		for (bool coalesce : {false, true}) {
+			MGE::MessagesSystem messagesSystem;
+			messagesSystem.registerReceiver(BenchMsg::MsgType, &receiver, reinterpret_cast<void*>(1));
+			bench.run({{"messages", count}, {"coalesce", coalesce}}, [&]() {
+				for (int i = 0; i < count; ++i) {
+					messagesSystem.postMessage(BenchMsg(), nullptr, coalesce);
+				}
+				messagesSystem.dispatchQueuedMessages();
+			});
+		}
+	}
+}
@@ -0,0 +1,43 @@
+#
+# ActorFactory macrobenchmark – spawn / destroy throughput and spatial queries
+#
+# run (from build dir):
+#   MGE_BENCHMARK_OUTPUT=benchmarks/ActorFactory.json ./Game --headless --config-file conf/MGEConfig-headless.xml --exec-script path/to/engine-benchmarks/scenarios/actorFactory.py
+#
+
+import sys, os
+sys.path.insert(0, os.environ.get("MGE_BENCHMARK_DIR", "engine-benchmarks/scenarios"))
+import mgeBenchmark
+
+suite = mgeBenchmark.Suite("ActorFactory")
+loadingSystem = MGE.LoadingSystem.get()
+actorFactory = MGE.ActorFactory.get()
+
+def spawnXML(count, prefix):
+	xml = ['<scene><nodes>']
+	for i in range(count):
+		xml.append('<node name="%s%d"><position x="%d" y="0" z="%d"/><item meshFile="Cube_1x1x1.mesh"/><actor/></node>' % (prefix, i, (i % 100) * 2, (i // 100) * 2))
+	xml.append('</nodes></scene>')
+	return "".join(xml)
+
+def spawnByCreateActor(count):
+	for i in range(count):
+		actorFactory.createActor(None, "BenchSpawn%d" % i, Ogre.Vector3((i % 100) * 2, 0, (i // 100) * 2), Ogre.Quaternion.IDENTITY, False, None)
+
+def destroyAll():
+	for name in list(actorFactory.allActors.keys()):
+		actorFactory.destroyActor(actorFactory.getActor(name), True)
+
+for count in (100, 1000):
+	sceneXML = spawnXML(count, "BenchActor")
+	suite.run("spawnFromDotScene", {"actors": count}, lambda: loadingSystem.loadDotSceneXML(sceneXML), loadingSystem.clearScene)
+	suite.run("spawnCreateActor", {"actors": count}, lambda: spawnByCreateActor(count), loadingSystem.clearScene)
+	
+	loadingSystem.clearScene()
+	loadingSystem.loadDotSceneXML(sceneXML)
+	suite.run("findActors", {"actors": count}, lambda: [actorFactory.findActors(Ogre.Vector3(x * 10.0, 0, 10.0), 8.0) for x in range(100)])
+	suite.run("destroyAll", {"actors": count}, destroyAll, lambda: (loadingSystem.clearScene(), loadingSystem.loadDotSceneXML(sceneXML)))
+
+loadingSystem.clearScene()
+suite.write()
+MGE.Engine.get().shutdown()
@@ -0,0 +1,55 @@
+#
+# helper for benchmark scenarios executed inside engine (via `--exec-script`)
+# produce the same JSON results format as engine-benchmarks/Benchmark.h
+#
+# environment variables:
+#   MGE_BENCHMARK_OUTPUT    path of JSON results file (default: print results only)
+#   MGE_BENCHMARK_REVISION  git revision stored in results (default: "unknown")
+#   MGE_BENCHMARK_SAMPLES   number of measured samples per scenario (default 15)
+#
+
+import json, math, os, time
+
+class Suite:
+	def __init__(self, name):
+		self.name = name
+		self.samples = int(os.environ.get("MGE_BENCHMARK_SAMPLES", 15))
+		self.results = []
+	
+	def run(self, name, params, body, setUp = None):
+		""" measure `body()` (single call per sample), call `setUp()` (not measured) before each sample """
+		if setUp: setUp()
+		body() # warm-up
+		
+		times = []
+		for i in range(self.samples):
+			if setUp: setUp()
+			start = time.perf_counter_ns()
+			body()
+			times.append(time.perf_counter_ns() - start)
+		
+		times.sort()
+		count = len(times)
+		res = {
+			"name": name, "params": params, "samples": count, "iterations": 1,
+			"min": times[0],
+			"median": times[count//2] if count % 2 else (times[count//2 - 1] + times[count//2]) / 2,
+			"p99": times[min(count - 1, math.ceil(0.99 * count) - 1)],
+			"mean": sum(times) / count
+		}
+		self.results.append(res)
+		
+		paramsStr = "".join("/" + k + "=" + str(v) for k, v in params.items())
+		print("%-40s  min=%12.1f ns  median=%12.1f ns  p99=%12.1f ns  (%d x 1)" % (name + paramsStr, res["min"], res["median"], res["p99"], count))
+		return res
+	
+	def write(self):
+		path = os.environ.get("MGE_BENCHMARK_OUTPUT")
+		if not path:
+			return
+		with open(path, "w") as outFile:
+			json.dump({
+				"suite": self.name, "revision": os.environ.get("MGE_BENCHMARK_REVISION", "unknown"), "unit": "ns",
+				"results": self.results
+			}, outFile, indent="\t")
+			outFile.write("\n")
@@ -0,0 +1,54 @@
+#
+# PathFinder macrobenchmark on synthetic hexagonal maps
+#
+# run (from build dir):
+#   MGE_BENCHMARK_OUTPUT=benchmarks/PathFinder.json ./Game --headless --config-file conf/MGEConfig-headless.xml --exec-script path/to/engine-benchmarks/scenarios/pathFinder.py
+#
+
+import sys, os, random
+sys.path.insert(0, os.environ.get("MGE_BENCHMARK_DIR", "engine-benchmarks/scenarios"))
+import mgeBenchmark
+
+suite = mgeBenchmark.Suite("PathFinder")
+loadingSystem = MGE.LoadingSystem.get()
+
+def buildHexMap(mapSize, density, seed):
+	""" ground plane (mapSize x mapSize) with 1x1x1 obstacles in hexagonal grid cells (with `density` percent probability) """
+	rnd = random.Random(seed)
+	distanceY = 2.0
+	distanceX = distanceY * 1.5 / 3**0.5
+	
+	xml = ['<scene><nodes>',
+		'<node name="BenchGround"><scale x="%d" y="1" z="%d"/>' % (mapSize, mapSize),
+		'<item meshFile="Plane_1x1.mesh" isGround="true"/></node>'
+	]
+	for a in range(int(mapSize / distanceX)):
+		for b in range(int(mapSize / distanceY)):
+			x = a * distanceX - mapSize/2
+			z = b * distanceY - (a & 1) * distanceY/2 - mapSize/2
+			if abs(x) < 4 and abs(z) < 4 or abs(x - mapSize/2 + 4) < 4 and abs(z - mapSize/2 + 4) < 4:
+				continue # keep free space around start and end points
+			if rnd.randrange(100) < density:
+				xml.append('<node><position x="%f" y="0.5" z="%f"/><item meshFile="Cube_1x1x1.mesh"/></node>' % (x, z))
+	xml.append('<node name="BenchWalker"><position x="0" y="0.5" z="0"/><scale x="0.5" y="0.5" z="0.5"/><item meshFile="Cube_1x1x1.mesh"/><actor/></node>')
+	xml.append('</nodes></scene>')
+	
+	loadingSystem.clearScene()
+	loadingSystem.loadDotSceneXML("".join(xml))
+	return MGE.World3DObject.getFromActor( MGE.ActorFactory.get().getActor("BenchWalker") )
+
+pathFinder = MGE.PathFinder()
+for mapSize in (32, 128):
+	for density in (0, 10, 25):
+		walker = buildHexMap(mapSize, density, 13)
+		src = Ogre.Vector3(0, 0, 0)
+		dst = Ogre.Vector3(mapSize/2 - 4, 0, mapSize/2 - 4)
+		
+		res = pathFinder.findPath(walker, src, dst)
+		print("findPath mapSize=%d density=%d status=%d points=%d" % (mapSize, density, res[0], len(res[1])))
+		
+		suite.run("findPath", {"mapSize": mapSize, "density": density}, lambda: pathFinder.findPath(walker, src, dst))
+
+loadingSystem.clearScene()
+suite.write()
+MGE.Engine.get().shutdown()
@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define MGE_BENCHMARK_SUITE ScriptsSystem
+#include "Benchmark.h"
+
+#include "ScriptsSystem.h"
+#include "LogSystem.h"
+
+namespace MGE {
+	Log* defaultLog = new Log("", false, false);
+	ScriptsSystem* scriptsSystem = new ScriptsSystem();
+}
+
+namespace {
+	const char* benchScripts = R"(
+def bench_noop():
+	pass
+
+def bench_args(a, b, c):
+	return a + b + c
+
+class BenchObject:
+	def __init__(self):
+		self.value = 0
+	def update(self, step):
+		self.value += step
+
+benchObject = BenchObject()
+
+def bench_method(step):
+	benchObject.update(step)
+)";
+}
+
+MGE_BENCHMARK( runObject ) {
+	MGE::scriptsSystem->runStringWithVoid(benchScripts);
+	
+	bench.run({{"args", 0}}, [&]() {
+		MGE::scriptsSystem->runObjectWithVoid("bench_noop");
+	});
+	bench.run({{"args", 3}}, [&]() {
+		MGE::Benchmark::doNotOptimize( MGE::scriptsSystem->runObjectWithCast<int>("bench_args", 0, 1, 2, 3) );
+	});
+	bench.run({{"args", 1}}, [&]() {
+		MGE::scriptsSystem->runObjectWithVoid("bench_method", 0.016f);
+	});
+}
+
+MGE_BENCHMARK( getObject ) {
+	MGE::scriptsSystem->runStringWithVoid(benchScripts);
+	
+	bench.run([&]() {
+		MGE::Benchmark::doNotOptimize( MGE::scriptsSystem->getObject("bench_noop").ptr() );
+	});
+}
+
+MGE_BENCHMARK( callCachedObject ) {
+	MGE::scriptsSystem->runStringWithVoid(benchScripts);
+	
+	pybind11::object func = MGE::scriptsSystem->getObject("bench_noop");
+	bench.run([&]() {
+		func();
+	});
+}
+
+MGE_BENCHMARK( runString ) {
+	bench.run({{"mode", Py_eval_input}}, [&]() {
+		MGE::scriptsSystem->runString("2+3", Py_eval_input);
+	});
+	bench.run({{"mode", Py_file_input}}, [&]() {
+		MGE::scriptsSystem->runString("x = 2+3");
+	});
+}
@@ -0,0 +1,139 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define MGE_BENCHMARK_SUITE StoreRestoreSystem
+#include "Benchmark.h"
+
+#include "StoreRestoreSystem.h"
+#include "LogSystem.h"
+
+#include <pugixml.hpp>
+#include <memory>
+#include <sstream>
+
+namespace MGE {
+	Log* defaultLog = new Log("", false, false);
+}
+
+namespace {
+	/// synthetic saveable module with @a entries records (similar to actors list in save file)
+	struct SaveableModule : MGE::SaveableToXMLInterface {
+		std::string tagName;
+		std::vector<std::pair<std::string, float>> entries;
+		size_t restored = 0;
+		
+		SaveableModule(int id, int count) : tagName("Module" + std::to_string(id)) {
+			for (int i = 0; i < count; ++i)
+				entries.emplace_back("Entry_" + std::to_string(i), i * 0.25f);
+		}
+		
+		bool storeToXML(pugi::xml_node& xmlNode, bool /*onlyRef*/) const override {
+			for (auto& e : entries) {
+				auto xmlSubNode = xmlNode.append_child("Entry");
+				xmlSubNode.append_attribute("name") = e.first.c_str();
+				xmlSubNode.append_child("position").append_attribute("x") = e.second;
+				xmlSubNode.child("position").append_attribute("y") = 0.0f;
+				xmlSubNode.child("position").append_attribute("z") = -e.second;
+			}
+			return true;
+		}
+		
+		bool restoreFromXML(const pugi::xml_node& xmlNode, const MGE::LoadingContext* /*context*/) override {
+			restored = 0;
+			for (auto xmlSubNode : xmlNode.children("Entry")) {
+				MGE::Benchmark::doNotOptimize( xmlSubNode.attribute("name").as_string() );
+				MGE::Benchmark::doNotOptimize( xmlSubNode.child("position").attribute("x").as_float() );
+				++restored;
+			}
+			return true;
+		}
+		
+		const std::string_view getXMLTagName() const override {
+			return tagName;
+		}
+	};
+	
+	struct Scenario {
+		MGE::StoreRestoreSystem storeRestoreSystem;
+		std::vector<std::unique_ptr<SaveableModule>> modules;
+		
+		Scenario(int modulesCount, int entries) {
+			for (int i = 0; i < modulesCount; ++i) {
+				modules.emplace_back(new SaveableModule(i, entries));
+				storeRestoreSystem.addSaveListener(modules.back().get(), i);
+			}
+		}
+		
+		std::string save() {
+			pugi::xml_document xmlDoc;
+			auto xmlNode = xmlDoc.append_child("SaveFile");
+			storeRestoreSystem.storeToXML(xmlNode);
+			std::ostringstream out;
+			xmlDoc.save(out);
+			return out.str();
+		}
+	};
+}
+
+MGE_BENCHMARK( store ) {
+	for (int entries : {100, 1000, 10000}) {
+		Scenario scenario(8, entries);
+		bench.run({{"modules", 8}, {"entries", entries}}, [&]() {
+			pugi::xml_document xmlDoc;
+			auto xmlNode = xmlDoc.append_child("SaveFile");
+			scenario.storeRestoreSystem.storeToXML(xmlNode);
+			MGE::Benchmark::doNotOptimize(xmlDoc);
+		});
+	}
+}
+
+MGE_BENCHMARK( save ) {
+	for (int entries : {100, 1000, 10000}) {
+		Scenario scenario(8, entries);
+		bench.run({{"modules", 8}, {"entries", entries}}, [&]() {
+			MGE::Benchmark::doNotOptimize( scenario.save() );
+		});
+	}
+}
+
+MGE_BENCHMARK( restore ) {
+	for (int entries : {100, 1000, 10000}) {
+		Scenario scenario(8, entries);
+		pugi::xml_document xmlDoc;
+		xmlDoc.load_string( scenario.save().c_str() );
+		bench.run({{"modules", 8}, {"entries", entries}}, [&]() {
+			scenario.storeRestoreSystem.restoreFromXML( xmlDoc.child("SaveFile") );
+		});
+	}
+}
+
+MGE_BENCHMARK( load ) {
+	for (int entries : {100, 1000, 10000}) {
+		Scenario scenario(8, entries);
+		std::string saveStr = scenario.save();
+		bench.run({{"modules", 8}, {"entries", entries}}, [&]() {
+			pugi::xml_document xmlDoc;
+			xmlDoc.load_buffer( saveStr.data(), saveStr.size() );
+			scenario.storeRestoreSystem.restoreFromXML( xmlDoc.child("SaveFile") );
+		});
+	}
+}
@@ -33,7 +33,10 @@ SOFTWARE.
 MGE::CmdLineArgs::CmdLineArgs() :
 	loadingMode(UNSET),
 	startPaused(std::nullopt),
-	mainConfigFilePath(std::nullopt)
+	mainConfigFilePath(std::nullopt),
+	headless(false),
+	fixedTimeStep(0),
+	maxFrames(0)
 {}
 
 bool MGE::CmdLineArgs::parse(int argc, char* argv[]) {
@@ -48,6 +51,9 @@ bool MGE::CmdLineArgs::parse(int argc, char* argv[]) {
 		("exec-script", boost::program_options::value<std::string>(), "execute script file from \"arg\"")
 		("pause",       "pause game after load")
 		("no-pause",    "no pause game after load")
+		("headless",    "run without window and GPU (Ogre NULL render system), e.g. for simulation servers and performance tests, use with --config-file conf/MGEConfig-headless.xml")
+		("fixed-dt",    boost::program_options::value<float>(), "use fixed time step \"arg\" (in seconds) for every frame instead of measured time")
+		("max-frames",  boost::program_options::value<uint64_t>(), "exit after \"arg\" frames")
 	;
 	
 	// parse command line options
@@ -93,6 +99,17 @@ bool MGE::CmdLineArgs::parse(int argc, char* argv[]) {
 		startPaused = false;
 	}
 	
+	// headless mode and main loop clock settings
+	headless = vm.count("headless");
+	if (vm.count("fixed-dt")) {
+		fixedTimeStep = vm["fixed-dt"].as<float>();
+		if (fixedTimeStep <= 0)
+			throw std::logic_error("fixed-dt must be greater than zero");
+	}
+	if (vm.count("max-frames")) {
+		maxFrames = vm["max-frames"].as<uint64_t>();
+	}
+	
 	// check exists of file indicated by cmd args
 	if (loadingMode == LOAD_SAVE || loadingMode == LOAD_MAP || loadingMode == EDIT_SCENE || loadingMode == RUN_SCRIPT) {
 		if (! std::filesystem::is_regular_file(std::filesystem::path( loadingFilePath ))) {
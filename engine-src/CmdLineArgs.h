@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include <string>
 #include <optional>
+#include <stdint.h>
 
 namespace MGE {
 
@@ -62,6 +63,15 @@ struct CmdLineArgs {
 	
 	/// Main config file path, when unset use default
 	std::optional<std::string>  mainConfigFilePath;
+	
+	/// Headless mode (Ogre NULL render system, no window, no GPU) set by cmdline args.
+	bool headless;
+	
+	/// Fixed real time step (in seconds) used for every frame instead of measured time, zero when not set by cmdline args.
+	float fixedTimeStep;
+	
+	/// Number of frames after which main loop will be finished, zero (no limit) when not set by cmdline args.
+	uint64_t maxFrames;
 };
 
 /// @}
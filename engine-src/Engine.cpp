@@ -23,6 +23,9 @@ SOFTWARE.
 #include "Engine.h"
 #include "MessagesSystem.h"
 #include "ScriptsSystem.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "MainLoopListener.h"
 
 #include "config.h"
 #include "with.h"
@@ -51,6 +54,7 @@ void createGameControler();
 #include <X11/Xlib.h> // for some reasons should be after CEGUI
 #endif
 
+#include <exception>
 #include <filesystem>
 
 int MGE::Engine::start(int argc, char* argv[]) {
@@ -85,13 +89,23 @@ int MGE::Engine::start(int argc, char* argv[]) {
 	MGE::ConfigParser::getPtr()->initMainConfig( cmdLineArgs.mainConfigFilePath.value_or(MGE_MAIN_CONFIG_FILE_DEFAULT_PATH).c_str(), "MGEConfig" );
 	
 	// update log system
-	defaultLog->setFile( MGE::ConfigParser::getPtr()->getMainConfig("LogSystem").child("LogFile").text().as_string(MGE_LOG_FILE_DEFAULT_PATH) );
+	auto logConfig = MGE::ConfigParser::getPtr()->getMainConfig("LogSystem");
+	defaultLog->setFile( logConfig.child("LogFile").text().as_string(MGE_LOG_FILE_DEFAULT_PATH) );
+	defaultLog->setLevel( MGE::Log::stringToLogLevel(logConfig.child("Level").text().as_string()) );
+	for (auto xmlNode : logConfig.children("Category")) {
+		defaultLog->setCategoryLevel( xmlNode.attribute("name").as_string(), MGE::Log::stringToLogLevel(xmlNode.attribute("level").as_string()) );
+	}
 	
 	// exit on request from parseCmdLineArgs or cmd line arg parsing error
 	if (retCode >=0) {
 		return retCode;
 	}
 	
+	// switch log to asynchronous mode (background writer thread)
+	if (logConfig.child("AsyncMode").text().as_bool(true)) {
+		defaultLog->setAsyncMode(true, logConfig.child("QueueSize").text().as_uint(4096));
+	}
+	
 	#if defined( TARGET_SYSTEM_IS_UNIX )
 	XInitThreads(); // need for X11 clipboard support ... must be called before any other X-system calls ... so add here :-/
 	#endif
@@ -99,6 +113,14 @@ int MGE::Engine::start(int argc, char* argv[]) {
 	// create engine (and essential modules - scripts and message systems)
 	new Engine(argv[0]);
 	
+	// set main loop mode from cmd line args (before init, because modules created in init depend on headless mode)
+	getPtr()->headless      = cmdLineArgs.headless;
+	getPtr()->fixedTimeStep = cmdLineArgs.fixedTimeStep;
+	getPtr()->maxFrames     = cmdLineArgs.maxFrames;
+	if (cmdLineArgs.headless) {
+		LOG_INFO("Engine", "Running in headless mode");
+	}
+	
 	// continue starting engine
 	getPtr()->init();
 	
@@ -123,7 +145,8 @@ int MGE::Engine::start(int argc, char* argv[]) {
 	}
 	
 	#ifdef MGE_USE_GAMECONTROLER
-	createGameControler();
+	if (MGE::InputSystem::getPtr()) // no InputSystem in headless mode
+		createGameControler();
 	#endif
 	
 	if (!cmdLineArgs.startPaused.value_or(true)) {
@@ -137,10 +160,18 @@ int MGE::Engine::start(int argc, char* argv[]) {
 }
 
 MGE::Engine::Engine(const char* argv0) :
+	headless(false),
+	fixedTimeStep(0),
+	maxFrames(0),
 	scriptsSystem( new MGE::ScriptsSystem() ),
 	messagesSystem( new MGE::MessagesSystem() ),
 	configParser( MGE::ConfigParser::getPtr() ),
-	storeRestoreSystem( new MGE::StoreRestoreSystem() ) /* this is core due to unload() registration / execution */
+	storeRestoreSystem( new MGE::StoreRestoreSystem() ), /* this is core due to unload() registration / execution */
+	jobSystem( new MGE::JobSystem( MGE::ConfigParser::getPtr()->getMainConfig("JobSystem").child("WorkerThreads").text().as_int(-1) ) ),
+	profiler( new MGE::Profiler(
+		MGE::ConfigParser::getPtr()->getMainConfig("Profiler").child("Frames").text().as_int(300),
+		MGE::ConfigParser::getPtr()->getMainConfig("Profiler").child("Enabled").text().as_bool(false)
+	) )
 {
 	// get working and binary path
 	workingDir    = std::filesystem::absolute(".").lexically_normal().generic_string();
@@ -154,6 +185,13 @@ MGE::Engine::Engine(const char* argv0) :
 	
 	// import MGE Python module => import engine Python script API
 	scriptsSystem->getGlobalsDict()["MGE"] = pybind11::module::import("MGE");
+	scriptsSystem->setProfilingEnabled( MGE::ConfigParser::getPtr()->getMainConfig("Profiler").child("Scripts").text().as_bool(false) );
+	
+	// deliver messages queued by MessagesSystem::postMessage() in main loop
+	mainLoopListeners.addListener(
+		messagesSystem,
+		MGE::ConfigParser::getPtr()->getMainConfig("MessagesSystem").child("QueuePriority").text().as_int(MGE::MainLoopListener::PRE_RENDER_ACTIONS)
+	);
 	
 	// list registered XML tags for parsing config files:
 	MGE::ConfigParser::getPtr()->listListeners();
@@ -173,6 +211,7 @@ void MGE::Engine::run() {
 	mainLoopTime = std::chrono::steady_clock::now();
 	
 	auto mainMenu = MGE::MainMenu::getPtr();
+	uint64_t frameNumber = 0;
 	
 	// main loop
 	while(true) {
@@ -182,35 +221,106 @@ void MGE::Engine::run() {
 		mainLoopTime = nowTime;
 		
 		// calculate TimeSinceLastFrame ...
-		float realTimeSinceLastFrame = diffTime.count();
+		float realTimeSinceLastFrame = fixedTimeStep > 0 ? fixedTimeStep : diffTime.count();
 		float gameTimeSinceLastFrame = MGE::TimeSystem::getPtr()->getScaledTime(realTimeSinceLastFrame); // == 0.0f when paused
 		
 		//LOG_DEBUG(" ======= ::::: ======= ");
 		
-		Ogre::WindowEventUtilities::messagePump();
-		
-		if (!isRun || MGE::RenderingSystem::getPtr()->getRenderWindow()->isClosed()) {
+		if (!isRun || (maxFrames && frameNumber >= maxFrames)) {
 			break;
 		}
 		
-		if (! MGE::RenderingSystem::getPtr()->getRenderWindow()->isVisible()) {
-			//if (mainMenu) mainMenu->show();
-			Ogre::Threads::Sleep( 500 );
-			continue;
+		if (!headless) {
+			Ogre::WindowEventUtilities::messagePump();
+			
+			if (MGE::RenderingSystem::getPtr()->getRenderWindow()->isClosed()) {
+				break;
+			}
+			
+			if (! MGE::RenderingSystem::getPtr()->getRenderWindow()->isVisible()) {
+				//if (mainMenu) mainMenu->show();
+				Ogre::Threads::Sleep( 500 );
+				continue;
+			}
 		}
 		
-		if (mainMenu && mainMenu->isVisible()) {
-			mainLoopListeners.callAll(&MGE::MainLoopListener::updateOnFullPause, realTimeSinceLastFrame);
-		} else {
-			/// @todo TODO.8: maybe run parallel/multi-thread listeners with the same key value
-			mainLoopListeners.callAll(&MGE::MainLoopListener::update, gameTimeSinceLastFrame, realTimeSinceLastFrame);
-		}
+		profiler->beginFrame();
+		callMainLoopListeners(mainMenu && mainMenu->isVisible(), gameTimeSinceLastFrame, realTimeSinceLastFrame);
+		profiler->endFrame();
+		++frameNumber;
 		
 		//std::string FPSInfo =  Ogre::StringConverter::toString(MGE::RenderingSystem::getPtr()->getRenderWindow()->getLastFPS());
 		//MGE::OnScreenInfo::getPtr()->showOnScreenText(FPSInfo.c_str(), -1, 333);
 	}
 	
 	LOG_HEADER("End Rendering via Main Loop ... shutting down Engine");
+	LOG_INFO("Engine", "Main loop finished after " << frameNumber << " frames");
+}
+
+void MGE::Engine::callMainLoopListeners(bool onFullPause, float gameTimeStep, float realTimeStep) {
+	auto call = [onFullPause, gameTimeStep, realTimeStep](MGE::MainLoopListener* listener) {
+		// profiler zone named by listener class name (demangled only on display / export)
+		MGE::Profiler::ZoneScope zone(typeid(*listener).name(), true);
+		if (onFullPause)
+			listener->updateOnFullPause(realTimeStep);
+		else
+			listener->update(gameTimeStep, realTimeStep);
+	};
+	
+	// iteration guard: listeners added / removed by called listeners are applied after finish of iteration
+	// (storage is not modified while guard exists, so iterators remain valid and removed listeners are only marked)
+	auto& listeners = mainLoopListeners.listeners;
+	auto guard = listeners.lockIteration();
+	auto iter = listeners.begin();
+	while (iter != listeners.end()) {
+		// get range of listeners with the same key value
+		int  key   = iter->first;
+		auto begin = iter;
+		int  threadSafeCount = 0;
+		for (; iter != listeners.end() && iter->first == key; ++iter) {
+			if (!listeners.isRemoved(iter))
+				threadSafeCount += iter->second->isThreadSafe();
+		}
+		
+		// when have less than two thread safe listeners, then run all in main thread (in order of registration)
+		// check isRemoved() before each call – listener can be removed by previous listener from this group
+		if (threadSafeCount < 2 || jobSystem->getWorkersCount() == 0) {
+			for (auto curr = begin; curr != iter; ++curr) {
+				if (!listeners.isRemoved(curr))
+					call(curr->second);
+			}
+			continue;
+		}
+		
+		// run not thread safe listeners in main thread (in order of registration) before thread safe listeners,
+		// so thread safe listeners need be safe only in relation to other thread safe listeners
+		for (auto curr = begin; curr != iter; ++curr) {
+			if (!listeners.isRemoved(curr) && !curr->second->isThreadSafe())
+				call(curr->second);
+		}
+		
+		// run thread safe listeners in worker threads (main thread help while waiting)
+		// listeners set is not synchronised, so add / remove listener from thread safe listener throw std::logic_error
+		MGE::JobSystem::JobsGroup group;
+		std::exception_ptr exception;
+		auto modificationsGuard = listeners.lockModifications();
+		try {
+			for (auto curr = begin; curr != iter; ++curr) {
+				if (!listeners.isRemoved(curr) && curr->second->isThreadSafe()) {
+					MGE::MainLoopListener* listener = curr->second;
+					jobSystem->run([&call, listener]{ call(listener); }, &group);
+				}
+			}
+		} catch(...) {
+			exception = std::current_exception();
+		}
+		
+		// barrier – wait for all listeners with this key value before go to next key
+		// (always wait, even on error – jobs use `call` and `group` from this stack frame)
+		jobSystem->wait(&group);
+		if (exception)
+			std::rethrow_exception(exception);
+	}
 }
 
 void MGE::Engine::shutDown() {
@@ -255,6 +365,9 @@ MGE::Engine::~Engine() { /// @todo TODO.4: use "destroy" listener registration b
 	delete MGE::LoadingSystem::getPtr();
 	*/
 	
+	delete jobSystem;
+	delete profiler;
+	
 	delete defaultLog;
 	defaultLog = nullptr;
 }
@@ -30,9 +30,11 @@ SOFTWARE.
 #include "LogSystem.h"
 #include "ConfigParser.h" // for LoadedModulesSet
 
-namespace MGE { class MessagesSystem; class ScriptsSystem; class StoreRestoreSystem; class LoadingSystem; struct MainLoopListener; }
+namespace MGE { class MessagesSystem; class ScriptsSystem; class StoreRestoreSystem; class LoadingSystem; class JobSystem; class Profiler; struct MainLoopListener; }
 
 #include <chrono>
+#include <stdint.h>
+#include <vector>
 
 /**
  * <b>Modules Game %Engine</b> main namespace.
@@ -96,6 +98,20 @@ public:
 		return configParser;
 	}
 	
+	/**
+	 * @brief Return pointer to job system.
+	 */
+	FORCE_INLINE MGE::JobSystem* getJobSystem() const {
+		return jobSystem;
+	}
+	
+	/**
+	 * @brief Return pointer to frame profiler.
+	 */
+	FORCE_INLINE MGE::Profiler* getProfiler() const {
+		return profiler;
+	}
+	
 	/**
 	 * @brief Return pointer to config parser.
 	 */
@@ -147,8 +163,12 @@ public:
 	 * Listener should derived from @ref MGE::MainLoopListener.
 	 * Key values are not unique and determinate order of listeners execution,
 	 * see @ref MGE::MainLoopListener::StandardLevels.
+	 * Listeners with the same key value returning true from @ref MGE::MainLoopListener::isThreadSafe
+	 * are executed in parallel via @ref MGE::JobSystem (after all other listeners with this key value, regardless of
+	 * registration order) and can't add or remove main loop listeners (see @ref MGE::MainLoopListener::isThreadSafe).
+	 * Use flat storage (@ref MGE::FlatListenerMap), because it is iterated every frame and modified rarely.
 	 */
-	ClassPtrListenerSet<MGE::MainLoopListener, int>   mainLoopListeners;
+	ClassPtrListenerSet<MGE::MainLoopListener, int, int, MGE::FlatListenerMap>   mainLoopListeners;
 	
 	/**
 	 * @brief Return time of start last (current for main loop listeners) execution of main loop.
@@ -157,6 +177,13 @@ public:
 		return mainLoopTime;
 	}
 	
+	/**
+	 * @brief Return true when engine is running in headless mode (Ogre NULL render system, without window and GPU).
+	 */
+	bool isHeadless() const {
+		return headless;
+	}
+	
 	/**
 	 * @brief Return path to directory with executable file.
 	 */
@@ -194,6 +221,15 @@ protected:
 	/// path to current directory on engine start
 	std::string  workingDir;
 	
+	/// headless mode (no window, Ogre NULL render system)
+	bool         headless;
+	
+	/// when non zero used as real time step of every frame (instead of measured time)
+	float        fixedTimeStep;
+	
+	/// when non zero main loop is finished after this number of frames
+	uint64_t     maxFrames;
+	
 private:
 	/// Constructor (used by @ref start).
 	Engine(const char* argv0);
@@ -204,11 +240,16 @@ private:
 	/// Executing main loop.
 	void run();
 	
+	/// Call main loop listeners – listeners with the same key value and isThreadSafe() == true are run in parallel.
+	void callMainLoopListeners(bool onFullPause, float gameTimeStep, float realTimeStep);
+	
 	/// Core modules pointers. @{
 	MGE::ScriptsSystem* scriptsSystem;
 	MGE::MessagesSystem* messagesSystem;
 	MGE::ConfigParser* configParser;
 	MGE::StoreRestoreSystem* storeRestoreSystem;
+	MGE::JobSystem* jobSystem;
+	MGE::Profiler* profiler;
 	/// Also ``MGE::Log* defaultLog;`` -- this is global `extern` variable, declare and used by logSystem.h, defined and allocated by engine.cpp.
 	/// @}
 	
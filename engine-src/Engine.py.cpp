@@ -42,6 +42,9 @@ MGE_SCRIPT_API_FOR_MODULE(Engine) {
 		.def("getMessagesSystem", &MGE::Engine::getMessagesSystem,
 			DOC(MGE, Engine, getMessagesSystem)
 		)
+		.def("isHeadless", &MGE::Engine::isHeadless,
+			DOC(MGE, Engine, isHeadless)
+		)
 		.def("crash", &MGE::ScriptsInterface::crash,
 			 "Crash engine (show crash message, write on-crash save and exit). For call on critical error at Python side. \n\n"
 			 "Exceptions in script code only break current script code execution and log error message, so to enforce engine crash is require call this method.",
@@ -87,6 +87,10 @@ void MGE::Engine::handleCrash() {
 	signal(SIGSEGV, SIG_DFL);
 	signal(SIGABRT, SIG_DFL);
 	
+	// write all queued messages and use synchronous writes (to keep order with direct std::cerr writes and before abort),
+	// without joining writer thread (it can be crashed thread or wait for lock held by crashed thread)
+	MGE_LOG.flushOnCrash();
+	
 	LOG_HEADER("MGE CRASH:  "s + errType + " " + errMsg);
 	
 	// make crash save
@@ -74,6 +74,22 @@ struct MainLoopListener {
 	 */
 	virtual bool updateOnFullPause(float realTimeStep) { return true; }
 	
+	/**
+	 * @brief Return true when @ref update and @ref updateOnFullPause of this listener can be executed in worker thread
+	 *        in parallel with other listeners registered with the same key value.
+	 *        By default (if not override) return false, so listener is executed in main thread.
+	 * 
+	 * @note Listeners with different key values are never executed in parallel (there is barrier between key values).
+	 *       When key value group has at least two thread safe listeners, then listeners not thread safe are executed
+	 *       (in main thread) before all thread safe listeners with the same key value, regardless of registration order.
+	 *       So thread safe listener must be safe only in relation to other thread safe listeners with the same key value.
+	 * @note Thread safe listener can't add or remove main loop listeners in @ref update (it throws std::logic_error,
+	 *       see @ref MGE::FlatListenerMap::lockModifications) – it should use e.g. @ref MGE::MessagesSystem::postMessage
+	 *       and handle the change in main thread. It also should use @ref MGE::MessagesSystem::postMessage
+	 *       instead of @ref MGE::MessagesSystem::sendMessage.
+	 */
+	virtual bool isThreadSafe() const { return false; }
+	
 	/// Empty virtual destructor.
 	virtual ~MainLoopListener() = default;
 };
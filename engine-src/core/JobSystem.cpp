@@ -0,0 +1,156 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "JobSystem.h"
+#include "LogSystem.h"
+
+thread_local int MGE::JobSystem::currentWorkerID = -1;
+
+MGE::JobSystem::JobSystem(int workersCount) :
+	queuedJobs(0), nextQueue(0), stopWorkers(false)
+{
+	if (workersCount < 0) {
+		workersCount = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+		if (workersCount < 0)
+			workersCount = 0;
+	}
+	
+	LOG_INFO("JobSystem", "Initialize Job System with " << workersCount << " worker threads");
+	
+	for (int i=0; i<workersCount; ++i) {
+		queues.emplace_back(new JobsQueue());
+	}
+	for (int i=0; i<workersCount; ++i) {
+		workers.emplace_back(&MGE::JobSystem::workerLoop, this, i);
+	}
+}
+
+MGE::JobSystem::~JobSystem() {
+	LOG_INFO("JobSystem", "Stop Job System");
+	
+	{
+		std::lock_guard<std::mutex> lock(wakeUpMutex);
+		stopWorkers = true;
+	}
+	wakeUpCondition.notify_all();
+	
+	for (auto& thread : workers) {
+		thread.join();
+	}
+}
+
+void MGE::JobSystem::run(JobFunction&& job, JobsGroup* group) {
+	++group->pendingJobs;
+	
+	if (workers.empty()) {
+		Job tmp {std::move(job), group};
+		execute(tmp);
+		return;
+	}
+	
+	// workers put new jobs to own queue, other threads use round-robin
+	unsigned int queueID = currentWorkerID >= 0 ? currentWorkerID : (nextQueue++ % queues.size());
+	{
+		std::lock_guard<std::mutex> lock(queues[queueID]->mutex);
+		queues[queueID]->jobs.push_back({std::move(job), group});
+	}
+	++queuedJobs;
+	
+	// lock and unlock wakeUpMutex to avoid missing wake up by worker between check queuedJobs and sleep
+	{ std::lock_guard<std::mutex> lock(wakeUpMutex); }
+	wakeUpCondition.notify_one();
+}
+
+void MGE::JobSystem::wait(JobsGroup* group) {
+	unsigned int queueID = currentWorkerID >= 0 ? currentWorkerID : 0;
+	
+	while (group->pendingJobs.load() > 0) {
+		if (queues.empty() || !runOneJob(queueID)) {
+			std::this_thread::yield();
+		}
+	}
+	
+	if (group->exception) {
+		std::exception_ptr exception;
+		std::swap(exception, group->exception);
+		std::rethrow_exception(exception);
+	}
+}
+
+bool MGE::JobSystem::runOneJob(unsigned int queueID) {
+	Job job;
+	bool haveJob = false;
+	
+	// try get job from back of own queue
+	{
+		auto& queue = *queues[queueID];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+			haveJob = true;
+		}
+	}
+	
+	// try steal job from front of other queues
+	for (unsigned int i=1; !haveJob && i<queues.size(); ++i) {
+		auto& queue = *queues[(queueID + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			haveJob = true;
+		}
+	}
+	
+	if (!haveJob)
+		return false;
+	
+	--queuedJobs;
+	execute(job);
+	return true;
+}
+
+void MGE::JobSystem::execute(Job& job) {
+	try {
+		job.function();
+	} catch(...) {
+		std::lock_guard<std::mutex> lock(job.group->exceptionMutex);
+		if (!job.group->exception)
+			job.group->exception = std::current_exception();
+	}
+	--(job.group->pendingJobs);
+}
+
+void MGE::JobSystem::workerLoop(unsigned int workerID) {
+	currentWorkerID = workerID;
+	
+	while (true) {
+		if (runOneJob(workerID))
+			continue;
+		
+		std::unique_lock<std::mutex> lock(wakeUpMutex);
+		wakeUpCondition.wait(lock, [this]{ return stopWorkers.load() || queuedJobs.load() > 0; });
+		if (stopWorkers)
+			return;
+	}
+}
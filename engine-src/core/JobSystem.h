@@ -0,0 +1,181 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma   once
+
+#include "BaseClasses.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MGE {
+
+/// @addtogroup JobSystem
+/// @{
+/// @file
+
+/**
+ * @brief Work-stealing job system – pool of worker threads executing short tasks (jobs).
+ * 
+ * Each worker thread has own jobs queue. Worker takes jobs from back of own queue (LIFO)
+ * and when own queue is empty steal jobs from front of other workers queues (FIFO).
+ * Thread waiting for jobs group (see @ref wait) do not sleep, but help with executing queued jobs.
+ * 
+ * \par Example
+	\code{.cpp}
+		MGE::JobSystem::JobsGroup group;
+		for (auto& obj : objects) {
+			MGE::JobSystem::getPtr()->run([&obj]{ obj.process(); }, &group);
+		}
+		MGE::JobSystem::getPtr()->wait(&group); // barrier – return after finish all jobs from group
+	\endcode
+ * 
+ * @remark
+ *    Singleton, created by @ref MGE::Engine (number of worker threads is read from main config).
+ */
+class JobSystem : public MGE::Singleton<JobSystem> {
+public:
+	/// Type of job function.
+	typedef std::function<void()> JobFunction;
+	
+	/**
+	 * @brief Group of jobs – used as barrier (see @ref wait) and for pass exceptions from jobs to waiting thread.
+	 */
+	struct JobsGroup {
+		/// Constructor.
+		JobsGroup() : pendingJobs(0) {}
+		
+	protected:
+		friend class JobSystem;
+		
+		/// number of submitted and not finished jobs
+		std::atomic<int> pendingJobs;
+		
+		/// first exception thrown by job from this group
+		std::exception_ptr exception;
+		
+		/// mutex for @ref exception
+		std::mutex exceptionMutex;
+	};
+	
+	/**
+	 * @brief Constructor – create worker threads.
+	 * 
+	 * @param workersCount  Number of worker threads. When negative use ``std::thread::hardware_concurrency() - 1``.
+	 *                      When zero all jobs will be executed synchronously in @ref run.
+	 */
+	JobSystem(int workersCount = -1);
+	
+	/**
+	 * @brief Destructor – stop and join worker threads.
+	 * 
+	 * @note Jobs remaining in queues are dropped, so all groups should be waited before destroy job system.
+	 */
+	~JobSystem();
+	
+	/**
+	 * @brief Submit job for execution.
+	 * 
+	 * @param job    Function to execute.
+	 * @param group  Jobs group to which job is added (must exist until @ref wait return).
+	 */
+	void run(JobFunction&& job, JobsGroup* group);
+	
+	/**
+	 * @brief Wait for finish all jobs from @a group. Calling thread help executing queued jobs while waiting.
+	 * 
+	 * @param group  Jobs group to wait for.
+	 * 
+	 * @note When some job from @a group thrown exception, then (after finish all jobs from @a group) rethrow first of them.
+	 */
+	void wait(JobsGroup* group);
+	
+	/**
+	 * @brief Return number of worker threads.
+	 */
+	FORCE_INLINE unsigned int getWorkersCount() const {
+		return workers.size();
+	}
+	
+protected:
+	/// single queued job
+	struct Job {
+		/// function to execute
+		JobFunction function;
+		
+		/// group of this job
+		JobsGroup*  group;
+	};
+	
+	/// per worker jobs queue
+	struct JobsQueue {
+		/// queue
+		std::deque<Job> jobs;
+		
+		/// mutex for @ref jobs
+		std::mutex      mutex;
+	};
+	
+	/// worker threads main function
+	void workerLoop(unsigned int workerID);
+	
+	/// get (pop from own queue or steal from other queue) and execute single job, return false when no jobs to do
+	bool runOneJob(unsigned int queueID);
+	
+	/// execute @a job and update its group
+	static void execute(Job& job);
+	
+	/// jobs queues (one for each worker)
+	std::vector<std::unique_ptr<JobsQueue>> queues;
+	
+	/// worker threads
+	std::vector<std::thread> workers;
+	
+	/// number of jobs in all queues (used to wake up sleeping workers)
+	std::atomic<int> queuedJobs;
+	
+	/// counter used to select queue for jobs submitted by non worker threads
+	std::atomic<unsigned int> nextQueue;
+	
+	/// when true workers should exit
+	std::atomic<bool> stopWorkers;
+	
+	/// mutex for @ref wakeUpCondition
+	std::mutex wakeUpMutex;
+	
+	/// condition variable used to wake up sleeping workers
+	std::condition_variable wakeUpCondition;
+	
+	/// worker id of current thread (-1 for non worker threads)
+	static thread_local int currentWorkerID;
+};
+
+/// @}
+
+}
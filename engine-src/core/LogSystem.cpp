@@ -31,103 +31,452 @@ SOFTWARE.
 
 #include <iostream>
 #include <iomanip>
+#include <unordered_map>
 
-int MGE::Log::LogStreamBuf::sync() {
-	const auto& str = this->str();
-	const auto  len = str.size();
-	
-	if (! len)
+/* ***********     per thread line assembly     ********** */
+
+int MGE::Log::ThreadBuf::overflow(int c) {
+	if (c != traits_type::eof())
+		line.push_back(static_cast<char>(c));
+	return c;
+}
+
+std::streamsize MGE::Log::ThreadBuf::xsputn(const char* s, std::streamsize n) {
+	line.append(s, n);
+	return n;
+}
+
+int MGE::Log::ThreadBuf::sync() {
+	if (line.empty())
 		return 0;
 	
-	std::string time;
-	if (onLineBegin && addTimeStamp) {
-		std::ostringstream ss;
-		ss << std::fixed << std::setprecision(6) << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - initTime).count() / 1000000.0 << " ";
-		time = ss.str();
+	if (owner->asyncMode.load(std::memory_order_relaxed)) {
+		// in asynchronous mode pass only complete lines, rest of text wait (in this thread buffer) for end of line
+		size_t pos = line.find_last_of('\n');
+		if (pos == std::string::npos) {
+			onLineBegin = false;
+			return 0;
+		}
+		if (++pos == line.size()) {
+			owner->submit(std::move(line), onLineBegin);
+			line.clear();
+		} else {
+			owner->submit(line.substr(0, pos), onLineBegin);
+			line.erase(0, pos);
+		}
+		onLineBegin = line.empty();
+	} else {
+		bool endOfLine = (line.back() == '\n');
+		owner->submit(std::move(line), onLineBegin);
+		line.clear();
+		onLineBegin = endOfLine;
 	}
+	return 0;
+}
+
+int MGE::Log::LogStreamBuf::overflow(int c) {
+	return owner->getThreadBuf().overflow(c);
+}
+
+std::streamsize MGE::Log::LogStreamBuf::xsputn(const char* s, std::streamsize n) {
+	return owner->getThreadBuf().xsputn(s, n);
+}
+
+int MGE::Log::LogStreamBuf::sync() {
+	return owner->getThreadBuf().sync();
+}
+
+MGE::Log::ThreadBuf& MGE::Log::getThreadBuf() {
+	thread_local std::unordered_map<uint64_t, std::unique_ptr<ThreadBuf>> threadBufs;
+	thread_local uint64_t  lastLogID = 0;
+	thread_local ThreadBuf* lastThreadBuf = nullptr;
 	
+	if (lastLogID != logID) {
+		auto& threadBuf = threadBufs[logID];
+		if (!threadBuf)
+			threadBuf.reset(new ThreadBuf(this));
+		lastLogID     = logID;
+		lastThreadBuf = threadBuf.get();
+	}
+	return *lastThreadBuf;
+}
+
+
+/* ***********     writing and queuing     ********** */
+
+void MGE::Log::writeOutput(const std::chrono::steady_clock::time_point& time, const std::string& text, bool onLineBegin) {
+	std::ostream* fileOutput = nullptr;
 	if (logToFile) {
 		if (logFileStream.is_open())
-			logFileStream << time << str << std::flush;
+			fileOutput = &logFileStream;
 		else
-			tmpBuf << time << str << std::flush;
+			fileOutput = &tmpBuf;
 	}
 	
-	if (logToStdErr) {
-		std::cerr << time << str << std::flush;
+	if (!addTimeStamp) {
+		if (fileOutput)
+			*fileOutput << text;
+		if (logToStdErr)
+			std::cerr << text;
+		return;
 	}
 	
-	onLineBegin = (str[len-1] == '\n');
-	this->str("");
-	return 0;
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(6) << std::chrono::duration_cast<std::chrono::microseconds>(time - initTime).count() / 1000000.0 << " ";
+	const std::string timeStr = ss.str();
+	
+	// text can contain multiple lines (e.g. all complete lines from single flush), so add time stamp at begin of each line
+	std::string_view textView(text);
+	size_t begin = 0;
+	while (begin < textView.size()) {
+		size_t end = textView.find('\n', begin);
+		end = (end == std::string_view::npos) ? textView.size() : end + 1;
+		std::string_view line = textView.substr(begin, end - begin);
+		bool addTime = (begin > 0 || onLineBegin);
+		
+		if (fileOutput) {
+			if (addTime)
+				*fileOutput << timeStr;
+			*fileOutput << line;
+		}
+		if (logToStdErr) {
+			if (addTime)
+				std::cerr << timeStr;
+			std::cerr << line;
+		}
+		begin = end;
+	}
 }
 
-MGE::Log::Log(const std::string_view& filename, bool useFile, bool useStdErr, bool addTimeStamp) :
-	std::ostream(&logStreamBuffer)
-{
-	logStreamBuffer.initTime = std::chrono::steady_clock::now();
-	logStreamBuffer.onLineBegin = true;
+void MGE::Log::submit(std::string&& text, bool onLineBegin) {
+	auto now = std::chrono::steady_clock::now();
+	
+	if (!asyncMode.load(std::memory_order_acquire)) {
+		std::lock_guard<std::mutex> lock(outputMutex);
+		writeQueued(); // messages queued before switching to synchronous mode
+		writeOutput(now, text, onLineBegin);
+		logFileStream.flush();
+		std::cerr.flush();
+		return;
+	}
+	
+	// lock-free multi-producer enqueue (bounded MPMC queue algorithm by Dmitry Vyukov)
+	LogEntry* entry;
+	size_t pos = enqueuePos.load(std::memory_order_relaxed);
+	while (true) {
+		entry = &queue[pos & queueMask];
+		size_t seq = entry->sequence.load(std::memory_order_acquire);
+		intptr_t diff = static_cast<intptr_t>(seq - pos); // unsigned (wraparound) difference, next interpreted as signed
+		if (diff == 0) {
+			if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		} else if (diff < 0) {
+			// queue is full – wake up writer and wait for free space
+			writerCondition.notify_one();
+			std::this_thread::yield();
+			pos = enqueuePos.load(std::memory_order_relaxed);
+		} else {
+			pos = enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+	entry->time = now;
+	entry->text = std::move(text);
+	entry->onLineBegin = onLineBegin;
+	entry->sequence.store(pos + 1); // seq_cst (not only release) – pair with writerSleeping operations to avoid lost wake up
+	
+	if (writerSleeping.load()) {
+		std::lock_guard<std::mutex> lock(writerMutex);
+		writerCondition.notify_one();
+	}
+}
+
+int MGE::Log::writeQueued() {
+	if (!queue)
+		return 0;
+	
+	int count = 0;
+	size_t pos = dequeuePos.load(std::memory_order_relaxed);
+	while (true) {
+		LogEntry& entry = queue[pos & queueMask];
+		size_t seq = entry.sequence.load(std::memory_order_acquire);
+		if (seq != pos + 1) // single consumer, so entry is ready only when its sequence is pos + 1
+			break;
+		
+		writeOutput(entry.time, entry.text, entry.onLineBegin);
+		entry.text.clear();
+		entry.sequence.store(pos + queueMask + 1, std::memory_order_release);
+		dequeuePos.store(++pos, std::memory_order_release);
+		++count;
+	}
+	return count;
+}
+
+void MGE::Log::writerLoop() {
+	while (true) {
+		{
+			std::lock_guard<std::mutex> lock(outputMutex);
+			if (writeQueued()) {
+				logFileStream.flush();
+				std::cerr.flush();
+			}
+		}
+		
+		if (stopWriter.load())
+			break;
+		
+		std::unique_lock<std::mutex> lock(writerMutex);
+		writerSleeping.store(true);
+		writerCondition.wait_for(lock, std::chrono::milliseconds(100), [this] {
+			size_t pos = dequeuePos.load(std::memory_order_acquire);
+			return stopWriter.load() || queue[pos & queueMask].sequence.load() == pos + 1;
+		});
+		writerSleeping.store(false, std::memory_order_relaxed);
+	}
+	
+	// write messages queued while stopping
+	std::lock_guard<std::mutex> lock(outputMutex);
+	writeQueued();
+	logFileStream.flush();
+	std::cerr.flush();
+}
+
+void MGE::Log::setAsyncMode(bool enabled, unsigned int queueSize) {
+	if (enabled == asyncMode.load())
+		return;
+	
+	if (enabled) {
+		size_t size = 2;
+		while (size < queueSize)
+			size <<= 1;
+		
+		{
+			std::lock_guard<std::mutex> lock(outputMutex);
+			writeQueued();
+			queue.reset(new LogEntry[size]);
+			queueMask = size - 1;
+			for (size_t i = 0; i < size; ++i)
+				queue[i].sequence.store(i, std::memory_order_relaxed);
+			enqueuePos.store(0, std::memory_order_relaxed);
+			dequeuePos.store(0, std::memory_order_relaxed);
+		}
+		
+		stopWriter = false;
+		writerThread = std::thread(&MGE::Log::writerLoop, this);
+		asyncMode.store(true, std::memory_order_release);
+	} else {
+		asyncMode.store(false, std::memory_order_release);
+		
+		{
+			std::lock_guard<std::mutex> lock(writerMutex);
+			stopWriter = true;
+		}
+		writerCondition.notify_one();
+		
+		if (writerThread.get_id() == std::this_thread::get_id()) {
+			// e.g. crash handler called from writer thread
+			writerThread.detach();
+		} else if (writerThread.joinable()) {
+			writerThread.join();
+		}
+	}
+}
+
+void MGE::Log::waitForWrite() {
+	getThreadBuf().pubsync();
 	
-	logStreamBuffer.logToFile    = useFile;
-	logStreamBuffer.logFilePath  = filename;
-	logStreamBuffer.logToStdErr  = useStdErr;
-	logStreamBuffer.addTimeStamp = addTimeStamp;
+	if (!asyncMode.load())
+		return;
 	
-	if (! logStreamBuffer.logFilePath.empty()) {
-		logStreamBuffer.logFileStream.open( logStreamBuffer.logFilePath.c_str() );
+	// wait until all messages enqueued before this call are written, positions only increase so use unsigned (wraparound)
+	// difference – it's not greater than queue size until dequeuePos reach pos, and wraps to huge value after pass it
+	size_t pos = enqueuePos.load();
+	while (true) {
+		size_t pending = pos - dequeuePos.load();
+		if (pending == 0 || pending > queueMask + 1)
+			break;
+		writerCondition.notify_one();
+		std::this_thread::yield();
+	}
+}
+
+void MGE::Log::flushOnCrash() {
+	if (!asyncMode.load())
+		return;
+	
+	asyncMode.store(false, std::memory_order_release);
+	stopWriter = true; // without writerMutex (can be locked by crashed thread) – writer wait with timeout, so will not sleep forever
+	writerCondition.notify_one();
+	
+	bool onWriterThread = writerThread.get_id() == std::this_thread::get_id();
+	if (writerThread.joinable())
+		writerThread.detach();
+	
+	// writer thread could crash while holding outputMutex
+	if (onWriterThread)
+		return;
+	
+	// output can be locked by other (crashed) thread, so don't wait for it forever
+	std::unique_lock<std::mutex> lock(outputMutex, std::try_to_lock);
+	for (int i = 0; !lock.owns_lock() && i < 100; ++i) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		lock.try_lock();
+	}
+	if (lock.owns_lock()) {
+		writeQueued();
+		logFileStream.flush();
+		std::cerr.flush();
+	}
+}
+
+
+/* ***********     init and deinit     ********** */
+
+namespace {
+	std::atomic<uint64_t> nextLogID(1);
+}
+
+MGE::Log::Log(const std::string_view& filename, bool useFile, bool useStdErr, bool addTimeStamp_) :
+	std::ostream(&logStreamBuffer),
+	logStreamBuffer(this),
+	logID(nextLogID++),
+	initTime(std::chrono::steady_clock::now()),
+	logFilePath(filename),
+	logToFile(useFile),
+	logToStdErr(useStdErr),
+	addTimeStamp(addTimeStamp_),
+	globalLevel(Debug),
+	maxLevel(Debug),
+	hasCategoriesLevels(false),
+	asyncMode(false),
+	queueMask(0),
+	enqueuePos(0),
+	dequeuePos(0),
+	stopWriter(false),
+	writerSleeping(false)
+{
+	if (! logFilePath.empty()) {
+		logFileStream.open( logFilePath.c_str() );
 	}
 }
 
 void MGE::Log::setFile(const std::string_view& filename) {
-	logStreamBuffer.logFileStream.close();
-	logStreamBuffer.logToFile = true;
-	logStreamBuffer.logFilePath = filename;
-	logStreamBuffer.logFileStream.open( logStreamBuffer.logFilePath.c_str() );
-	logStreamBuffer.logFileStream << logStreamBuffer.tmpBuf.str() << std::flush;
-	logStreamBuffer.tmpBuf.str("");
+	std::lock_guard<std::mutex> lock(outputMutex);
+	logFileStream.close();
+	logToFile = true;
+	logFilePath = filename;
+	logFileStream.open( logFilePath.c_str() );
+	logFileStream << tmpBuf.str() << std::flush;
+	tmpBuf.str("");
 }
 
 MGE::Log::~Log() {
-	logStreamBuffer.logFileStream.close();
+	getThreadBuf().pubsync();
+	setAsyncMode(false);
+	{
+		std::lock_guard<std::mutex> lock(outputMutex);
+		writeQueued();
+	}
+	logFileStream.close();
+}
+
+
+/* ***********     log level filtering     ********** */
+
+MGE::Log::LogLevel MGE::Log::stringToLogLevel(const std::string_view& s, LogLevel def) {
+	if (s == "Error")        return Error;
+	else if (s == "Warning") return Warning;
+	else if (s == "Info")    return Info;
+	else if (s == "Verbose") return Verbose;
+	else if (s == "Debug")   return Debug;
+	return def;
+}
+
+void MGE::Log::setLevel(LogLevel level) {
+	std::unique_lock<std::shared_mutex> lock(categoriesMutex);
+	globalLevel = level;
 	
+	LogLevel newMaxLevel = level;
+	for (auto& iter : categoriesLevels) {
+		if (iter.second > newMaxLevel)
+			newMaxLevel = iter.second;
+	}
+	maxLevel = newMaxLevel;
+}
+
+void MGE::Log::setCategoryLevel(const std::string_view& moduleName, LogLevel level) {
+	{
+		std::unique_lock<std::shared_mutex> lock(categoriesMutex);
+		categoriesLevels[std::string(moduleName)] = level;
+		hasCategoriesLevels = true;
+	}
+	setLevel(getLevel());
+}
+
+void MGE::Log::resetCategoryLevel(const std::string_view& moduleName) {
+	{
+		std::unique_lock<std::shared_mutex> lock(categoriesMutex);
+		auto iter = categoriesLevels.find(moduleName);
+		if (iter != categoriesLevels.end())
+			categoriesLevels.erase(iter);
+		hasCategoriesLevels = !categoriesLevels.empty();
+	}
+	setLevel(getLevel());
+}
+
+MGE::Log::LogLevel MGE::Log::getCategoryLevel(const std::string_view& moduleName) const {
+	std::shared_lock<std::shared_mutex> lock(categoriesMutex);
+	auto iter = categoriesLevels.find(moduleName);
+	if (iter != categoriesLevels.end())
+		return iter->second;
+	return globalLevel.load(std::memory_order_relaxed);
 }
 
 
-MGE::Log& MGE::Log::logLevel(LogLevel level, const std::string_view& moduleName) {
-	logStreamBuffer.sync();
+/* ***********     formatted logging     ********** */
+
+std::ostream& MGE::Log::logLevel(LogLevel level, const std::string_view& moduleName) {
+	ThreadBuf& threadBuf = getThreadBuf();
+	threadBuf.pubsync();
 	
-	if (logStreamBuffer.onLineBegin) {
+	if (threadBuf.onLineBegin) {
 		switch(level) {
 			case Error:
-				*this << "ERROR: ";
+				threadBuf.stream << "ERROR: ";
 				break;
 			case Warning:
-				*this << "WARNING: ";
+				threadBuf.stream << "WARNING: ";
 				break;
 			case Debug:
-				*this << "DEBUG: ";
+				threadBuf.stream << "DEBUG: ";
 				break;
 			default:
 				break;
 		}
 		
 		if (moduleName.size()) {
-			*this << "[" << moduleName << "] ";
+			threadBuf.stream << "[" << moduleName << "] ";
 		}
 	}
 	
-	return* this;
+	return threadBuf.stream;
 }
 
 void MGE::Log::logHeader(const std::string_view& text) {
+	if (!isEnabled(Info))
+		return;
+	
+	std::ostream& stream = getThreadBuf().stream;
 	int len = MGE::UTF8::getCharsLen(text) + 12;
-	*this << std::endl;
-	*this << std::string(len, '+') << std::endl;
-	*this << "++++  " << text << "  ++++" << std::endl;
-	*this << std::string(len, '+') << std::endl;
+	stream << std::endl;
+	stream << std::string(len, '+') << "\n";
+	stream << "++++  " << text << "  ++++" << "\n";
+	stream << std::string(len, '+') << std::endl;
 }
 
 void MGE::Log::logMultiLine(const std::string_view& text, LogLevel level, const std::string_view& moduleName) {
+	if (!isEnabled(level, moduleName))
+		return;
+	
 	size_t pos = 0;
 	const size_t size = text.size();
 	while (pos < size) {
@@ -25,6 +25,13 @@ SOFTWARE.
 #include <fstream>
 #include <sstream>
 #include <chrono>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
 
 #include "StringTypedefs.h"
 
@@ -41,6 +48,13 @@ namespace MGE {
  * When do that remember to add @c std::endl or @c std::flush to real write to log
  * (log system don't add new line by itself, but macros LOG_*() add new line at end of log message).
  * 
+ * Log is thread safe: each thread assembles lines in own buffer (see @ref logLevel), so messages from different threads
+ * are not mixed inside single line. In asynchronous mode (see @ref setAsyncMode) complete lines are passed via lock-free
+ * multi-producer ring buffer to background writer thread, so logging do not wait for file and stderr writes.
+ * 
+ * Messages can be filtered at runtime by level – globally (see @ref setLevel) and per module name / category (see @ref setCategoryLevel).
+ * LOG_*() macros check @ref isEnabled before evaluate message expression.
+ * 
  * @see
  *   - @ref LOG and other <b>LOG_*</b> macros (defined in @ref logSystem.h) documentation.
  */
@@ -62,6 +76,11 @@ public:
 		Debug
 	};
 	
+	/**
+	 * @brief Convert string notation of log level (e.g. "Info", "Debug") to @ref LogLevel, return @a def when @a s is not valid level name.
+	 */
+	static LogLevel stringToLogLevel(const std::string_view& s, LogLevel def = Debug);
+	
 	/**
 	 * @brief Constructor - create log system (open log file for writing, etc).
 	 * 
@@ -73,21 +92,95 @@ public:
 	 * @remark
 	 *       - when both @a useFile and @a useStdErr are true log to file and stderr
 	 *       - when @a useFile is true, but @a filename is empty wait
+	 *       - log is created in synchronous mode, use @ref setAsyncMode to enable background writer thread
 	 */
 	Log(const std::string_view& filename = MGE::EMPTY_STRING_VIEW, bool useFile = false, bool useStdErr = true, bool addTimeStamp = true);
 	
 	/**
-	 * @brief Destructor - close log.
+	 * @brief Destructor - write all queued messages and close log.
 	 */
 	virtual ~Log();
 	
 	/**
-	 * @brief Generate log verbosity level and module name prefix and log message from stream.
+	 * @brief Generate log verbosity level and module name prefix and return (per thread) stream for log message.
 	 * 
 	 * @param level       Level to use in prefix.
 	 * @param moduleName  Module name to use in prefix.
+	 * 
+	 * @note Returned stream is owned by calling thread, so message should be ended by @c std::endl in this same thread.
 	 */
-	Log& logLevel(LogLevel level = Info, const std::string_view& moduleName = MGE::EMPTY_STRING_VIEW);
+	std::ostream& logLevel(LogLevel level = Info, const std::string_view& moduleName = MGE::EMPTY_STRING_VIEW);
+	
+	/**
+	 * @brief Return true when messages with @a level from @a moduleName should be logged.
+	 * 
+	 * @param level       Level of message.
+	 * @param moduleName  Module name (category) of message.
+	 */
+	inline bool isEnabled(LogLevel level, const std::string_view& moduleName = MGE::EMPTY_STRING_VIEW) const {
+		if (level > maxLevel.load(std::memory_order_relaxed))
+			return false;
+		if (!hasCategoriesLevels.load(std::memory_order_relaxed))
+			return true;
+		return level <= getCategoryLevel(moduleName);
+	}
+	
+	/**
+	 * @brief Set global log level – messages with higher level (e.g. Debug when set to Info) will be skipped.
+	 */
+	void setLevel(LogLevel level);
+	
+	/**
+	 * @brief Return global log level.
+	 */
+	LogLevel getLevel() const {
+		return globalLevel.load(std::memory_order_relaxed);
+	}
+	
+	/**
+	 * @brief Set log level for module name (category), overriding global log level for messages from this module.
+	 */
+	void setCategoryLevel(const std::string_view& moduleName, LogLevel level);
+	
+	/**
+	 * @brief Remove log level for module name (category) set by @ref setCategoryLevel.
+	 */
+	void resetCategoryLevel(const std::string_view& moduleName);
+	
+	/**
+	 * @brief Return log level for module name (category) – level set by @ref setCategoryLevel or global log level.
+	 */
+	LogLevel getCategoryLevel(const std::string_view& moduleName) const;
+	
+	/**
+	 * @brief Enable or disable asynchronous mode (background writer thread).
+	 * 
+	 * @param enabled    When true log messages are queued and written by background thread,
+	 *                   when false all queued messages are written and log back to synchronous write mode.
+	 * @param queueSize  Size (number of lines, will be round up to power of two) of messages queue, used only on enabling.
+	 *                   When queue is full logging thread wait for free space.
+	 */
+	void setAsyncMode(bool enabled, unsigned int queueSize = 4096);
+	
+	/**
+	 * @brief Switch to synchronous mode without waiting for background writer thread (for use in crash handler).
+	 * 
+	 * Writer thread is detached (not joined) and messages queued so far are written by calling thread,
+	 * but only when output is not locked by other (e.g. crashed) thread for too long.
+	 */
+	void flushOnCrash();
+	
+	/**
+	 * @brief Return true when asynchronous mode is enabled.
+	 */
+	bool isAsyncMode() const {
+		return asyncMode.load(std::memory_order_relaxed);
+	}
+	
+	/**
+	 * @brief Wait for write all (complete lines) messages queued before this call.
+	 */
+	void waitForWrite();
 	
 	/**
 	 * @brief Write @a text to log as header.
@@ -117,64 +210,183 @@ public:
 	 * 
 	 * @param val       When true log to file and stderr.
 	 */
-	void setUseFile(bool val) {logStreamBuffer.logToFile = val;}
+	void setUseFile(bool val) {logToFile = val;}
 	
 	/**
 	 * @brief Change (set) use stderr logger option
 	 * 
 	 * @param val       When true log to file and stderr.
 	 */
-	void setUseStdErr(bool val) {logStreamBuffer.logToStdErr = val;}
+	void setUseStdErr(bool val) {logToStdErr = val;}
 	
 	/**
 	 * @brief Change (set) time prefixed option.
 	 * 
 	 * @param val       When true log will be prefixed timestamp (seconds from start log).
 	 */
-	void setAddTimeStamp(bool val) {logStreamBuffer.addTimeStamp = val;}
+	void setAddTimeStamp(bool val) {addTimeStamp = val;}
 	
 	/**
 	 * @brief Return path to file used by this log
 	 */
-	const std::string& getLogFilePath() {return logStreamBuffer.logFilePath;}
+	const std::string& getLogFilePath() {return logFilePath;}
 	
 private:
 	/**
-	 * @brief String stream implementation for log object, derived from std::stringbuf.
-	 * 
-	 * @remarks we need this to use << operators for write to log
+	 * @brief Per thread line buffer and output stream.
 	 */
-	struct LogStreamBuf : public std::stringbuf {
-		/// function used to write buffer data to file or stderr
+	struct ThreadBuf : public std::streambuf {
+		/// constructor
+		ThreadBuf(Log* _owner) : owner(_owner), stream(this), onLineBegin(true) {}
+		
+		/// append single char to @ref line
+		virtual int overflow(int c) override;
+		
+		/// append chars to @ref line
+		virtual std::streamsize xsputn(const char* s, std::streamsize n) override;
+		
+		/// pass complete lines (all text in synchronous mode) to log
 		virtual int sync() override;
 		
-		/// time of creation log system
-		std::chrono::time_point<std::chrono::steady_clock> initTime;
+		/// log object
+		Log* owner;
 		
-		/// path to file for writing log
-		std::string logFilePath;
+		/// buffer for current (not completed) line
+		std::string line;
 		
-		/// file output stream for writing log
-		std::ofstream logFileStream;
+		/// output stream using this buffer
+		std::ostream stream;
 		
-		/// temporary buffer to store log when wait to file
-		std::ostringstream tmpBuf;
+		/// when true we are on beginning of new line
+		bool onLineBegin;
+	};
+	
+	/**
+	 * @brief Stream buffer for direct use of log object as output stream (``logObject << ...``), redirect data to @ref ThreadBuf of calling thread.
+	 */
+	struct LogStreamBuf : public std::streambuf {
+		/// constructor
+		LogStreamBuf(Log* _owner) : owner(_owner) {}
 		
-		/// true when write log to file
-		bool logToFile;
+		/// @copydoc ThreadBuf::overflow
+		virtual int overflow(int c) override;
 		
-		/// true when write log to stderr
-		bool logToStdErr;
+		/// @copydoc ThreadBuf::xsputn
+		virtual std::streamsize xsputn(const char* s, std::streamsize n) override;
 		
-		/// when true write time info to log (seconds from start log)
-		bool addTimeStamp;
+		/// @copydoc ThreadBuf::sync
+		virtual int sync() override;
 		
-		/// when true we are on beginning of new line
+		/// log object
+		Log* owner;
+	};
+	
+	/**
+	 * @brief Single entry of messages queue.
+	 */
+	struct LogEntry {
+		/// sequence number used to synchronise producers and consumer
+		std::atomic<size_t> sequence;
+		
+		/// time of message
+		std::chrono::steady_clock::time_point time;
+		
+		/// message text (one or more complete lines)
+		std::string text;
+		
+		/// true when @a text starts at begin of line
 		bool onLineBegin;
 	};
 	
-	/// log stream buffer and std::ostream used to receive stream data
+	/// return @ref ThreadBuf for calling thread
+	ThreadBuf& getThreadBuf();
+	
+	/// write (synchronous mode) or queue (asynchronous mode) @a text
+	void submit(std::string&& text, bool onLineBegin);
+	
+	/// write @a text to file and/or stderr, add time stamp at each line begin (must be called with @ref outputMutex locked)
+	void writeOutput(const std::chrono::steady_clock::time_point& time, const std::string& text, bool onLineBegin);
+	
+	/// write all messages from queue (must be called with @ref outputMutex locked), return number of written messages
+	int writeQueued();
+	
+	/// background writer thread main function
+	void writerLoop();
+	
+	/// stream buffer used by this object as std::ostream
 	LogStreamBuf logStreamBuffer;
+	
+	/// unique id of this log object (used to identify per thread buffers)
+	const uint64_t logID;
+	
+	/// time of creation log system
+	std::chrono::time_point<std::chrono::steady_clock> initTime;
+	
+	/// path to file for writing log
+	std::string logFilePath;
+	
+	/// file output stream for writing log
+	std::ofstream logFileStream;
+	
+	/// temporary buffer to store log when wait to file
+	std::ostringstream tmpBuf;
+	
+	/// true when write log to file
+	std::atomic<bool> logToFile;
+	
+	/// true when write log to stderr
+	std::atomic<bool> logToStdErr;
+	
+	/// when true write time info to log (seconds from start log)
+	std::atomic<bool> addTimeStamp;
+	
+	/// mutex for file and stderr output (and queue consuming)
+	std::mutex outputMutex;
+	
+	/// global log level
+	std::atomic<LogLevel> globalLevel;
+	
+	/// maximum of global and all categories levels (used for fast check in @ref isEnabled)
+	std::atomic<LogLevel> maxLevel;
+	
+	/// true when @ref categoriesLevels is not empty
+	std::atomic<bool> hasCategoriesLevels;
+	
+	/// per module name (category) log levels
+	std::map<std::string, LogLevel, std::less<>> categoriesLevels;
+	
+	/// mutex for @ref categoriesLevels
+	mutable std::shared_mutex categoriesMutex;
+	
+	/// true when asynchronous mode is enabled
+	std::atomic<bool> asyncMode;
+	
+	/// messages queue (ring buffer)
+	std::unique_ptr<LogEntry[]> queue;
+	
+	/// size of @ref queue minus one (size is power of two)
+	size_t queueMask;
+	
+	/// position for next enqueue operation
+	std::atomic<size_t> enqueuePos;
+	
+	/// position for next dequeue operation (modified only with @ref outputMutex locked)
+	std::atomic<size_t> dequeuePos;
+	
+	/// background writer thread
+	std::thread writerThread;
+	
+	/// when true writer thread should exit (after write all queued messages)
+	std::atomic<bool> stopWriter;
+	
+	/// true when writer thread wait for new messages
+	std::atomic<bool> writerSleeping;
+	
+	/// mutex for @ref writerCondition
+	std::mutex writerMutex;
+	
+	/// condition variable used to wake up writer thread
+	std::condition_variable writerCondition;
 };
 /// @}
 }
@@ -221,25 +433,25 @@ private:
 
 /// Write error message (@a msg) to log from module (@a mod). @{
 #define LOG_ERROR(...)           BOOST_PP_OVERLOAD(LOG_ERROR_, __VA_ARGS__)(__VA_ARGS__)
-#define LOG_ERROR_2(mod, msg)    MGE_LOG.logLevel( MGE::Log::Error, mod ) << msg << std::endl;
+#define LOG_ERROR_2(mod, msg)    void( MGE_LOG.isEnabled( MGE::Log::Error, mod ) && (MGE_LOG.logLevel( MGE::Log::Error, mod ) << msg << std::endl) );
 #define LOG_ERROR_1(msg)         LOG_ERROR_2(LOG_MODULE_NAME, msg)
 /// @}
 
 /// Write warning message (@a msg) to log from module (@a mod). @{
 #define LOG_WARNING(...)         BOOST_PP_OVERLOAD(LOG_WARNING_, __VA_ARGS__)(__VA_ARGS__)
-#define LOG_WARNING_2(mod, msg)  MGE_LOG.logLevel( MGE::Log::Warning, mod ) << msg << std::endl;
+#define LOG_WARNING_2(mod, msg)  void( MGE_LOG.isEnabled( MGE::Log::Warning, mod ) && (MGE_LOG.logLevel( MGE::Log::Warning, mod ) << msg << std::endl) );
 #define LOG_WARNING_1(msg)       LOG_WARNING_2(LOG_MODULE_NAME, msg)
 /// @}
 
 /// Write normal message (@a msg) to log from module (@a mod). @{
 #define LOG_INFO(...)            BOOST_PP_OVERLOAD(LOG_INFO_, __VA_ARGS__)(__VA_ARGS__)
-#define LOG_INFO_2(mod, msg)     MGE_LOG.logLevel( MGE::Log::Info, mod ) << msg << std::endl;
+#define LOG_INFO_2(mod, msg)     void( MGE_LOG.isEnabled( MGE::Log::Info, mod ) && (MGE_LOG.logLevel( MGE::Log::Info, mod ) << msg << std::endl) );
 #define LOG_INFO_1(msg)          LOG_INFO_2(LOG_MODULE_NAME, msg)
 /// @}
 
 /// Write verbose message (@a msg) to log from module (@a mod). @{
 #define LOG_VERBOSE(...)         BOOST_PP_OVERLOAD(LOG_VERBOSE_, __VA_ARGS__)(__VA_ARGS__)
-#define LOG_VERBOSE_2(mod, msg)  MGE_LOG.logLevel( MGE::Log::Verbose, mod ) << msg << std::endl;
+#define LOG_VERBOSE_2(mod, msg)  void( MGE_LOG.isEnabled( MGE::Log::Verbose, mod ) && (MGE_LOG.logLevel( MGE::Log::Verbose, mod ) << msg << std::endl) );
 #define LOG_VERBOSE_1(msg)       LOG_VERBOSE_2(LOG_MODULE_NAME, msg)
 /// @}
 
@@ -251,7 +463,7 @@ private:
 /// Write debug level 1 message (@a msg) to log from module (@a mod). @{
 #if not defined MGE_DEBUG_LEVEL or MGE_DEBUG_LEVEL > 0
 	#define LOG_DEBUG(...)        BOOST_PP_OVERLOAD(LOG_DEBUG_, __VA_ARGS__)(__VA_ARGS__)
-	#define LOG_DEBUG_2(mod, msg) MGE_LOG.logLevel( MGE::Log::Debug, mod ) << msg << std::endl;
+	#define LOG_DEBUG_2(mod, msg) void( MGE_LOG.isEnabled( MGE::Log::Debug, mod ) && (MGE_LOG.logLevel( MGE::Log::Debug, mod ) << msg << std::endl) );
 	#define LOG_DEBUG_1(msg)      LOG_DEBUG_2(LOG_MODULE_NAME, msg)
 #else
 	#define LOG_DEBUG(...)
@@ -260,7 +472,7 @@ private:
 
 /// Write debug level 1 message (@a msg) to log, adding file and line of use at end of the message.
 #if not defined MGE_DEBUG_LEVEL or MGE_DEBUG_LEVEL > 0
-	#define LOG_XDEBUG(msg)    MGE_LOG.logLevel( MGE::Log::Debug, "" ) << msg << std::noshowbase << std::dec << " at " <<  __FILE__ << ":" << __LINE__ << std::endl;
+	#define LOG_XDEBUG(msg)    void( MGE_LOG.isEnabled( MGE::Log::Debug ) && (MGE_LOG.logLevel( MGE::Log::Debug, "" ) << msg << std::noshowbase << std::dec << " at " <<  __FILE__ << ":" << __LINE__ << std::endl) );
 #else
 	#define LOG_XDEBUG(msg)    
 #endif
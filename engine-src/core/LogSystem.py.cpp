@@ -0,0 +1,66 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LogSystem.h"
+#include "ScriptsInterface.h"
+
+#ifndef __DOCUMENTATION_GENERATOR__
+MGE_SCRIPT_API_FOR_MODULE(LogSystem) {
+	py::class_<MGE::Log, std::unique_ptr<MGE::Log, py::nodelete>> log(
+		m, "Log", DOC(MGE, Log)
+	);
+	
+	py::enum_<MGE::Log::LogLevel>(log, "LogLevel", DOC(MGE, Log, LogLevel))
+		.value("Error",   MGE::Log::Error)
+		.value("Warning", MGE::Log::Warning)
+		.value("Info",    MGE::Log::Info)
+		.value("Verbose", MGE::Log::Verbose)
+		.value("Debug",   MGE::Log::Debug)
+	;
+	
+	log
+		.def("setLevel", &MGE::Log::setLevel,
+			DOC(MGE, Log, setLevel)
+		)
+		.def("getLevel", &MGE::Log::getLevel,
+			DOC(MGE, Log, getLevel)
+		)
+		.def("setCategoryLevel", &MGE::Log::setCategoryLevel,
+			DOC(MGE, Log, setCategoryLevel)
+		)
+		.def("resetCategoryLevel", &MGE::Log::resetCategoryLevel,
+			DOC(MGE, Log, resetCategoryLevel)
+		)
+		.def("getCategoryLevel", &MGE::Log::getCategoryLevel,
+			DOC(MGE, Log, getCategoryLevel)
+		)
+		.def("setAsyncMode", &MGE::Log::setAsyncMode,
+			DOC(MGE, Log, setAsyncMode),
+			py::arg("enabled"), py::arg("queueSize") = 4096
+		)
+		.def("isAsyncMode", &MGE::Log::isAsyncMode,
+			DOC(MGE, Log, isAsyncMode)
+		)
+		.def_static("get", []() { return MGE::defaultLog; }, py::return_value_policy::reference, "return default (engine) log object")
+	;
+}
+#endif
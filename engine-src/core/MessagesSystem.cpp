@@ -23,26 +23,136 @@ SOFTWARE.
 #include "MessagesSystem.h"
 #include "LogSystem.h"
 
-MGE::MessagesSystem::MessagesSystem() {
+#include <algorithm>
+#include <set>
+#include <unordered_map>
+
+MGE::MessagesSystem::MessagesSystem() :
+	dispatchTable(64),
+	typesCount(0),
+	sendingDepth(0),
+	hasPendingChanges(false),
+	queueHead(nullptr)
+{
 	LOG_INFO("Initialize Message System");
 }
 
-void MGE::MessagesSystem::sendMessage(const EventMsg* msg, const void* sender) const {
-	const std::string_view& msgTypeName = msg->getType();
+MGE::MessagesSystem::~MessagesSystem() {
+	QueuedMsg* node = queueHead.exchange(nullptr);
+	while (node) {
+		QueuedMsg* next = node->next;
+		delete node;
+		node = next;
+	}
+}
+
+void MGE::MessagesSystem::sendMessage(const EventMsg* msg, const void* sender) {
+	MsgTypeReceivers* msgType = findMsgType( msg->getTypeID(), msg->getType() );
+	if (!msgType) {
+		LOG_VERBOSE("MessagesSystem", "no receivers for: " << msg->getType());
+		return;
+	}
+	
+	// receivers vectors are not modified (only marked as removed) during sending, so references are valid in nested sendMessage() calls
+	SendingGuard guard(this);
 	
-	auto iter = receiversMap.find( msgTypeName );
-	if (iter != receiversMap.end()) {
-		for (auto& iter2 : iter->second) {
-			if (iter2.onlyFrom == NULL || iter2.onlyFrom == sender || sender == NULL) {
-				LOG_DEBUG("MessagesSystem", "send: " << msgTypeName << " from: " << sender << " to " << iter2.receiverID );
-				iter2.exec(msg, iter2.receiverID);
+	for (auto& receiver : msgType->receivers) {
+		if (receiver.removed)
+			continue;
+		if (receiver.onlyFrom == NULL || receiver.onlyFrom == sender || sender == NULL) {
+			LOG_DEBUG("MessagesSystem", "send: " << msgType->typeName << " from: " << sender << " to " << receiver.receiverID );
+			receiver.call(msg);
+		} else {
+			LOG_DEBUG("MessagesSystem", "skip: " << msgType->typeName << " from: " << sender << " to " << receiver.receiverID << " due to filter");
+		}
+	}
+}
+
+void MGE::MessagesSystem::postMessage(std::unique_ptr<const EventMsg>&& msg, const void* sender, bool coalesce) {
+	QueuedMsg* node = new QueuedMsg{std::move(msg), sender, coalesce, queueHead.load(std::memory_order_relaxed)};
+	while (!queueHead.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {}
+}
+
+size_t MGE::MessagesSystem::dispatchQueuedMessages() {
+	QueuedMsg* node = queueHead.exchange(nullptr, std::memory_order_acquire);
+	if (!node)
+		return 0;
+	
+	// queue is LIFO list, so get it in reverse order
+	// (local buffer, because receiver functions can call dispatchQueuedMessages() recursively)
+	std::vector<std::unique_ptr<QueuedMsg>> queue;
+	for (; node; node = node->next)
+		queue.emplace_back(node);
+	std::reverse(queue.begin(), queue.end());
+	
+	// coalesce – keep only the latest message for each (type, sender) pair (drop older)
+	// (types are compared by name, because type IDs can collide)
+	std::set<std::pair<std::string_view, const void*>> coalesced;
+	for (auto iter = queue.rbegin(); iter != queue.rend(); ++iter) {
+		if ((*iter)->coalesce && !coalesced.emplace((*iter)->msg->getType(), (*iter)->sender).second)
+			(*iter)->msg.reset();
+	}
+	
+	// group by message type (in order of first message of type, messages order inside group is preserved)
+	std::unordered_map<std::string_view, size_t> groupsIndex;
+	std::vector<std::pair<size_t, QueuedMsg*>> ordered;
+	ordered.reserve(queue.size());
+	for (auto& queued : queue) {
+		if (!queued->msg)
+			continue;
+		auto res = groupsIndex.emplace(queued->msg->getType(), groupsIndex.size());
+		ordered.emplace_back(res.first->second, queued.get());
+	}
+	std::stable_sort(ordered.begin(), ordered.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+	
+	std::vector<const EventMsg*> batch;
+	for (size_t begin = 0, end; begin < ordered.size(); begin = end) {
+		for (end = begin + 1; end < ordered.size() && ordered[end].first == ordered[begin].first; ++end) {}
+		
+		const EventMsg* firstMsg = ordered[begin].second->msg.get();
+		MsgTypeReceivers* msgType = findMsgType( firstMsg->getTypeID(), firstMsg->getType() );
+		if (!msgType) {
+			LOG_VERBOSE("MessagesSystem", "no receivers for: " << firstMsg->getType());
+			continue;
+		}
+		
+		SendingGuard guard(this);
+		for (auto& receiver : msgType->receivers) {
+			// collect messages passing receiver filter (sender == NULL pass all filters)
+			batch.clear();
+			for (size_t i = begin; i < end; ++i) {
+				const QueuedMsg* queued = ordered[i].second;
+				if (receiver.onlyFrom == NULL || queued->sender == NULL || receiver.onlyFrom == queued->sender)
+					batch.push_back(queued->msg.get());
+			}
+			if (batch.empty())
+				continue;
+			
+			LOG_DEBUG("MessagesSystem", "deliver " << batch.size() << " queued: " << msgType->typeName << " to " << receiver.receiverID);
+			if (receiver.execBatch) {
+				if (!receiver.removed)
+					receiver.execBatch(std::span<const EventMsg* const>(batch), receiver.receiverID);
 			} else {
-				LOG_DEBUG("MessagesSystem", "skip: " << msgTypeName << " from: " << sender << " to " << iter2.receiverID << " due to filter");
+				for (auto msg : batch) {
+					if (receiver.removed)
+						break;
+					receiver.exec(msg, receiver.receiverID);
+				}
 			}
 		}
-	} else {
-		LOG_VERBOSE("MessagesSystem", "no receivers for: " << msgTypeName);
 	}
+	
+	return ordered.size();
+}
+
+bool MGE::MessagesSystem::update(float gameTimeStep, float realTimeStep) {
+	dispatchQueuedMessages();
+	return true;
+}
+
+bool MGE::MessagesSystem::updateOnFullPause(float realTimeStep) {
+	dispatchQueuedMessages();
+	return true;
 }
 
 bool MGE::MessagesSystem::registerReceiver(
@@ -53,27 +163,41 @@ bool MGE::MessagesSystem::registerReceiver(
 	void* receivOnlyFrom
 ) {
 	LOG_VERBOSE("MessagesSystem", "register receiver for message type: " << messageTypeName << " for: " << regOwnerID << "/" << regOwnerSubID << " with filter: " << receivOnlyFrom);
+	return addReceiver(messageTypeName, ReceiverInfo(receiverFunction, regOwnerID, regOwnerSubID, receivOnlyFrom));
+}
+
+bool MGE::MessagesSystem::registerBatchReceiver(
+	const std::string_view& messageTypeName,
+	const MsgBatchReceiverFunction& receiverFunction,
+	void* regOwnerID,
+	void* regOwnerSubID,
+	void* receivOnlyFrom
+) {
+	LOG_VERBOSE("MessagesSystem", "register batch receiver for message type: " << messageTypeName << " for: " << regOwnerID << "/" << regOwnerSubID << " with filter: " << receivOnlyFrom);
+	return addReceiver(messageTypeName, ReceiverInfo(receiverFunction, regOwnerID, regOwnerSubID, receivOnlyFrom));
+}
+
+bool MGE::MessagesSystem::addReceiver(const std::string_view& messageTypeName, ReceiverInfo&& receiverInfo) {
+	if (sendingDepth == 0)
+		return insertReceiver(messageTypeName, std::move(receiverInfo));
 	
-	// create object for new registration
-	ReceiverInfo receiverInfo(receiverFunction, regOwnerID, regOwnerSubID, receivOnlyFrom);
-	
-	// find set of ReceiverInfo for used messageTypeName
-	auto receiversSetIter = receiversMap.find(messageTypeName);
-	if (receiversSetIter != receiversMap.end()) {
-		// check if is not already registered
-		if (receiversSetIter->second.find(receiverInfo) != receiversSetIter->second.end()) {
-			LOG_ERROR("MessagesSystem", "receiver for message type: " << messageTypeName << " for: " << regOwnerID << "/" << regOwnerSubID << " with filter: " << receivOnlyFrom << " already registered");
+	// during sending message receivers vectors can't be modified, so store registration for apply it after sending
+	MsgTypeReceivers* msgType = findMsgType( MGE::EventMsg::hashType(messageTypeName), messageTypeName );
+	if (msgType) {
+		auto iter = std::lower_bound(msgType->receivers.begin(), msgType->receivers.end(), receiverInfo);
+		if (iter != msgType->receivers.end() && *iter == receiverInfo && !iter->removed) {
+			LOG_ERROR("MessagesSystem", "receiver for message type: " << messageTypeName << " for: " << receiverInfo.receiverID << "/" << receiverInfo.receiverInternalID << " with filter: " << receiverInfo.onlyFrom << " already registered");
 			return false;
 		}
-		
-		// insert (move) receiverInfo to existed set
-		receiversSetIter->second.insert(std::move(receiverInfo));
-	} else {
-		LOG_INFO("MessagesSystem", "Register new message type: " << messageTypeName);
-		// create new set (for messageTypeName) and insert (move) receiverInfo into it
-		receiversMap.insert({std::string(messageTypeName), {std::move(receiverInfo)}});
 	}
-	
+	for (auto& pending : pendingReceivers) {
+		if (pending.first == messageTypeName && pending.second == receiverInfo) {
+			LOG_ERROR("MessagesSystem", "receiver for message type: " << messageTypeName << " for: " << receiverInfo.receiverID << "/" << receiverInfo.receiverInternalID << " with filter: " << receiverInfo.onlyFrom << " already registered");
+			return false;
+		}
+	}
+	pendingReceivers.emplace_back(std::string(messageTypeName), std::move(receiverInfo));
+	hasPendingChanges = true;
 	return true;
 }
 
@@ -84,23 +208,122 @@ void MGE::MessagesSystem::unregisterReceiver(
 	void* regOwnerSubID,
 	void* receivOnlyFrom
 ) {
-	auto receiversSetIter = receiversMap.find(messageTypeName);
-	if (receiversSetIter != receiversMap.end()) {
-		if (receiversSetIter->second.erase( ReceiverInfo(receiverFunction, regOwnerID, regOwnerSubID, receivOnlyFrom) ) == 0) {
-			LOG_WARNING("MessagesSystem", "try remove non registered receiver for message type: " << messageTypeName << " for: " << regOwnerID << "/" << regOwnerSubID << " with filter: " << receivOnlyFrom);
-		} else {
+	ReceiverInfo receiverInfo(receiverFunction, regOwnerID, regOwnerSubID, receivOnlyFrom);
+	
+	// registered during sending message and not yet applied
+	for (auto iter = pendingReceivers.begin(); iter != pendingReceivers.end(); ++iter) {
+		if (iter->first == messageTypeName && iter->second == receiverInfo) {
 			LOG_VERBOSE("MessagesSystem", "remove receiver for message type: " << messageTypeName << " for: " << regOwnerID << "/" << regOwnerSubID);
+			pendingReceivers.erase(iter);
+			return;
 		}
-	} else {
+	}
+	
+	MsgTypeReceivers* msgType = findMsgType( MGE::EventMsg::hashType(messageTypeName), messageTypeName );
+	if (!msgType) {
 		LOG_WARNING("MessagesSystem", "try remove receiver for non registered message type: " << messageTypeName << " for: " << regOwnerID << "/" << regOwnerSubID);
+		return;
+	}
+	
+	auto iter = std::lower_bound(msgType->receivers.begin(), msgType->receivers.end(), receiverInfo);
+	if (iter == msgType->receivers.end() || !(*iter == receiverInfo) || iter->removed) {
+		LOG_WARNING("MessagesSystem", "try remove non registered receiver for message type: " << messageTypeName << " for: " << regOwnerID << "/" << regOwnerSubID << " with filter: " << receivOnlyFrom);
+		return;
+	}
+	
+	LOG_VERBOSE("MessagesSystem", "remove receiver for message type: " << messageTypeName << " for: " << regOwnerID << "/" << regOwnerSubID);
+	if (sendingDepth == 0) {
+		msgType->receivers.erase(iter);
+	} else {
+		iter->removed = true;
+		msgType->hasRemoved = true;
+		hasPendingChanges = true;
 	}
 }
 
 void MGE::MessagesSystem::unregisterReceiver(void* regOwnerID, void* regOwnerSubID, bool ignoreOwnerSubID) {
-	for (auto receiversSet : receiversMap) {
-		for (auto iter = receiversSet.second.begin(); iter!=receiversSet.second.end(); ) { // don't use `for(auto& it : set)` because of using `set.erase(it)` in the loop
-			if (iter->receiverID == regOwnerID && (ignoreOwnerSubID || iter->receiverInternalID == regOwnerSubID))
-			receiversSet.second.erase(iter++);
+	auto isMatching = [regOwnerID, regOwnerSubID, ignoreOwnerSubID](const ReceiverInfo& receiver) {
+		return receiver.receiverID == regOwnerID && (ignoreOwnerSubID || receiver.receiverInternalID == regOwnerSubID);
+	};
+	
+	std::erase_if(pendingReceivers, [&isMatching](const auto& pending) { return isMatching(pending.second); });
+	
+	for (auto& msgType : dispatchTable) {
+		if (sendingDepth == 0) {
+			std::erase_if(msgType.receivers, isMatching);
+		} else {
+			for (auto& receiver : msgType.receivers) {
+				if (isMatching(receiver)) {
+					receiver.removed = true;
+					msgType.hasRemoved = true;
+					hasPendingChanges = true;
+				}
+			}
 		}
 	}
 }
+
+MGE::MessagesSystem::MsgTypeReceivers* MGE::MessagesSystem::getMsgType(const std::string_view& messageTypeName) {
+	uint32_t typeID = MGE::EventMsg::hashType(messageTypeName);
+	
+	MsgTypeReceivers* msgType = findMsgType(typeID, messageTypeName);
+	if (msgType)
+		return msgType;
+	
+	LOG_INFO("MessagesSystem", "Register new message type: " << messageTypeName);
+	
+	// keep load factor not greater than 1/2 (short probe sequences and always at least one free entry)
+	if (2 * (typesCount + 1) > dispatchTable.size()) {
+		std::vector<MsgTypeReceivers> oldTable(dispatchTable.size() * 2);
+		oldTable.swap(dispatchTable);
+		for (auto& entry : oldTable) {
+			if (entry.typeName.empty())
+				continue;
+			size_t mask = dispatchTable.size() - 1;
+			size_t i = entry.typeID & mask;
+			while (!dispatchTable[i].typeName.empty())
+				i = (i + 1) & mask;
+			dispatchTable[i] = std::move(entry);
+		}
+	}
+	
+	size_t mask = dispatchTable.size() - 1;
+	size_t i = typeID & mask;
+	while (!dispatchTable[i].typeName.empty())
+		i = (i + 1) & mask;
+	
+	++typesCount;
+	dispatchTable[i].typeID   = typeID;
+	dispatchTable[i].typeName = messageTypeName;
+	return &dispatchTable[i];
+}
+
+bool MGE::MessagesSystem::insertReceiver(const std::string_view& messageTypeName, ReceiverInfo&& receiverInfo) {
+	MsgTypeReceivers* msgType = getMsgType(messageTypeName);
+	if (!msgType)
+		return false;
+	
+	auto iter = std::lower_bound(msgType->receivers.begin(), msgType->receivers.end(), receiverInfo);
+	if (iter != msgType->receivers.end() && *iter == receiverInfo) {
+		LOG_ERROR("MessagesSystem", "receiver for message type: " << messageTypeName << " for: " << receiverInfo.receiverID << "/" << receiverInfo.receiverInternalID << " with filter: " << receiverInfo.onlyFrom << " already registered");
+		return false;
+	}
+	
+	msgType->receivers.insert(iter, std::move(receiverInfo));
+	return true;
+}
+
+void MGE::MessagesSystem::applyPendingChanges() {
+	for (auto& msgType : dispatchTable) {
+		if (msgType.hasRemoved) {
+			std::erase_if(msgType.receivers, [](const ReceiverInfo& receiver) { return receiver.removed; });
+			msgType.hasRemoved = false;
+		}
+	}
+	
+	for (auto& receiver : pendingReceivers) {
+		insertReceiver(receiver.first, std::move(receiver.second));
+	}
+	pendingReceivers.clear();
+	hasPendingChanges = false;
+}
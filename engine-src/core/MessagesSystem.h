@@ -23,13 +23,19 @@ SOFTWARE.
 #pragma   once
 
 #include "force_inline.h"
+#include "MainLoopListener.h"
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 
+#include <atomic>
+#include <concepts>
 #include <functional>
-#include <map>
-#include <set>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <vector>
 
 namespace MGE {
 
@@ -44,12 +50,20 @@ namespace MGE {
 	\code{.cpp}
 		struct MyMsg : MGE::EventMsg  {
 			/// message type string
-			inline static const std::string_view MsgType = "MyMsg"sv;
+			inline static constexpr std::string_view MsgType = "MyMsg"sv;
+			
+			/// message type ID
+			inline static constexpr uint32_t MsgTypeID = MGE::EventMsg::hashType(MsgType);
 			
 			/// @copydoc MGE::EventMsg::getType
 			const std::string_view getType() const override final {
 				return MsgType;
 			}
+			
+			/// @copydoc MGE::EventMsg::getTypeID
+			uint32_t getTypeID() const override final {
+				return MsgTypeID;
+			}
 		protected:
 			friend MGE::MyMsgSender;
 			MyMsg() {}
@@ -60,6 +74,25 @@ struct EventMsg {
 	/// return message type string
 	virtual const std::string_view getType() const = 0;
 	
+	/**
+	 * @brief return message type ID (hash of message type string, see @ref hashType)
+	 * 
+	 * @remark Default implementation calculate hash of @ref getType on each call,
+	 *         so message classes should override it to return value calculated at compile time.
+	 */
+	virtual uint32_t getTypeID() const {
+		return hashType(getType());
+	}
+	
+	/// return message type ID for message type string @a typeName (FNV-1a hash, can be evaluated at compile time)
+	static constexpr uint32_t hashType(const std::string_view& typeName) {
+		uint32_t hash = 2166136261u;
+		for (char c : typeName) {
+			hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+		}
+		return hash;
+	}
+	
 	/// destructor
 	virtual ~EventMsg() = default;
 };
@@ -67,8 +100,21 @@ struct EventMsg {
 /**
  * @brief Event message system.
  * 
+ * Receivers are stored in dispatch table indexed by message type ID (see @ref EventMsg::getTypeID),
+ * so sending message cost single table lookup and walk on vector of receivers of this message type.
+ * 
+ * Receivers can be registered and unregistered inside receiver function (during sending message),
+ * such changes are applied after finish sending all (nested) messages:
+ *   - receivers registered during sending do not receive currently sent messages
+ *   - receivers unregistered during sending do not receive any more messages (also currently sent)
+ * 
+ * Messages can be delivered synchronously (@ref sendMessage) or queued (@ref postMessage) for delivery in main loop
+ * (see @ref dispatchQueuedMessages, called from @ref update at main loop listener key value set by @c \<MessagesSystem\>\<QueuePriority\>
+ * in main config file, see @ref XMLSyntax_MainConfig).
  */
-class MessagesSystem {
+class MessagesSystem :
+	public MGE::MainLoopListener
+{
 public:
 	/// @{
 	/**
@@ -80,13 +126,54 @@ public:
 	 * @note Function returns after all registred receivers recive and proccessing message,
 	 *       so message can be deleted after this function exit.
 	 */
-	void sendMessage(const EventMsg* msg, const void* sender = NULL) const;
+	void sendMessage(const EventMsg* msg, const void* sender = NULL);
 	
-	FORCE_INLINE void sendMessage(const EventMsg&& msg, const void* sender = NULL) const {
-		return sendMessage(&msg);
+	FORCE_INLINE void sendMessage(const EventMsg&& msg, const void* sender = NULL) {
+		return sendMessage(&msg, sender);
 	}
 	/// @}
 	
+	/**
+	 * @brief Queue event message for delivery in main thread (by @ref dispatchQueuedMessages).
+	 * 
+	 * Thread safe (lock-free) – can be called from any thread (e.g. worker threads) and from receiver functions
+	 * (message posted during @ref dispatchQueuedMessages will be delivered on next call of @ref dispatchQueuedMessages).
+	 * 
+	 * @param msg       message to send (ownership is taken by messages system)
+	 * @param sender    (optional) pointer to sender object, used for filtering and coalescing
+	 * @param coalesce  when true only the latest of queued (with @a coalesce == true) messages with the same message type and @a sender
+	 *                  will be delivered (e.g. for state update messages)
+	 * 
+	 * @note Message (and @a sender) must be valid until delivery, so message should not store pointers to objects
+	 *       which can be destroyed before next call of @ref dispatchQueuedMessages.
+	 */
+	void postMessage(std::unique_ptr<const EventMsg>&& msg, const void* sender = NULL, bool coalesce = false);
+	
+	/// @copydoc postMessage
+	template <typename MsgType> requires std::derived_from<std::decay_t<MsgType>, EventMsg>
+	FORCE_INLINE void postMessage(MsgType&& msg, const void* sender = NULL, bool coalesce = false) {
+		postMessage(std::make_unique<const std::decay_t<MsgType>>(std::forward<MsgType>(msg)), sender, coalesce);
+	}
+	
+	/**
+	 * @brief Deliver all queued (by @ref postMessage) messages.
+	 * 
+	 * Queued messages are grouped by message type (in order of first message of each type) and each group is delivered in batch:
+	 *   - receivers registered by @ref registerBatchReceiver get all messages of group (passing their sender filter) in single call
+	 *   - receivers registered by @ref registerReceiver get each message of group (passing their sender filter) in queue order
+	 * 
+	 * Must be called in main thread (the same as @ref sendMessage, @ref registerReceiver, etc).
+	 * 
+	 * @return number of delivered (not coalesced) messages
+	 */
+	size_t dispatchQueuedMessages();
+	
+	/// @copydoc MGE::MainLoopListener::update
+	bool update(float gameTimeStep, float realTimeStep) override;
+	
+	/// @copydoc MGE::MainLoopListener::updateOnFullPause
+	bool updateOnFullPause(float realTimeStep) override;
+	
 	/**
 	 * @brief Type of function to receive event message.
 	 * 
@@ -102,10 +189,27 @@ public:
 	 * @param messageTypeName  Message type name for messages that we want to receive.
 	 * @copydetails ReceiverInfo::ReceiverInfo
 	 * 
-	 * @return true on success, false on error.
+	 * @return true on success, false on error (already registered receiver or message type ID collision).
 	 */
 	bool registerReceiver(const std::string_view& messageTypeName, const MsgReceiverFunction& receiverFunction, void* regOwnerID, void* regOwnerSubID = nullptr, void* receivOnlyFrom = nullptr);
 	
+	/**
+	 * @brief Type of function to receive batch of event messages (of the same type).
+	 * 
+	 * This is two argument function or class member function.
+	 * - First argument is span of pointers to messages. This pointers can be deleted after this function return (do not store this pointers).
+	 * - Second argument is regOwnerID used in @ref registerBatchReceiver.
+	 */
+	typedef std::function<void(std::span<const EventMsg* const> eventMsgs, void* regOwnerID)> MsgBatchReceiverFunction;
+	
+	/**
+	 * @brief Register event message batch receiver – receive all queued messages of @a messageTypeName type in single call
+	 *        (see @ref dispatchQueuedMessages), messages send via @ref sendMessage are received as single element batch.
+	 * 
+	 * Arguments and return value like for @ref registerReceiver (registration is unregistered via @ref unregisterReceiver).
+	 */
+	bool registerBatchReceiver(const std::string_view& messageTypeName, const MsgBatchReceiverFunction& receiverFunction, void* regOwnerID, void* regOwnerSubID = nullptr, void* receivOnlyFrom = nullptr);
+	
 	/**
 	 * @brief Unregister event message receiver.
 	 * 
@@ -129,6 +233,9 @@ public:
 	/// constructor
 	MessagesSystem();
 	
+	/// destructor
+	~MessagesSystem();
+	
 protected:
 	/**
 	 * @brief Struct for store info about C++ message subscriber.
@@ -138,6 +245,9 @@ protected:
 		/// Callback function.
 		MsgReceiverFunction exec;
 		
+		/// Batch callback function (used instead of @a exec when not empty).
+		MsgBatchReceiverFunction execBatch;
+		
 		/// Unique subscriber ID.
 		void* receiverID;
 		
@@ -149,9 +259,17 @@ protected:
 		/// Sender filter value (NULL == disable filtering).
 		void* onlyFrom;
 		
-		/// %Compare operation (compare based on values of all field without @a exec). Needed to use in std::set.
+		/// Receiver was unregistered during sending message (will be removed after finish sending).
+		bool removed;
+		
+		/// %Compare operation (lexicographical compare of all field without @a exec and @a removed). Needed to keep receivers vector sorted.
 		bool operator <(const ReceiverInfo& x) const {
-			return receiverID < x.receiverID || receiverInternalID < x.receiverInternalID || onlyFrom < x.onlyFrom;
+			return std::tie(receiverID, receiverInternalID, onlyFrom) < std::tie(x.receiverID, x.receiverInternalID, x.onlyFrom);
+		}
+		
+		/// %Compare operation (compare values of all field without @a exec and @a removed).
+		bool operator ==(const ReceiverInfo& x) const {
+			return receiverID == x.receiverID && receiverInternalID == x.receiverInternalID && onlyFrom == x.onlyFrom;
 		}
 		
 		/**
@@ -164,19 +282,110 @@ protected:
 		 * @param receivOnlyFrom   Optional filter value to compare with @c sender value from @ref sendMessage, default NULL == no filtering.
 		 */
 		ReceiverInfo(const MsgReceiverFunction& receiverFunction, void* regOwnerID, void* regOwnerSubID, void* receivOnlyFrom) :
-			exec(receiverFunction), receiverID(regOwnerID), receiverInternalID(regOwnerSubID), onlyFrom(receivOnlyFrom)
+			exec(receiverFunction), receiverID(regOwnerID), receiverInternalID(regOwnerSubID), onlyFrom(receivOnlyFrom), removed(false)
+		{}
+		
+		/// Constructor for batch receiver, arguments like for non batch constructor.
+		ReceiverInfo(const MsgBatchReceiverFunction& receiverFunction, void* regOwnerID, void* regOwnerSubID, void* receivOnlyFrom) :
+			execBatch(receiverFunction), receiverID(regOwnerID), receiverInternalID(regOwnerSubID), onlyFrom(receivOnlyFrom), removed(false)
 		{}
+		
+		/// Call receiver function for single message.
+		FORCE_INLINE void call(const EventMsg* msg) const {
+			if (execBatch)
+				execBatch(std::span<const EventMsg* const>(&msg, 1), receiverID);
+			else
+				exec(msg, receiverID);
+		}
+	};
+	
+	/// Receivers of single message type (single entry of @ref dispatchTable).
+	struct MsgTypeReceivers {
+		/// Message type ID.
+		uint32_t typeID = 0;
+		
+		/// Message type string (empty for unused entry), compared on lookup, so message types with colliding IDs are separate entries.
+		std::string typeName;
+		
+		/// Registered receivers, sorted by @ref ReceiverInfo::operator<.
+		std::vector<ReceiverInfo> receivers;
+		
+		/// True when some of @ref receivers was unregistered during sending message.
+		bool hasRemoved = false;
 	};
 	
 	/**
-	 * @brief Message type --> set of receivers (subscribing this type of message) map.
+	 * @brief Dispatch table – open addressing hash table with message type ID as key.
 	 * 
-	 * Key of this std::map is message type string. Values is set of registered receivers (represented by @ref ReceiverInfo).
-	 * 
-	 * @remark Used ``std::less<>`` to accept ``std::string_view`` on ``receiversMap.find()`` and compare it with key value (``std::string``)
-	 *         without creating ``std::string`` (by ``string_view < string_view`` operator).
+	 * Size is power of 2, entry for message type is placed at index @c typeID & (size-1) or (on collision) at next free index.
+	 * Entries are matched by type ID and type name (see @ref findMsgType), so type ID collisions are handled like index collisions.
 	 */
-	std::map<std::string, std::set<ReceiverInfo>, std::less<>> receiversMap;
+	std::vector<MsgTypeReceivers> dispatchTable;
+	
+	/// Number of used entries in @ref dispatchTable.
+	size_t typesCount;
+	
+	/// Nesting level of @ref sendMessage calls.
+	int sendingDepth;
+	
+	/// Receivers registered during sending message (pairs of message type name and receiver info).
+	std::vector<std::pair<std::string, ReceiverInfo>> pendingReceivers;
+	
+	/// True when there are receivers registered or unregistered during sending message.
+	bool hasPendingChanges;
+	
+	/// Node of queue of messages posted by @ref postMessage.
+	struct QueuedMsg {
+		/// Message.
+		std::unique_ptr<const EventMsg> msg;
+		
+		/// Sender (used for filtering and coalescing).
+		const void* sender;
+		
+		/// Coalescing flag.
+		bool coalesce;
+		
+		/// Next (previously posted) message in queue.
+		QueuedMsg* next;
+	};
+	
+	/// Head (last posted message) of lock-free (Treiber stack based) multi-producer queue of posted messages.
+	std::atomic<QueuedMsg*> queueHead;
+	
+	/// Guard for nested sending (counting @ref sendingDepth and applying pending changes on exit from outermost sending).
+	struct SendingGuard {
+		MGE::MessagesSystem* msgSys;
+		SendingGuard(MGE::MessagesSystem* s) : msgSys(s) {
+			++msgSys->sendingDepth;
+		}
+		~SendingGuard() {
+			if (--msgSys->sendingDepth == 0 && msgSys->hasPendingChanges)
+				msgSys->applyPendingChanges();
+		}
+	};
+	
+	/// Return entry of @ref dispatchTable for message type @a typeName with ID @a typeID (NULL when not registered).
+	FORCE_INLINE MsgTypeReceivers* findMsgType(uint32_t typeID, const std::string_view& typeName) {
+		size_t mask = dispatchTable.size() - 1;
+		for (size_t i = typeID & mask;; i = (i + 1) & mask) {
+			if (dispatchTable[i].typeName.empty())
+				return nullptr;
+			if (dispatchTable[i].typeID == typeID && dispatchTable[i].typeName == typeName)
+				return &dispatchTable[i];
+		}
+	}
+	
+	/// Return entry of @ref dispatchTable for message type @a messageTypeName (create it when not exist).
+	MsgTypeReceivers* getMsgType(const std::string_view& messageTypeName);
+	
+	/// Insert @a receiverInfo to receivers of @a messageTypeName (not used during sending message).
+	bool insertReceiver(const std::string_view& messageTypeName, ReceiverInfo&& receiverInfo);
+	
+	/// Register @a receiverInfo (common part of @ref registerReceiver and @ref registerBatchReceiver).
+	bool addReceiver(const std::string_view& messageTypeName, ReceiverInfo&& receiverInfo);
+	
+	/// Apply changes (unregister and register receivers) done during sending message.
+	void applyPendingChanges();
 };
 /// @}
 }
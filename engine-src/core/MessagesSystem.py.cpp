@@ -28,13 +28,18 @@ SOFTWARE.
 namespace MGE { namespace ScriptsInterface {
 	struct PythonEventMsg : MGE::EventMsg  {
 		std::string type;
+		uint32_t    typeID;
 		
 		const std::string_view getType() const override final {
 			return type;
 		}
 		
+		uint32_t getTypeID() const override final {
+			return typeID;
+		}
+		
 		PythonEventMsg(const std::string_view& _type) :
-			type(_type)
+			type(_type), typeID(MGE::EventMsg::hashType(_type))
 		{}
 	};
 	
@@ -42,11 +47,16 @@ namespace MGE { namespace ScriptsInterface {
 		MGE::ScriptsSystem::getPtr()->runObjectWithVoid( scriptName.c_str(), eventMsg, receiverID );
 	}
 	
-	void sendMessage(const MessagesSystem* msgSys, const PythonEventMsg* msg, const py::object& sender /*void* sender*/) {
+	void sendMessage(MessagesSystem* msgSys, const PythonEventMsg* msg, const py::object& sender /*void* sender*/) {
 		void* sender_ptr = sender.is_none() ? 0 : sender.ptr();
 		return msgSys->sendMessage( msg, sender_ptr );
 	}
 	
+	void postMessage(MessagesSystem* msgSys, const PythonEventMsg* msg, const py::object& sender, bool coalesce) {
+		void* sender_ptr = sender.is_none() ? 0 : sender.ptr();
+		return msgSys->postMessage( PythonEventMsg(*msg), sender_ptr, coalesce );
+	}
+	
 	bool registerReceiver(
 		MessagesSystem* msgSys,
 		const std::string_view& messageTypeName,
@@ -98,6 +108,13 @@ MGE_SCRIPT_API_FOR_MODULE(MessagesSystem) {
 			 DOC(MGE, MessagesSystem, sendMessage),
 			 py::arg("msg"), py::arg("sender") = py::none()
 		)
+		.def("postMessage", &MGE::ScriptsInterface::postMessage,
+			 DOC(MGE, MessagesSystem, postMessage),
+			 py::arg("msg"), py::arg("sender") = py::none(), py::arg("coalesce") = false
+		)
+		.def("dispatchQueuedMessages", &MGE::MessagesSystem::dispatchQueuedMessages,
+			 DOC(MGE, MessagesSystem, dispatchQueuedMessages)
+		)
 	;
 	py::class_<MGE::ScriptsInterface::PythonEventMsg>(m, "EventMsg", DOC(MGE, EventMsg))
 		.def(py::init<const std::string &>(), "constructor from \"message type\" string")
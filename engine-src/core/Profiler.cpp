@@ -0,0 +1,266 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Profiler.h"
+
+#include "LogSystem.h"
+
+#include <boost/core/demangle.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+struct MGE::Profiler::ThreadBuffer {
+	/// mutex for @a zones (locked by owner thread on zone end and by @ref endFrame)
+	std::mutex        mutex;
+	/// finished zones
+	std::vector<Zone> zones;
+	/// profiler internal thread number
+	uint32_t          thread;
+	/// current nesting level (used only by owner thread)
+	uint16_t          depth;
+};
+
+namespace {
+	std::atomic<uint64_t> lastProfilerInstanceID(0);
+}
+
+MGE::Profiler::Profiler(size_t framesCapacity, bool enable) :
+	enabled(enable),
+	epoch(std::chrono::steady_clock::now()),
+	frames(std::max<size_t>(1, framesCapacity)),
+	framesCount(0),
+	nextFrame(0),
+	frameNumber(0),
+	frameStart(0),
+	instanceID(++lastProfilerInstanceID)
+{
+	LOG_INFO("Profiler", "Create profiler with ring buffer for " << frames.size() << " frames, enabled=" << enable);
+	getThreadBuffer(); // creating thread will be thread 0
+}
+
+MGE::Profiler::~Profiler() {
+	LOG_INFO("Profiler", "Destroy profiler");
+}
+
+MGE::Profiler::ThreadBuffer* MGE::Profiler::getThreadBuffer() {
+	// cache is valid only for profiler instance with the same instanceID (profiler can be re-created, e.g. in tests)
+	thread_local struct {
+		uint64_t      instanceID = 0;
+		ThreadBuffer* buffer     = nullptr;
+	} cache;
+	if (cache.instanceID != instanceID) {
+		std::lock_guard<std::mutex> lock(threadBuffersMutex);
+		threadBuffers.emplace_back(new ThreadBuffer());
+		cache.buffer = threadBuffers.back().get();
+		cache.buffer->thread = threadBuffers.size() - 1;
+		cache.buffer->depth = 0;
+		cache.instanceID = instanceID;
+	}
+	return cache.buffer;
+}
+
+void MGE::Profiler::beginZone(ZoneScope& zone, const char* name, bool isTypeName) {
+	zone.buffer     = getThreadBuffer();
+	zone.name       = name;
+	zone.isTypeName = isTypeName;
+	++zone.buffer->depth;
+	zone.start      = now();
+}
+
+void MGE::Profiler::endZone(ZoneScope& zone) {
+	uint64_t end = now();
+	auto buffer = zone.buffer;
+	uint16_t depth = --buffer->depth;
+	std::lock_guard<std::mutex> lock(buffer->mutex);
+	buffer->zones.push_back({zone.name, zone.start, end, buffer->thread, depth, zone.isTypeName});
+}
+
+void MGE::Profiler::setEnabled(bool value) {
+	LOG_INFO("Profiler", "Set enabled=" << value);
+	enabled.store(value, std::memory_order_relaxed);
+}
+
+void MGE::Profiler::beginFrame() {
+	frameStart = now();
+}
+
+void MGE::Profiler::endFrame() {
+	uint64_t frameEnd = now();
+	Frame& frame = frames[nextFrame];
+	frame.zones.clear(); // keep capacity, so in steady state there is no memory allocations
+	
+	{
+		std::lock_guard<std::mutex> lock(threadBuffersMutex);
+		for (auto& buffer : threadBuffers) {
+			std::lock_guard<std::mutex> lock2(buffer->mutex);
+			frame.zones.insert(frame.zones.end(), buffer->zones.begin(), buffer->zones.end());
+			buffer->zones.clear();
+		}
+	}
+	
+	++frameNumber;
+	if (frame.zones.empty() && !isEnabled())
+		return;
+	
+	frame.number = frameNumber;
+	frame.start  = frameStart;
+	frame.end    = frameEnd;
+	
+	nextFrame = (nextFrame + 1) % frames.size();
+	if (framesCount < frames.size())
+		++framesCount;
+}
+
+void MGE::Profiler::clear() {
+	framesCount = 0;
+	nextFrame = 0;
+}
+
+const MGE::Profiler::Frame* MGE::Profiler::getFrame(size_t age) const {
+	if (age >= framesCount)
+		return nullptr;
+	return &frames[(nextFrame + frames.size() - 1 - age) % frames.size()];
+}
+
+const std::string_view MGE::Profiler::getZoneName(const Zone& zone) {
+	if (!zone.isTypeName)
+		return zone.name;
+	
+	auto iter = demangledNames.find(zone.name);
+	if (iter == demangledNames.end()) {
+		iter = demangledNames.emplace(zone.name, boost::core::demangle(zone.name)).first;
+	}
+	return iter->second;
+}
+
+void MGE::Profiler::writeSummary(std::ostream& out, size_t framesToAnalyse, size_t limit) {
+	struct ZoneStats {
+		const Zone* zone;
+		uint64_t    sum      = 0;
+		uint64_t    max      = 0;
+		uint64_t    calls    = 0;
+		uint16_t    depth    = std::numeric_limits<uint16_t>::max();
+	};
+	std::unordered_map<const char*, ZoneStats> stats;
+	std::unordered_map<const char*, uint64_t>  frameSums;
+	uint64_t frameSum = 0, frameMax = 0;
+	
+	framesToAnalyse = std::min(framesToAnalyse, framesCount);
+	for (size_t i = 0; i < framesToAnalyse; ++i) {
+		const Frame* frame = getFrame(i);
+		uint64_t frameTime = frame->end - frame->start;
+		frameSum += frameTime;
+		frameMax = std::max(frameMax, frameTime);
+		
+		frameSums.clear();
+		for (auto& zone : frame->zones) {
+			auto& s = stats[zone.name];
+			s.zone  = &zone;
+			s.calls += 1;
+			s.depth = std::min(s.depth, zone.depth);
+			frameSums[zone.name] += zone.end - zone.start;
+		}
+		for (auto& [name, sum] : frameSums) {
+			auto& s = stats[name];
+			s.sum += sum;
+			s.max = std::max(s.max, sum);
+		}
+	}
+	
+	out << std::fixed << std::setprecision(2);
+	if (!framesToAnalyse) {
+		out << "no recorded frames" << std::endl;
+		return;
+	}
+	out << "frame: avg " << frameSum / framesToAnalyse / 1e6 << " ms  max " << frameMax / 1e6 << " ms  (last " << framesToAnalyse << " frames)" << std::endl;
+	
+	std::vector<ZoneStats*> sorted;
+	for (auto& s : stats)
+		sorted.push_back(&s.second);
+	std::sort(sorted.begin(), sorted.end(), [](const ZoneStats* a, const ZoneStats* b) { return a->sum > b->sum; });
+	if (sorted.size() > limit)
+		sorted.resize(limit);
+	
+	out << "  avg ms    max ms  calls  zone" << std::endl;
+	for (auto s : sorted) {
+		out << std::setw(8) << s->sum / framesToAnalyse / 1e6 << "  " << std::setw(8) << s->max / 1e6 << "  "
+		    << std::setw(5) << std::setprecision(1) << static_cast<double>(s->calls) / framesToAnalyse << std::setprecision(2) << "  "
+		    << std::string(2 * s->depth, ' ') << getZoneName(*(s->zone)) << std::endl;
+	}
+}
+
+namespace {
+	void writeJSONString(std::ostream& out, const std::string_view& str) {
+		out << '"';
+		for (char c : str) {
+			if (c == '"' || c == '\\')
+				out << '\\' << c;
+			else if (static_cast<unsigned char>(c) < 0x20)
+				out << ' ';
+			else
+				out << c;
+		}
+		out << '"';
+	}
+}
+
+void MGE::Profiler::writeChromeTrace(std::ostream& out) {
+	out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+	out << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": 0, \"args\": {\"name\": \"main\"}}";
+	size_t threadsCount;
+	{
+		std::lock_guard<std::mutex> lock(threadBuffersMutex);
+		threadsCount = threadBuffers.size();
+	}
+	for (size_t i = 1; i < threadsCount; ++i) {
+		out << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << i << ", \"args\": {\"name\": \"worker " << i << "\"}}";
+	}
+	
+	out << std::fixed << std::setprecision(3);
+	for (size_t i = framesCount; i > 0; --i) {
+		const Frame* frame = getFrame(i - 1);
+		out << ",\n{\"name\": \"Frame " << frame->number << "\", \"cat\": \"frame\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0"
+		    << ", \"ts\": " << frame->start / 1e3 << ", \"dur\": " << (frame->end - frame->start) / 1e3 << "}";
+		for (auto& zone : frame->zones) {
+			out << ",\n{\"name\": ";
+			writeJSONString(out, getZoneName(zone));
+			out << ", \"cat\": \"zone\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << zone.thread
+			    << ", \"ts\": " << zone.start / 1e3 << ", \"dur\": " << (zone.end - zone.start) / 1e3 << "}";
+		}
+	}
+	out << "\n]}\n";
+}
+
+bool MGE::Profiler::writeChromeTrace(const std::string& filePath) {
+	LOG_INFO("Profiler", "Write " << framesCount << " frames to Chrome trace file: " << filePath);
+	std::ofstream out(filePath);
+	writeChromeTrace(out);
+	out.close();
+	if (!out) {
+		LOG_ERROR("Profiler", "Can't write Chrome trace file: " << filePath);
+		return false;
+	}
+	return true;
+}
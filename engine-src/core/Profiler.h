@@ -0,0 +1,262 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma   once
+
+#include "BaseClasses.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace MGE {
+
+/// @addtogroup Profiler
+/// @{
+/// @file
+
+/**
+ * @brief Per-frame hierarchical CPU profiler.
+ * 
+ * Records time of scoped zones (see @ref MGE_PROFILER_ZONE) from all threads.
+ * Zones recorded between @ref beginFrame and @ref endFrame are stored as single frame in ring buffer of last N frames.
+ * @ref MGE::Engine calls @ref beginFrame / @ref endFrame for each main loop iteration and creates zone for every
+ * @ref MGE::MainLoopListener update call (named by listener class name).
+ * 
+ * \par Example
+	\code{.cpp}
+		void MyModule::update(float gameTimeStep, float realTimeStep) {
+			MGE_PROFILER_ZONE("MyModule::update::ai");
+			// ...
+			{
+				MGE_PROFILER_ZONE("MyModule::update::pathfinding");
+				// ...
+			}
+		}
+	\endcode
+ * 
+ * @remark
+ *    - Singleton, created by @ref MGE::Engine (ring buffer size and initial state are read from main config).
+ *    - When profiler is disabled (default), zone costs single atomic load.
+ *      For complete remove zones from code define @c MGE_PROFILER_DISABLED macro.
+ *    - Zone name must be string with static storage duration (e.g. string literal), because only pointer is stored.
+ */
+class Profiler : public MGE::Singleton<Profiler> {
+protected:
+	/// per thread buffer for finished zones
+	struct ThreadBuffer;
+	
+public:
+	/// Single recorded zone.
+	struct Zone {
+		/// zone name (pointer to static string)
+		const char* name;
+		/// zone start time (in nanoseconds from profiler creation)
+		uint64_t    start;
+		/// zone end time (in nanoseconds from profiler creation)
+		uint64_t    end;
+		/// profiler internal thread number (0 for thread calling @ref endFrame, typically main thread)
+		uint32_t    thread;
+		/// nesting level of zone (in its thread)
+		uint16_t    depth;
+		/// when true @a name is mangled C++ type name (from @c typeid().name())
+		bool        isTypeName;
+	};
+	
+	/// Single recorded frame.
+	struct Frame {
+		/// frame number (counted from profiler creation)
+		uint64_t          number;
+		/// frame start time (in nanoseconds from profiler creation)
+		uint64_t          start;
+		/// frame end time (in nanoseconds from profiler creation)
+		uint64_t          end;
+		/// zones finished in this frame (in order of finishing)
+		std::vector<Zone> zones;
+	};
+	
+	/**
+	 * @brief RAII zone object – record zone from construction to destruction (when profiler is enabled).
+	 */
+	class ZoneScope {
+	public:
+		/// constructor – start zone
+		inline ZoneScope(const char* name, bool isTypeName = false) {
+			auto profiler = MGE::Profiler::getPtr();
+			if (profiler && profiler->enabled.load(std::memory_order_relaxed))
+				profiler->beginZone(*this, name, isTypeName);
+			else
+				buffer = nullptr;
+		}
+		
+		/// destructor – finish zone
+		inline ~ZoneScope() {
+			if (buffer)
+				MGE::Profiler::getPtr()->endZone(*this);
+		}
+		
+	protected:
+		friend class Profiler;
+		
+		ThreadBuffer*        buffer;
+		const char*          name;
+		uint64_t             start;
+		bool                 isTypeName;
+	};
+	
+	/// Enable or disable recording (when disabling, all recorded frames are kept).
+	void setEnabled(bool value);
+	
+	/// Return true when recording is enabled.
+	inline bool isEnabled() const {
+		return enabled.load(std::memory_order_relaxed);
+	}
+	
+	/// Start new frame (should be called only from one thread – main loop thread).
+	void beginFrame();
+	
+	/// Finish current frame and store it in ring buffer (should be called only from thread calling @ref beginFrame).
+	void endFrame();
+	
+	/// Remove all recorded frames.
+	void clear();
+	
+	/// Return number of stored frames.
+	inline size_t getFramesCount() const {
+		return framesCount;
+	}
+	
+	/**
+	 * @brief Return stored frame.
+	 * 
+	 * @param age  0 for last finished frame, 1 for previous frame, etc.
+	 * 
+	 * @return pointer to frame or NULL when @a age >= @ref getFramesCount
+	 */
+	const Frame* getFrame(size_t age) const;
+	
+	/**
+	 * @brief Return (human readable) zone name.
+	 */
+	const std::string_view getZoneName(const Zone& zone);
+	
+	/**
+	 * @brief Write summary of last @a frames frames (frame time and per zone average / max time) as text.
+	 * 
+	 * @param out     output stream
+	 * @param frames  number of frames to analyse
+	 * @param limit   maximum number of zones to write
+	 */
+	void writeSummary(std::ostream& out, size_t frames = 60, size_t limit = 20);
+	
+	/**
+	 * @brief Write all stored frames as Chrome trace-event JSON (can be open in `chrome://tracing` or https://ui.perfetto.dev).
+	 * 
+	 * @return true on success, false on write error
+	 */
+	bool writeChromeTrace(const std::string& filePath);
+	
+	/// @copydoc writeChromeTrace(const std::string& filePath)
+	void writeChromeTrace(std::ostream& out);
+	
+	/**
+	 * @brief Constructor.
+	 * 
+	 * @param framesCapacity  size of ring buffer (number of stored frames)
+	 * @param enable          initial value of recording state
+	 */
+	Profiler(size_t framesCapacity = 300, bool enable = false);
+	
+	/// Destructor.
+	~Profiler();
+	
+protected:
+	/// recording state
+	std::atomic<bool> enabled;
+	
+	/// profiler time base
+	std::chrono::steady_clock::time_point epoch;
+	
+	/// frames ring buffer
+	std::vector<Frame> frames;
+	
+	/// number of stored frames
+	size_t framesCount;
+	
+	/// index of next frame slot in @ref frames
+	size_t nextFrame;
+	
+	/// number of next frame
+	uint64_t frameNumber;
+	
+	/// start time of current frame
+	uint64_t frameStart;
+	
+	/// per thread buffers for finished zones
+	std::vector< std::unique_ptr<ThreadBuffer> > threadBuffers;
+	
+	/// mutex for @ref threadBuffers
+	std::mutex threadBuffersMutex;
+	
+	/// cache of demangled type names (used by @ref getZoneName)
+	std::unordered_map<const char*, std::string> demangledNames;
+	
+	/// unique ID of profiler instance (used to invalidate thread local cache of thread buffers)
+	uint64_t instanceID;
+	
+	/// return current time (in nanoseconds from profiler creation)
+	inline uint64_t now() const {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+	}
+	
+	/// return (and create if need) buffer for current thread
+	ThreadBuffer* getThreadBuffer();
+	
+	/// used by ZoneScope constructor
+	void beginZone(ZoneScope& zone, const char* name, bool isTypeName);
+	
+	/// used by ZoneScope destructor
+	void endZone(ZoneScope& zone);
+};
+
+/// @}
+
+}
+
+#define MGE_PROFILER_CONCAT2(a, b) a ## b
+#define MGE_PROFILER_CONCAT(a, b)  MGE_PROFILER_CONCAT2(a, b)
+
+#ifndef MGE_PROFILER_DISABLED
+/// create profiler zone with name @a name (string literal) from this line to end of current scope
+#define MGE_PROFILER_ZONE(name) MGE::Profiler::ZoneScope MGE_PROFILER_CONCAT(mgeProfilerZone_, __LINE__)(name)
+/// create profiler zone with name of current function from this line to end of current scope
+#define MGE_PROFILER_FUNCTION() MGE_PROFILER_ZONE(__PRETTY_FUNCTION__)
+#else
+#define MGE_PROFILER_ZONE(name)
+#define MGE_PROFILER_FUNCTION()
+#endif
@@ -0,0 +1,59 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Profiler.h"
+
+#include "ScriptsInterface.h"
+
+#include <sstream>
+
+#ifndef __DOCUMENTATION_GENERATOR__
+MGE_SCRIPT_API_FOR_MODULE(Profiler) {
+	py::class_<MGE::Profiler, std::unique_ptr<MGE::Profiler, py::nodelete>>(
+		m, "Profiler", DOC(MGE, Profiler)
+	)
+		.def("setEnabled", &MGE::Profiler::setEnabled,
+			DOC(MGE, Profiler, setEnabled)
+		)
+		.def("isEnabled", &MGE::Profiler::isEnabled,
+			DOC(MGE, Profiler, isEnabled)
+		)
+		.def("clear", &MGE::Profiler::clear,
+			DOC(MGE, Profiler, clear)
+		)
+		.def("getFramesCount", &MGE::Profiler::getFramesCount,
+			DOC(MGE, Profiler, getFramesCount)
+		)
+		.def("writeChromeTrace", py::overload_cast<const std::string&>(&MGE::Profiler::writeChromeTrace),
+			DOC(MGE, Profiler, writeChromeTrace)
+		)
+		.def("getSummary", [](MGE::Profiler* profiler, size_t frames, size_t limit) {
+				std::ostringstream out;
+				profiler->writeSummary(out, frames, limit);
+				return out.str();
+			}, py::arg("frames") = 60, py::arg("limit") = 20,
+			DOC(MGE, Profiler, writeSummary)
+		)
+		.def_static("get", &MGE::Profiler::getPtr, py::return_value_policy::reference, DOC_SINGLETON_GET("Profiler"))
+	;
+}
+#endif
@@ -22,9 +22,14 @@ SOFTWARE.
 
 #include "ScriptsSystem.h"
 #include "LogSystem.h"
+#include "Profiler.h"
 #include "pragma.h"
 
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
 
 /* ***********     running python code     ********** */
 
@@ -34,6 +39,7 @@ pybind11::object MGE::ScriptsSystem::runString(
 	PyObject* locals,
 	PyObject* globals
 ) {
+	MGE_SCRIPTS_SYSTEM_ASSERT_GIL
 	LOG_DEBUG("Execute Python string: " << code);
 	
 	PyObject* result = PyRun_String( code, mode, globals, locals );
@@ -41,6 +47,9 @@ pybind11::object MGE::ScriptsSystem::runString(
 	if (!result)
 		onError();
 	
+	if (mode != Py_eval_input)
+		invalidateObjectsCache();
+	
 	return pybind11::reinterpret_steal<pybind11::object>(result);
 }
 
@@ -50,7 +59,9 @@ pybind11::object MGE::ScriptsSystem::runFile(
 	PyObject* locals,
 	PyObject* globals
 ){
+	MGE_SCRIPTS_SYSTEM_ASSERT_GIL
 	LOG_INFO("Execute Python file: " << path);
+	ProfilingScope profile(this, path);
 	
 	pybind11::str path_pystr( path );
 	
@@ -68,11 +79,32 @@ pybind11::object MGE::ScriptsSystem::runFile(
 	if (!result)
 		onError();
 	
+	invalidateObjectsCache();
+	
 	getGlobalsDict()["__file__"] = pybind11::none();
 	
 	return pybind11::reinterpret_steal<pybind11::object>(result);
 }
 
+pybind11::object MGE::ScriptsSystem::getObject(null_end_string name) {
+	MGE_SCRIPTS_SYSTEM_ASSERT_GIL
+	auto iter = objectsCache.find(name);
+	if (iter != objectsCache.end())
+		return iter->second;
+	
+	auto object = runString(name, Py_eval_input);
+	if (object)
+		objectsCache.emplace(name, object);
+	return object;
+}
+
+void MGE::ScriptsSystem::invalidateObjectsCache() {
+	if (!objectsCache.empty()) {
+		LOG_DEBUG("Invalidate Python objects cache");
+		objectsCache.clear();
+	}
+}
+
 void MGE::ScriptsSystem::loadScriptsFromFilesystem(const std::string& path) {
 	LOG_INFO("Load python scripts from file or directory: " << path);
 	
@@ -98,22 +130,142 @@ void MGE::ScriptsSystem::loadScriptsFromFilesystem(const std::string& path) {
 	}
 }
 
+void MGE::ScriptsSystem::assertGIL(const char* where) {
+	if (Py_IsInitialized() && !PyGILState_Check()) {
+		LOG_ERROR("ScriptsSystem", "Call Python API without GIL in " << where);
+		throw std::logic_error(std::string("Call Python API without GIL in ") + where);
+	}
+}
+
 void MGE::ScriptsSystem::runStringInThread(const std::string& code) {
 	MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
 	LOG_DEBUG("AA");
 	MGE::ScriptsSystem::getPtr()->getGlobalsDict()["__MGE_ScriptsSystem__Thread__Command__"] = code;
 	LOG_DEBUG("BB");
-	MGE::ScriptsSystem::getPtr()->runString( "threading.Thread(target=exec, args=[__MGE_ScriptsSystem__Thread__Command__]).start()" );
+	MGE::ScriptsSystem::getPtr()->runString( "threading.Thread(target=__MGE_ScriptsSystem__exec__, args=[__MGE_ScriptsSystem__Thread__Command__]).start()" );
 	LOG_DEBUG("CC");
 	MGE::ScriptsSystem::getPtr()->getGlobalsDict()["__MGE_ScriptsSystem__Thread__Command__"] = "";
 }
 
 
+/* ***********     scripts profiling     ********** */
+
+void MGE::ScriptsSystem::setProfilingEnabled(bool value) {
+	LOG_INFO("ScriptsSystem", "Set scripts profiling to: " << value);
+	profilingEnabled = value;
+}
+
+MGE::ScriptsSystem::ProfilingStats* MGE::ScriptsSystem::getProfilingStats(null_end_string name, const char*& zoneName) {
+	auto iter = profilingStats.find(name);
+	if (iter == profilingStats.end())
+		iter = profilingStats.emplace(name, std::deque<ProfilingStats>()).first;
+	zoneName = iter->first.c_str();
+	
+	const char* caller = currentCaller ? currentCaller : "Other";
+	for (auto& stats : iter->second) {
+		if (stats.caller == caller || std::strcmp(stats.caller, caller) == 0)
+			return &stats;
+	}
+	return &iter->second.emplace_back(ProfilingStats{caller, 0, 0, 0});
+}
+
+struct MGE::ScriptsSystem::ProfilingScope::Data {
+	ProfilingStats*                        stats;
+	MGE::Profiler::ZoneScope               zone;
+	std::chrono::steady_clock::time_point  start;
+};
+
+void MGE::ScriptsSystem::ProfilingScope::begin(ScriptsSystem* scriptsSystem, null_end_string name) {
+	const char* zoneName;
+	ProfilingStats* stats = scriptsSystem->getProfilingStats(name, zoneName);
+	data = new Data{stats, MGE::Profiler::ZoneScope(zoneName), std::chrono::steady_clock::now()};
+}
+
+void MGE::ScriptsSystem::ProfilingScope::end() {
+	uint64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - data->start).count();
+	data->stats->calls     += 1;
+	data->stats->totalTime += time;
+	data->stats->maxTime    = std::max(data->stats->maxTime, time);
+	delete data;
+}
+
+void MGE::ScriptsSystem::clearProfilingStats() {
+	MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
+	// don't remove elements - names are used by MGE::Profiler zones (and calls can be in progress)
+	for (auto& [name, callers] : profilingStats) {
+		for (auto& stats : callers) {
+			stats.calls = stats.totalTime = stats.maxTime = 0;
+		}
+	}
+}
+
+void MGE::ScriptsSystem::writeProfilingSummary(std::ostream& out, size_t limit) {
+	MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
+	std::vector< std::pair<const std::string*, const ProfilingStats*> > sorted;
+	for (auto& [name, callers] : profilingStats) {
+		for (auto& stats : callers) {
+			if (stats.calls)
+				sorted.emplace_back(&name, &stats);
+		}
+	}
+	
+	if (sorted.empty()) {
+		out << (profilingEnabled ? "no recorded script calls" : "scripts profiling is disabled") << std::endl;
+		return;
+	}
+	
+	std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second->totalTime > b.second->totalTime; });
+	if (sorted.size() > limit)
+		sorted.resize(limit);
+	
+	out << std::fixed << std::setprecision(3);
+	out << "  total ms    avg ms    max ms    calls  caller          function" << std::endl;
+	for (auto& [name, stats] : sorted) {
+		out << std::setw(10) << stats->totalTime / 1e6 << "  " << std::setw(8) << stats->totalTime / stats->calls / 1e6 << "  "
+		    << std::setw(8) << stats->maxTime / 1e6 << "  " << std::setw(7) << stats->calls << "  "
+		    << std::left << std::setw(14) << stats->caller << std::right << "  " << *name << std::endl;
+	}
+}
+
+void MGE::ScriptsSystem::writeProfilingCSV(std::ostream& out) {
+	MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
+	out << "caller,function,calls,total_ms,avg_ms,max_ms" << std::endl;
+	out << std::fixed << std::setprecision(6);
+	for (auto& [name, callers] : profilingStats) {
+		for (auto& stats : callers) {
+			if (!stats.calls)
+				continue;
+			out << stats.caller << ",\"";
+			for (char c : name) {
+				if (c == '"')
+					out << '"';
+				out << c;
+			}
+			out << "\"," << stats.calls << "," << stats.totalTime / 1e6 << "," << stats.totalTime / stats.calls / 1e6 << "," << stats.maxTime / 1e6 << std::endl;
+		}
+	}
+}
+
+bool MGE::ScriptsSystem::writeProfilingCSV(const std::string& filePath) {
+	LOG_INFO("ScriptsSystem", "Write scripts profiling statistics to: " << filePath);
+	std::ofstream out(filePath);
+	writeProfilingCSV(out);
+	out.close();
+	if (!out) {
+		LOG_ERROR("ScriptsSystem", "Can't write scripts profiling statistics file: " << filePath);
+		return false;
+	}
+	return true;
+}
+
+
 /* ***********     init and deinit python interpreter     ********** */
 
 PyObject* MGE::ScriptsSystem::pythonGlobals = nullptr;
 
-MGE::ScriptsSystem::ScriptsSystem() {
+MGE::ScriptsSystem::ScriptsSystem() :
+	profilingEnabled(false)
+{
 	LOG_INFO("Initialize python interpreter and script system");
 	
 	// due to Python interpreter construction (and use pybind11::initialize_interpreter() here)
@@ -140,6 +292,17 @@ class MGEStdOut:
     sys.MGEStdOut.write(text, threading.current_thread().name)
 sys.stdout = MGEStdOut()
 sys.stderr = MGEStdOut()
+
+import importlib, __MGE_ScriptsSystem__
+def __MGE_ScriptsSystem__reload__(module, reload=importlib.reload):
+  ret = reload(module)
+  __MGE_ScriptsSystem__.invalidateObjectsCache()
+  return ret
+importlib.reload = __MGE_ScriptsSystem__reload__
+
+def __MGE_ScriptsSystem__exec__(code):
+  exec(code, globals())
+  __MGE_ScriptsSystem__.invalidateObjectsCache()
 )");
 	
 	#ifdef NO_DEFAULT_GIL_LOCK
@@ -153,6 +316,7 @@ sys.stderr = MGEStdOut()
 
 MGE::ScriptsSystem::~ScriptsSystem() {
 	delete gil_release;
+	objectsCache.clear();
 	runString("sys.stdout = sys.__stdout__");
 	delete pythonStdout;
 	pybind11::finalize_interpreter();
@@ -204,6 +368,9 @@ PYBIND11_EMBEDDED_MODULE(__MGE_ScriptsSystem__, m) {
 			 pybind11::arg("txt"), pybind11::arg("listener_id") = ""
 		)
 	;
+	m.def("invalidateObjectsCache", []() { MGE::ScriptsSystem::getPtr()->invalidateObjectsCache(); },
+		"clear cache of objects resolved by MGE::ScriptsSystem::getObject()"
+	);
 }
 
 MGE_CLANG_WARNING_POP
@@ -29,15 +29,29 @@ SOFTWARE.
 #include <pybind11/embed.h>
 
 #include <map>
+#include <unordered_map>
 #include <list>
+#include <algorithm>
+#include <chrono>
+#include <deque>
 #include <functional>
+#include <optional>
+#include <ostream>
 
-#ifdef NO_DEFAULT_GIL_LOCK
-	/// macro to acquire GIL (when using NO_DEFAULT_GIL_LOCK)
-	#define MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL pybind11::gil_scoped_acquire acquire;
+/// macro to acquire GIL in current scope (when using NO_DEFAULT_GIL_LOCK or inside @ref MGE_SCRIPTS_SYSTEM_RELEASE_SCOPED_GIL scope),
+/// do nothing when current thread already holds GIL
+#define MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL MGE::ScriptsSystem::ScopedGILAcquire acquireGIL;
+
+/// macro to release GIL in current scope (for long native sections like physics step or frame rendering, to allow run python threads),
+/// do nothing when current thread doesn't hold GIL
+#define MGE_SCRIPTS_SYSTEM_RELEASE_SCOPED_GIL MGE::ScriptsSystem::ScopedGILRelease releaseGIL;
+
+#ifdef MGE_DEBUG_GIL
+	/// macro to check (on debug build) that current thread holds GIL - for use in functions calling Python API without acquire GIL
+	#define MGE_SCRIPTS_SYSTEM_ASSERT_GIL MGE::ScriptsSystem::assertGIL(__func__);
 #else
-	/// macro to acquire GIL (when using NO_DEFAULT_GIL_LOCK)
-	#define MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
+	/// macro to check (on debug build) that current thread holds GIL - for use in functions calling Python API without acquire GIL
+	#define MGE_SCRIPTS_SYSTEM_ASSERT_GIL
 #endif
 
 namespace MGE {
@@ -85,8 +99,8 @@ public:
 	 * 
 	 * @return pybind11 object with results, null on error
 	 * 
-	 * @note While use NO_DEFAULT_GIL_LOCK mode this function can be called with or without GIL acquire,
-	 *       but returned value must be retrieved and next must processed <b>and destroyed</b> with GIL acquire.
+	 * @note While use NO_DEFAULT_GIL_LOCK mode this function must be called with GIL acquire,
+	 *       and returned value must be retrieved and next must processed <b>and destroyed</b> with GIL acquire.
 	 *       See @ref runFileWithCast and @ref runFileWithVoid as NO_DEFAULT_GIL_LOCK safe alternatives.
 	 */
 	pybind11::object runFile(
@@ -168,8 +182,8 @@ public:
 	 * 
 	 * @return pybind11 object with results, null on error
 	 * 
-	 * @note While use NO_DEFAULT_GIL_LOCK mode this function can be called with or without GIL acquire,
-	 *       but returned value must be retrieved and next must processed <b>and destroyed</b> with GIL acquire.
+	 * @note While use NO_DEFAULT_GIL_LOCK mode this function must be called with GIL acquire,
+	 *       and returned value must be retrieved and next must processed <b>and destroyed</b> with GIL acquire.
 	 *       See @ref runStringWithCast and @ref runStringWithVoid as NO_DEFAULT_GIL_LOCK safe alternatives.
 	 */
 	pybind11::object runString(
@@ -265,12 +279,22 @@ public:
 	 *       For python function in global namespace, you can use simple: \code getGlobalsDict()["functionName"] \endcode
 	 *       For functions in modules: \code getGlobalsDict()["moduleName"].attr("functionName") \endcode
 	 * 
-	 * @note While use NO_DEFAULT_GIL_LOCK mode this function can be called with or without GIL acquire,
-	 *       but returned value must be retrieved and next must processed <b>and destroyed</b> with GIL acquire.
+	 * @note Resolved objects are cached by name, so name is evaluated only on first call (or first call after @ref invalidateObjectsCache).
+	 *       When name (or its scope) is rebound by python code not executed via @ref runFile or @ref runString (in non ``Py_eval_input`` mode)
+	 *       and not reloaded by ``importlib.reload()``, then @ref invalidateObjectsCache should be called manually.
+	 * 
+	 * @note While use NO_DEFAULT_GIL_LOCK mode this function must be called with GIL acquire,
+	 *       and returned value must be retrieved and next must processed <b>and destroyed</b> with GIL acquire.
 	 */
-	FORCE_INLINE pybind11::object getObject(null_end_string name) {
-		return runString(name, Py_eval_input);
-	}
+	pybind11::object getObject(null_end_string name);
+	
+	/**
+	 * @brief Clear cache of objects resolved by @ref getObject.
+	 * 
+	 * @note Called automatically after @ref runFile, after @ref runString in non ``Py_eval_input`` mode and after python ``importlib.reload()``.
+	 *       Available in python as ``__MGE_ScriptsSystem__.invalidateObjectsCache()``.
+	 */
+	void invalidateObjectsCache();
 	
 	/**
 	 * @brief Run python callable object (e.g. function) based on (scoped) name.
@@ -281,12 +305,14 @@ public:
 	 * 
 	 * @return* pybind11* object with results, null on error.
 	 * 
-	 * @note While use NO_DEFAULT_GIL_LOCK mode this function can be called with or without GIL acquire,
-	 *       but returned value must be retrieved and next must processed <b>and destroyed</b> with GIL acquire.
+	 * @note While use NO_DEFAULT_GIL_LOCK mode this function must be called with GIL acquire,
+	 *       and returned value must be retrieved and next must processed <b>and destroyed</b> with GIL acquire.
 	 *       See @ref runObjectWithCast and @ref runObjectWithVoid as NO_DEFAULT_GIL_LOCK safe alternatives.
 	 */
 	template <typename... ARG> inline pybind11::object runObject(null_end_string name, ARG... args)  {
 		try {
+			MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
+			ProfilingScope profile(this, name);
 			return getObject(name)(args...);
 		} catch(pybind11::error_already_set& e) {
 			onError(e.what());
@@ -307,6 +333,7 @@ public:
 	template <typename RES, typename... ARG> inline RES runObjectWithCast(null_end_string name, RES def, ARG... args)  {
 		try {
 			MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
+			ProfilingScope profile(this, name);
 			return ( getObject(name)(args...) ).template cast<RES>();
 		} catch(pybind11::error_already_set& e) {
 			onError(e.what());
@@ -324,6 +351,7 @@ public:
 	template <typename... ARG> inline void runObjectWithVoid(null_end_string name, ARG... args)  {
 		try {
 			MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
+			ProfilingScope profile(this, name);
 			getObject(name)(args...);
 		} catch(pybind11::error_already_set& e) {
 			onError(e.what());
@@ -339,12 +367,14 @@ public:
 	 * 
 	 * @return* pybind11* object with results, throw exception on error.
 	 * 
-	 * @note While use NO_DEFAULT_GIL_LOCK mode this function can be called with or without GIL acquire,
-	 *       but returned value must be retrieved and next must processed <b>and destroyed</b> with GIL acquire.
+	 * @note While use NO_DEFAULT_GIL_LOCK mode this function must be called with GIL acquire,
+	 *       and returned value must be retrieved and next must processed <b>and destroyed</b> with GIL acquire.
 	 *       See @ref runObjectWithCastThrow and @ref runObjectWithVoidThrow as NO_DEFAULT_GIL_LOCK safe alternatives.
 	 */
 	template <typename... ARG> inline pybind11::object runObjectThrow(null_end_string name, ARG... args)  {
 		try {
+			MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
+			ProfilingScope profile(this, name);
 			return getObject(name)(args...);
 		} catch(pybind11::error_already_set& e) {
 			onError(e.what());
@@ -364,6 +394,7 @@ public:
 	template <typename RES, typename... ARG> inline RES runObjectWithCastThrow(null_end_string name, ARG... args)  {
 		try {
 			MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
+			ProfilingScope profile(this, name);
 			return ( getObject(name)(args...) ).template cast<RES>();
 		} catch(pybind11::error_already_set& e) {
 			onError(e.what());
@@ -381,6 +412,7 @@ public:
 	template <typename... ARG> inline void runObjectWithVoidThrow(null_end_string name, ARG... args)  {
 		try {
 			MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
+			ProfilingScope profile(this, name);
 			getObject(name)(args...);
 		} catch(pybind11::error_already_set& e) {
 			onError(e.what());
@@ -388,6 +420,61 @@ public:
 		}
 	}
 	
+	/**
+	 * @brief RAII GIL acquire (used by @ref MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL).
+	 * 
+	 * Acquire GIL only when current thread doesn't hold it (so can be nested and used in callbacks called from python code
+	 * or from @ref ScopedGILRelease scope), do nothing when python interpreter is not initialized.
+	 */
+	struct ScopedGILAcquire {
+		/// constructor - acquire GIL when needed
+		ScopedGILAcquire() : acquired(Py_IsInitialized() && !PyGILState_Check()) {
+			if (acquired)
+				state = PyGILState_Ensure();
+		}
+		/// destructor - release GIL when was acquired by constructor
+		~ScopedGILAcquire() {
+			if (acquired)
+				PyGILState_Release(state);
+		}
+		ScopedGILAcquire(const ScopedGILAcquire&) = delete;
+		ScopedGILAcquire& operator=(const ScopedGILAcquire&) = delete;
+	private:
+		bool             acquired;
+		PyGILState_STATE state;
+	};
+	
+	/**
+	 * @brief RAII GIL release (used by @ref MGE_SCRIPTS_SYSTEM_RELEASE_SCOPED_GIL).
+	 * 
+	 * Release GIL only when current thread holds it (so can be used in main loop listeners executed in main or worker thread,
+	 * with or without NO_DEFAULT_GIL_LOCK), do nothing when python interpreter is not initialized.
+	 * Code in this scope can't call python API without @ref MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL.
+	 */
+	struct ScopedGILRelease {
+		/// constructor - release GIL when current thread holds it
+		ScopedGILRelease() :
+			threadState( (Py_IsInitialized() && PyGILState_Check()) ? PyEval_SaveThread() : nullptr )
+		{}
+		/// destructor - restore GIL when was released by constructor
+		~ScopedGILRelease() {
+			if (threadState)
+				PyEval_RestoreThread(threadState);
+		}
+		ScopedGILRelease(const ScopedGILRelease&) = delete;
+		ScopedGILRelease& operator=(const ScopedGILRelease&) = delete;
+	private:
+		PyThreadState* threadState;
+	};
+	
+	/**
+	 * @brief Check that current thread holds GIL, log error and throw std::logic_error if not.
+	 *        Used by @ref MGE_SCRIPTS_SYSTEM_ASSERT_GIL (on build with MGE_DEBUG_GIL defined).
+	 * 
+	 * @param where  Name of function calling Python API (used in error message).
+	 */
+	static void assertGIL(const char* where);
+	
 	/**
 	 * @brief Return python globals directory.
 	 *
@@ -403,6 +490,7 @@ public:
 	 * @note While use NO_DEFAULT_GIL_LOCK mode all operation on returned object must be doing with GIL acquire.
 	 */
 	FORCE_INLINE pybind11::dict getGlobalsDict() const {
+		MGE_SCRIPTS_SYSTEM_ASSERT_GIL
 		return pybind11::handle(pythonGlobals).cast<pybind11::dict>();
 	}
 	
@@ -453,10 +541,124 @@ public:
 	 */
 	void setScriptOutputListener(const std::string id_str, const ScriptOutputListener& listener);
 	
+	/**
+	 * @brief Enable or disable scripts profiling.
+	 * 
+	 * When enabled, every call of Python entry point (by runObject* and runFile* functions) is recorded:
+	 *   - wall time (including nested calls) and calls count are accumulated per (caller tag, python object name) pair,
+	 *     caller tag is set by @ref ProfilingCallerScope (e.g. "ActionExecutor", "TimeSystem", "Trigger", "InputSystem"),
+	 *   - @ref MGE::Profiler zone (named by python object name) is created, so calls are visible on frame timeline.
+	 * 
+	 * @note Statistics are protected by GIL (entry points are profiled after GIL acquire).
+	 */
+	void setProfilingEnabled(bool value);
+	
+	/// Return true when scripts profiling is enabled.
+	inline bool isProfilingEnabled() const {
+		return profilingEnabled;
+	}
+	
+	/// Reset all scripts profiling statistics.
+	void clearProfilingStats();
+	
+	/**
+	 * @brief Write (the most expensive by total time) script entry points statistics as text.
+	 * 
+	 * @param out    output stream
+	 * @param limit  maximum number of entries to write
+	 */
+	void writeProfilingSummary(std::ostream& out, size_t limit = 20);
+	
+	/**
+	 * @brief Write all script entry points statistics as CSV (caller, function, calls, total ms, avg ms, max ms).
+	 * 
+	 * @return true on success, false on write error
+	 */
+	bool writeProfilingCSV(const std::string& filePath);
+	
+	/// @copydoc writeProfilingCSV(const std::string& filePath)
+	void writeProfilingCSV(std::ostream& out);
+	
+	/**
+	 * @brief RAII scope setting caller tag for scripts profiling.
+	 *        Python entry points called (in current thread) while this object exists are recorded with this caller tag.
+	 * 
+	 * \par Example
+		\code{.cpp}
+			MGE::ScriptsSystem::ProfilingCallerScope profilingCaller("Trigger");
+			MGE::ScriptsSystem::getPtr()->runObjectWithVoid(scriptName, actor);
+		\endcode
+	 */
+	struct ProfilingCallerScope {
+		/// constructor - set caller tag to @a caller (string with static storage duration, e.g. string literal)
+		ProfilingCallerScope(const char* caller) : prevCaller(currentCaller) {
+			currentCaller = caller;
+		}
+		/// destructor - restore previous caller tag
+		~ProfilingCallerScope() {
+			currentCaller = prevCaller;
+		}
+		ProfilingCallerScope(const ProfilingCallerScope&) = delete;
+		ProfilingCallerScope& operator=(const ProfilingCallerScope&) = delete;
+	private:
+		const char* prevCaller;
+	};
+	
 protected:
+	/// Statistics of single (caller tag, python object name) pair.
+	struct ProfilingStats {
+		/// caller tag (see @ref ProfilingCallerScope)
+		const char* caller;
+		/// number of calls
+		uint64_t    calls;
+		/// sum of calls wall time (in nanoseconds)
+		uint64_t    totalTime;
+		/// maximum call wall time (in nanoseconds)
+		uint64_t    maxTime;
+	};
+	
+	/// RAII profiling of single entry point call (do nothing when profiling is disabled).
+	/// Must be created with GIL acquired (statistics are protected by GIL).
+	struct ProfilingScope {
+		/// constructor - start measuring call of @a name
+		inline ProfilingScope(ScriptsSystem* scriptsSystem, null_end_string name) : data(nullptr) {
+			if (scriptsSystem->profilingEnabled)
+				begin(scriptsSystem, name);
+		}
+		/// destructor - update statistics
+		inline ~ProfilingScope() {
+			if (data)
+				end();
+		}
+		ProfilingScope(const ProfilingScope&) = delete;
+		ProfilingScope& operator=(const ProfilingScope&) = delete;
+	private:
+		/// profiling state of call (statistics, MGE::Profiler zone and start time), defined in ScriptsSystem.cpp
+		struct Data;
+		Data* data;
+		void begin(ScriptsSystem* scriptsSystem, null_end_string name);
+		void end();
+	};
+	
+	/// return (create if need) statistics for @a name called by current caller tag, set @a zoneName to name with static storage duration
+	ProfilingStats* getProfilingStats(null_end_string name, const char*& zoneName);
+	
+	/// scripts profiling state
+	bool profilingEnabled;
+	
+	/// scripts profiling statistics (python object name → statistics per caller tag),
+	/// elements are never removed (keys are used as MGE::Profiler zone names), so std::deque is used for stable pointers
+	std::unordered_map<std::string, std::deque<ProfilingStats>, MGE::string_hash, std::equal_to<>> profilingStats;
+	
+	/// current caller tag for scripts profiling (see @ref ProfilingCallerScope)
+	inline static thread_local const char* currentCaller = nullptr;
+	
 	/// Python globals dictionary.
 	static PyObject* pythonGlobals;
 	
+	/// Cache of objects resolved by @ref getObject (name → object).
+	std::unordered_map<std::string, pybind11::object, MGE::string_hash, std::equal_to<>> objectsCache;
+	
 	/// Used on NO_DEFAULT_GIL_LOCK mode to hold global GIL release
 	/// (need because GIL is hold by default after call initialize_interpreter)
 	pybind11::gil_scoped_release *gil_release;
@@ -25,8 +25,11 @@ SOFTWARE.
 #include "force_inline.h"
 #include "Range.h"
 
+#include <algorithm>
 #include <map>
 #include <functional>
+#include <stdexcept>
+#include <vector>
 #include <stdint.h>
 
 // do NOT use logSystem.h here - ListenerSet can be used in global-constructors (before create default log)
@@ -37,21 +40,372 @@ namespace MGE {
 /// @{
 /// @file
 
+/**
+ * @brief Default storage policy for @ref ListenerSetBase - std::multimap with listeners call helpers.
+ * 
+ * @note  Use std::multimap, not std::unordered_multimap, because we want call listener in order of keys.
+ *        Listener can remove itself (or add new listeners) during @ref forEach and @ref forEachUntil
+ *        (iterator to next element is obtained before call listener function).
+ * 
+ * @tparam KeyStorageType  Type of multimap key.
+ * @tparam ListenerType    Type of listener class/function/...
+ */
+template <typename KeyStorageType, typename ListenerType>
+struct ListenerMultimap : public std::multimap<KeyStorageType, ListenerType, std::less<>> {
+	/// Add @a listener with @a key, return false when key-listener pair was already in set.
+	template <typename KeyType> bool add(const ListenerType& listener, const KeyType& key) {
+		auto range = MGE::Range(*this, key);
+		for (auto iter=range.begin(); iter!=range.end(); ++iter) {
+			if (iter->second == listener)
+				return false;
+		}
+		this->insert(std::pair<KeyStorageType, ListenerType>(key, listener));
+		return true;
+	}
+	
+	/// Remove first occurrence of @a listener.
+	void remove(const ListenerType& listener) {
+		for (auto iter=this->begin(); iter!=this->end(); ++iter) { // don't use range-based for loop here, because we want use iterator ... and don't use in other functions for homogeneity ...
+			if (iter->second == listener) {
+				this->erase(iter);
+				return;
+			}
+		}
+	}
+	
+	/// Remove @a listener registered with @a key.
+	template <typename KeyType> void remove(const ListenerType& listener, const KeyType& key) {
+		auto range = MGE::Range(*this, key);
+		for (auto iter=range.begin(); iter!=range.end(); ++iter) {
+			if (iter->second == listener) {
+				this->erase(iter);
+				return;
+			}
+		}
+	}
+	
+	// in forEachUntil() and forEach() member functions use while loop and iter++ (instead of for and ++iter),
+	// because called listener function can remove itself from listeners map,
+	// so we must obtain next iterator before call listener function
+	
+	/// Call @a function for successive listeners until it return true, return true when some call returned true.
+	template <typename FunctionType> bool forEachUntil(FunctionType&& function) {
+		auto iter = this->begin();
+		while (iter != this->end()) {
+			if ( function((iter++)->second) )
+				return true;
+		}
+		return false;
+	}
+	
+	/// Call @a function for all listeners, return number of calls returned true.
+	template <typename FunctionType> int forEach(FunctionType&& function) {
+		int ret = 0;
+		auto iter = this->begin();
+		while (iter != this->end()) {
+			ret += function((iter++)->second);
+		}
+		return ret;
+	}
+	
+	/// Call @a function for successive listeners with key == @a key until it return true (called function must not modify set).
+	template <typename KeyType, typename FunctionType> bool forEachWithKeyUntil(const KeyType& key, FunctionType&& function) {
+		for (auto&& [k, listener] : MGE::Range(*this, key)) {
+			if ( function(listener) )
+				return true;
+		}
+		return false;
+	}
+	
+	/// Call @a function for all listeners with key == @a key (called function must not modify set), return number of calls returned true.
+	template <typename KeyType, typename FunctionType> int forEachWithKey(const KeyType& key, FunctionType&& function) {
+		int ret = 0;
+		for (auto&& [k, listener] : MGE::Range(*this, key)) {
+			ret += function(listener);
+		}
+		return ret;
+	}
+};
+
+/**
+ * @brief Flat storage policy for @ref ListenerSetBase - contiguous vector of (key, listener) pairs sorted by key.
+ * 
+ * Listeners with equal key are kept in order of registration. Iteration (@ref forEach, @ref forEachUntil
+ * or manual iteration protected by @ref lockIteration) does not chase tree pointers, so it is preferred
+ * for sets called every frame (main loop, input) and modified rarely.
+ * 
+ * Modifications during iteration are safe:
+ *   - removed listeners are marked as removed (tombstone) and skipped by all forEach functions,
+ *   - added listeners are buffered and are not called in the current iteration,
+ * 
+ * storage is compacted (tombstones are erased and buffered listeners are merged) after finish of the outermost iteration.
+ * 
+ * @note Storage is not synchronised. While listeners are called from other threads, owner of the set should
+ *       hold @ref lockModifications, then add and remove operations throw std::logic_error instead of racing.
+ * 
+ * \par Example
+	\code{.cpp}
+		MGE::ClassPtrListenerSet<ListenerClass, int, int, MGE::FlatListenerMap> myListener;
+	\endcode
+ * 
+ * @tparam KeyStorageType  Type of key.
+ * @tparam ListenerType    Type of listener class/function/...
+ */
+template <typename KeyStorageType, typename ListenerType>
+struct FlatListenerMap {
+	/// Type of stored (key, listener) pair.
+	typedef std::pair<KeyStorageType, ListenerType>              value_type;
+	
+	/// Iterator type (for @ref MGE::Range and manual iteration).
+	typedef typename std::vector<value_type>::iterator           iterator;
+	
+	/// Const iterator type.
+	typedef typename std::vector<value_type>::const_iterator     const_iterator;
+	
+	/**
+	 * @brief RAII guard for manual iteration over listeners.
+	 * 
+	 * While any guard exists, add and remove operations don't change layout of @ref FlatListenerMap
+	 * (so iterators remain valid), removed elements must be skipped by checking @ref isRemoved.
+	 */
+	struct IterationGuard {
+		/// constructor - start iteration on @a _owner
+		IterationGuard(FlatListenerMap* _owner) : owner(_owner) { ++owner->iterationDepth; }
+		/// destructor - finish iteration on owner, compact storage when it was outermost iteration
+		~IterationGuard() {
+			if (--owner->iterationDepth == 0 && owner->needCompact)
+				owner->compact();
+		}
+		IterationGuard(const IterationGuard&) = delete;
+		IterationGuard& operator=(const IterationGuard&) = delete;
+	private:
+		FlatListenerMap* owner;
+	};
+	
+	/// Start manual iteration, return guard object (iteration finishes at destroy of the guard).
+	[[nodiscard]] IterationGuard lockIteration() {
+		return IterationGuard(this);
+	}
+	
+	/**
+	 * @brief RAII guard forbidding add and remove operations (e.g. while listeners are called from worker threads).
+	 * 
+	 * Must be created and destroyed by thread owning the set, while no other thread use the set.
+	 */
+	struct ModificationsGuard {
+		/// constructor - forbid modifications of @a _owner
+		ModificationsGuard(FlatListenerMap* _owner) : owner(_owner) { ++owner->modificationsLockDepth; }
+		/// destructor - allow modifications of owner (when it was outermost guard)
+		~ModificationsGuard() { --owner->modificationsLockDepth; }
+		ModificationsGuard(const ModificationsGuard&) = delete;
+		ModificationsGuard& operator=(const ModificationsGuard&) = delete;
+	private:
+		FlatListenerMap* owner;
+	};
+	
+	/// Forbid add and remove operations, return guard object (modifications are allowed again at destroy of the guard).
+	[[nodiscard]] ModificationsGuard lockModifications() {
+		return ModificationsGuard(this);
+	}
+	
+	/// Return true when element pointed by @a iter was removed during current iteration.
+	bool isRemoved(const_iterator iter) const {
+		return removed[iter - entries.begin()];
+	}
+	
+	/// @{
+	/// standard container interface (read only)
+	iterator begin() { return entries.begin(); }
+	iterator end() { return entries.end(); }
+	const_iterator begin() const { return entries.begin(); }
+	const_iterator end() const { return entries.end(); }
+	size_t size() const { return entries.size() + pending.size(); }
+	bool empty() const { return entries.empty() && pending.empty(); }
+	template <typename KeyType> std::pair<iterator, iterator> equal_range(const KeyType& key) {
+		return std::equal_range(entries.begin(), entries.end(), key, KeyCompare());
+	}
+	/// @}
+	
+	/// Add @a listener with @a key, return false when key-listener pair was already in set.
+	template <typename KeyType> bool add(const ListenerType& listener, const KeyType& key) {
+		checkModificationsAllowed();
+		auto range = equal_range(key);
+		for (auto iter=range.first; iter!=range.second; ++iter) {
+			if (iter->second == listener && !isRemoved(iter))
+				return false;
+		}
+		
+		if (iterationDepth) {
+			for (auto& p : pending) {
+				if (p.second == listener && !KeyCompare()(p, key) && !KeyCompare()(key, p))
+					return false;
+			}
+			pending.emplace_back(key, listener);
+			needCompact = true;
+		} else {
+			// insert after all elements with equal key => keep registration order
+			removed.insert(removed.begin() + (range.second - entries.begin()), false);
+			entries.emplace(range.second, key, listener);
+		}
+		return true;
+	}
+	
+	/// Remove first occurrence of @a listener.
+	void remove(const ListenerType& listener) {
+		checkModificationsAllowed();
+		for (auto iter=entries.begin(); iter!=entries.end(); ++iter) {
+			if (iter->second == listener && !isRemoved(iter)) {
+				erase(iter);
+				return;
+			}
+		}
+		removePending(listener, [](const value_type&) { return true; });
+	}
+	
+	/// Remove @a listener registered with @a key.
+	template <typename KeyType> void remove(const ListenerType& listener, const KeyType& key) {
+		checkModificationsAllowed();
+		auto range = equal_range(key);
+		for (auto iter=range.first; iter!=range.second; ++iter) {
+			if (iter->second == listener && !isRemoved(iter)) {
+				erase(iter);
+				return;
+			}
+		}
+		removePending(listener, [&key](const value_type& p) { return !KeyCompare()(p, key) && !KeyCompare()(key, p); });
+	}
+	
+	/// Call @a function for successive listeners until it return true, return true when some call returned true.
+	template <typename FunctionType> bool forEachUntil(FunctionType&& function) {
+		IterationGuard guard(this);
+		// index based loop - entries is not resized during iteration, so reference to current listener is valid while calling
+		for (size_t i=0, n=entries.size(); i<n; ++i) {
+			if ( !removed[i] && function(entries[i].second) )
+				return true;
+		}
+		return false;
+	}
+	
+	/// Call @a function for all listeners, return number of calls returned true.
+	template <typename FunctionType> int forEach(FunctionType&& function) {
+		IterationGuard guard(this);
+		int ret = 0;
+		for (size_t i=0, n=entries.size(); i<n; ++i) {
+			if ( !removed[i] )
+				ret += function(entries[i].second);
+		}
+		return ret;
+	}
+	
+	/// Call @a function for successive listeners with key == @a key until it return true.
+	template <typename KeyType, typename FunctionType> bool forEachWithKeyUntil(const KeyType& key, FunctionType&& function) {
+		IterationGuard guard(this);
+		auto range = equal_range(key);
+		for (auto iter=range.first; iter!=range.second; ++iter) {
+			if ( !isRemoved(iter) && function(iter->second) )
+				return true;
+		}
+		return false;
+	}
+	
+	/// Call @a function for all listeners with key == @a key, return number of calls returned true.
+	template <typename KeyType, typename FunctionType> int forEachWithKey(const KeyType& key, FunctionType&& function) {
+		IterationGuard guard(this);
+		int ret = 0;
+		auto range = equal_range(key);
+		for (auto iter=range.first; iter!=range.second; ++iter) {
+			if ( !isRemoved(iter) )
+				ret += function(iter->second);
+		}
+		return ret;
+	}
+	
+private:
+	/// heterogeneous comparison (value_type vs key) by std::less<>
+	struct KeyCompare {
+		template <typename KeyType> bool operator()(const value_type& a, const KeyType& key) const { return std::less<>()(a.first, key); }
+		template <typename KeyType> bool operator()(const KeyType& key, const value_type& a) const { return std::less<>()(key, a.first); }
+	};
+	
+	/// throw std::logic_error when modifications are forbidden by @ref lockModifications
+	void checkModificationsAllowed() const {
+		if (modificationsLockDepth)
+			throw std::logic_error("FlatListenerMap: add / remove listener while modifications are locked (e.g. from thread safe main loop listener)");
+	}
+	
+	/// remove element pointed by @a iter (or mark it as removed when iteration is in progress)
+	void erase(iterator iter) {
+		if (iterationDepth) {
+			removed[iter - entries.begin()] = true;
+			needCompact = true;
+		} else {
+			removed.erase(removed.begin() + (iter - entries.begin()));
+			entries.erase(iter);
+		}
+	}
+	
+	/// remove first @a listener from pending (added during iteration) listeners, when @a filter return true
+	template <typename FilterType> void removePending(const ListenerType& listener, FilterType&& filter) {
+		for (auto iter=pending.begin(); iter!=pending.end(); ++iter) {
+			if (iter->second == listener && filter(*iter)) {
+				pending.erase(iter);
+				return;
+			}
+		}
+	}
+	
+	/// erase tombstones and merge pending listeners into sorted storage
+	void compact() {
+		size_t j = 0;
+		for (size_t i=0; i<entries.size(); ++i) {
+			if (!removed[i]) {
+				if (i != j)
+					entries[j] = std::move(entries[i]);
+				++j;
+			}
+		}
+		entries.erase(entries.begin() + j, entries.end());
+		removed.assign(entries.size(), false);
+		
+		for (auto& p : pending) {
+			auto iter = std::upper_bound(entries.begin(), entries.end(), p.first, KeyCompare());
+			entries.insert(iter, std::move(p));
+		}
+		removed.resize(entries.size(), false);
+		pending.clear();
+		needCompact = false;
+	}
+	
+	/// sorted by key (and by order of registration for equal keys) listeners
+	std::vector<value_type>  entries;
+	/// tombstones flags for @ref entries (elements removed during iteration)
+	std::vector<uint8_t>     removed;
+	/// listeners added during iteration
+	std::vector<value_type>  pending;
+	/// number of currently running iterations
+	int                      iterationDepth = 0;
+	/// true when @ref removed or @ref pending are non empty
+	bool                     needCompact = false;
+	/// number of existing @ref ModificationsGuard objects
+	int                      modificationsLockDepth = 0;
+};
+
 /**
  * @brief Base class for @ref FunctionListenerSet and @ref ClassListenerSet templates. Provide add / remove listener interface.
  * 
  * @tparam ListenerType    Type of listener class/function/...
  * @tparam KeyType         Type of member functions key argument. Must be comparable with @a KeyStorageType by std::less<>, and convertible to @a KeyStorageType (for add operation).
  * @tparam KeyStorageType  Type of multimap key.
+ * @tparam StorageType     Storage policy template: @ref ListenerMultimap (default) or @ref FlatListenerMap.
  */
-template <typename ListenerType, typename KeyType, typename KeyStorageType = KeyType>
+template <typename ListenerType, typename KeyType, typename KeyStorageType = KeyType, template <typename, typename> class StorageType = ListenerMultimap>
 struct ListenerSetBase {
 	/**
 	 * @brief Set of listeners (as map key - pointer).
 	 * 
-	 * @note  Use std::multimap, not std::unordered_multimap, because we want call listener in order of keys.
+	 * @note  By default std::multimap (via @ref ListenerMultimap), not std::unordered_multimap, because we want call listener in order of keys.
 	 */
-	std::multimap<KeyStorageType, ListenerType, std::less<>> listeners;
+	StorageType<KeyStorageType, ListenerType> listeners;
 	
 	/**
 	 * @brief Add @a listener to listener set.
@@ -62,13 +416,7 @@ struct ListenerSetBase {
 	 * @return True when listener is add to set, false when key-listener pair was already in set.
 	 */
 	bool addListener(ListenerType listener, KeyType key) {
-		auto range = MGE::Range(listeners, key);
-		for (auto iter=range.begin(); iter!=range.end(); ++iter) {
-			if (iter->second == listener)
-				return false;
-		}
-		listeners.insert(std::pair<KeyType, ListenerType>(key, listener));
-		return true;
+		return listeners.add(listener, key);
 	}
 	
 	/**
@@ -77,12 +425,7 @@ struct ListenerSetBase {
 	 * @param listener Pointer to listener object / function.
 	 */
 	void remListener(ListenerType listener) {
-		for (auto iter=listeners.begin(); iter!=listeners.end(); ++iter) { // don't use range-based for loop here, because we want use iterator ... and don't use in other functions for homogeneity ...
-			if (iter->second == listener) {
-				listeners.erase(iter);
-				return;
-			}
-		}
+		listeners.remove(listener);
 	}
 	
 	/**
@@ -92,13 +435,7 @@ struct ListenerSetBase {
 	 * @param key      Key in multimap (remove only for this key value).
 	 */
 	void remListener(ListenerType listener, KeyType key) {
-		auto range = MGE::Range(listeners, key);
-		for (auto iter=range.begin(); iter!=range.end(); ++iter) {
-			if (iter->second == listener) {
-				listeners.erase(iter);
-				return;
-			}
-		}
+		listeners.remove(listener, key);
 	}
 };
 
@@ -118,12 +455,13 @@ struct ListenerSetBase {
  * @tparam ListenerType    Type of listener function pointer (should return value auto convertible to bool).
  * @tparam KeyType         Type of member functions key argument. Must be comparable with @a KeyStorageType by std::less<>, and convertible to @a KeyStorageType (for add operation).
  * @tparam KeyStorageType  Type of multimap key.
+ * @tparam StorageType     Storage policy template: @ref ListenerMultimap (default) or @ref FlatListenerMap.
  *
  * @note Can't be used with ``ListenerType==std::function`` (e.g. for std::bind), because lack of comparisons between std::function.
  *       In that case, use @ref ClassListenerSet with @ref FunctorListenerClassBase.
  */
-template <typename ListenerType, typename KeyType = unsigned char, typename KeyStorageType = KeyType>
-struct FunctionListenerSet : public ListenerSetBase<ListenerType, KeyType, KeyStorageType> {
+template <typename ListenerType, typename KeyType = unsigned char, typename KeyStorageType = KeyType, template <typename, typename> class StorageType = ListenerMultimap>
+struct FunctionListenerSet : public ListenerSetBase<ListenerType, KeyType, KeyStorageType, StorageType> {
 	/**
 	 * @brief Call register functions with @a args for successive elements from listener set until return true.
 	 * 
@@ -132,17 +470,11 @@ struct FunctionListenerSet : public ListenerSetBase<ListenerType, KeyType, KeySt
 	 * @return True when some listener returned true. False when all listeners returned false.
 	 */
 	template <typename ...Args> bool callFirst(Args ... args) {
-		auto iter = this->listeners.begin();
-		while (iter != this->listeners.end()) {
-			if ( (iter++)->second(args...) )
-				return true;
-		}
-		return false;
+		return this->listeners.forEachUntil([&](ListenerType& listener) { return listener(args...); });
 	}
 	
-	// in callFirst() and callAll() member functions use while loop and iter++ (instead of for and ++iter),
-	// because called listener function can remove itself from listeners map,
-	// so we must obtain next iterator before call listener function
+	// called listener function can add or remove listeners (including itself) in callFirst() and callAll(),
+	// this is handled by storage policy (see ListenerMultimap::forEach and FlatListenerMap::forEach)
 	
 	/**
 	 * @brief Call register functions with @a args for all elements from listener set.
@@ -152,12 +484,7 @@ struct FunctionListenerSet : public ListenerSetBase<ListenerType, KeyType, KeySt
 	 * @return Number of listeners returned true.
 	 */
 	template <typename ...Args> int callAll(Args ... args) {
-		int ret = 0;
-		auto iter = this->listeners.begin();
-		while (iter != this->listeners.end()) {
-			ret += (iter++)->second(args...);
-		}
-		return ret;
+		return this->listeners.forEach([&](ListenerType& listener) { return listener(args...); });
 	}
 	
 	/**
@@ -172,12 +499,7 @@ struct FunctionListenerSet : public ListenerSetBase<ListenerType, KeyType, KeySt
 	 *             If this is needed use @ref callFirst.
 	 */
 	template <typename ...Args> bool callFirstWithKey(KeyType key, Args&& ... args) {
-		auto range = MGE::Range(this->listeners, key);
-		for (auto iter=range.begin(); iter!=range.end(); ++iter) {
-			if ( (iter->second)(args...) )
-				return true;
-		}
-		return false;
+		return this->listeners.forEachWithKeyUntil(key, [&](ListenerType& listener) { return listener(args...); });
 	}
 	
 	/**
@@ -192,12 +514,7 @@ struct FunctionListenerSet : public ListenerSetBase<ListenerType, KeyType, KeySt
 	 *             If this is needed use @ref callAll.
 	 */
 	template <typename ...Args> int callAllWithKey(KeyType key, Args&& ... args) {
-		int ret = 0;
-		auto range = MGE::Range(this->listeners, key);
-		for (auto iter=range.begin(); iter!=range.end(); ++iter) {
-			ret += (iter->second)(args...);
-		}
-		return ret;
+		return this->listeners.forEachWithKey(key, [&](ListenerType& listener) { return listener(args...); });
 	}
 };
 
@@ -222,9 +539,10 @@ struct FunctionListenerSet : public ListenerSetBase<ListenerType, KeyType, KeySt
  * @tparam ListenerStorageType  Set to ``ListenerType*`` for store pointers to listeners or to ``ListenerType`` for store listeners objects.
  * @tparam KeyType              Type of member functions key argument. Must be comparable with @a KeyStorageType by std::less<>, and convertible to @a KeyStorageType (for add operation).
  * @tparam KeyStorageType       Type of multimap key.
+ * @tparam StorageType          Storage policy template: @ref ListenerMultimap (default) or @ref FlatListenerMap.
  */
-template <typename ListenerType, typename ListenerStorageType = ListenerType*, typename KeyType = unsigned char, typename KeyStorageType = KeyType>
-struct ClassListenerSet : public ListenerSetBase<ListenerStorageType, KeyType, KeyStorageType> {
+template <typename ListenerType, typename ListenerStorageType = ListenerType*, typename KeyType = unsigned char, typename KeyStorageType = KeyType, template <typename, typename> class StorageType = ListenerMultimap>
+struct ClassListenerSet : public ListenerSetBase<ListenerStorageType, KeyType, KeyStorageType, StorageType> {
 	/**
 	 * @brief Call @a memberFunction with @a args for successive elements from listener set until return true.
 	 * 
@@ -234,17 +552,11 @@ struct ClassListenerSet : public ListenerSetBase<ListenerStorageType, KeyType, K
 	 * @return True when some listener returned true. False when all listeners returned false.
 	 */
 	template <typename FunctionType, typename ...Args> bool callFirst(FunctionType memberFunction, Args&& ... args) {
-		auto iter = this->listeners.begin();
-		while (iter != this->listeners.end()) {
-			if ( call((iter++)->second, memberFunction, args...) )
-				return true;
-		}
-		return false;
+		return this->listeners.forEachUntil([&](ListenerStorageType& listener) { return call(listener, memberFunction, args...); });
 	}
 	
-	// in callFirst() and callAll() member functions use while loop and iter++ (instead of for and ++iter),
-	// because called listener function can remove itself from listeners map,
-	// so we must obtain next iterator before call listener function
+	// called listener function can add or remove listeners (including itself) in callFirst() and callAll(),
+	// this is handled by storage policy (see ListenerMultimap::forEach and FlatListenerMap::forEach)
 	
 	/**
 	 * @brief Call @a memberFunction with @a args for all elements from listener set.
@@ -255,12 +567,7 @@ struct ClassListenerSet : public ListenerSetBase<ListenerStorageType, KeyType, K
 	 * @return Number of listeners returned true.
 	 */
 	template <typename FunctionType, typename ...Args> int callAll(FunctionType memberFunction, Args&& ... args) {
-		int ret = 0;
-		auto iter = this->listeners.begin();
-		while (iter != this->listeners.end()) {
-			ret += call((iter++)->second, memberFunction, args...);
-		}
-		return ret;
+		return this->listeners.forEach([&](ListenerStorageType& listener) { return call(listener, memberFunction, args...); });
 	}
 	
 	/**
@@ -276,12 +583,7 @@ struct ClassListenerSet : public ListenerSetBase<ListenerStorageType, KeyType, K
 	 *             If this is needed use @ref callFirst.
 	 */
 	template <typename FunctionType, typename ...Args> bool callFirstWithKey(KeyType key, FunctionType memberFunction, Args&& ... args) {
-		auto range = MGE::Range(this->listeners, key);
-		for (auto iter=range.begin(); iter!=range.end(); ++iter) {
-			if ( call(iter->second, memberFunction, args...) )
-				return true;
-		}
-		return false;
+		return this->listeners.forEachWithKeyUntil(key, [&](ListenerStorageType& listener) { return call(listener, memberFunction, args...); });
 	}
 	
 	/**
@@ -297,12 +599,7 @@ struct ClassListenerSet : public ListenerSetBase<ListenerStorageType, KeyType, K
 	 *             If this is needed use @ref callAll.
 	 */
 	template <typename FunctionType, typename ...Args> int callAllWithKey(KeyType key, FunctionType memberFunction, Args&& ... args) {
-		int ret = 0;
-		auto range = MGE::Range(this->listeners, key);
-		for (auto iter=range.begin(); iter!=range.end(); ++iter) {
-			ret += call(iter->second, memberFunction, args...);
-		}
-		return ret;
+		return this->listeners.forEachWithKey(key, [&](ListenerStorageType& listener) { return call(listener, memberFunction, args...); });
 	}
 	
 private:
@@ -317,10 +614,10 @@ private:
 };
 
 /// Shortcut for @ref ClassListenerSet stored pointers to listeners.
-template<typename ListenerType, typename KeyType = unsigned char, typename KeyStorageType = KeyType> using ClassPtrListenerSet = ClassListenerSet<ListenerType, ListenerType*, KeyType, KeyStorageType>;
+template<typename ListenerType, typename KeyType = unsigned char, typename KeyStorageType = KeyType, template <typename, typename> class StorageType = ListenerMultimap> using ClassPtrListenerSet = ClassListenerSet<ListenerType, ListenerType*, KeyType, KeyStorageType, StorageType>;
 
 /// Shortcut for @ref ClassListenerSet stored listeners objects.
-template<typename ListenerType, typename KeyType = unsigned char, typename KeyStorageType = KeyType> using ClassObjListenerSet = ClassListenerSet<ListenerType, ListenerType,  KeyType, KeyStorageType>;
+template<typename ListenerType, typename KeyType = unsigned char, typename KeyStorageType = KeyType, template <typename, typename> class StorageType = ListenerMultimap> using ClassObjListenerSet = ClassListenerSet<ListenerType, ListenerType,  KeyType, KeyStorageType, StorageType>;
 
 /**
  * @brief Base class for register std::function in ClassListenerSet
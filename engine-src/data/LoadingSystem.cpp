@@ -41,6 +41,9 @@ SOFTWARE.
 #include "rendering/RenderingSystem.h"
 #include "rendering/audio-video/AudioSystem.h"
 #include "physics/TimeSystem.h"
+#include "physics/utils/CoarseNavigationGrid.h"
+#include "physics/utils/OgreMeshRaycast.h"
+#include "physics/utils/WorldSizeInfo.h"
 #include "ScriptsSystem.h"
 
 // factories to create in constructor
@@ -350,6 +353,14 @@ void MGE::LoadingSystem::finishLoading(SceneLoadStates loadType) {
 	// set scene load state
 	sceneLoadState = loadType;
 	
+	// build coarse navigation grid (when configured to build on map load)
+	auto coarseGrid = MGE::CoarseNavigationGrid::getPtr();
+	if (loadType == GAME && coarseGrid && coarseGrid->usePrebuild()) {
+		if (loadingScreen)
+			loadingScreen->setLoadingScreenProgress(0.85, "Building navigation grid ...");
+		coarseGrid->build(MGE::WorldSizeInfo::getWorldMin(), MGE::WorldSizeInfo::getWorldMax());
+	}
+	
 	// wait for load resources
 	if (loadingScreen)
 		loadingScreen->setLoadingScreenProgress(0.9, "Prearing rendering ...");
@@ -412,6 +423,7 @@ void MGE::LoadingSystem::clearScene() {
 	}
 	
 	MGE::RenderingSystem::getPtr()->destroyLoadingSceneManager();
+	MGE::OgreMeshRaycast::clearMeshGeometryCache();
 	
 	// this fix "Renderable wasn't being tracked by this datablock" ogre exception
 	// after manipulate "SkyPostprocess" material in MGE::DotSceneLoader::processEnvironment
@@ -35,13 +35,21 @@ namespace MGE {
  */
 struct ActorCreatedEventMsg : MGE::EventMsg  {
 	/// message type string
-	inline static const std::string_view MsgType = "ActorCreated"sv;
+	inline static constexpr std::string_view MsgType = "ActorCreated"sv;
+	
+	/// message type ID
+	inline static constexpr uint32_t MsgTypeID = MGE::EventMsg::hashType(MsgType);
 	
 	/// @copydoc MGE::EventMsg::getType
 	const std::string_view getType() const override final {
 		return MsgType;
 	}
 	
+	/// @copydoc MGE::EventMsg::getTypeID
+	uint32_t getTypeID() const override final {
+		return MsgTypeID;
+	}
+	
 	/// created actor
 	MGE::BaseActor* actor;
 	
@@ -59,13 +67,21 @@ protected:
  */
 struct ActorDestroyEventMsg : MGE::EventMsg  {
 	/// message type string
-	inline static const std::string_view MsgType = "ActorDestroy"sv;
+	inline static constexpr std::string_view MsgType = "ActorDestroy"sv;
+	
+	/// message type ID
+	inline static constexpr uint32_t MsgTypeID = MGE::EventMsg::hashType(MsgType);
 	
 	/// @copydoc MGE::EventMsg::getType
 	const std::string_view getType() const override final {
 		return MsgType;
 	}
 	
+	/// @copydoc MGE::EventMsg::getTypeID
+	uint32_t getTypeID() const override final {
+		return MsgTypeID;
+	}
+	
 	/// actor to destroy
 	MGE::BaseActor* actor;
 	
@@ -83,13 +99,21 @@ protected:
  */
 struct ActorAvailableEventMsg : MGE::EventMsg  {
 	/// message type string
-	inline static const std::string_view MsgType = "ActorAvailable"sv;
+	inline static constexpr std::string_view MsgType = "ActorAvailable"sv;
+	
+	/// message type ID
+	inline static constexpr uint32_t MsgTypeID = MGE::EventMsg::hashType(MsgType);
 	
 	/// @copydoc MGE::EventMsg::getType
 	const std::string_view getType() const override final {
 		return MsgType;
 	}
 	
+	/// @copydoc MGE::EventMsg::getTypeID
+	uint32_t getTypeID() const override final {
+		return MsgTypeID;
+	}
+	
 	/// available actor
 	MGE::BaseActor* actor;
 	
@@ -107,13 +131,21 @@ protected:
  */
 struct ActorNotAvailableEventMsg : MGE::EventMsg  {
 	/// message type string
-	inline static const std::string_view MsgType = "ActorNotAvailable"sv;
+	inline static constexpr std::string_view MsgType = "ActorNotAvailable"sv;
+	
+	/// message type ID
+	inline static constexpr uint32_t MsgTypeID = MGE::EventMsg::hashType(MsgType);
 	
 	/// @copydoc MGE::EventMsg::getType
 	const std::string_view getType() const override final {
 		return MsgType;
 	}
 	
+	/// @copydoc MGE::EventMsg::getTypeID
+	uint32_t getTypeID() const override final {
+		return MsgTypeID;
+	}
+	
 	/// not available destroy
 	MGE::BaseActor* actor;
 	
@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include "Engine.h"
 #include "data/structs/factories/ComponentFactory.h"
+#include "data/structs/factories/PrototypeFactory.h"
 #include "data/utils/OgreResources.h"
 #include "data/property/G11n.h"
 
@@ -71,12 +72,11 @@ MGE::BasePrototypeImpl::BasePrototypeImpl(
 	config(_name, _fileName, _fileGroup)
 {
 	LOG_INFO("Creating prototype " << config.name << " from file: " << config.fileName << " in group: " << config.fileGroup);
-	pugi::xml_document xmlDoc;
-	pugi::xml_node     xmlNode = getPrototypeXML(&config, xmlDoc);
+	auto prototypeXML = MGE::PrototypeFactory::getPtr()->getPrototypeXML(&config);
 	
 	// restore from XML config
-	if (xmlNode) {
-		restoreFromXML(xmlNode, nullptr);
+	if (prototypeXML) {
+		restoreFromXML(prototypeXML.node, nullptr);
 	} else {
 		throw std::logic_error("can't find config for: name=" + config.name + " in file: " + config.fileName + " in group: " + config.fileGroup);
 	}
@@ -55,6 +55,8 @@ struct BasePrototype :
 	/**
 	 * @brief return pointer to prototype XML configuration node
 	 * 
+	 * @note This function always read and parse config file, for cached version see @ref MGE::PrototypeFactory::getPrototypeXML.
+	 * 
 	 * @param config  config info identifying prototype and describing the prototype config location
 	 * @param xmlDoc  pugixml document object for opening xml file specified by @a config
 	 */
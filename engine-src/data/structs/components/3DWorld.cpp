@@ -23,12 +23,15 @@ SOFTWARE.
 #include "data/structs/components/3DWorld.h"
 
 #include "Engine.h"
+#include "physics/Physics.h"
 #include "physics/Raycast.h"
 #include "physics/PathFinder.h"
+#include "physics/utils/NavigationField.h"
 #include "data/utils/OgreUtils.h"
 #include "physics/utils/OgreColisionBoundingBox.h"
 #include "data/property/XmlUtils_Ogre.h"
 #include "data/structs/factories/ComponentFactory.h"
+#include "data/structs/factories/ActorFactory.h"
 #include "data/structs/factories/ComponentFactoryRegistrar.h"
 #include "data/utils/NamedSceneNodes.h"
 
@@ -59,8 +62,32 @@ Ogre::Vector3 MGE::World3DObject::getWorldDirection() const {
 	return - getWorldOrientation().zAxis();
 }
 
+void MGE::World3DObject::invalidateNavigationArea() const {
+	MGE::NavigationField* navigationField = MGE::NavigationField::getPtr();
+	if (!navigationField)
+		return;
+	
+	Ogre::AxisAlignedBox aabb = getWorldOrientedAABB();
+	if (aabb.isNull())
+		return;
+	
+	Ogre::Vector3 position = getOgreSceneNode()->_getDerivedPositionUpdated();
+	navigationField->invalidateArea(position + aabb.getMinimum(), position + aabb.getMaximum());
+}
+
 void MGE::World3DObject::setWorldPosition(const Ogre::Vector3& position) {
-	return getOgreSceneNode()->_setDerivedPosition(position);
+	invalidateNavigationArea();
+	getOgreSceneNode()->_setDerivedPosition(position);
+	MGE::Physics::markTransformDirty(getOgreSceneNode());
+	updateActorsIndex(position);
+	invalidateNavigationArea();
+}
+
+void MGE::World3DObject::updateActorsIndex(const Ogre::Vector3& position) const {
+	MGE::ActorFactory* actorFactory = MGE::ActorFactory::getPtr();
+	MGE::BaseActor*    actor        = MGE::BaseActor::get(getOgreSceneNode());
+	if (actorFactory && actor)
+		actorFactory->updateActorPosition(actor, position);
 }
 
 void MGE::World3DObject::setWorldPositionOnGround(Ogre::Vector3& position) {
@@ -95,10 +122,12 @@ void MGE::World3DObject::findAndSetFreePositionOnGround(Ogre::Vector3& position)
 
 void MGE::World3DObject::setWorldOrientation(const Ogre::Quaternion& orientation) {
 	getOgreSceneNode()->_setDerivedOrientation(orientation);
+	MGE::Physics::markTransformDirty(getOgreSceneNode());
 }
 
 void MGE::World3DObject::setWorldDirection(Ogre::Vector3 direction) {
 	getOgreSceneNode()->setDirection(direction, Ogre::Node::TS_WORLD, Ogre::Vector3::NEGATIVE_UNIT_Z);
+	MGE::Physics::markTransformDirty(getOgreSceneNode());
 	/*
 	direction.y = 0;
 	
@@ -112,17 +141,28 @@ void MGE::World3DObject::setWorldDirection(Ogre::Vector3 direction) {
 
 void MGE::World3DObject::updateCachedTransform(bool updateAABB, bool recursive, bool updateParent) {
 	MGE::OgreUtils::updateCachedTransform(getOgreSceneNode(), updateAABB, recursive, updateParent);
+	MGE::Physics::markTransformDirty(getOgreSceneNode());
+	updateActorsIndex(getOgreSceneNode()->_getDerivedPosition());
 }
 
 int16_t MGE::World3DObject::canMove(
 	const Ogre::Vector3& start, const Ogre::Vector3& end,
 	float& speedModifier, float& squaredLength, float& heightDiff,
 	std::forward_list<MGE::BaseActor*>* triggers,
-	Ogre::MovableObject** collisionWith
+	Ogre::MovableObject** collisionWith,
+	int queryMask
 ) const {
 	return MGE::PathFinder::IS_NOT_MOVABLE;
 }
 
+float MGE::World3DObject::getTriggersSpeedModifier(const std::vector<MGE::BaseActor*>& triggers) const {
+	return 0;
+}
+
+uint32_t MGE::World3DObject::getMoverType() const {
+	return 0;
+}
+
 
 /*--------------------- World3DObjectImpl : setup and create ---------------------*/
 
@@ -23,6 +23,7 @@ SOFTWARE.
 #pragma   once
 
 #include "data/structs/BaseComponent.h"
+#include "data/QueryFlags.h"
 
 namespace MGE { struct BaseActor; }
 namespace MGE { struct ActorFactory; }
@@ -38,6 +39,7 @@ namespace Ogre {
 }
 
 #include <forward_list>
+#include <vector>
 #include <stdint.h>
 
 namespace MGE {
@@ -90,6 +92,9 @@ struct World3DObject :
 		/**
 		 * @brief set object position in world (not parent) coordinate
 		 * 
+		 * @note This is "teleport" – it invalidates navigation data for old and new object area (see @ref invalidateNavigationArea),
+		 *       so should not be used for per-frame movement.
+		 * 
 		 * @param[in] position      position Vector
 		 */
 		virtual void setWorldPosition(const Ogre::Vector3& position);
@@ -127,6 +132,11 @@ struct World3DObject :
 		
 		/**
 		 * @brief update object cached information about transformation and world AABB
+		 *        (and object position in @ref MGE::ActorFactory spatial index)
+		 * 
+		 * This also mark node transform as changed for physics (see @ref MGE::Physics::Physics::markTransformDirty)
+		 * and update object position in actors spatial index (see @ref updateActorsIndex),
+		 * so it should be called after moving object scene node directly via Ogre API (e.g. from Python scripts).
 		 * 
 		 * @param updateAABB    when true update worldAABB of node and (if enabled) child nodes
 		 * @param recursive     when true update transformations (and AABBs if enabled) of child nodes
@@ -150,6 +160,23 @@ struct World3DObject :
 		 * @brief return scaled and rotated (to world axis) object axis aligned bounding box
 		 */
 		virtual Ogre::AxisAlignedBox getWorldOrientedAABB() const;
+		
+		/**
+		 * @brief mark area occupied by object as changed in @ref MGE::NavigationField
+		 *        (and in derived pathfinding caches, see @ref MGE::NavigationField::invalidateArea)
+		 * 
+		 * Called automatically on actor create / destroy and by @ref setWorldPosition (old and new area).
+		 */
+		void invalidateNavigationArea() const;
+		
+		/**
+		 * @brief update object position in @ref MGE::ActorFactory spatial index
+		 * 
+		 * Called automatically by engine API for changing position (e.g. @ref setWorldPosition, @ref updateCachedTransform).
+		 * 
+		 * @param[in] position      object position in world coordinate
+		 */
+		void updateActorsIndex(const Ogre::Vector3& position) const;
 	/** 
 	 * @}
 	 * 
@@ -168,6 +195,8 @@ struct World3DObject :
 		 * @param[out]    heightDiff     (not squared) height difference between @a start and @a end
 		 * @param[out]    triggers       (when not NULL) list to store BaseActor pointers from crossable trigger
 		 * @param[out]    collisionWith  (when not NULL) pointer to store Ogre::MovableObject pointer to collided object
+		 * @param[in]     queryMask      mask of QueryFlags for objects to check collisions with (0 to check only slope),
+		 *                               triggers are processed only when it include @ref MGE::QueryFlags::TRIGGER
 		 * 
 		 * @return if (value \< 0) error; if (value \> 0) success
 		 *         full list of values see @ref MGE::PathFinder::ReturnCodes
@@ -176,8 +205,25 @@ struct World3DObject :
 			const Ogre::Vector3& start, const Ogre::Vector3& end,
 			float& speedModifier, float& squaredLength, float& heightDiff,
 			std::forward_list<MGE::BaseActor*>* triggers = 0,
-			Ogre::MovableObject** collisionWith = 0
+			Ogre::MovableObject** collisionWith = 0,
+			int queryMask = MGE::QueryFlags::COLLISION_OBJECT | MGE::QueryFlags::TRIGGER
 		) const;
+		
+		/**
+		 * @brief return product of speed modifiers of all @a triggers for this object
+		 * 
+		 * @param[in]     triggers       list of trigger actors
+		 * 
+		 * @return speed modifier, 0 when at least one of @a triggers is not crossable for this object
+		 */
+		virtual float getTriggersSpeedModifier(const std::vector<MGE::BaseActor*>& triggers) const;
+		
+		/**
+		 * @brief return identifier of mover type – objects with the same (non zero) type can share found paths (see @ref MGE::PathCache)
+		 * 
+		 * @return mover type, 0 when paths for this object should not be cached
+		 */
+		virtual uint32_t getMoverType() const;
 	/**
 	 * @}
 	 */
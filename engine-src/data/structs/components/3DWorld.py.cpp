@@ -60,6 +60,10 @@ MGE_SCRIPT_API_FOR_MODULE(World3DObject, 17) {
 		.def("setWorldDirection",           &MGE::World3DObject::setWorldDirection,
 			DOC(MGE, World3DObject, setWorldDirection)
 		)
+		.def("updateCachedTransform",       &MGE::World3DObject::updateCachedTransform,
+			py::arg("updateAABB") = true, py::arg("recursive") = true, py::arg("updateParent") = false,
+			DOC(MGE, World3DObject, updateCachedTransform)
+		)
 		.def("getOgreSceneNode",            &MGE::World3DObject::getOgreSceneNode,
 			py::return_value_policy::reference,
 			DOC(MGE, World3DObject, getOgreSceneNode)
@@ -136,9 +136,9 @@ MGE::BaseActor* MGE::ActorFactory::_createActor(
 	// 2. load config from prototype
 	if (prototype) {
 		LOG_VERBOSE("ActorFactory", "Loading setting from prototype for " << mainSceneNode->getName());
-		// open prototype config xml file and get prototype xml node
-		pugi::xml_document xmlDoc;
-		pugi::xml_node     xmlNode = MGE::BasePrototype::getPrototypeXML(prototype->getLocationInfo(), xmlDoc);
+		// get prototype xml node (from cache of parsed prototypes config files)
+		auto           prototypeXML = MGE::PrototypeFactory::getPtr()->getPrototypeXML(prototype->getLocationInfo());
+		pugi::xml_node xmlNode      = prototypeXML.node;
 		
 		if (xmlNode) {
 			// load scene elements from XML node
@@ -186,8 +186,12 @@ MGE::BaseActor* MGE::ActorFactory::_createActor(
 		iter.second->init(gameObj);
 	}
 	
-	// 4. register Actor object in global allActors map (name->pointer)
+	// 4. register Actor object in global allActors map (name->pointer) and in spatial index
 	allActors[gameObjImpl->name] = gameObj;
+	addToIndex(gameObj);
+	
+	// 4.1. new actor can block cached paths
+	gameObj3Dworld->invalidateNavigationArea();
 	
 	// 5. send event message
 	MGE::Engine::getPtr()->getMessagesSystem()->sendMessage( MGE::ActorCreatedEventMsg(gameObj), gameObj );
@@ -205,6 +209,11 @@ void MGE::ActorFactory::destroyActor(MGE::BaseActor* obj, bool deleteSceneNode)
 	if (iter != MGE::ActorFactory::allActors.end()) {
 		MGE::ActorFactory::allActors.erase(iter);
 	}
+	removeFromIndex(obj);
+	
+	MGE::World3DObject* gameObj3Dworld = obj->getComponent<MGE::World3DObject>();
+	if (gameObj3Dworld && gameObj3Dworld->getOgreSceneNode())
+		gameObj3Dworld->invalidateNavigationArea();
 	
 	if (deleteSceneNode) {
 		MGE::OgreUtils::recursiveDeleteSceneNode(
@@ -225,6 +234,8 @@ bool MGE::ActorFactory::unload() {
 		delete a;
 	}
 	allActors.clear();
+	actorsIndex.clear();
+	indexedActors.clear();
 	return true;
 }
 
@@ -265,6 +276,8 @@ bool MGE::ActorFactory::restoreFromXML(const pugi::xml_node& xmlNode, const MGE:
 	
 	// remove unwanted Actors
 	for (auto& iter : preloaded) {
+		allActors.erase(iter->getName());
+		removeFromIndex(iter);
 		delete iter;
 	}
 	
@@ -287,23 +300,74 @@ MGE::ActorFactory::ActorFactory() : MGE::SaveableToXML<ActorFactory>(401, 601) {
 	MGE::SceneLoader::getPtr()->addSceneNodesCreateListener(
 		"actor", reinterpret_cast<MGE::SceneLoader::SceneNodesCreateFunction>(MGE::ActorFactory::processActorXMLNode)
 	);
+	// derived transforms of all nodes are updated while rendering, so re-synchronise actors spatial index after render
+	MGE::Engine::getPtr()->mainLoopListeners.addListener(this, GRAPHICS_RENDER+1);
 }
 
 MGE::ActorFactory::~ActorFactory() {
+	MGE::Engine::getPtr()->mainLoopListeners.remListener(this);
 	MGE::SceneLoader::getPtr()->remSceneNodesCreateListener(
 		reinterpret_cast<MGE::SceneLoader::SceneNodesCreateFunction>(MGE::ActorFactory::processActorXMLNode)
 	);
 }
 
 void MGE::ActorFactory::findActors(const Ogre::Vector3& point, float range, std::multimap<float, MGE::BaseActor*>* results) {
-	float srange = range * range;
-	for (auto& iter : allActors) {
-		MGE::World3DObject* w3dObj = iter.second->getComponent<MGE::World3DObject>();
-		if (w3dObj) {
-			float sdist = w3dObj->getWorldPosition().squaredDistance(point);
-			if (sdist < srange) {
-				results->insert(std::make_pair(sdist, iter.second));
-			}
+	static thread_local FindResults found;
+	actorsIndex.findInRadius(point, range, found, false);
+	for (auto& iter : found) {
+		results->insert(std::make_pair(iter.squaredDistance, iter.value));
+	}
+}
+
+
+/*--------------------- actors spatial index ---------------------*/
+
+void MGE::ActorFactory::addToIndex(MGE::BaseActor* actor) {
+	MGE::World3DObject* w3dObj = actor->getComponent<MGE::World3DObject>();
+	if (!w3dObj || !w3dObj->getOgreSceneNode())
+		return;
+	
+	if (!actorsIndex.getPosition(actor))
+		indexedActors.emplace_back(actor, w3dObj->getOgreSceneNode());
+	actorsIndex.update(actor, w3dObj->getOgreSceneNode()->_getDerivedPositionUpdated());
+}
+
+void MGE::ActorFactory::removeFromIndex(MGE::BaseActor* actor) {
+	if (!actorsIndex.remove(actor))
+		return;
+	
+	for (auto iter = indexedActors.begin(); iter != indexedActors.end(); ++iter) {
+		if (iter->first == actor) {
+			*iter = indexedActors.back();
+			indexedActors.pop_back();
+			break;
 		}
 	}
 }
+
+void MGE::ActorFactory::updateActorPosition(MGE::BaseActor* actor, const Ogre::Vector3& position) {
+	actorsIndex.move(actor, position);
+}
+
+void MGE::ActorFactory::updateActorPosition(Ogre::SceneNode* node) {
+	MGE::BaseActor* actor = MGE::BaseActor::get(node);
+	if (actor)
+		actorsIndex.move(actor, node->_getDerivedPositionUpdated());
+}
+
+void MGE::ActorFactory::updateIndex() {
+	// update() is cheap when position was not changed (e.g. already updated by updateActorPosition)
+	for (auto& iter : indexedActors) {
+		actorsIndex.update(iter.first, iter.second->_getDerivedPosition());
+	}
+}
+
+bool MGE::ActorFactory::update(float gameTimeStep, float realTimeStep) {
+	updateIndex();
+	return true;
+}
+
+bool MGE::ActorFactory::updateOnFullPause(float realTimeStep) {
+	updateIndex();
+	return true;
+}
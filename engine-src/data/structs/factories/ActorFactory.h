@@ -25,12 +25,16 @@ SOFTWARE.
 #include "BaseClasses.h"
 #include "StringTypedefs.h"
 #include "ModuleBase.h"
+#include "MainLoopListener.h"
 
 #include "data/structs/BaseActor.h"
+#include "data/utils/SpatialHashGrid.h"
 
 #include <OgreVector3.h>
+#include <OgreAxisAlignedBox.h>
 #include <OgreNameGenerator.h>
 #include <unordered_map>
+#include <vector>
 
 namespace MGE { struct LoadingContext; struct SceneObjectInfo; }
 
@@ -76,9 +80,18 @@ namespace MGE {
  * Therefore, in .scene file xml actors node you can't use syntax elements that refernce to other actors),
  * if you need this you must put it in .state (fake save) file loading after .scene file
  * (see @ref MGE::LoadingSystem and @ref XMLSyntax_MapConfig for more detail).
+ * 
+ * \par Spatial queries
+ * Positions of all actors are stored in spatial index (@ref MGE::SpatialHashGrid) used by @ref findActors, @ref findActorsInBox
+ * and @ref findNearestActors. Index is updated immediately by engine API for changing actor position
+ * (@ref MGE::World3DObject::setWorldPosition, @ref MGE::World3DObject::updateCachedTransform, move steps of @ref MGE::World3DMovable,
+ * see @ref updateActorPosition) and re-synchronised with scene nodes derived positions once per frame (after render,
+ * when Ogre updates derived transforms of all nodes), so actors moved in other way (directly via Ogre::Node API,
+ * by node animation, by physics simulation or by moving parent node) are visible at new position since next frame.
  */
 struct ActorFactory :
 	public MGE::SaveableToXML<ActorFactory>,
+	public MGE::MainLoopListener,
 	public MGE::Singleton<ActorFactory>
 {
 public:
@@ -98,6 +111,12 @@ public:
 		}
 	}
 	
+	/// type of spatial index of actors positions
+	typedef MGE::SpatialHashGrid<MGE::BaseActor*> ActorsIndex;
+	
+	/// type of buffer for spatial queries results (vector of squared distance and actor pointer pairs)
+	typedef ActorsIndex::Results FindResults;
+	
 	/**
 	 * @brief find actors in @a range from @a point
 	 *
@@ -121,6 +140,56 @@ public:
 		return ret;
 	}
 	
+	/**
+	 * @brief find actors in @a range from @a point
+	 *
+	 * @param[in]  point   center of search circle
+	 * @param[in]  range   radius of search circle
+	 * @param[out] results buffer for found actors (cleared before search, can be reused between calls to avoid allocations)
+	 * @param[in]  sorted  when true results are sorted by distance
+	 */
+	inline void findActors(const Ogre::Vector3& point, float range, FindResults& results, bool sorted = true) const {
+		actorsIndex.findInRadius(point, range, results, sorted);
+	}
+	
+	/**
+	 * @brief find actors inside axis aligned box
+	 *
+	 * @param[in]  box     search box
+	 * @param[out] results buffer for found actors (cleared before search, can be reused between calls to avoid allocations)
+	 */
+	inline void findActorsInBox(const Ogre::AxisAlignedBox& box, FindResults& results) const {
+		actorsIndex.findInBox(box.getMinimum(), box.getMaximum(), results);
+	}
+	
+	/**
+	 * @brief find up to @a count actors nearest to @a point
+	 *
+	 * @param[in]  point   search center
+	 * @param[in]  count   maximum number of results
+	 * @param[out] results buffer for found actors (cleared before search, can be reused between calls to avoid allocations),
+	 *                     sorted by distance
+	 * @param[in]  range   maximum distance from @a point
+	 */
+	inline void findNearestActors(const Ogre::Vector3& point, size_t count, FindResults& results, float range = std::numeric_limits<float>::infinity()) const {
+		actorsIndex.findNearest(point, count, results, range);
+	}
+	
+	/**
+	 * @brief update position of @a actor in spatial index (only when @a actor is in index)
+	 * 
+	 * Must be called after change of actor scene node position – this is done by engine API for changing position
+	 * (see @ref MGE::World3DObject::updateActorsIndex).
+	 */
+	void updateActorPosition(MGE::BaseActor* actor, const Ogre::Vector3& position);
+	
+	/**
+	 * @brief update position of actor with main scene node @a node in spatial index (do nothing when @a node is not actor node)
+	 * 
+	 * Version of @ref updateActorPosition for code moving scene nodes (e.g. map editor).
+	 */
+	void updateActorPosition(Ogre::SceneNode* node);
+	
 	/**
 	 * @brief create Actor identifying by @a name based on @a prototype
 	 * 
@@ -185,10 +254,32 @@ public:
 	/// @copydoc MGE::UnloadableInterface::unload
 	virtual bool unload() override;
 	
+	/// @copydoc MGE::MainLoopListener::update
+	virtual bool update(float gameTimeStep, float realTimeStep) override;
+	
+	/// @copydoc MGE::MainLoopListener::updateOnFullPause
+	virtual bool updateOnFullPause(float realTimeStep) override;
+	
 	/// constructor ... register listeners
 	ActorFactory();
 	
 protected:
+	/// spatial index of actors positions
+	ActorsIndex actorsIndex;
+	
+	/// actors (with its main scene nodes) stored in @ref actorsIndex, used to re-synchronise positions once per frame
+	std::vector< std::pair<MGE::BaseActor*, const Ogre::Node*> > indexedActors;
+	
+	/// add @a actor to @ref actorsIndex (when has World3DObject component)
+	void addToIndex(MGE::BaseActor* actor);
+	
+	/// remove @a actor from @ref actorsIndex
+	void removeFromIndex(MGE::BaseActor* actor);
+	
+	/// re-synchronise positions of all actors in @ref actorsIndex with its scene nodes derived positions
+	void updateIndex();
+	
+
 	/// createObject Actor based on @a prototype and @a node
 	MGE::BaseActor* _createActor(
 		const MGE::BasePrototype* prototype,
@@ -23,6 +23,8 @@ SOFTWARE.
 #include "data/structs/factories/PrototypeFactory.h"
 #include "LogSystem.h"
 
+#include "data/utils/OgreResources.h"
+
 MGE::PrototypeFactory::PrototypeFactory() {
 	LOG_INFO("Create PrototypeFactory");
 }
@@ -65,3 +67,61 @@ MGE::BasePrototype* MGE::PrototypeFactory::getPrototype(
 	
 	return ret;
 }
+
+const MGE::PrototypeFactory::CachedFile* MGE::PrototypeFactory::getCachedFile(const std::string& path) {
+	std::error_code ec;
+	auto modificationTime = std::filesystem::last_write_time(path, ec);
+	
+	auto iter = filesCache.find(path);
+	if (iter != filesCache.end()) {
+		if (!ec && iter->second.modificationTime == modificationTime)
+			return &(iter->second);
+		LOG_INFO("prototypes config file " << path << " was modified, reloading");
+		filesCache.erase(iter);
+	}
+	
+	auto xmlDoc = std::make_shared<pugi::xml_document>();
+	if (! MGE::XMLUtils::openXMLFile(*xmlDoc, path.c_str(), "Prototypes")) {
+		LOG_ERROR("can't find <Prototypes> in file: " + path);
+		return nullptr;
+	}
+	return &(filesCache[path] = CachedFile{xmlDoc, modificationTime});
+}
+
+MGE::PrototypeFactory::PrototypeXML MGE::PrototypeFactory::getPrototypeXML(const MGE::ResourceLocationInfo* config) {
+	auto protoIter = prototypesCache.find(config->name);
+	if (protoIter != prototypesCache.end()) {
+		std::error_code ec;
+		if (protoIter->second.modificationTime == std::filesystem::last_write_time(protoIter->second.path, ec) && !ec)
+			return protoIter->second.xml;
+		prototypesCache.erase(protoIter);
+	}
+	
+	// get config xml file paths
+	std::list<std::string> pathList;
+	MGE::OgreResources::getResourcePaths(config->fileName, config->fileGroup, &pathList, false, "Prototypes");
+	
+	// for all matching paths:
+	for (auto& path : pathList) {
+		const CachedFile* file = getCachedFile(path);
+		if (!file)
+			continue;
+		
+		// search for ActorPrototype node with correct name
+		for (auto xmlSubNode : file->document->child("Prototypes").children("ActorPrototype")) {
+			if (config->name == xmlSubNode.attribute("name").as_string()) {
+				LOG_VERBOSE("found <ActorPrototype> with name=" + config->name + " in file: " + path);
+				PrototypeXML ret{xmlSubNode, file->document};
+				prototypesCache[config->name] = CachedPrototype{path, ret, file->modificationTime};
+				return ret;
+			}
+		}
+	}
+	LOG_ERROR("can't find <ActorPrototype> with name=" + config->name + " in file: " + config->fileName + " in group: " + config->fileGroup);
+	return PrototypeXML();
+}
+
+void MGE::PrototypeFactory::clearPrototypeXMLCache() {
+	prototypesCache.clear();
+	filesCache.clear();
+}
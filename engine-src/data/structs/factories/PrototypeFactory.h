@@ -25,6 +25,8 @@ SOFTWARE.
 #include "data/structs/BasePrototype.h"
 #include "utils/BaseClasses.h"
 
+#include <filesystem>
+#include <memory>
 #include <unordered_map>
 
 namespace MGE {
@@ -72,6 +74,38 @@ public:
 		return getPrototype( MGE::ResourceLocationInfo( xmlNode ) );
 	}
 	
+	/**
+	 * @brief parsed prototype XML configuration (result of @ref getPrototypeXML)
+	 */
+	struct PrototypeXML {
+		/// prototype XML configuration node (empty when not found)
+		pugi::xml_node                             node;
+		/// document owning @a node, keep it while using @a node (document can be removed from cache when file was modified)
+		std::shared_ptr<const pugi::xml_document>  document;
+		
+		/// return true when prototype config node was found
+		inline explicit operator bool() const {
+			return !node.empty();
+		}
+	};
+	
+	/**
+	 * @brief return prototype XML configuration node from cache of parsed prototypes files
+	 * 
+	 * On first call for given prototype name, finds and parses prototype config file (see @ref MGE::BasePrototype::getPrototypeXML).
+	 * Next calls only check modification time of the file and (when file was not changed) return cached node.
+	 * 
+	 * @param config  config info identifying prototype and describing the prototype config location
+	 * 
+	 * @note Returned XML node must be treated as read-only (is shared by all users of the cache).
+	 */
+	PrototypeXML getPrototypeXML(const MGE::ResourceLocationInfo* config);
+	
+	/**
+	 * @brief clear cache of parsed prototypes files, so next @ref getPrototypeXML call will search and read files again
+	 */
+	void clearPrototypeXMLCache();
+	
 	/// constructor
 	PrototypeFactory();
 	
@@ -81,6 +115,33 @@ protected:
 	/// list of all prototypes for game object (as map name -> object pointer)
 	std::unordered_map<std::string, MGE::BasePrototype*, MGE::string_hash, std::equal_to<>> allPrototypes;
 	
+	/// info about parsed prototypes config file
+	struct CachedFile {
+		/// parsed file
+		std::shared_ptr<pugi::xml_document>  document;
+		/// file modification time at parsing
+		std::filesystem::file_time_type      modificationTime;
+	};
+	
+	/// info about cached prototype config node
+	struct CachedPrototype {
+		/// path to file with prototype config
+		std::string     path;
+		/// file location and prototype node
+		PrototypeXML    xml;
+		/// file modification time at parsing
+		std::filesystem::file_time_type  modificationTime;
+	};
+	
+	/// parsed prototypes config files (as map path -> file info)
+	std::unordered_map<std::string, CachedFile, MGE::string_hash, std::equal_to<>> filesCache;
+	
+	/// prototypes config nodes (as map prototype name -> prototype info)
+	std::unordered_map<std::string, CachedPrototype, MGE::string_hash, std::equal_to<>> prototypesCache;
+	
+	/// return parsed file @a path from @ref filesCache (read and parse file when is not cached or was modified)
+	const CachedFile* getCachedFile(const std::string& path);
+	
 protected:
 	~PrototypeFactory() = default;
 };
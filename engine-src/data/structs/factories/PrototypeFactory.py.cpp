@@ -38,6 +38,9 @@ MGE_SCRIPT_API_FOR_MODULE(PrototypeFactory) {
 			DOC(MGE, PrototypeFactory, getPrototype),
 			py::return_value_policy::reference
 		)
+		.def("clearPrototypeXMLCache", &MGE::PrototypeFactory::clearPrototypeXMLCache,
+			DOC(MGE, PrototypeFactory, clearPrototypeXMLCache)
+		)
 		.def_static("get", &MGE::PrototypeFactory::getPtr, py::return_value_policy::reference, DOC_SINGLETON_GET("PrototypeFactory"))
 	;
 }
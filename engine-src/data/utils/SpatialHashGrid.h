@@ -0,0 +1,438 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma   once
+
+#include <OgreVector3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+
+namespace MGE {
+
+/// @addtogroup OgreWorldUtils
+/// @{
+/// @file
+
+/**
+ * @brief Spatial index of points (e.g. actors positions) based on uniform grid of square cells on XZ plane (stored in hash map).
+ * 
+ * Grid is 2D (Y coordinate is not used to select cells), but all distances in queries are calculated in 3D,
+ * so results are the same as for linear search over all elements.
+ * 
+ * Queries write results to caller provided vector (flat buffer), so can be called many times per frame without memory allocation
+ * (when the same results buffer is reused).
+ * 
+ * @tparam ValueType  Type of stored value (e.g. pointer to object). Must be hashable by std::hash and comparable by operator==.
+ */
+template <typename ValueType>
+class SpatialHashGrid {
+public:
+	/// Single query result.
+	struct Result {
+		/// squared distance from query point
+		float     squaredDistance;
+		/// found value
+		ValueType value;
+		
+		/// compare by @a squaredDistance (for sort and heap operations)
+		inline bool operator<(const Result& other) const {
+			return squaredDistance < other.squaredDistance;
+		}
+	};
+	
+	/// Type of query results buffer.
+	typedef std::vector<Result> Results;
+	
+	/**
+	 * @brief Add @a value at @a position to index or update its position (when @a value is already in index).
+	 */
+	void update(const ValueType& value, const Ogre::Vector3& position) {
+		auto slotIter = slots.find(value);
+		CellKey newKey = getCellKey(position);
+		if (slotIter == slots.end()) {
+			slots.emplace(value, Slot{newKey, position});
+			addToCell(newKey, value, position);
+		} else if (slotIter->second.cellKey != newKey) {
+			removeFromCell(slotIter->second.cellKey, value);
+			slotIter->second = Slot{newKey, position};
+			addToCell(newKey, value, position);
+		} else if (slotIter->second.position != position) {
+			slotIter->second.position = position;
+			for (auto& entry : cells[newKey]) {
+				if (entry.value == value) {
+					entry.position = position;
+					break;
+				}
+			}
+		}
+	}
+	
+	/**
+	 * @brief Update position of @a value only when it is already in index.
+	 * 
+	 * @return true when @a value is in index
+	 */
+	bool move(const ValueType& value, const Ogre::Vector3& position) {
+		if (!slots.count(value))
+			return false;
+		update(value, position);
+		return true;
+	}
+	
+	/**
+	 * @brief Remove @a value from index.
+	 * 
+	 * @return true when @a value was in index
+	 */
+	bool remove(const ValueType& value) {
+		auto slotIter = slots.find(value);
+		if (slotIter == slots.end())
+			return false;
+		removeFromCell(slotIter->second.cellKey, value);
+		slots.erase(slotIter);
+		return true;
+	}
+	
+	/**
+	 * @brief Remove all values from index.
+	 */
+	void clear() {
+		cells.clear();
+		slots.clear();
+		resetBounds();
+	}
+	
+	/**
+	 * @brief Return number of values in index.
+	 */
+	size_t size() const {
+		return slots.size();
+	}
+	
+	/**
+	 * @brief Return (stored in index) position of @a value, or NULL when @a value is not in index.
+	 */
+	const Ogre::Vector3* getPosition(const ValueType& value) const {
+		auto slotIter = slots.find(value);
+		if (slotIter == slots.end())
+			return nullptr;
+		return &(slotIter->second.position);
+	}
+	
+	/**
+	 * @brief Return size of grid cell.
+	 */
+	float getCellSize() const {
+		return cellSize;
+	}
+	
+	/**
+	 * @brief Set size of grid cell (and rebuild index).
+	 * 
+	 * Optimal cell size is similar to typical query range.
+	 */
+	void setCellSize(float newSize) {
+		cellSize    = newSize;
+		invCellSize = 1.0f / newSize;
+		
+		std::vector< std::pair<ValueType, Ogre::Vector3> > values;
+		values.reserve(slots.size());
+		for (auto& iter : slots)
+			values.emplace_back(iter.first, iter.second.position);
+		clear();
+		for (auto& iter : values)
+			update(iter.first, iter.second);
+	}
+	
+	/**
+	 * @brief Find values in @a range from @a point.
+	 * 
+	 * @param[in]  point    center of search sphere
+	 * @param[in]  range    radius of search sphere
+	 * @param[out] results  buffer for found values (will be cleared before search)
+	 * @param[in]  sorted   when true results are sorted by distance from @a point
+	 */
+	void findInRadius(const Ogre::Vector3& point, float range, Results& results, bool sorted = true) const {
+		results.clear();
+		float srange = range * range;
+		forEachCell(
+			getCellCoord(point.x - range), getCellCoord(point.z - range),
+			getCellCoord(point.x + range), getCellCoord(point.z + range),
+			[&point, srange, &results](const Cell& cell) {
+				for (auto& entry : cell) {
+					float sdist = entry.position.squaredDistance(point);
+					if (sdist < srange)
+						results.push_back({sdist, entry.value});
+				}
+			}
+		);
+		if (sorted)
+			std::sort(results.begin(), results.end());
+	}
+	
+	/**
+	 * @brief Find values inside axis aligned box.
+	 * 
+	 * @param[in]  minPoint  minimum corner of box
+	 * @param[in]  maxPoint  maximum corner of box
+	 * @param[out] results   buffer for found values (will be cleared before search),
+	 *                       @ref Result::squaredDistance is squared distance from box center
+	 */
+	void findInBox(const Ogre::Vector3& minPoint, const Ogre::Vector3& maxPoint, Results& results) const {
+		results.clear();
+		Ogre::Vector3 center = (minPoint + maxPoint) * 0.5f;
+		forEachCell(
+			getCellCoord(minPoint.x), getCellCoord(minPoint.z),
+			getCellCoord(maxPoint.x), getCellCoord(maxPoint.z),
+			[&minPoint, &maxPoint, &center, &results](const Cell& cell) {
+				for (auto& entry : cell) {
+					const Ogre::Vector3& p = entry.position;
+					if (
+						p.x >= minPoint.x && p.x <= maxPoint.x &&
+						p.y >= minPoint.y && p.y <= maxPoint.y &&
+						p.z >= minPoint.z && p.z <= maxPoint.z
+					) {
+						results.push_back({p.squaredDistance(center), entry.value});
+					}
+				}
+			}
+		);
+	}
+	
+	/**
+	 * @brief Find up to @a count values nearest to @a point.
+	 * 
+	 * @param[in]  point    search center
+	 * @param[in]  count    maximum number of results
+	 * @param[out] results  buffer for found values (will be cleared before search), sorted by distance from @a point
+	 * @param[in]  range    maximum distance from @a point
+	 */
+	void findNearest(const Ogre::Vector3& point, size_t count, Results& results, float range = std::numeric_limits<float>::infinity()) const {
+		results.clear();
+		if (count == 0 || cells.empty())
+			return;
+		
+		float   srange = range * range;
+		int32_t cx     = getCellCoord(point.x);
+		int32_t cz     = getCellCoord(point.z);
+		int32_t maxRing = std::max(
+			std::max(cx - minCell[0], maxCell[0] - cx),
+			std::max(cz - minCell[1], maxCell[1] - cz)
+		);
+		
+		// results is used as max-heap (by squaredDistance) of best candidates
+		auto checkCell = [&point, count, srange, &results](const Cell& cell) {
+			for (auto& entry : cell) {
+				float sdist = entry.position.squaredDistance(point);
+				if (sdist >= srange)
+					continue;
+				if (results.size() < count) {
+					results.push_back({sdist, entry.value});
+					std::push_heap(results.begin(), results.end());
+				} else if (sdist < results.front().squaredDistance) {
+					std::pop_heap(results.begin(), results.end());
+					results.back() = {sdist, entry.value};
+					std::push_heap(results.begin(), results.end());
+				}
+			}
+		};
+		
+		for (int32_t ring = 0; ring <= maxRing; ++ring) {
+			// all not visited cells are at least (ring - 1) * cellSize from point
+			float minDist = (ring - 1) * cellSize;
+			if (ring > 1 && (minDist * minDist >= srange || (results.size() == count && minDist * minDist >= results.front().squaredDistance)))
+				break;
+			
+			if (static_cast<size_t>(8 * ring) > cells.size()) {
+				// ring has more cells than whole (sparse) index, so check all remaining cells directly
+				for (auto& iter : cells) {
+					if (std::max(std::abs(getCellX(iter.first) - cx), std::abs(getCellZ(iter.first) - cz)) >= ring)
+						checkCell(iter.second);
+				}
+				break;
+			}
+			
+			if (ring == 0) {
+				visitCell(cx, cz, checkCell);
+				continue;
+			}
+			for (int32_t x = cx - ring; x <= cx + ring; ++x) {
+				visitCell(x, cz - ring, checkCell);
+				visitCell(x, cz + ring, checkCell);
+			}
+			for (int32_t z = cz - ring + 1; z < cz + ring; ++z) {
+				visitCell(cx - ring, z, checkCell);
+				visitCell(cx + ring, z, checkCell);
+			}
+		}
+		
+		std::sort_heap(results.begin(), results.end());
+	}
+	
+	/**
+	 * @brief Constructor.
+	 * 
+	 * @param size  size of grid cell
+	 */
+	SpatialHashGrid(float size = 16.0f) :
+		cellSize(size), invCellSize(1.0f / size)
+	{
+		resetBounds();
+	}
+	
+protected:
+	/// packed (x, z) cell coordinates
+	typedef uint64_t CellKey;
+	
+	/// single element stored in cell
+	struct Entry {
+		ValueType     value;
+		Ogre::Vector3 position;
+	};
+	
+	/// cell content
+	typedef std::vector<Entry> Cell;
+	
+	/// location of value in index
+	struct Slot {
+		CellKey       cellKey;
+		Ogre::Vector3 position;
+	};
+	
+	/// non empty cells
+	std::unordered_map<CellKey, Cell> cells;
+	
+	/// map value → location in index
+	std::unordered_map<ValueType, Slot> slots;
+	
+	/// size of grid cell
+	float cellSize;
+	
+	/// 1 / cellSize
+	float invCellSize;
+	
+	/// minimum (x, z) cell coordinates of all used (since last clear) cells
+	int32_t minCell[2];
+	
+	/// maximum (x, z) cell coordinates of all used (since last clear) cells
+	int32_t maxCell[2];
+	
+	/// return cell coordinate for world coordinate @a v
+	/// (clamped to avoid overflow in cell ranges calculation for very big or infinite values)
+	inline int32_t getCellCoord(float v) const {
+		constexpr float limit = 1 << 29;
+		return static_cast<int32_t>(std::clamp(std::floor(v * invCellSize), -limit, limit));
+	}
+	
+	/// return key of cell with given coordinates
+	inline static CellKey getCellKey(int32_t x, int32_t z) {
+		return (static_cast<CellKey>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+	}
+	
+	/// return key of cell containing @a position
+	inline CellKey getCellKey(const Ogre::Vector3& position) const {
+		return getCellKey(getCellCoord(position.x), getCellCoord(position.z));
+	}
+	
+	/// return x cell coordinate from @a key
+	inline static int32_t getCellX(CellKey key) {
+		return static_cast<int32_t>(static_cast<uint32_t>(key >> 32));
+	}
+	
+	/// return z cell coordinate from @a key
+	inline static int32_t getCellZ(CellKey key) {
+		return static_cast<int32_t>(static_cast<uint32_t>(key));
+	}
+	
+	/// reset used cells bounds
+	void resetBounds() {
+		minCell[0] = minCell[1] = std::numeric_limits<int32_t>::max();
+		maxCell[0] = maxCell[1] = std::numeric_limits<int32_t>::min();
+	}
+	
+	/// add entry to cell (and update used cells bounds)
+	void addToCell(CellKey key, const ValueType& value, const Ogre::Vector3& position) {
+		cells[key].push_back({value, position});
+		minCell[0] = std::min(minCell[0], getCellX(key));
+		minCell[1] = std::min(minCell[1], getCellZ(key));
+		maxCell[0] = std::max(maxCell[0], getCellX(key));
+		maxCell[1] = std::max(maxCell[1], getCellZ(key));
+	}
+	
+	/// remove entry from cell (and remove cell when is empty)
+	void removeFromCell(CellKey key, const ValueType& value) {
+		auto cellIter = cells.find(key);
+		if (cellIter == cells.end())
+			return;
+		Cell& cell = cellIter->second;
+		for (auto iter = cell.begin(); iter != cell.end(); ++iter) {
+			if (iter->value == value) {
+				*iter = std::move(cell.back());
+				cell.pop_back();
+				break;
+			}
+		}
+		if (cell.empty())
+			cells.erase(cellIter);
+	}
+	
+	/// call @a func on cell (@a x, @a z) when this cell exists
+	template <typename Function> inline void visitCell(int32_t x, int32_t z, Function& func) const {
+		auto cellIter = cells.find(getCellKey(x, z));
+		if (cellIter != cells.end())
+			func(cellIter->second);
+	}
+	
+	/// call @a func on all existing cells in rectangle [@a x1, @a x2] × [@a z1, @a z2]
+	template <typename Function> void forEachCell(int32_t x1, int32_t z1, int32_t x2, int32_t z2, Function func) const {
+		x1 = std::max(x1, minCell[0]);
+		z1 = std::max(z1, minCell[1]);
+		x2 = std::min(x2, maxCell[0]);
+		z2 = std::min(z2, maxCell[1]);
+		if (x1 > x2 || z1 > z2)
+			return;
+		
+		if (static_cast<uint64_t>(x2 - x1 + 1) * static_cast<uint64_t>(z2 - z1 + 1) > cells.size()) {
+			// rectangle has more cells than whole (sparse) index, so iterate over existing cells
+			for (auto& iter : cells) {
+				int32_t x = getCellX(iter.first), z = getCellZ(iter.first);
+				if (x >= x1 && x <= x2 && z >= z1 && z <= z2)
+					func(iter.second);
+			}
+		} else {
+			for (int32_t x = x1; x <= x2; ++x) {
+				for (int32_t z = z1; z <= z2; ++z) {
+					visitCell(x, z, func);
+				}
+			}
+		}
+	}
+};
+
+/// @}
+
+}
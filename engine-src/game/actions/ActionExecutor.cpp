@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include "with.h"
 #include "ConfigParser.h"
+#include "ScriptsSystem.h"
 #include "Engine.h"
 
 #include "game/actions/ActionQueue.h"
@@ -62,6 +63,9 @@ bool MGE::ActionExecutor::update(float gameTimeStep, float realTimeStep) {
 	
 	bool paused = MGE::TimeSystem::getPtr()->gameIsPaused();
 	
+	// tag action scripts (run, start and end scripts) calls for scripts profiling
+	MGE::ScriptsSystem::ProfilingCallerScope profilingCaller("ActionExecutor");
+	
 	auto iter = activeActionQueue.begin(); // don't use `for(auto& it : set)` because of using `set.erase(it)` in the loop
 	while( iter != activeActionQueue.end() ) {
 		_process(*(iter++), gameTimeStep, paused);
@@ -73,7 +77,6 @@ bool MGE::ActionExecutor::update(float gameTimeStep, float realTimeStep) {
 /*--------------------- ActionExecutor::_process() ---------------------*/
 
 #include "rendering/audio-video/AnimationSystem.h"
-#include "ScriptsSystem.h"
 
 #include "data/structs/BaseActor.h"
 #include "data/structs/factories/ActorFactory.h"
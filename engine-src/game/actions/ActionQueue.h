@@ -156,13 +156,21 @@ protected:
 
 struct MGE::ActionQueue::ActionQueueUpdateEventMsg : MGE::EventMsg  {
 	/// message type string
-	inline static const std::string_view MsgType = "ActionQueueUpdate"sv;
+	inline static constexpr std::string_view MsgType = "ActionQueueUpdate"sv;
+	
+	/// message type ID
+	inline static constexpr uint32_t MsgTypeID = MGE::EventMsg::hashType(MsgType);
 	
 	/// @copydoc MGE::EventMsg::getType
 	const std::string_view getType() const override final {
 		return MsgType;
 	}
 	
+	/// @copydoc MGE::EventMsg::getTypeID
+	uint32_t getTypeID() const override final {
+		return MsgTypeID;
+	}
+	
 	/// actor with updated action queue
 	MGE::BaseActor* actor;
 	
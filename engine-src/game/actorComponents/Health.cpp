@@ -158,7 +158,8 @@ void MGE::Health::process(float gameTimeStep) {
 		if (health < healthMin) {
 			if (status != IS_DEAD_OR_DESTROY) {
 				status = IS_DEAD_OR_DESTROY;
-				MGE::Engine::getPtr()->getMessagesSystem()->sendMessage( MGE::HealthSubSystem::ActorDeathMsg(owner), owner );
+				// process() is called from (thread safe) HealthSubSystem::update, so queue message for delivery in main thread
+				MGE::Engine::getPtr()->getMessagesSystem()->postMessage( MGE::HealthSubSystem::ActorDeathMsg(owner), owner );
 			}
 			health = healthMin;
 		}
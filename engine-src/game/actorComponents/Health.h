@@ -52,6 +52,10 @@ struct HealthSubSystem :
 	/// @copydoc MGE::MainLoopListener::update
 	bool update(float gameTimeStep, float realTimeStep) override;
 	
+	/// @copydoc MGE::MainLoopListener::isThreadSafe
+	/// @note update use only Health components state and send messages via MGE::MessagesSystem::postMessage
+	bool isThreadSafe() const override { return true; }
+	
 	/// list of burning object
 	std::set<MGE::Health*>   unwellObjects;
 	
@@ -187,13 +191,21 @@ protected:
 
 struct HealthSubSystem::ActorDeathMsg : MGE::EventMsg  {
 	/// message type string
-	inline static const std::string_view MsgType = "ActorDeath"sv;
+	inline static constexpr std::string_view MsgType = "ActorDeath"sv;
+	
+	/// message type ID
+	inline static constexpr uint32_t MsgTypeID = MGE::EventMsg::hashType(MsgType);
 	
 	/// @copydoc MGE::EventMsg::getType
 	const std::string_view getType() const override final {
 		return MsgType;
 	}
 	
+	/// @copydoc MGE::EventMsg::getTypeID
+	uint32_t getTypeID() const override final {
+		return MsgTypeID;
+	}
+	
 	/// actor who died
 	MGE::BaseActor* actor;
 	
@@ -33,6 +33,7 @@ SOFTWARE.
 #include "data/structs/factories/ComponentFactoryRegistrar.h"
 
 #include "game/actorComponents/World3DMovable.h"
+#include "physics/utils/NavigationField.h"
 
 #if defined MGE_DEBUG_LEVEL and MGE_DEBUG_LEVEL > 1
 #define DEBUG2_LOG(a) LOG_XDEBUG(a)
@@ -44,6 +45,10 @@ MGE::Trigger::Trigger(MGE::NamedObject* parent) {
 }
 
 MGE::Trigger::~Trigger() {
+	// cached navigation data can contain pointer to this trigger
+	MGE::NavigationField* navigationField = MGE::NavigationField::getPtr();
+	if (navigationField && !worldArea.isNull())
+		navigationField->invalidateArea(worldArea.getMinimum(), worldArea.getMaximum());
 }
 
 MGE_ACTOR_COMPONENT_DEFAULT_CREATOR(MGE::Trigger, Trigger)
@@ -96,10 +101,24 @@ void MGE::Trigger::init(MGE::NamedObject* parent) {
 		parent->getComponent<MGE::World3DObject>()->getOgreSceneNode(),
 		0, MGE::VisibilityFlags::TRIGGERS
 	);
+	
+	// new trigger change cached navigation data
+	MGE::World3DObject* world3D = parent->getComponent<MGE::World3DObject>();
+	worldArea = world3D->getWorldOrientedAABB();
+	if (worldArea.isNull())
+		return;
+	worldArea.setExtents(
+		worldArea.getMinimum() + world3D->getWorldPosition(),
+		worldArea.getMaximum() + world3D->getWorldPosition()
+	);
+	MGE::NavigationField* navigationField = MGE::NavigationField::getPtr();
+	if (navigationField)
+		navigationField->invalidateArea(worldArea.getMinimum(), worldArea.getMaximum());
 }
 
 void MGE::Trigger::runTrigger(MGE::BaseActor* actor) const {
 	DEBUG2_LOG(" RUN trigger: " << scriptName);
+	MGE::ScriptsSystem::ProfilingCallerScope profilingCaller("Trigger");
 	switch(triggerType) {
 		case RUN_SCRIPT:
 		case RUN_ACTION_SCRIPT:
@@ -25,6 +25,8 @@ SOFTWARE.
 #include "StringUtils.h"
 #include "data/structs/BaseComponent.h"
 
+#include <OgreAxisAlignedBox.h>
+
 namespace MGE { struct BaseActor; }
 
 #include <map>
@@ -125,6 +127,9 @@ protected:
 	
 	/// map movable subtype -> speed modifier for this trigger
 	std::map<int,float> speedModifiers;
+	
+	/// world space area of trigger (set in @ref init), invalidated in @ref MGE::NavigationField on init and destroy
+	Ogre::AxisAlignedBox worldArea;
 };
 
 /// @}
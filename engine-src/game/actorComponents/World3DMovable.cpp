@@ -22,12 +22,17 @@ SOFTWARE.
 
 #include "game/actorComponents/World3DMovable.h"
 
+#include "with.h"
 #include "Engine.h"
 
-#include "ScriptsSystem.h"
+#include "physics/Physics.h"
 #include "physics/TimeSystem.h"
 #include "physics/Raycast.h"
 #include "physics/PathFinder.h"
+#include "physics/PathFinderPool.h"
+#include "physics/FlowField.h"
+#include "physics/utils/PathCache.h"
+#include "data/structs/factories/ActorFactory.h"
 #include "data/utils/OgreUtils.h"
 #include "physics/utils/OgreColisionBoundingBox.h"
 
@@ -41,10 +46,6 @@ SOFTWARE.
 
 #include "data/property/XmlUtils_Ogre.h"
 
-#ifdef PATHFINDER_SUBTHREAD
-#include <pthread.h>
-#endif
-
 #ifdef MGE_DEBUG_MOVE
 #define DEBUG_MOVE_LOG_STREAM(a)  LOG_VERBOSE(a);
 #else
@@ -63,6 +64,7 @@ MGE::World3DMovable::World3DMovable(MGE::NamedObject* parent) :
 
 MGE::World3DMovable::~World3DMovable() {
 	delete moveInfo;
+	WITH_NOT_NULL(MGE::FlowFieldCache::getPtr())->cancel(this);
 }
 
 MGE_ACTOR_COMPONENT_CREATOR(MGE::World3DMovable, World3DMovable) {
@@ -194,7 +196,8 @@ int16_t MGE::World3DMovable::canMove(
 	const Ogre::Vector3& start, const Ogre::Vector3& end,
 	float& speedModifier, float& squaredLength, float& heightDiff,
 	std::forward_list<MGE::BaseActor*>* triggers,
-	Ogre::MovableObject** collisionWith
+	Ogre::MovableObject** collisionWith,
+	int queryMask
 ) const {
 	DEBUG_MOVE_LOG_STREAM("   check move possibility from " << start << " to " << end);
 	
@@ -209,10 +212,13 @@ int16_t MGE::World3DMovable::canMove(
 		return MGE::PathFinder::TOO_STEEPLY;
 	}
 	
+	if (!queryMask)
+		return MGE::PathFinder::CAN_MOVE;
+	
 	std::list<Ogre::MovableObject*> collisionObject;
 	if (! MGE::OgreColisionBoundingBox::isFreePath(
 			getOgreSceneNode(), getAABB(), start, end,
-			MGE::QueryFlags::COLLISION_OBJECT | MGE::QueryFlags::TRIGGER,
+			queryMask,
 			&collisionObject
 		)
 	) {
@@ -223,7 +229,7 @@ int16_t MGE::World3DMovable::canMove(
 				DEBUG_MOVE_LOG_STREAM("     - collision with COLLISION_OBJECT: " << iter->getName() << " @ " << iter->getParentSceneNode()->getPosition());
 				if (collisionWith)* collisionWith = iter;
 				return MGE::PathFinder::OBJECT_COLLISION;
-			} else if (qf & MGE::QueryFlags::GAME_OBJECT) {
+			} else if ((qf & MGE::QueryFlags::GAME_OBJECT) && (queryMask & MGE::QueryFlags::TRIGGER)) {
 				auto  actor = MGE::BaseActor::get(iter);
 				float triggerSpeedModifier = actor->getComponent<MGE::Trigger>()->getSpeedModifier(owner);
 				if (triggerSpeedModifier == 0) {
@@ -242,6 +248,25 @@ int16_t MGE::World3DMovable::canMove(
 	return MGE::PathFinder::CAN_MOVE;
 }
 
+float MGE::World3DMovable::getTriggersSpeedModifier(const std::vector<MGE::BaseActor*>& triggers) const {
+	float speedModifier = 1.0;
+	for (auto& actor : triggers) {
+		speedModifier *= actor->getComponent<MGE::Trigger>()->getSpeedModifier(owner);
+		if (speedModifier == 0)
+			break;
+	}
+	return speedModifier;
+}
+
+uint32_t MGE::World3DMovable::getMoverType() const {
+	// found path depends on subtype (triggers speed modifiers), maximum slope and (horizontal) size of object
+	const Ogre::Vector3& size = getAABB().getSize();
+	uint32_t sizeKey  = static_cast<uint32_t>(std::max(size.x, size.z) * 10) & 0xffff;
+	uint32_t slopeKey = static_cast<uint32_t>(maxSlopeSin2 * 100) & 0xff;
+	uint32_t type     = (static_cast<uint32_t>(subType & 0xff) << 24) | (slopeKey << 16) | sizeKey;
+	return type ? type : 1;
+}
+
 /*--------------------- prepare move plan ---------------------*/
 
 void MGE::World3DMovable::cancelMove() {
@@ -251,45 +276,18 @@ void MGE::World3DMovable::cancelMove() {
 
 MGE::World3DMovable::MoveInfo::~MoveInfo() {
 	LOG_DEBUG("MoveInfo destructor");
-	deletePathfinder(true);
+	cancelPathFinding();
 }
 
-void MGE::World3DMovable::MoveInfo::deletePathfinder(bool killThread) {
-	#ifdef PATHFINDER_SUBTHREAD
-	if (pathFinderThread) {
-		LOG_DEBUG("detach pathfinder thread in " << this);
-		
-		auto nativeThread = pathFinderThread->native_handle();
-		pathFinderThread->detach();
-		delete pathFinderThread;
-		pathFinderThread = nullptr;
-		
-		if (killThread) {
-			LOG_DEBUG("cancel pathfinder thread in " << this);
-			pthread_cancel(nativeThread);
-			pthread_join(nativeThread, NULL);
-		}
-	} else {
-		LOG_DEBUG("call deletePathfinder without pathFinderThread in " << this);
-	}
-	#endif
-	
-	#ifdef MGE_DEBUG_PATHFINDER_VISUAL_GRID
-	MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
-	if (pathFinder && MGE::ScriptsSystem::getPtr()->getGlobalsDict()["visualPathFinder"].cast<MGE::PathFinder*>() == pathFinder) {
-		pathFinder->readyToRemove = true;
-		LOG_DEBUG("this is visualPathFinder ... skip deletion " << pathFinder << " in " << this);
-	}
-	else
-	#endif
-	{
-		LOG_DEBUG("delete pathfinder " << pathFinder << " in " << this);
-		delete pathFinder;
+void MGE::World3DMovable::MoveInfo::cancelPathFinding() {
+	if (pathFinderRequest) {
+		LOG_DEBUG("cancel pathfinder request " << pathFinderRequest.get() << " in " << this);
+		WITH_NOT_NULL(MGE::PathFinderPool::getPtr())->cancel(pathFinderRequest);
+		pathFinderRequest.reset();
 	}
-	pathFinder = nullptr;
 }
 
-void MGE::World3DMovable::initMove(const Ogre::Vector3& target) {
+void MGE::World3DMovable::initMove(const Ogre::Vector3& target, int priority) {
 	delete moveInfo;
 	moveInfo = new MoveInfo();
 	
@@ -301,41 +299,36 @@ void MGE::World3DMovable::initMove(const Ogre::Vector3& target) {
 	moveInfo->target    = target;
 	moveInfo->ready     = false;
 	
-	moveInfo->pathFinder = new MGE::PathFinder();
-	LOG_DEBUG("pathfinder " << moveInfo->pathFinder << " created in " << moveInfo << " for " << this);
-	
-	#ifdef MGE_DEBUG_PATHFINDER_VISUAL_GRID
-	{
-		MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
-		MGE::PathFinder* oldVisualPathFinder = nullptr;
-		try {
-			oldVisualPathFinder = MGE::ScriptsSystem::getPtr()->getGlobalsDict()["visualPathFinder"].cast<MGE::PathFinder*>();
-		} catch (...) {}
-		if (!oldVisualPathFinder || oldVisualPathFinder->readyToRemove) {
-			delete oldVisualPathFinder;
-			MGE::ScriptsSystem::getPtr()->getGlobalsDict()["visualPathFinder"] = pybind11::cast(moveInfo->pathFinder);
-		}
-	}
-	#endif
+	LOG_DEBUG("initMove: from=" << moveInfo->moveStart << " with init direcion=" << moveInfo->direction << " to dst=" << moveInfo->target);
 	
-	#ifdef PATHFINDER_SUBTHREAD
-	moveInfo->pathFinderThread = new std::thread(&MGE::World3DMovable::doPathFinding, this);
-	#else
-	doPathFinding();
-	#endif
+	auto pathFinderPool = MGE::PathFinderPool::getPtr();
+	if (pathFinderPool) {
+		// callback is called from PathFinderPool::update() (in main thread) only when request was not canceled,
+		// and request is canceled in MoveInfo destructor, so `this` and `moveInfo` are valid in callback
+		// when flow field covering this move is computing (group move order), path search waits for it and takes path from it
+		MGE::PathFinderPool::RequestHandle flowFieldRequest;
+		if (MGE::FlowFieldCache::getPtr())
+			flowFieldRequest = MGE::FlowFieldCache::getPtr()->getPending(moveInfo->target, moveInfo->moveStart, getMoverType());
+		
+		moveInfo->pathFinderRequest = pathFinderPool->findPath(
+			this, moveInfo->moveStart, moveInfo->target,
+			[this](int16_t status, std::list<Ogre::Vector3>& points) { onPathFound(status, points); },
+			priority,
+			flowFieldRequest
+		);
+		LOG_DEBUG("pathfinder request " << moveInfo->pathFinderRequest.get() << " created in " << moveInfo << " for " << this);
+	} else {
+		MGE::PathFinder pathFinder;
+		std::list<Ogre::Vector3> points;
+		int16_t status = pathFinder.findPath(this, moveInfo->moveStart, moveInfo->target, points);
+		onPathFound(status, points);
+	}
 }
 
-void MGE::World3DMovable::doPathFinding() {
-	#ifdef PATHFINDER_SUBTHREAD
-	pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
-	pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, NULL);
-	#endif
-	
-	LOG_DEBUG("initMove: from=" << moveInfo->moveStart << " with init direcion=" << moveInfo->direction << " to dst=" << moveInfo->target);
-	
-	moveInfo->pathStatus = moveInfo->pathFinder->findPath(this, moveInfo->moveStart, moveInfo->target, moveInfo->points );
-	
-	moveInfo->deletePathfinder(false);
+void MGE::World3DMovable::onPathFound(int16_t status, std::list<Ogre::Vector3>& points) {
+	moveInfo->pathFinderRequest.reset();
+	moveInfo->pathStatus = status;
+	moveInfo->points.swap(points);
 	
 	if (moveInfo->pathStatus >= 0) {
 		// remove start point (current position) from moveInfo->points
@@ -472,6 +465,13 @@ int MGE::World3DMovable::doMoveStep(float gameTimeStep) {
 			// on FINAL-TARGET
 			delete moveInfo;
 			moveInfo = NULL;
+			
+			// stopped actor is obstacle for other movers, so cached paths crossing its position can be invalid
+			MGE::PathCache* pathCache = MGE::PathCache::getPtr();
+			if (pathCache) {
+				Ogre::AxisAlignedBox aabb = getWorldOrientedAABB();
+				pathCache->invalidateArea(aabb.getMinimum(), aabb.getMaximum());
+			}
 			return 1;
 		}
 	} else if (!moveInfo->moving) {
@@ -593,6 +593,8 @@ int MGE::World3DMovable::moveTo_onGround(Ogre::Vector3& gotoPoint, const Ogre::V
 	
 	// do move step
 	mainSceneNode->translate(gotoPoint - position);
+	MGE::Physics::markTransformDirty(mainSceneNode);
+	WITH_NOT_NULL(MGE::ActorFactory::getPtr())->updateActorPosition(owner, mainSceneNode->_getDerivedPositionUpdated());
 	
 	return 0;
 }
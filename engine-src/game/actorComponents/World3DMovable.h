@@ -28,11 +28,9 @@ SOFTWARE.
 #include "MessagesSystem.h"
 
 #include "data/structs/components/3DWorld.h"
-
-namespace MGE { class PathFinder; }
+#include "physics/PathFinderPool.h"
 
 #include <OgreVector2.h>
-#include <thread>
 
 namespace MGE {
 
@@ -109,15 +107,27 @@ public:
 		const Ogre::Vector3& start, const Ogre::Vector3& end,
 		float& speedModifier, float& squaredLength, float& heightDiff,
 		std::forward_list<MGE::BaseActor*>* triggers = 0,
-		Ogre::MovableObject** collisionWith = 0
+		Ogre::MovableObject** collisionWith = 0,
+		int queryMask = MGE::QueryFlags::COLLISION_OBJECT | MGE::QueryFlags::TRIGGER
 	) const override;
 	
+	/// @copydoc MGE::World3DObject::getTriggersSpeedModifier
+	virtual float getTriggersSpeedModifier(const std::vector<MGE::BaseActor*>& triggers) const override;
+	
+	/// @copydoc MGE::World3DObject::getMoverType
+	virtual uint32_t getMoverType() const override;
+	
 	/**
 	 * @brief initialize scene object move (prepare @ref MoveInfo, do pathfinding, init first step of move via @ref MoveInfo::reinitMove)
 	 * 
 	 * @param[out]    target    3D world final destination point
+	 * @param[in]     priority  pathfinding request priority, see @ref MGE::PathFinderPool::Priority
+	 * 
+	 * @note When @ref MGE::PathFinderPool exists pathfinding is done asynchronously, so check @ref moveIsReady before start move.
+	 * @note When @ref MGE::FlowFieldCache contains (or is computing) flow field for @a target and mover type of this object
+	 *       covering current position, path is taken from this field instead of A* search (see @ref MGE::PathFinder::findPath).
 	 */
-	void initMove(const Ogre::Vector3& target);
+	void initMove(const Ogre::Vector3& target, int priority = MGE::PathFinderPool::NORMAL_PRIORITY);
 	
 	/**
 	 * @brief initialize scene object move by points list (prepare @ref MoveInfo, WITHOUT doing pathfinding, init first step of move via @ref MoveInfo::reinitMove)
@@ -239,8 +249,7 @@ private:
 		bool              ready;
 		Ogre::Real        traveledDistance;
 		
-		MGE::PathFinder*  pathFinder;
-		std::thread*      pathFinderThread;
+		MGE::PathFinderPool::RequestHandle  pathFinderRequest;
 		int16_t           pathStatus;
 		
 		/**
@@ -254,20 +263,20 @@ private:
 		
 		MoveInfo() {
 			ready = 0;
-			pathFinder = 0;
-			pathFinderThread = nullptr;
 		}
 		
 		~MoveInfo();
 		
-		void deletePathfinder(bool cancelThread);
+		/// cancel pathfinding request (if any)
+		void cancelPathFinding();
 		
 		bool storeToXML(pugi::xml_node&& xmlNode) const;
 		
 		bool restoreFromXML(const pugi::xml_node& xmlNode);
 	};
 	
-	void doPathFinding();
+	/// process pathfinding result (called in main thread by MGE::PathFinderPool or directly from initMove)
+	void onPathFound(int16_t status, std::list<Ogre::Vector3>& points);
 	
 	MoveInfo* moveInfo;
 };
@@ -277,13 +286,21 @@ private:
  */
 struct ActorMovingEventMsg : MGE::EventMsg  {
 	/// message type string
-	inline static const std::string_view MsgType = "ActorMovingUpdate"sv;
+	inline static constexpr std::string_view MsgType = "ActorMovingUpdate"sv;
+	
+	/// message type ID
+	inline static constexpr uint32_t MsgTypeID = MGE::EventMsg::hashType(MsgType);
 	
 	/// @copydoc MGE::EventMsg::getType
 	const std::string_view getType() const override final {
 		return MsgType;
 	}
 	
+	/// @copydoc MGE::EventMsg::getTypeID
+	uint32_t getTypeID() const override final {
+		return MsgTypeID;
+	}
+	
 	/// actor with updated moving state
 	MGE::BaseActor* actor;
 	
@@ -29,11 +29,13 @@ SOFTWARE.
 #include "gui/utils/CeguiString.h"
 #include "data/property/G11n.h"
 #include "data/utils/OgreUtils.h"
+#include "physics/FlowField.h"
 
 #include "data/structs/BaseActor.h"
 #include "data/structs/components/3DWorld.h"
 #include "data/structs/components/ObjectOwner.h"
 #include "game/actorComponents/SelectableObject.h"
+#include "game/actorComponents/World3DMovable.h"
 #include "game/misc/PrimarySelection.h"
 #include "game/actions/ActionFactory.h"
 #include "game/actions/ActionQueue.h"
@@ -42,6 +44,8 @@ SOFTWARE.
 
 #include <boost/format.hpp>
 
+#include <map>
+
 /*--------------------- constructors, destructors ---------------------*/
 
 /**
@@ -445,6 +449,10 @@ bool MGE::ContextMenu::handleTargetDone(const CEGUI::EventArgs& args) {
 void MGE::ContextMenu::addActionToQueue() {
 	LOG_DEBUG("Action Target is complete ...");
 	
+	bool isMoveAction = (action->getType() & MGE::ActionPrototype::ENUMERATIVE_MASK) == MGE::ActionPrototype::MOVE && !action->targetPoints.empty();
+	// movers grouped by mover type (flow field can be shared only by movers of the same type): type → (first mover, positions of movers)
+	std::map<uint32_t, std::pair<MGE::World3DMovable*, std::vector<Ogre::Vector3>>> movers;
+	
 	for(auto& iter : MGE::PrimarySelection::getPtr()->selectedObjects.selection) {
 		LOG_DEBUG(" - add action for: " << iter->getName());
 		
@@ -455,5 +463,26 @@ void MGE::ContextMenu::addActionToQueue() {
 		// queued action (via copy constructor - every actor must have own Action object)
 		MGE::ActionQueue* actionQueue = iter->getComponent<MGE::ActionQueue>(MGE::ActionQueue::classID, MGE::ActionQueue::classID);
 		actionQueue->addActionAtEnd( new MGE::Action( *action ) );
+		
+		if (isMoveAction) {
+			MGE::World3DMovable* movable = iter->getComponent<MGE::World3DMovable>();
+			uint32_t moverType = movable ? movable->getMoverType() : 0;
+			if (moverType) {
+				auto& group = movers[moverType];
+				if (!group.first)
+					group.first = movable;
+				group.second.push_back(movable->getWorldPosition());
+			}
+		}
+	}
+	
+	// group move order – compute (in MGE::PathFinderPool) one flow field shared by all movers of the same type
+	// (used in MGE::PathFinder::findPath instead of A* for each mover)
+	MGE::FlowFieldCache* flowFieldCache = MGE::FlowFieldCache::getPtr();
+	if (flowFieldCache) {
+		for (auto& iter : movers) {
+			if (iter.second.second.size() > 1)
+				flowFieldCache->createAsync(iter.second.first, action->targetPoints.front(), iter.second.second);
+		}
 	}
 }
@@ -0,0 +1,231 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "gui/modules/ProfilerOverlay.h"
+
+#include "LogSystem.h"
+#include "ConfigParser.h"
+#include "XmlUtils.h"
+#include "Engine.h"
+#include "Profiler.h"
+#include "ScriptsSystem.h"
+
+#include "gui/GuiSystem.h"
+#include "gui/modules/GuiConsole.h"
+#include "gui/utils/CeguiString.h"
+
+#include <sstream>
+
+MGE::ProfilerOverlay::ProfilerOverlay(int _framesToAnalyse, int _zonesLimit, float _refreshInterval, const std::string& _exportPath, const std::string& _scriptsExportPath) :
+	framesToAnalyse(_framesToAnalyse),
+	zonesLimit(_zonesLimit),
+	refreshInterval(_refreshInterval),
+	timeFromRefresh(0),
+	exportPath(_exportPath),
+	scriptsExportPath(_scriptsExportPath)
+{
+	LOG_INFO("Initialise ProfilerOverlay");
+	
+	overlayWin = CEGUI::WindowManager::getSingleton().loadLayoutFromFile("ProfilerOverlay.layout");
+	MGE::GUISystem::getPtr()->getMainWindow()->addChild(overlayWin);
+	overlayWin->hide();
+	
+	if (MGE::GUIConsole::getPtr()) {
+		MGE::GUIConsole::getPtr()->addConsoleCmd(
+			"profiler", "CPU profiler overlay and trace export",
+			std::bind(&MGE::ProfilerOverlay::consoleCmd, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)
+		);
+	} else {
+		LOG_WARNING("GUIConsole not exist, \"profiler\" console command will not be available");
+	}
+	
+	MGE::Engine::getPtr()->mainLoopListeners.addListener(this, POST_RENDER_GUI);
+}
+
+MGE::ProfilerOverlay::~ProfilerOverlay() {
+	LOG_INFO("Destroy ProfilerOverlay");
+	MGE::Engine::getPtr()->mainLoopListeners.remListener(this);
+	MGE::GUISystem::getPtr()->getMainWindow()->removeChild(overlayWin);
+	CEGUI::WindowManager::getSingleton().destroyWindow(overlayWin);
+}
+
+/**
+@page XMLSyntax_MainConfig
+
+@subsection XMLNode_ProfilerOverlay \<ProfilerOverlay\>
+
+@c \<ProfilerOverlay\> is used for setup <b>CPU profiler overlay</b> and @c profiler console command (should be created after @ref XMLNode_GUIConsole).
+It can contain following (optional) subnodes:
+  - @c \<Frames\>
+    - number of recent frames used to calculate summary
+    - default 60
+  - @c \<Zones\>
+    - number of (most expensive) zones shown in overlay
+    - default 15
+  - @c \<RefreshInterval\>
+    - time in seconds between overlay text updates
+    - default 0.5
+  - @c \<ExportPath\>
+    - default path for Chrome trace-event JSON file written by @c profiler @c export
+    - default "profiler-trace.json"
+  - @c \<ScriptsExportPath\>
+    - default path for CSV file with Python scripts statistics written by @c profiler @c scripts @c export
+    - default "scripts-profile.csv"
+
+Profiler recording itself is configured by @c \<Profiler\> node (see @ref XMLSyntax_MainConfig).
+*/
+
+MGE_CONFIG_PARSER_MODULE_FOR_XMLTAG(ProfilerOverlay) {
+	return new MGE::ProfilerOverlay(
+		MGE::XMLUtils::getValue(xmlNode.child("Frames"), 60),
+		MGE::XMLUtils::getValue(xmlNode.child("Zones"), 15),
+		MGE::XMLUtils::getValue(xmlNode.child("RefreshInterval"), 0.5f),
+		MGE::XMLUtils::getValue<std::string>(xmlNode.child("ExportPath"), "profiler-trace.json"),
+		MGE::XMLUtils::getValue<std::string>(xmlNode.child("ScriptsExportPath"), "scripts-profile.csv")
+	);
+}
+
+
+void MGE::ProfilerOverlay::show() {
+	MGE::Engine::getPtr()->getProfiler()->setEnabled(true);
+	overlayWin->show();
+	timeFromRefresh = refreshInterval;
+}
+
+void MGE::ProfilerOverlay::hide() {
+	overlayWin->hide();
+}
+
+void MGE::ProfilerOverlay::toggleVisibility() {
+	if (overlayWin->isVisible()) {
+		hide();
+	} else {
+		show();
+	}
+}
+
+bool MGE::ProfilerOverlay::isVisible() const {
+	return overlayWin->isVisible();
+}
+
+bool MGE::ProfilerOverlay::update(float gameTimeStep, float realTimeStep) {
+	return updateOnFullPause(realTimeStep);
+}
+
+bool MGE::ProfilerOverlay::updateOnFullPause(float realTimeStep) {
+	if (!overlayWin->isVisible())
+		return true;
+	
+	timeFromRefresh += realTimeStep;
+	if (timeFromRefresh < refreshInterval)
+		return true;
+	timeFromRefresh = 0;
+	
+	std::ostringstream text;
+	MGE::Engine::getPtr()->getProfiler()->writeSummary(text, framesToAnalyse, zonesLimit);
+	overlayWin->setText(STRING_TO_CEGUI(text.str()));
+	
+	return true;
+}
+
+bool MGE::ProfilerOverlay::consoleCmd(MGE::GUIConsole* console, const std::string& cmd, const std::string& args) {
+	MGE::Profiler* profiler = MGE::Engine::getPtr()->getProfiler();
+	
+	std::string subCmd, arg;
+	std::istringstream argsStream(args);
+	argsStream >> subCmd;
+	std::getline(argsStream >> std::ws, arg);
+	
+	if (subCmd == "show") {
+		show();
+	} else if (subCmd == "hide") {
+		hide();
+	} else if (subCmd == "toggle" || subCmd.empty()) {
+		toggleVisibility();
+	} else if (subCmd == "start") {
+		profiler->setEnabled(true);
+	} else if (subCmd == "stop") {
+		profiler->setEnabled(false);
+	} else if (subCmd == "clear") {
+		profiler->clear();
+	} else if (subCmd == "export") {
+		if (arg.empty())
+			arg = exportPath;
+		if (profiler->writeChromeTrace(arg)) {
+			console->addTextToConsole(STRING_TO_CEGUI("Profiler trace (" + std::to_string(profiler->getFramesCount()) + " frames) written to: " + arg));
+		} else {
+			console->addTextToConsole(STRING_TO_CEGUI("Can't write profiler trace to: " + arg));
+		}
+	} else if (subCmd == "summary") {
+		std::ostringstream text;
+		profiler->writeSummary(text, framesToAnalyse, zonesLimit);
+		console->addTextToConsole(STRING_TO_CEGUI(text.str()), false);
+	} else if (subCmd == "scripts") {
+		scriptsConsoleCmd(console, arg);
+	} else {
+		console->addTextToConsole("USAGE: profiler [show|hide|toggle|start|stop|clear|summary|export [filePath]]");
+		console->addTextToConsole("  show, hide, toggle  - control visibility of profiler overlay (show enable recording)");
+		console->addTextToConsole("  start, stop         - enable / disable recording of frames");
+		console->addTextToConsole("  clear               - remove all recorded frames");
+		console->addTextToConsole("  summary             - print most expensive zones from recent frames");
+		console->addTextToConsole("  export              - write recorded frames as Chrome trace-event JSON (chrome://tracing, Perfetto)");
+		console->addTextToConsole("  scripts             - python scripts profiling, see: profiler scripts help");
+	}
+	
+	return true;
+}
+
+void MGE::ProfilerOverlay::scriptsConsoleCmd(MGE::GUIConsole* console, const std::string& args) {
+	MGE::ScriptsSystem* scriptsSystem = MGE::ScriptsSystem::getPtr();
+	
+	std::string subCmd, arg;
+	std::istringstream argsStream(args);
+	argsStream >> subCmd;
+	std::getline(argsStream >> std::ws, arg);
+	
+	if (subCmd == "start") {
+		scriptsSystem->setProfilingEnabled(true);
+	} else if (subCmd == "stop") {
+		scriptsSystem->setProfilingEnabled(false);
+	} else if (subCmd == "clear") {
+		scriptsSystem->clearProfilingStats();
+	} else if (subCmd == "export") {
+		if (arg.empty())
+			arg = scriptsExportPath;
+		if (scriptsSystem->writeProfilingCSV(arg)) {
+			console->addTextToConsole(STRING_TO_CEGUI("Scripts profiling statistics written to: " + arg));
+		} else {
+			console->addTextToConsole(STRING_TO_CEGUI("Can't write scripts profiling statistics to: " + arg));
+		}
+	} else if (subCmd == "summary" || subCmd.empty()) {
+		std::ostringstream text;
+		scriptsSystem->writeProfilingSummary(text, zonesLimit);
+		console->addTextToConsole(STRING_TO_CEGUI(text.str()), false);
+	} else {
+		console->addTextToConsole("USAGE: profiler scripts [start|stop|clear|summary|export [filePath]]");
+		console->addTextToConsole("  start, stop         - enable / disable recording of python entry points calls (time, calls count, caller)");
+		console->addTextToConsole("  clear               - reset recorded statistics");
+		console->addTextToConsole("  summary             - print most expensive python entry points");
+		console->addTextToConsole("  export              - write all statistics as CSV file");
+		console->addTextToConsole("(when frame profiler is recording, script calls are also visible as zones in exported trace)");
+	}
+}
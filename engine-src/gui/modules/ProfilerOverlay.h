@@ -0,0 +1,120 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma   once
+
+#include "BaseClasses.h"
+#include "MainLoopListener.h"
+#include "ModuleBase.h"
+
+#include <string>
+
+namespace CEGUI { class  Window; }
+namespace MGE { class GUIConsole; }
+
+namespace MGE {
+
+/// @addtogroup GUI_Modules
+/// @{
+/// @file
+
+/**
+ * @brief On screen overlay (CEGUI window) with @ref MGE::Profiler summary (frame time and most expensive zones).
+ * 
+ * Add @c profiler command to @ref MGE::GUIConsole (so GUIConsole should be created before ProfilerOverlay):
+ *   - @c profiler @c show / @c hide / @c toggle – show / hide overlay (showing overlay enable profiler recording)
+ *   - @c profiler @c start / @c stop – enable / disable profiler recording
+ *   - @c profiler @c export @c [filePath] – write recorded frames as Chrome trace-event JSON file
+ *   - @c profiler @c summary – write summary to console
+ *   - @c profiler @c scripts @c [start|stop|clear|summary|export [filePath]] – control and show Python scripts profiling
+ *     (see @ref MGE::ScriptsSystem::setProfilingEnabled)
+ */
+class ProfilerOverlay :
+	public MGE::Module,
+	public MGE::MainLoopListener,
+	public MGE::Singleton<ProfilerOverlay>
+{
+public:
+	/// show overlay (and enable profiler recording)
+	void show();
+	
+	/// hide overlay
+	void hide();
+	
+	/// switch overlay visibility
+	void toggleVisibility();
+	
+	/// return true when overlay is visible
+	bool isVisible() const;
+	
+	/// @copydoc MGE::MainLoopListener::update
+	bool update(float gameTimeStep, float realTimeStep) override;
+	
+	/// @copydoc MGE::MainLoopListener::updateOnFullPause
+	bool updateOnFullPause(float realTimeStep) override;
+	
+	/**
+	 * @brief constructor
+	 * 
+	 * @param framesToAnalyse  number of frames used to calculate summary
+	 * @param zonesLimit       number of zones shown in overlay
+	 * @param refreshInterval  time (in seconds) between overlay text updates
+	 * @param exportPath       default file path for @c profiler @c export console command
+	 * @param scriptsExportPath default file path for @c profiler @c scripts @c export console command
+	 */
+	ProfilerOverlay(int framesToAnalyse = 60, int zonesLimit = 15, float refreshInterval = 0.5, const std::string& exportPath = "profiler-trace.json", const std::string& scriptsExportPath = "scripts-profile.csv");
+	
+	/// destructor
+	~ProfilerOverlay();
+	
+protected:
+	/// pointer to overlay window
+	CEGUI::Window* overlayWin;
+	
+	/// number of frames used to calculate summary
+	int framesToAnalyse;
+	
+	/// number of zones shown in overlay
+	int zonesLimit;
+	
+	/// time between overlay text updates
+	float refreshInterval;
+	
+	/// time from last overlay text update
+	float timeFromRefresh;
+	
+	/// default file path for export
+	std::string exportPath;
+	
+	/// default file path for scripts statistics export
+	std::string scriptsExportPath;
+	
+	/// implementation of @c profiler console command
+	bool consoleCmd(MGE::GUIConsole* console, const std::string& cmd, const std::string& args);
+	
+	/// implementation of @c profiler @c scripts console command
+	void scriptsConsoleCmd(MGE::GUIConsole* console, const std::string& args);
+};
+
+/// @}
+
+}
@@ -25,6 +25,7 @@ SOFTWARE.
 #include "LogSystem.h"
 #include "ConfigParser.h"
 #include "MessagesSystem.h"
+#include "ScriptsSystem.h"
 #include "with.h"
 
 #include "Engine.h"
@@ -39,6 +40,10 @@ SOFTWARE.
 MGE::InputSystem::InputSystem() {
 	LOG_HEADER("Initialise OIS input system");
 	
+	if (MGE::Engine::getPtr()->isHeadless()) {
+		throw std::logic_error("InputSystem require window, so can't be used in headless mode (use main config without <InputSystem>)");
+	}
+	
 	OIS::ParamList pl;
 	size_t windowHnd = 0;
 	std::ostringstream windowHndStr;
@@ -85,9 +90,14 @@ MGE::InputSystem::InputSystem() {
 @subsection XMLNode_Input \<InputSystem\>
 
 @c \<InputSystem\> is used for setup <b>InputSystem</b>. This node do not contain any subnodes nor attributes.
+In headless mode (see @c --headless command line option) this node is ignored (input system require window).
 */
 
 MGE_CONFIG_PARSER_MODULE_FOR_XMLTAG(InputSystem) {
+	if (MGE::Engine::getPtr()->isHeadless()) {
+		LOG_WARNING("Skip creating InputSystem in headless mode (no window) - modules using input (GUI, camera control, ...) should not be used in this mode (see MGEConfig-headless.xml)");
+		return NULL;
+	}
 	return new MGE::InputSystem();
 }
 
@@ -124,6 +134,8 @@ MGE::InputSystem::~InputSystem(void) {
 }
 
 bool MGE::InputSystem::update(float gameTimeStep, float realTimeStep) {
+	// input listeners are called from capture(), so tag scripts called by them for scripts profiling
+	MGE::ScriptsSystem::ProfilingCallerScope profilingCaller("InputSystem");
 	keyboardInput->capture();
 	mouseInput->capture();
 	return true;
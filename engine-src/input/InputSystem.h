@@ -235,22 +235,22 @@ protected:
 	void onWindowResized();
 	
 	/// set of keyboard listeners
-	MGE::ClassPtrListenerSet<Listener, int> keyPressedListeners;
+	MGE::ClassPtrListenerSet<Listener, int, int, MGE::FlatListenerMap> keyPressedListeners;
 	
 	/// set of keyboard listeners
-	MGE::ClassPtrListenerSet<Listener, int> keyReleasedListeners;
+	MGE::ClassPtrListenerSet<Listener, int, int, MGE::FlatListenerMap> keyReleasedListeners;
 	
 	/// set of lost input listeners
-	MGE::ClassPtrListenerSet<Listener, int> lostInputListeners;
+	MGE::ClassPtrListenerSet<Listener, int, int, MGE::FlatListenerMap> lostInputListeners;
 	
 	/// set of mouse listeners
-	MGE::ClassPtrListenerSet<Listener, int> mousePressedListeners;
+	MGE::ClassPtrListenerSet<Listener, int, int, MGE::FlatListenerMap> mousePressedListeners;
 	
 	/// set of mouse listeners
-	MGE::ClassPtrListenerSet<Listener, int> mouseMovedListeners;
+	MGE::ClassPtrListenerSet<Listener, int, int, MGE::FlatListenerMap> mouseMovedListeners;
 	
 	/// set of mouse listeners
-	MGE::ClassPtrListenerSet<Listener, int> mouseReleasedListeners;
+	MGE::ClassPtrListenerSet<Listener, int, int, MGE::FlatListenerMap> mouseReleasedListeners;
 	
 	/// pointer to gui input aggregator (used also for mouse position calculations)
 	InputAggregatorBase*      inputAggregator;
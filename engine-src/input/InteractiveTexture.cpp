@@ -221,7 +221,9 @@ void MGE::InteractiveTexture::createMaterialOnOgreObject(bool isInteractive) {
 			getBillboardInfoWhenDoTest = true;
 			MGE::OgreMeshRaycast::getBillboardInformation( static_cast<Ogre::v1::BillboardSet*>(ogreObject), NULL, &indices, &UVs );
 		} else {
-			MGE::OgreMeshRaycast::getMeshInformation( ogreObject, &vertices, &indices, &UVs, isNotMovable );
+			meshGeometry = MGE::OgreMeshRaycast::getMeshGeometry( ogreObject, true );
+			if (isNotMovable)
+				toLocal = ogreObject->getParentSceneNode()->_getFullTransform().inverse();
 		}
 	}
 	
@@ -373,6 +375,17 @@ std::pair<bool, Ogre::Vector2> MGE::InteractiveTexture::ogreObjectHitTest(const
 		);
 	}
 	
+	if (meshGeometry) {
+		MGE::OgreMeshRaycast::Results res = isNotMovable ?
+			MGE::OgreMeshRaycast::entityHitTest(mouseRay, toLocal, *meshGeometry, true, false) :
+			MGE::OgreMeshRaycast::entityHitTest(mouseRay, ogreObject, *meshGeometry, true, false);
+		
+		if (res.index < 0)
+			return std::pair<bool, Ogre::Vector2>(false, Ogre::Vector2::ZERO);
+		else
+			return std::pair<bool, Ogre::Vector2>(true, MGE::OgreMeshRaycast::getTexturePoint(res, *meshGeometry));
+	}
+	
 	MGE::OgreMeshRaycast::Results res = MGE::OgreMeshRaycast::entityHitTest(
 		mouseRay, ogreObject, vertices, indices, true, false, !isNotMovable
 	);
@@ -31,6 +31,8 @@ SOFTWARE.
 #include <OISKeyboard.h>
 #include <OISMouse.h>
 
+#include <memory>
+
 namespace CEGUI {
 	class  Window;
 	class  Texture;
@@ -39,6 +41,9 @@ namespace CEGUI {
 namespace Ogre {
 	class HlmsUnlitDatablock;
 }
+namespace MGE {
+	struct MeshGeometry;
+}
 
 namespace MGE {
 
@@ -239,6 +244,12 @@ protected:
 	/// true when ogreObject is BillboardSet and need (re)get vertices info in ogreObjectHitTest
 	bool                       getBillboardInfoWhenDoTest;
 	
+	/// shared (cached) mesh geometry, used instead of @ref vertices, @ref indices and @ref UVs when ogreObject is Item or Entity
+	std::shared_ptr<const MGE::MeshGeometry> meshGeometry;
+	
+	/// transform from WORLD space to ogreObject parent node space (used only when @ref isNotMovable)
+	Ogre::Matrix4              toLocal;
+	
 	/// window using for (current) interaction with texture
 	CEGUI::Window*             clickWindow;
 	
@@ -35,6 +35,8 @@ SOFTWARE.
 #include "data/LoadingSystem.h"
 #include "data/DotSceneLoader.h"
 #include "data/utils/OgreUtils.h"
+#include "data/structs/factories/ActorFactory.h"
+#include "physics/Physics.h"
 
 #include <OgreItem.h>
 #include <iomanip>
@@ -927,6 +929,9 @@ void MGE::Editor::updateNodes(
 			
 			if (operationsToSave)
 				updateXML(iter, iter->getPosition(), iter->getScale(), iter->getOrientation(), operationsToSave);
+			
+			MGE::Physics::markTransformDirty(iter);
+			WITH_NOT_NULL(MGE::ActorFactory::getPtr())->updateActorPosition(iter);
 		}
 	}
 	
@@ -942,6 +947,9 @@ void MGE::Editor::updateNodes(
 	if (operationsToSave && selectionSet.selection.size() == 1)
 		updateXML(targetNode, position, scale, orientation, operationsToSave);
 	
+	MGE::Physics::markTransformDirty(targetNode);
+	WITH_NOT_NULL(MGE::ActorFactory::getPtr())->updateActorPosition(targetNode);
+	
 	setTransformInfo(targetNode, operationsToSave);
 }
 
@@ -0,0 +1,386 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "physics/FlowField.h"
+
+#include "LogSystem.h"
+#include "Profiler.h"
+#include "with.h"
+
+#include "physics/PathFinder.h"
+#include "physics/utils/NavigationField.h"
+#include "data/structs/components/3DWorld.h"
+
+#include <algorithm>
+
+/*--------------------- FlowField ---------------------*/
+
+MGE::FlowField::FlowField(const Ogre::Vector3& _goal, uint32_t _moverType) :
+	goal(_goal),
+	goalCell(_goal),
+	moverType(_moverType),
+	minCell(goalCell),
+	maxCell(goalCell)
+{ }
+
+int16_t MGE::FlowField::compute(
+	const std::vector<Ogre::Vector3>& starts,
+	const StepCostFunction& stepCost,
+	size_t maxCells,
+	const std::atomic<bool>* cancelFlag
+) {
+	MGE_PROFILER_ZONE("FlowField::compute");
+	
+	cells.clear();
+	cellsIndex.clear();
+	minCell = maxCell = goalCell;
+	
+	// starts to reach
+	MGE::SearchHashMap<uint32_t, bool> targets;
+	size_t remainingTargets = 0;
+	for (auto& start : starts) {
+		bool inserted;
+		targets.get(getCellKey(MGE::HexagonalGridPoint(start)), inserted) = true;
+		if (inserted)
+			++remainingTargets;
+	}
+	
+	MGE::IndexedBinaryHeap<Cell, &Cell::cost, &Cell::heapIndex> openCells;
+	cells.push_back(Cell{goalCell, 0, -1, 0, goal.y, -1, false});
+	cellsIndex.set(getCellKey(goalCell), 0);
+	openCells.update(&cells.back());
+	
+	int16_t retCode = MGE::PathFinder::NOT_AVAILABLE;
+	while (!openCells.empty()) {
+		if (cancelFlag && cancelFlag->load(std::memory_order_relaxed)) {
+			retCode = MGE::PathFinder::CANCELED;
+			break;
+		}
+		
+		Cell* cell = openCells.pop();
+		cell->closed = true;
+		minCell.a = std::min(minCell.a, cell->point.a);
+		minCell.b = std::min(minCell.b, cell->point.b);
+		maxCell.a = std::max(maxCell.a, cell->point.a);
+		maxCell.b = std::max(maxCell.b, cell->point.b);
+		
+		if (targets.find(getCellKey(cell->point)) && --remainingTargets == 0) {
+			retCode = MGE::PathFinder::PATH_OK;
+			break;
+		}
+		
+		if (cells.size() >= maxCells) {
+			retCode = MGE::PathFinder::TOO_MANY_STEPS;
+			break;
+		}
+		
+		int bIndex = cell->point.getBIndex();
+		for (int i=0; i<cell->point.getNeighborCount(); ++i) {
+			MGE::HexagonalGridPoint neighbor = cell->point.getNeighbor(i, bIndex);
+			
+			const int32_t* neighborIndex = cellsIndex.find(getCellKey(neighbor));
+			if (neighborIndex && cells[*neighborIndex].closed)
+				continue;
+			
+			// field is expanded from goal, so we need cost of move from neighbor to current cell
+			float height;
+			float cost = stepCost(neighbor, cell->point, cell->point.getNeighborMode(i), height);
+			if (cost < 0)
+				continue;
+			cost += cell->cost;
+			
+			if (!neighborIndex) {
+				int32_t id = cells.size();
+				cells.push_back(Cell{neighbor, id, cell->id, cost, height, -1, false});
+				cellsIndex.set(getCellKey(neighbor), id);
+				openCells.update(&cells.back());
+			} else if (cost < cells[*neighborIndex].cost) {
+				Cell& neighborCell = cells[*neighborIndex];
+				neighborCell.cost = cost;
+				neighborCell.next = cell->id;
+				openCells.update(&neighborCell);
+			}
+		}
+	}
+	
+	LOG_INFO("FlowField to " << goal << " computed with " << cells.size() << " cells, status: " << std::hex << std::showbase << retCode);
+	return retCode;
+}
+
+float MGE::FlowField::getCost(const Ogre::Vector3& point) const {
+	const Cell* cell = getCell(point);
+	return cell ? cell->cost : -1;
+}
+
+Ogre::Vector3 MGE::FlowField::getDirection(const Ogre::Vector3& point) const {
+	const Cell* cell = getCell(point);
+	if (!cell || cell->next < 0)
+		return Ogre::Vector3::ZERO;
+	
+	Ogre::Vector3 direction = cells[cell->next].point.toOgre() - cell->point.toOgre();
+	direction.normalise();
+	return direction;
+}
+
+int16_t MGE::FlowField::getPath(const Ogre::Vector3& start, std::list<Ogre::Vector3>& points) const {
+	const Cell* cell = getCell(start);
+	if (!cell)
+		return MGE::PathFinder::NOT_AVAILABLE;
+	
+	points.clear();
+	points.push_back(start);
+	
+	// add only turn points (cells where direction to next cell is changing)
+	uint16_t lastDirection = 0;
+	while (cell->next >= 0) {
+		const Cell* nextCell = &cells[cell->next];
+		uint16_t direction = cell->point.getDirection(nextCell->point);
+		if (lastDirection && direction != lastDirection) {
+			Ogre::Vector3 point = cell->point.toOgre();
+			point.y = cell->height;
+			points.push_back(point);
+		}
+		lastDirection = direction;
+		cell = nextCell;
+	}
+	
+	points.push_back(goal);
+	return MGE::PathFinder::PATH_OK;
+}
+
+bool MGE::FlowField::intersects(const Ogre::Vector3& min, const Ogre::Vector3& max) const {
+	// cells are selected by rounding, so extend area by one cell on each side
+	MGE::HexagonalGridPoint areaMin(min), areaMax(max);
+	return std::min(areaMin.a, areaMax.a) - 1 <= maxCell.a && std::max(areaMin.a, areaMax.a) + 1 >= minCell.a &&
+	       std::min(areaMin.b, areaMax.b) - 1 <= maxCell.b && std::max(areaMin.b, areaMax.b) + 1 >= minCell.b;
+}
+
+
+/*--------------------- FlowFieldCache ---------------------*/
+
+MGE::FlowFieldCache::FlowFieldCache(size_t _maxCells, size_t _maxFields) :
+	maxCells(_maxCells),
+	maxFields(_maxFields),
+	lastPendingId(0),
+	version(0)
+{
+	LOG_INFO("Create FlowFieldCache with maxCells=" << maxCells << " maxFields=" << maxFields);
+}
+
+MGE::FlowFieldCache::~FlowFieldCache() {
+	LOG_INFO("Destroy FlowFieldCache");
+	clear();
+}
+
+std::shared_ptr<const MGE::FlowField> MGE::FlowFieldCache::get(const Ogre::Vector3& goal, const Ogre::Vector3& start, uint32_t moverType) {
+	std::lock_guard<std::mutex> lock(mutex);
+	MGE::HexagonalGridPoint goalCell(goal);
+	for (auto& field : fields) {
+		if (field->getGoalCell() == goalCell && field->getMoverType() == moverType && field->contains(start))
+			return field;
+	}
+	return nullptr;
+}
+
+std::shared_ptr<MGE::FlowField> MGE::FlowFieldCache::compute(
+	MGE::World3DObject* object, const Ogre::Vector3& goal, const std::vector<Ogre::Vector3>& starts,
+	const std::atomic<bool>* cancelFlag
+) {
+	MGE::NavigationField* navigationField = MGE::NavigationField::getPtr();
+	if (!navigationField || !navigationField->isEnabled() || !maxCells || !maxFields)
+		return nullptr;
+	
+	auto field = std::make_shared<MGE::FlowField>(goal, object->getMoverType());
+	int16_t retCode = field->compute(
+		starts,
+		[navigationField, object](const MGE::HexagonalGridPoint& from, const MGE::HexagonalGridPoint& to, int mode, float& fromHeight) {
+			MGE::NavigationField::CellInfo fromInfo = navigationField->getCell(from);
+			if (!fromInfo.isWalkable())
+				return -1.0f;
+			MGE::NavigationField::CellInfo toInfo = navigationField->getCell(to);
+			
+			float speedModifier = 1.0;
+			if (toInfo.triggers) {
+				speedModifier = object->getTriggersSpeedModifier(*toInfo.triggers);
+				if (speedModifier == 0)
+					return -1.0f;
+			}
+			
+			// check slope (triggers are handled by navigation field)
+			Ogre::Vector3 fromPoint = from.toOgre(), toPoint = to.toOgre();
+			fromPoint.y = fromHeight = fromInfo.groundHeight;
+			toPoint.y   = toInfo.groundHeight;
+			float squaredLength, heightDiff, tmp = 1.0;
+			if (object->canMove(fromPoint, toPoint, tmp, squaredLength, heightDiff, NULL, NULL, 0) < 0)
+				return -1.0f;
+			
+			// navigation field cell info is only probe at cell center, so check static obstacles between cells centers (like PathFinder)
+			if (MGE::PathFinder::checkEdgeCollisions(object, fromPoint, toPoint, false) < 0)
+				return -1.0f;
+			
+			// step cost is proportional to time of move
+			return from.getNeighborCost(mode) / speedModifier;
+		},
+		maxCells,
+		cancelFlag
+	);
+	
+	return (retCode == MGE::PathFinder::CANCELED) ? nullptr : field;
+}
+
+void MGE::FlowFieldCache::addField(const std::shared_ptr<const MGE::FlowField>& field) {
+	fields.remove_if([&field](const std::shared_ptr<const MGE::FlowField>& iter) -> bool {
+		return iter->getGoalCell() == field->getGoalCell() && iter->getMoverType() == field->getMoverType();
+	});
+	fields.push_front(field);
+	while (fields.size() > maxFields)
+		fields.pop_back();
+}
+
+std::shared_ptr<const MGE::FlowField> MGE::FlowFieldCache::create(MGE::World3DObject* object, const Ogre::Vector3& goal, const std::vector<Ogre::Vector3>& starts) {
+	auto field = compute(object, goal, starts, nullptr);
+	if (field) {
+		std::lock_guard<std::mutex> lock(mutex);
+		addField(field);
+	}
+	return field;
+}
+
+MGE::PathFinderPool::RequestHandle MGE::FlowFieldCache::createAsync(
+	MGE::World3DObject* object, const Ogre::Vector3& goal, const std::vector<Ogre::Vector3>& starts,
+	int priority
+) {
+	MGE::PathFinderPool* pathFinderPool = MGE::PathFinderPool::getPtr();
+	if (!pathFinderPool) {
+		create(object, goal, starts);
+		return nullptr;
+	}
+	
+	uint64_t startVersion, pendingId;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		startVersion = version;
+		pendingId    = ++lastPendingId;
+		
+		pending.emplace_back();
+		PendingField& pendingField = pending.back();
+		pendingField.id        = pendingId;
+		pendingField.goalCell  = MGE::HexagonalGridPoint(goal);
+		pendingField.moverType = object->getMoverType();
+		pendingField.object    = object;
+		for (auto& iter : starts)
+			pendingField.startCells.emplace_back(iter);
+	}
+	
+	// task is executed in worker thread, so it adds field to cache itself (before start of path searches waiting for it),
+	// pending entry is removed in main thread (by completion callback or by cancel)
+	// runTask must be called without lock, because without worker threads it executes task synchronously
+	auto request = pathFinderPool->runTask(
+		[this, object, goal, starts, startVersion](const std::atomic<bool>* cancelFlag) -> int16_t {
+			MGE_PROFILER_ZONE("FlowFieldCache::createAsync");
+			auto field = compute(object, goal, starts, cancelFlag);
+			if (!field)
+				return MGE::PathFinder::NOT_AVAILABLE;
+			
+			std::lock_guard<std::mutex> lock(mutex);
+			if (version != startVersion) {
+				LOG_INFO("FlowField to " << goal << " was invalidated during computation");
+				return MGE::PathFinder::NOT_AVAILABLE;
+			}
+			addField(field);
+			return MGE::PathFinder::PATH_OK;
+		},
+		[this, pendingId](int16_t status, std::list<Ogre::Vector3>& points) {
+			std::lock_guard<std::mutex> lock(mutex);
+			pending.remove_if([pendingId](const PendingField& iter) -> bool { return iter.id == pendingId; });
+		},
+		priority
+	);
+	
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto& iter : pending) {
+		if (iter.id == pendingId) {
+			iter.request = request;
+			break;
+		}
+	}
+	return request;
+}
+
+MGE::PathFinderPool::RequestHandle MGE::FlowFieldCache::getPending(const Ogre::Vector3& goal, const Ogre::Vector3& start, uint32_t moverType) {
+	std::lock_guard<std::mutex> lock(mutex);
+	MGE::HexagonalGridPoint goalCell(goal), startCell(start);
+	for (auto& iter : pending) {
+		if (iter.request && iter.goalCell == goalCell && iter.moverType == moverType &&
+			std::find(iter.startCells.begin(), iter.startCells.end(), startCell) != iter.startCells.end()
+		) {
+			return iter.request;
+		}
+	}
+	return nullptr;
+}
+
+void MGE::FlowFieldCache::cancel(MGE::World3DObject* object) {
+	std::vector<MGE::PathFinderPool::RequestHandle> requests;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pending.remove_if([object, &requests](const PendingField& iter) -> bool {
+			if (iter.object != object)
+				return false;
+			if (iter.request)
+				requests.push_back(iter.request);
+			return true;
+		});
+	}
+	
+	// PathFinderPool::cancel waits for finish of running task (which locks mutex), so it is called without lock
+	for (auto& iter : requests)
+		WITH_NOT_NULL(MGE::PathFinderPool::getPtr())->cancel(iter);
+}
+
+void MGE::FlowFieldCache::invalidateArea(const Ogre::Vector3& min, const Ogre::Vector3& max) {
+	std::lock_guard<std::mutex> lock(mutex);
+	++version;
+	fields.remove_if([&min, &max](const std::shared_ptr<const MGE::FlowField>& iter) -> bool { return iter->intersects(min, max); });
+}
+
+void MGE::FlowFieldCache::clear() {
+	std::vector<MGE::PathFinderPool::RequestHandle> requests;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		++version;
+		fields.clear();
+		for (auto& iter : pending) {
+			if (iter.request)
+				requests.push_back(iter.request);
+		}
+		pending.clear();
+	}
+	
+	for (auto& iter : requests)
+		WITH_NOT_NULL(MGE::PathFinderPool::getPtr())->cancel(iter);
+}
+
+size_t MGE::FlowFieldCache::size() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return fields.size();
+}
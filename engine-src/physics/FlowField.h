@@ -0,0 +1,343 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma   once
+
+#include "BaseClasses.h"
+
+#include "physics/PathFinderPool.h"
+#include "physics/utils/HexagonalGrid.h"
+#include "physics/utils/SearchContainers.h"
+
+namespace MGE { struct World3DObject; }
+
+#include <OgreVector3.h>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace MGE {
+
+/// @addtogroup Physics
+/// @{
+/// @file
+
+/**
+ * @brief Flow field to single goal over @ref MGE::HexagonalGridPoint grid (Dijkstra integration field with direction to next cell for each cell).
+ * 
+ * Flow field is computed once per destination and mover type (see @ref compute) and is shared (read-only) by all movers of this type
+ * targeting this destination – each mover get its path by following directions from its own position (see @ref getPath), without own A* search.
+ * 
+ * Field is expanded from goal only until all requested start cells are reached (or cells limit is exceeded),
+ * so it covers area needed by group of movers, not whole map.
+ * 
+ * See too: @ref MGE::FlowFieldCache, @ref PathFinding
+ */
+class FlowField {
+public:
+	/**
+	 * @brief Type of function used to calculate cost of single step between neighboring cells.
+	 * 
+	 * @param[in]  from        start cell of step
+	 * @param[in]  to          end cell of step (cell closer to goal)
+	 * @param[in]  mode        neighbor mode of step (see @ref MGE::HexagonalGridPoint::getNeighborMode)
+	 * @param[out] fromHeight  ground height at @a from cell
+	 * 
+	 * @return step cost, negative when step is not possible
+	 */
+	typedef std::function<float(const MGE::HexagonalGridPoint& from, const MGE::HexagonalGridPoint& to, int mode, float& fromHeight)> StepCostFunction;
+	
+	/**
+	 * @brief Compute flow field.
+	 * 
+	 * @param[in] starts      positions of movers, expanding is finished when all of them are reached
+	 * @param[in] stepCost    function used to calculate step costs
+	 * @param[in] maxCells    maximum number of cells in field
+	 * @param[in] cancelFlag  pointer to cancellation flag (checked in each iteration of Dijkstra loop), can be NULL
+	 * 
+	 * @return @ref MGE::PathFinder::PATH_OK when all @a starts are reached, otherwise error code from @ref MGE::PathFinder::ReturnCodes
+	 *         (field can be used for reached starts also in this case)
+	 */
+	int16_t compute(
+		const std::vector<Ogre::Vector3>& starts,
+		const StepCostFunction& stepCost,
+		size_t maxCells,
+		const std::atomic<bool>* cancelFlag = nullptr
+	);
+	
+	/**
+	 * @brief Return true when field contains path from @a point to goal.
+	 */
+	bool contains(const Ogre::Vector3& point) const {
+		return cellsIndex.find(getCellKey(MGE::HexagonalGridPoint(point))) != nullptr;
+	}
+	
+	/**
+	 * @brief Return cost of path from @a point to goal (negative when field do not contains @a point).
+	 */
+	float getCost(const Ogre::Vector3& point) const;
+	
+	/**
+	 * @brief Return (normalised, horizontal) move direction at @a point (zero vector on goal cell or when field do not contains @a point).
+	 */
+	Ogre::Vector3 getDirection(const Ogre::Vector3& point) const;
+	
+	/**
+	 * @brief Get path from @a start to goal by following field directions.
+	 * 
+	 * @param[in]  start   start point
+	 * @param[out] points  path points (@a start, turn points with ground height, goal) – like in @ref MGE::PathFinder::findPath
+	 * 
+	 * @return @ref MGE::PathFinder::PATH_OK on success, @ref MGE::PathFinder::NOT_AVAILABLE when field do not contains @a start
+	 */
+	int16_t getPath(const Ogre::Vector3& start, std::list<Ogre::Vector3>& points) const;
+	
+	/**
+	 * @brief Return goal point.
+	 */
+	inline const Ogre::Vector3& getGoal() const {
+		return goal;
+	}
+	
+	/**
+	 * @brief Return goal grid cell.
+	 */
+	inline const MGE::HexagonalGridPoint& getGoalCell() const {
+		return goalCell;
+	}
+	
+	/**
+	 * @brief Return mover type for which field was computed (see @ref MGE::World3DObject::getMoverType).
+	 */
+	inline uint32_t getMoverType() const {
+		return moverType;
+	}
+	
+	/**
+	 * @brief Return number of cells in field.
+	 */
+	inline size_t getCellsCount() const {
+		return cells.size();
+	}
+	
+	/**
+	 * @brief Return true when field overlaps (x,z) area from @a min to @a max.
+	 */
+	bool intersects(const Ogre::Vector3& min, const Ogre::Vector3& max) const;
+	
+	/// constructor
+	FlowField(const Ogre::Vector3& goal, uint32_t moverType = 0);
+	
+protected:
+	/// single cell of field
+	struct Cell {
+		/// grid cell
+		MGE::HexagonalGridPoint point;
+		/// index of this cell in @ref cells
+		int32_t id;
+		/// index of next cell (cell closer to goal) in @ref cells, -1 for goal
+		int32_t next;
+		/// cost of path to goal
+		float   cost;
+		/// ground height
+		float   height;
+		/// position in open list heap (-1 when not in heap)
+		int32_t heapIndex;
+		/// cell was closed (cost is final)
+		bool    closed;
+	};
+	
+	/// goal point
+	Ogre::Vector3 goal;
+	
+	/// goal grid cell
+	MGE::HexagonalGridPoint goalCell;
+	
+	/// mover type for which field was computed
+	uint32_t moverType;
+	
+	/// field cells (std::deque to keep references valid when adding cells)
+	std::deque<Cell> cells;
+	
+	/// map packed grid point → index in @ref cells
+	MGE::SearchHashMap<uint32_t, int32_t> cellsIndex;
+	
+	/// minimum grid coordinates of field cells
+	MGE::HexagonalGridPoint minCell;
+	
+	/// maximum grid coordinates of field cells
+	MGE::HexagonalGridPoint maxCell;
+	
+	/// return key for @ref cellsIndex
+	inline static uint32_t getCellKey(const MGE::HexagonalGridPoint& point) {
+		return MGE::SearchHashMap<uint32_t, int32_t>::packPoint(point.a, point.b);
+	}
+	
+	/// return cell for @a point (NULL when field do not contains @a point)
+	inline const Cell* getCell(const Ogre::Vector3& point) const {
+		const int32_t* index = cellsIndex.find(getCellKey(MGE::HexagonalGridPoint(point)));
+		return index ? &cells[*index] : nullptr;
+	}
+};
+
+/**
+ * @brief Cache of flow fields shared by movers with common destination (e.g. group move order).
+ * 
+ * Fields are created for group orders (see @ref createAsync) and used by @ref MGE::PathFinder::findPath instead of A* search
+ * (see @ref get). Field is kept until it is evicted by newer fields or map changes in its area (see @ref invalidateArea).
+ * 
+ * Fields are keyed by goal cell and mover type (see @ref MGE::World3DObject::getMoverType) – mover type covers all properties
+ * of mover used in field computation (size, maximum slope, triggers speed modifiers), so field can be shared only by movers of the same type.
+ * 
+ * Fields are computed using data from @ref MGE::NavigationField (cache is disabled when navigation field is disabled)
+ * and mover AABB sweep along each edge for static obstacles (like @ref MGE::PathFinder does, but actors are ignored
+ * – field is shared by group, so group members must not block each other).
+ */
+class FlowFieldCache :
+	public MGE::Singleton<FlowFieldCache>
+{
+public:
+	/**
+	 * @brief Return cached flow field for @a goal and @a moverType containing path from @a start (or NULL when there is no such field).
+	 */
+	std::shared_ptr<const MGE::FlowField> get(const Ogre::Vector3& goal, const Ogre::Vector3& start, uint32_t moverType);
+	
+	/**
+	 * @brief Compute synchronously (and add to cache) flow field to @a goal for group of movers.
+	 * 
+	 * @param object  moving object used to check slope, size and triggers speed modifiers (one of group movers,
+	 *                all movers using this field should have the same mover type as @a object)
+	 * @param goal    destination point
+	 * @param starts  positions of movers
+	 * 
+	 * @return created field or NULL when cache is disabled
+	 */
+	std::shared_ptr<const MGE::FlowField> create(MGE::World3DObject* object, const Ogre::Vector3& goal, const std::vector<Ogre::Vector3>& starts);
+	
+	/**
+	 * @brief Queue computation (and adding to cache) of flow field to @a goal for group of movers in @ref MGE::PathFinderPool.
+	 * 
+	 * Arguments like in @ref create. When there is no @ref MGE::PathFinderPool field is computed synchronously.
+	 * 
+	 * @param priority  request priority, see @ref MGE::PathFinderPool::Priority
+	 * 
+	 * @return handle to pool request (NULL when field was computed synchronously or cache is disabled)
+	 */
+	MGE::PathFinderPool::RequestHandle createAsync(
+		MGE::World3DObject* object, const Ogre::Vector3& goal, const std::vector<Ogre::Vector3>& starts,
+		int priority = MGE::PathFinderPool::HIGH_PRIORITY
+	);
+	
+	/**
+	 * @brief Return pool request computing flow field for @a goal and @a moverType with @a start (or NULL when there is no such request).
+	 * 
+	 * Returned handle should be used as @a after argument of @ref MGE::PathFinderPool::findPath.
+	 */
+	MGE::PathFinderPool::RequestHandle getPending(const Ogre::Vector3& goal, const Ogre::Vector3& start, uint32_t moverType);
+	
+	/**
+	 * @brief Cancel computation of flow fields using @a object (must be called before destroy of @a object).
+	 */
+	void cancel(MGE::World3DObject* object);
+	
+	/**
+	 * @brief Remove from cache fields overlapping (x,z) area from @a min to @a max.
+	 */
+	void invalidateArea(const Ogre::Vector3& min, const Ogre::Vector3& max);
+	
+	/**
+	 * @brief Remove all fields from cache and cancel all pending computations.
+	 */
+	void clear();
+	
+	/**
+	 * @brief Return number of cached fields.
+	 */
+	size_t size();
+	
+	/**
+	 * @brief Constructor.
+	 * 
+	 * @param maxCells   maximum number of cells in single field
+	 * @param maxFields  maximum number of cached fields
+	 */
+	FlowFieldCache(size_t maxCells = 100000, size_t maxFields = 8);
+	
+	/// destructor
+	~FlowFieldCache();
+	
+protected:
+	/// cached fields (most recently created first)
+	std::list<std::shared_ptr<const MGE::FlowField>> fields;
+	
+	/// maximum number of cells in single field
+	size_t maxCells;
+	
+	/// maximum number of cached fields
+	size_t maxFields;
+	
+	/// flow field computation queued in @ref MGE::PathFinderPool
+	struct PendingField {
+		/// unique id of entry
+		uint64_t id;
+		/// goal grid cell
+		MGE::HexagonalGridPoint goalCell;
+		/// mover type
+		uint32_t moverType;
+		/// grid cells of movers positions
+		std::vector<MGE::HexagonalGridPoint> startCells;
+		/// moving object used in computation
+		MGE::World3DObject* object;
+		/// pool request
+		MGE::PathFinderPool::RequestHandle request;
+	};
+	
+	/// flow fields computations queued in @ref MGE::PathFinderPool
+	std::list<PendingField> pending;
+	
+	/// id of last added @ref pending entry
+	uint64_t lastPendingId;
+	
+	/// counter of @ref invalidateArea and @ref clear calls, used to drop fields computed on outdated data
+	uint64_t version;
+	
+	/// mutex for @ref fields, @ref pending and @ref version
+	std::mutex mutex;
+	
+	/// compute flow field, return NULL when cache is disabled
+	std::shared_ptr<MGE::FlowField> compute(
+		MGE::World3DObject* object, const Ogre::Vector3& goal, const std::vector<Ogre::Vector3>& starts,
+		const std::atomic<bool>* cancelFlag
+	);
+	
+	/// add @a field to @ref fields (mutex must be locked)
+	void addField(const std::shared_ptr<const MGE::FlowField>& field);
+};
+
+/// @}
+
+}
@@ -24,7 +24,17 @@ Inspired by:
 */
 
 #include "physics/PathFinder.h"
+#include "physics/FlowField.h"
+#include "physics/utils/CoarseNavigationGrid.h"
+#include "physics/utils/NavigationField.h"
+#include "physics/utils/PathCache.h"
+#include "physics/utils/OgreColisionBoundingBox.h"
+#include "data/QueryFlags.h"
+#include "data/structs/BaseActor.h"
 #include "data/structs/components/3DWorld.h"
+#include "Profiler.h"
+
+#include <array>
 
 #ifdef MGE_DEBUG_PATHFINDER_VISUAL_PATH
 	#include "rendering/markers/VisualMarkers.h"
@@ -132,7 +142,10 @@ void MGE::PathFinder::onFoundPath(PathNode* currNode, std::list<Ogre::Vector3>&
 		fullCost += costFromTurn;
 		
 		// when we can go directly from "src" to "dst", we don't need "turn"
-		if ( object->canMove(*src, *dst, newCost, newLen, tmp1) > 0 ) {
+		int16_t retCode = object->canMove(*src, *dst, newCost, newLen, tmp1);
+		if ((retCode & ACTOR_COLLISION) == ACTOR_COLLISION)
+			actorCollision = true;
+		if ( retCode > 0 ) {
 			newLen  = Ogre::Math::Sqrt(newLen);
 			newCost = newLen / newCost;
 			if (newCost *.9 < fullCost) {
@@ -164,8 +177,12 @@ void MGE::PathFinder::onFoundPath(PathNode* currNode, std::list<Ogre::Vector3>&
 	#endif
 }
 
-bool MGE::PathFinder::canMove(MGE::World3DObject* object, const Ogre::Vector3& currPoint, Ogre::Vector3& newPoint, float& costFromParent) {
-	if (! MGE::RayCast::getGroundHeight( object->getOgreSceneNode()->getCreator(), newPoint )) {
+bool MGE::PathFinder::canMove(MGE::World3DObject* object, const Ogre::Vector3& currPoint, Ogre::Vector3& newPoint, float& costFromParent, const bool* hasGround) {
+	MGE::NavigationField* field = MGE::NavigationField::getPtr();
+	if (field && field->isEnabled())
+		return canMoveOnField(field, object, currPoint, newPoint, costFromParent);
+	
+	if (hasGround ? !*hasGround : !MGE::RayCast::getGroundHeight( object->getOgreSceneNode()->getCreator(), newPoint )) {
 		MGE_DEBUG_PATHFINDER3_LOG_STREAM(" - can't move from " << currPoint << " to " << newPoint << " not found ground - out of map ?");
 		#ifdef MGE_DEBUG_PATHFINDER_VISUAL_GRID
 		addGridNode(newPoint, CHILD_FORBIDDEN2);
@@ -177,6 +194,8 @@ bool MGE::PathFinder::canMove(MGE::World3DObject* object, const Ogre::Vector3& c
 	Ogre::MovableObject* collison;
 	int16_t retCode = object->canMove(currPoint, newPoint, costFromParent, tmp1, tmp2, NULL, &collison);
 	if (retCode & NOT_AVAILABLE) {
+		if ((retCode & ACTOR_COLLISION) == ACTOR_COLLISION)
+			actorCollision = true;
 		MGE_DEBUG_PATHFINDER3_LOG_STREAM(" - can't move from " << currPoint << " to " << newPoint << " retCode=" << std::hex << std::showbase << retCode);
 		#ifdef MGE_DEBUG_PATHFINDER_VISUAL_GRID
 		addGridNode(newPoint, CHILD_FORBIDDEN, currPoint, collison);
@@ -191,16 +210,201 @@ bool MGE::PathFinder::canMove(MGE::World3DObject* object, const Ogre::Vector3& c
 	return true;
 }
 
-#define OpenNodesInsert(node)         openNodes.insert(std::make_pair(node->estimateCostToEnd + (node->needCheckFromParent ? node->costFromStart : 0), node))
-#define AllGridPointNodesInsert(node) allGridPointNodes.insert(std::make_pair(node->point, node))
-#define AllNodesInsert(node)          allNodes.insert(std::make_pair(std::make_pair(node->point, node->parent ? node->parent->point : node->point), node))
+bool MGE::PathFinder::canMoveOnField(MGE::NavigationField* field, MGE::World3DObject* object, const Ogre::Vector3& currPoint, Ogre::Vector3& newPoint, float& costFromParent) {
+	MGE::NavigationField::CellInfo cell = field->getCell(MGE::HexagonalGridPoint(newPoint));
+	if (! cell.hasGround()) {
+		MGE_DEBUG_PATHFINDER3_LOG_STREAM(" - can't move from " << currPoint << " to " << newPoint << " not found ground (in navigation field) - out of map ?");
+		#ifdef MGE_DEBUG_PATHFINDER_VISUAL_GRID
+		addGridNode(newPoint, CHILD_FORBIDDEN2);
+		#endif
+		return false;
+	}
+	newPoint.y = cell.groundHeight;
+	
+	if (cell.isBlocked()) {
+		MGE_DEBUG_PATHFINDER3_LOG_STREAM(" - can't move from " << currPoint << " to " << newPoint << " static collision (in navigation field)");
+		#ifdef MGE_DEBUG_PATHFINDER_VISUAL_GRID
+		addGridNode(newPoint, CHILD_FORBIDDEN, currPoint);
+		#endif
+		return false;
+	}
+	
+	if (cell.triggers) {
+		float triggersSpeedModifier = object->getTriggersSpeedModifier(*cell.triggers);
+		if (triggersSpeedModifier == 0) {
+			MGE_DEBUG_PATHFINDER3_LOG_STREAM(" - can't move from " << currPoint << " to " << newPoint << " no crossable trigger (in navigation field)");
+			#ifdef MGE_DEBUG_PATHFINDER_VISUAL_GRID
+			addGridNode(newPoint, CHILD_FORBIDDEN, currPoint);
+			#endif
+			return false;
+		}
+		costFromParent *= triggersSpeedModifier;
+	}
+	
+	// triggers are handled by navigation field, so check only slope here
+	float tmp1, tmp2;
+	Ogre::MovableObject* collison = NULL;
+	int16_t retCode = object->canMove(
+		currPoint, newPoint, costFromParent, tmp1, tmp2, NULL, &collison, 0
+	);
+	
+	// navigation field cell info is only early rejection (probe at cell center, without mover size),
+	// so sweep mover AABB along edge to find static obstacles (and optionally actors) between cells centers
+	if (! (retCode & NOT_AVAILABLE)) {
+		int16_t edgeRetCode = checkEdgeCollisions(object, currPoint, newPoint, field->checkActors(), &collison);
+		if (edgeRetCode & NOT_AVAILABLE)
+			retCode = edgeRetCode;
+	}
+	
+	if (retCode & NOT_AVAILABLE) {
+		if ((retCode & ACTOR_COLLISION) == ACTOR_COLLISION)
+			actorCollision = true;
+		MGE_DEBUG_PATHFINDER3_LOG_STREAM(" - can't move from " << currPoint << " to " << newPoint << " retCode=" << std::hex << std::showbase << retCode);
+		#ifdef MGE_DEBUG_PATHFINDER_VISUAL_GRID
+		addGridNode(newPoint, CHILD_FORBIDDEN, currPoint, collison);
+		#endif
+		return false;
+	}
+	
+	#ifdef MGE_DEBUG_PATHFINDER_VISUAL_GRID
+	addGridNode(newPoint, CHILD_OK, currPoint);
+	#endif
+	
+	return true;
+}
+
+int16_t MGE::PathFinder::checkEdgeCollisions(
+	MGE::World3DObject* object,
+	const Ogre::Vector3& from, const Ogre::Vector3& to,
+	bool withActors,
+	Ogre::MovableObject** collision
+) {
+	std::list<Ogre::MovableObject*> collisionObjects;
+	if (MGE::OgreColisionBoundingBox::isFreePath(
+			object->getOgreSceneNode(), object->getAABB(), from, to,
+			MGE::QueryFlags::COLLISION_OBJECT, &collisionObjects
+		)
+	) {
+		return OK;
+	}
+	
+	for (auto& iter : collisionObjects) {
+		bool isActor = MGE::BaseActor::get(iter) != NULL;
+		if (!isActor || withActors) {
+			if (collision)
+				*collision = iter;
+			return isActor ? ACTOR_COLLISION : OBJECT_COLLISION;
+		}
+	}
+	return OK;
+}
+
+#define AllGridPointNodesInsert(node) allGridPointNodes.set(getGridPointKey(node->point), node)
+#define AllNodesInsert(node)          allNodes.set(getNodeKey(node->point, node->parent ? node->parent->point : node->point), node)
 
 int MGE::PathFinder::iterationLimit = 1000;
 
 int16_t MGE::PathFinder::findPath(
 	MGE::World3DObject* object,
 	Ogre::Vector3 start, Ogre::Vector3 finish,
-	std::list<Ogre::Vector3>& points
+	std::list<Ogre::Vector3>& points,
+	const std::atomic<bool>* cancelFlag
+) {
+	MGE_PROFILER_ZONE("PathFinder::findPath");
+	
+	uint32_t moverType = object->getMoverType();
+	
+	// paths of group movers are taken from shared flow field (see MGE::FlowFieldCache::createAsync)
+	MGE::FlowFieldCache* flowFieldCache = MGE::FlowFieldCache::getPtr();
+	if (moverType && flowFieldCache) {
+		auto flowField = flowFieldCache->get(finish, start, moverType);
+		if (flowField && flowField->getPath(start, points) > 0) {
+			LOG_INFO("findPath from " << start << " to " << finish << " found in flow field");
+			points.back() = finish;
+			return PATH_OK;
+		}
+	}
+	
+	// repeated paths (the same start and finish cells and mover type) are taken from cache
+	MGE::PathCache* pathCache = MGE::PathCache::getPtr();
+	if (!moverType || !pathCache)
+		return findPathUncached(object, start, finish, points, cancelFlag);
+	
+	if (pathCache->get(moverType, start, finish, points) != MGE::PathCache::MISS) {
+		LOG_INFO("findPath from " << start << " to " << finish << " found in path cache");
+		// cached path is keyed by cells, so use exact requested endpoints
+		points.front() = start;
+		points.back()  = finish;
+		return PATH_OK;
+	}
+	
+	// version must be get before search – changes during search make this path outdated
+	uint64_t cacheVersion = pathCache->getVersion();
+	actorCollision = false;
+	int16_t retCode = findPathUncached(object, start, finish, points, cancelFlag);
+	
+	// actors are moving, so path shaped by them is not reusable
+	if (retCode > 0 && !actorCollision) {
+		const Ogre::Vector3& size = object->getAABB().getSize();
+		pathCache->put(moverType, start, finish, points, 0.5f * std::max(size.x, size.z), cacheVersion);
+	}
+	return retCode;
+}
+
+int16_t MGE::PathFinder::findPathUncached(
+	MGE::World3DObject* object,
+	Ogre::Vector3 start, Ogre::Vector3 finish,
+	std::list<Ogre::Vector3>& points,
+	const std::atomic<bool>* cancelFlag
+) {
+	// long paths – search on coarse grid and refine each segment (path inside single cluster) on fine grid
+	MGE::CoarseNavigationGrid* coarseGrid = MGE::CoarseNavigationGrid::getPtr();
+	if (coarseGrid && coarseGrid->isLongPath(start, finish)) {
+		std::vector<Ogre::Vector3> waypoints;
+		{
+			MGE_PROFILER_ZONE("PathFinder::findCoarsePath");
+			coarseGrid->findPath(start, finish, waypoints, cancelFlag);
+		}
+		
+		if (!waypoints.empty()) {
+			waypoints.push_back(finish);
+			
+			int16_t retCode = PATH_OK;
+			std::list<Ogre::Vector3> segmentPoints;
+			Ogre::Vector3 segmentStart = start;
+			points.clear();
+			for (auto& segmentFinish : waypoints) {
+				retCode = findPathOnGrid(object, segmentStart, segmentFinish, segmentPoints, cancelFlag);
+				if (retCode < 0)
+					break;
+				
+				// segment start is the same as previous segment finish
+				if (!points.empty())
+					segmentPoints.pop_front();
+				points.splice(points.end(), segmentPoints);
+				segmentStart = segmentFinish;
+			}
+			
+			if (retCode > 0 || retCode == CANCELED) {
+				LOG_INFO("findPath on coarse grid end with code: " << std::hex << std::showbase << retCode << std::dec << std::noshowbase << " after refine " << waypoints.size() << " segments");
+				return retCode;
+			}
+			
+			// coarse grid data can be outdated (or do not include obstacles important for this object), so try full search on fine grid
+			LOG_INFO("Refine coarse path fail with code: " << std::hex << std::showbase << retCode << std::dec << std::noshowbase << ", try search on fine grid");
+		} else if (cancelFlag && cancelFlag->load(std::memory_order_relaxed)) {
+			return CANCELED;
+		}
+	}
+	
+	return findPathOnGrid(object, start, finish, points, cancelFlag);
+}
+
+int16_t MGE::PathFinder::findPathOnGrid(
+	MGE::World3DObject* object,
+	Ogre::Vector3 start, Ogre::Vector3 finish,
+	std::list<Ogre::Vector3>& points,
+	const std::atomic<bool>* cancelFlag
 ) {
 	/** @todo TODO.8: 3D world path finding can be slow ... maybe we should use two pathfinders:
 	 *                  1) based on 2D image (like minimap, but numeric map of area type, e.g. 0 = forbidden, 1 = deep water, 2 = ..., 99 = road, ... )
@@ -211,6 +415,9 @@ int16_t MGE::PathFinder::findPath(
 	 *                  2. start moving
 	 *                  3. rechecking this path (during moving) by 3D world pathfinder
 	 *                  4. when it's not crossable – stop move, back to point 1 for search other path
+	 *                
+	 *                Long paths are already split by coarse grid (see MGE::CoarseNavigationGrid), but coarse grid do not use
+	 *                area types nor (sub)type of moving object yet.
 	 */
 	
 	int16_t retCode = NOT_AVAILABLE;
@@ -218,9 +425,19 @@ int16_t MGE::PathFinder::findPath(
 	PathNode* newNode, *currNode;
 	Ogre::Vector3 newPoint, currPoint, parentPoint;
 	float turnCost = 2 * MGE::HexagonalGridPoint::distanceY;
-	std::map<std::pair<MGE::HexagonalGridPoint, MGE::HexagonalGridPoint>, PathNode*> allNodes;
-	std::map<MGE::HexagonalGridPoint, PathNode*> allGridPointNodes;
-	std::multimap<float, PathNode*> openNodes;
+	
+	// without navigation field ground heights of all neighbors of analyzed node are read by single scene query
+	MGE::NavigationField* field = MGE::NavigationField::getPtr();
+	bool batchGround = !(field && field->isEnabled());
+	Ogre::SceneManager* scnMgr = object->getOgreSceneNode()->getCreator();
+	std::array<Ogre::Vector3, MGE::HexagonalGridPoint::getNeighborCount()> neighborPoints;
+	std::array<uint8_t, MGE::HexagonalGridPoint::getNeighborCount()> neighborHasGround;
+	
+	// nodes and search structures are per search, but keep allocated memory between searches
+	nodesArena.clear();
+	openNodes.clear();
+	allNodes.clear();
+	allGridPointNodes.clear();
 	
 	LOG_INFO("findPath from " << start << " to " << finish << " with gridSize=" << MGE::HexagonalGridPoint::distanceY << " and iterationLimit=" << loopCounter);
 	
@@ -234,14 +451,14 @@ int16_t MGE::PathFinder::findPath(
 	MGE::HexagonalGridPoint endGridPoint(finish);
 
 	// create start node
-	newNode = new PathNode();
+	newNode = nodesArena.create();
 	newNode->point.fromOgre(start);
 	newNode->groundHeight = start.y;
 	newNode->direction = newNode->point.getDirection(object->getWorldDirection());
 	newNode->estimateCostToEnd = costEstimate(newNode->point, endGridPoint);
 	AllNodesInsert(newNode);
 	AllGridPointNodesInsert(newNode);
-	OpenNodesInsert(newNode);
+	updateOpenNode(newNode);
 	
 	// end when start and finish point is in this same grig point
 	if (newNode->point == endGridPoint) {
@@ -252,13 +469,8 @@ int16_t MGE::PathFinder::findPath(
 	}
 	
 	// find path
-	for (auto openNodesIter = openNodes.begin(); openNodesIter != openNodes.end(); openNodesIter = openNodes.begin()) {
-		currNode = openNodesIter->second;
-		openNodes.erase(openNodesIter);
-		
-		if (!currNode->isOpen) { // we can have duplicates in openNodes - on upgrade we don't remove old entry
-			continue;
-		}
+	while (!openNodes.empty()) {
+		currNode = openNodes.pop(); // openNodes is indexed heap, so it don't have duplicates – on upgrade node position is updated
 		
 		currPoint = currNode->point.toOgre();
 		currPoint.y = currNode->groundHeight;
@@ -271,7 +483,7 @@ int16_t MGE::PathFinder::findPath(
 					// allow forbidden move from start point but with higher cost
 					currNode->costFromParent *= 10;
 				} else {
-					currNode->parent->childs.erase(currNode);
+					currNode->unlinkFromParent();
 					continue;
 				}
 			}
@@ -283,6 +495,12 @@ int16_t MGE::PathFinder::findPath(
 		
 		currNode->isOpen = false;
 		
+		if (cancelFlag && cancelFlag->load(std::memory_order_relaxed)) {
+			retCode = CANCELED;
+			LOG_INFO("Path search canceled, break");
+			break;
+		}
+		
 		if (--loopCounter < 0) {
 			retCode = TOO_MANY_STEPS;
 			LOG_INFO("Too many iteration in pathfinder, break");
@@ -292,7 +510,7 @@ int16_t MGE::PathFinder::findPath(
 		#ifdef MGE_DEBUG_PATHFINDER3
 		if (currNode->parent)
 			LOG_VERBOSE("Analyze node " << currNode->point <<
-				" with " << currNode->childs.size() << " childs"
+				" with " << (currNode->firstChild ? "" : "no ") << "childs"
 				" from parent " << currNode->parent->point <<
 				" costFromStart=" << currNode->costFromStart <<
 				" estimateCostToEnd=" << currNode->estimateCostToEnd);
@@ -314,6 +532,11 @@ int16_t MGE::PathFinder::findPath(
 		
 		// process neighbors of current node
 		int bIndex = currNode->point.getBIndex();
+		if (batchGround) {
+			for (int i=0; i<currNode->point.getNeighborCount(); ++i)
+				neighborPoints[i] = currNode->point.getNeighbor(i, bIndex).toOgre();
+			MGE::RayCast::getGroundHeights(scnMgr, neighborPoints, neighborHasGround);
+		}
 		for (int i=0; i<currNode->point.getNeighborCount(); ++i) { // we don't run multi-thread here, because whole pathfinding is running in separate thread
 			MGE::HexagonalGridPoint nextGridPoint = currNode->point.getNeighbor(i, bIndex);
 			
@@ -336,9 +559,9 @@ int16_t MGE::PathFinder::findPath(
 			float estimateCostToEnd = costEstimate(nextGridPoint, endGridPoint);
 			
 			// find on allNodes
-			auto allNodesIter = allNodes.find(std::make_pair(nextGridPoint, currNode->point));
-			if (allNodesIter != allNodes.end()) {
-				newNode = allNodesIter->second;
+			PathNode** allNodesIter = allNodes.find(getNodeKey(nextGridPoint, currNode->point));
+			if (allNodesIter) {
+				newNode = *allNodesIter;
 				MGE_DEBUG_PATHFINDER3_LOG_STREAM(" - found node " << nextGridPoint << "/parent=" << currNode->point <<
 					" on allNodes as " << newNode->point << "/parent=" << (newNode->parent ? newNode->parent->point : newNode->point)
 				);
@@ -348,8 +571,9 @@ int16_t MGE::PathFinder::findPath(
 			
 			bool needCheckFromParent = true;
 			if (estimateCostToEnd < currNode->estimateCostToEnd) {
-				newPoint = nextGridPoint.toOgre();
-				if (! canMove(object, currPoint, newPoint, costFromParent) ) {
+				bool hasGround = batchGround && neighborHasGround[i];
+				newPoint = batchGround ? neighborPoints[i] : nextGridPoint.toOgre();
+				if (! canMove(object, currPoint, newPoint, costFromParent, batchGround ? &hasGround : NULL) ) {
 					if (currNode->parent == NULL/* || currNode->parent->parent == NULL*/) {
 						// allow forbidden move from start point but with higher cost
 						currNode->costFromParent *= 10;
@@ -360,13 +584,13 @@ int16_t MGE::PathFinder::findPath(
 				needCheckFromParent = false;
 				
 				// try find node in allGridPointNodes
-				auto iter = allGridPointNodes.find(nextGridPoint);
-				if (iter != allGridPointNodes.end()) {
+				PathNode** iter = allGridPointNodes.find(getGridPointKey(nextGridPoint));
+				if (iter) {
 					MGE_DEBUG_PATHFINDER3_LOG_STREAM(" - found node " << nextGridPoint <<
-						" on allGridPointNodes as " << iter->second->point <<
-						" the same as on allNodes: " << bool(newNode == 0 || iter->second == newNode)
+						" on allGridPointNodes as " << (*iter)->point <<
+						" the same as on allNodes: " << bool(newNode == 0 || *iter == newNode)
 					);
-					newNode = iter->second;
+					newNode = *iter;
 					
 					// update nodes with lower path cost
 					if (costFromStart < newNode->costFromStart) {
@@ -375,18 +599,17 @@ int16_t MGE::PathFinder::findPath(
 							" parent.OLD=" << newNode->parent->point
 						);
 						
-						newNode->parent         = currNode;
+						newNode->setParent(currNode);
 						newNode->direction      = newDir;
 						newNode->costFromParent = costFromParent;
 						newNode->costFromStart  = costFromStart;
 						if (!newNode->isOpen) {
-							newNode->updateChilds(openNodes, currNode);
+							newNode->updateChilds(this, currNode);
 						}
-						currNode->childs.insert(newNode);
 					}
 				} else if (!newNode) {
 					MGE_DEBUG_PATHFINDER3_LOG_STREAM(" - create new (open) node " << nextGridPoint << " after check from parent");
-					newNode = new PathNode(currNode, newDir, costFromParent, costFromStart, estimateCostToEnd, needCheckFromParent);
+					newNode = nodesArena.create(currNode, newDir, costFromParent, costFromStart, estimateCostToEnd, needCheckFromParent);
 					newNode->point = nextGridPoint;
 					newNode->groundHeight = newPoint.y;
 					
@@ -394,51 +617,57 @@ int16_t MGE::PathFinder::findPath(
 					AllNodesInsert(newNode);
 					
 					// add to parent
-					currNode->childs.insert(newNode);
+					newNode->linkToParent();
 					
 					// set as GridPointNode
 					AllGridPointNodesInsert(newNode);
 				
 					// add to open nodes
-					OpenNodesInsert(newNode);
+					updateOpenNode(newNode);
 				}
 			} else if (!newNode) {
 				MGE_DEBUG_PATHFINDER3_LOG_STREAM(" - create new (open) node " << nextGridPoint << " without check from parent");
-				newNode = new PathNode(currNode, newDir, costFromParent, costFromStart, estimateCostToEnd, needCheckFromParent);
+				newNode = nodesArena.create(currNode, newDir, costFromParent, costFromStart, estimateCostToEnd, needCheckFromParent);
 				newNode->point = nextGridPoint;
 				
 				// add to all nodes map ... this must be after set newNode->point value
 				AllNodesInsert(newNode);
 				
 				// add to parent
-				currNode->childs.insert(newNode);
+				newNode->linkToParent();
 				
 				// add to open nodes
-				OpenNodesInsert(newNode);
+				updateOpenNode(newNode);
 			}
 		}
 	}
 	
-	for (auto& iter : allNodes) {
-		delete iter.second;
-	}
-	
-	LOG_INFO("findPath end with code: " << std::hex << std::showbase << retCode << " after "<< std::dec << std::noshowbase << (iterationLimit - loopCounter - 1) << " iterations");
+	LOG_INFO("findPath end with code: " << std::hex << std::showbase << retCode << " after "<< std::dec << std::noshowbase << (iterationLimit - loopCounter - 1) << " iterations" << " and " << nodesArena.size() << " nodes");
 	return retCode;
 }
 
-void MGE::PathFinder::PathNode::updateChilds(std::multimap<float, PathNode*>& openNodes, PathNode* changedParent) {
+void MGE::PathFinder::PathNode::unlinkFromParent() {
+	for (PathNode** iter = &parent->firstChild; *iter; iter = &(*iter)->nextSibling) {
+		if (*iter == this) {
+			*iter = nextSibling;
+			break;
+		}
+	}
+	nextSibling = NULL;
+}
+
+void MGE::PathFinder::PathNode::updateChilds(PathFinder* pathFinder, PathNode* changedParent) {
 	if (parent != changedParent) // information in childs can be outdated, so we check if change relates to the actual parent
 		return;
 	
-	for (auto& iter : childs) {
+	for (PathNode* iter = firstChild; iter; iter = iter->nextSibling) {
 		iter->costFromStart = iter->parent->costFromStart + iter->costFromParent;
 		
 		if (iter->isOpen)
 			// update open node position in openNodes
-			OpenNodesInsert(iter);
+			pathFinder->updateOpenNode(iter);
 		else
-			iter->updateChilds(openNodes, this);
+			iter->updateChilds(pathFinder, this);
 	}
 }
 
@@ -498,10 +727,9 @@ void MGE::PathFinder::showPath(PathNode* pathNode, MGE::World3DObject* object, c
 }
 #endif
 
-MGE::PathFinder::PathFinder() {
-	#ifdef MGE_DEBUG_PATHFINDER_VISUAL_GRID
-	readyToRemove = false;
-	#endif
+MGE::PathFinder::PathFinder() :
+	actorCollision(false)
+{
 	LOG_DEBUG("PathFinder constructor " << this);
 }
 
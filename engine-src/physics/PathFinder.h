@@ -29,9 +29,11 @@ Inspired by:
 
 #include "physics/Raycast.h"
 #include "physics/utils/HexagonalGrid.h"
+#include "physics/utils/SearchContainers.h"
 
-namespace MGE { struct World3DObject; }
+namespace MGE { struct World3DObject; class NavigationField; }
 
+#include <atomic>
 #include <forward_list>
 
 #ifdef MGE_DEBUG_PATHFINDER_VISUAL_GRID
@@ -67,15 +69,24 @@ public:
 		OGRE_OBJECT_COLLISION    = NOT_AVAILABLE | (1 << 7), //< collision with ogre object (not being actor)
 		OBJECT_COLLISION         = NOT_AVAILABLE | (1 << 8), //< collision with MGE::QueryFlags::COLLISION_OBJECT (actor or Ogre object, NOT trigger)
 		TRIGGER_NO_ACCESS        = NOT_AVAILABLE | (1 << 9), //< trigger object do not allow crossing
+		CANCELED                 = NOT_AVAILABLE | (1 << 10), //< path search was canceled (see @ref MGE::PathFinderPool::cancel)
+		QUEUE_FULL               = NOT_AVAILABLE | (1 << 11), //< path search request was dropped due to full queue (see @ref MGE::PathFinderPool::findPath)
 	};
 	
 	/**
 	 * @brief find path between two points
 	 * 
+	 * When @ref MGE::CoarseNavigationGrid is enabled and points are far away, path is searched on coarse grid first,
+	 * and then each segment (path to entry of next cluster) is refined on fine grid (with @ref iterationLimit per segment).
+	 * When @ref MGE::PathCache exists and object has non zero mover type (see @ref MGE::World3DObject::getMoverType),
+	 * path is taken from cache when possible and found path is put to cache.
+	 * When @ref MGE::FlowFieldCache contains field for @a dst and object mover type covering @a src, path is taken from this field.
+	 * 
 	 * @param[in]  object            pointer to "3D World Interface" of the moving object
 	 * @param[in]  src               start point
 	 * @param[in]  dst               stop point
 	 * @param[out] points            reference to std::list of points to write found path
+	 * @param[in]  cancelFlag        pointer to cancellation flag (checked in each iteration of A* loop), can be NULL
 	 * 
 	 * @return if (value \< 0) error; if (value \> 0) success
 	 *         full list of values see @ref ReturnCodes
@@ -83,7 +94,8 @@ public:
 	int16_t findPath(
 		MGE::World3DObject* object,
 		Ogre::Vector3 src, Ogre::Vector3 dst,
-		std::list<Ogre::Vector3>& points
+		std::list<Ogre::Vector3>& points,
+		const std::atomic<bool>* cancelFlag = nullptr
 	);
 	
 	/**
@@ -107,10 +119,36 @@ public:
 		return std::make_pair( ret_code, ret_vec );
 	}
 	
+	/**
+	 * @brief Sweep AABB of @a object along edge from @a from to @a to and check collisions with static objects (and optionally actors).
+	 * 
+	 * This is used together with @ref MGE::NavigationField data (which is only probe at cell center, without mover size).
+	 * 
+	 * @param[in]  object      pointer to "3D World Interface" of the moving object
+	 * @param[in]  from        start point of edge
+	 * @param[in]  to          end point of edge
+	 * @param[in]  withActors  when false collisions with actors are ignored
+	 * @param[out] collision   when not NULL, set to colliding object (when collision was found)
+	 * 
+	 * @return @ref OK when edge is free, @ref OBJECT_COLLISION or @ref ACTOR_COLLISION otherwise
+	 */
+	static int16_t checkEdgeCollisions(
+		MGE::World3DObject* object,
+		const Ogre::Vector3& from, const Ogre::Vector3& to,
+		bool withActors,
+		Ogre::MovableObject** collision = nullptr
+	);
+	
 	/// iteration limit for findPath function (number open-nodes to check)
 	static int iterationLimit;
 	
-	/// constructor
+	/**
+	 * @brief constructor
+	 * 
+	 * @note PathFinder created from Python is owned (and deleted) by the Python object.
+	 *       PathFinders owned by C++ code (e.g. @ref MGE::PathFinderPool workers) must be passed to Python
+	 *       only by reference (@c return_value_policy::reference), never with ownership.
+	 */
 	PathFinder();
 	
 	/// destructor
@@ -125,8 +163,11 @@ protected:
 		/// current optimal path parrent of node
 		PathNode* parent;
 		
-		/// set of child for whom this node was whenever parents
-		std::set<PathNode*> childs;
+		/// first node on (intrusive, single linked) list of childs for whom this node is parent
+		PathNode* firstChild;
+		
+		/// next node on parent's childs list
+		PathNode* nextSibling;
 		
 		/// direction betwen parent and this node
 		uint16_t direction;
@@ -143,20 +184,91 @@ protected:
 		/// 3D world groundHeight at node point
 		float groundHeight;
 		
+		/// priority in openNodes heap (see @ref updateOpenNode)
+		float openPriority;
+		
+		/// position in openNodes heap (-1 when not in heap)
+		int32_t heapIndex;
+		
 		/// true when node is open (was not query about neighbors)
 		bool isOpen;
 		
 		/// true need check accessibility from parrent
 		bool needCheckFromParent;
 		
+		/// add this node to parent childs list
+		inline void linkToParent() {
+			nextSibling = parent->firstChild;
+			parent->firstChild = this;
+		}
+		
+		/// remove this node from parent childs list (parent pointer is NOT changed)
+		void unlinkFromParent();
+		
+		/// set @a newParent as parent of this node (move this node from old parent childs list to @a newParent childs list)
+		inline void setParent(PathNode* newParent) {
+			if (parent)
+				unlinkFromParent();
+			parent = newParent;
+			linkToParent();
+		}
+		
 		/// update costFromStart in child and re-put open child to openNodes with new estimate total cost
-		void updateChilds(std::multimap<float, PathNode*>& openNodes, PathNode* changedParent);
+		void updateChilds(PathFinder* pathFinder, PathNode* changedParent);
 		
 		/// constructor
 		PathNode(PathNode* p = NULL, uint16_t d = 0, float c1 = 0, float c2 = 0, float c3 = 0, bool needCheck = false) :
-			parent (p), direction (d), costFromParent (c1), costFromStart (c2), estimateCostToEnd (c3), isOpen (true), needCheckFromParent (needCheck) { }
+			parent (p), firstChild (NULL), nextSibling (NULL), direction (d), costFromParent (c1), costFromStart (c2), estimateCostToEnd (c3),
+			groundHeight (0), openPriority (0), heapIndex (-1), isOpen (true), needCheckFromParent (needCheck) { }
 	};
 	
+	/// nodes allocator (reused between findPath() calls)
+	MGE::SearchArena<PathNode> nodesArena;
+	
+	/// open nodes priority queue (reused between findPath() calls)
+	MGE::IndexedBinaryHeap<PathNode, &PathNode::openPriority, &PathNode::heapIndex> openNodes;
+	
+	/// all nodes, key is packed (point, parent point) pair (reused between findPath() calls)
+	MGE::SearchHashMap<uint64_t, PathNode*> allNodes;
+	
+	/// checked nodes, key is packed point (reused between findPath() calls)
+	MGE::SearchHashMap<uint32_t, PathNode*> allGridPointNodes;
+	
+	/// set when any move check of current search was rejected by collision with actor (such path is not stored in @ref MGE::PathCache)
+	bool actorCollision;
+	
+	/// return key for @ref allGridPointNodes
+	inline static uint32_t getGridPointKey(const MGE::HexagonalGridPoint& point) {
+		return MGE::SearchHashMap<uint32_t, PathNode*>::packPoint(point.a, point.b);
+	}
+	
+	/// return key for @ref allNodes
+	inline static uint64_t getNodeKey(const MGE::HexagonalGridPoint& point, const MGE::HexagonalGridPoint& parentPoint) {
+		return MGE::SearchHashMap<uint64_t, PathNode*>::packPair(getGridPointKey(point), getGridPointKey(parentPoint));
+	}
+	
+	/// (re)calculate @a node priority and add it to @ref openNodes (or update its position in @ref openNodes)
+	inline void updateOpenNode(PathNode* node) {
+		node->openPriority = node->estimateCostToEnd + (node->needCheckFromParent ? node->costFromStart : 0);
+		openNodes.update(node);
+	}
+	
+	/// find path between two points without using @ref MGE::PathCache, arguments and return value like @ref findPath
+	int16_t findPathUncached(
+		MGE::World3DObject* object,
+		Ogre::Vector3 start, Ogre::Vector3 finish,
+		std::list<Ogre::Vector3>& points,
+		const std::atomic<bool>* cancelFlag
+	);
+	
+	/// find path between two points on (fine) hexagonal grid, arguments and return value like @ref findPath
+	int16_t findPathOnGrid(
+		MGE::World3DObject* object,
+		Ogre::Vector3 src, Ogre::Vector3 dst,
+		std::list<Ogre::Vector3>& points,
+		const std::atomic<bool>* cancelFlag
+	);
+	
 	/// function to calculate minimal path cost (distance) betwen two nodes
 	float costEstimate(
 		MGE::HexagonalGridPoint stateStart,
@@ -166,8 +278,13 @@ protected:
 		return d.length();
 	}
 	
-	/// check possibility to move from @a currPoint to @a newPoint
-	bool canMove(MGE::World3DObject* object, const Ogre::Vector3& currPoint, Ogre::Vector3& newPoint, float& costFromParent);
+	/// check possibility to move from @a currPoint to @a newPoint,
+	/// when @a hasGround is not NULL ground height is already set in @a newPoint (e.g. by @ref MGE::RayCast::getGroundHeights)
+	/// and @a *hasGround is true when ground was found
+	bool canMove(MGE::World3DObject* object, const Ogre::Vector3& currPoint, Ogre::Vector3& newPoint, float& costFromParent, const bool* hasGround = NULL);
+	
+	/// check possibility to move from @a currPoint to @a newPoint using cached data from @a field (instead of scene queries for ground and static objects)
+	bool canMoveOnField(MGE::NavigationField* field, MGE::World3DObject* object, const Ogre::Vector3& currPoint, Ogre::Vector3& newPoint, float& costFromParent);
 	
 	/// used internally in findPath() when path is found
 	void onFoundPath(PathNode* currNode, std::list<Ogre::Vector3>& points, MGE::World3DObject* object);
@@ -228,8 +345,6 @@ protected:
 	void showNextGridPoint(const std::list<MarkedPoint>::iterator& iter);
 	
 public:
-	bool readyToRemove;
-	
 	/// show points from @ref visualGrid
 	void showNextGridPoints(int count);
 	#endif
@@ -30,9 +30,12 @@ SOFTWARE.
 
 #ifndef __DOCUMENTATION_GENERATOR__
 MGE_SCRIPT_API_FOR_MODULE(PathFinder) {
-	py::class_<MGE::PathFinder, std::unique_ptr<MGE::PathFinder, py::nodelete>>(
+	py::class_<MGE::PathFinder>(
 		m, "PathFinder", DOC(MGE, PathFinder)
 	)
+		.def(py::init<>(),
+			DOC(MGE, PathFinder, PathFinder)
+		)
 		.def("findPath", py::overload_cast<MGE::World3DObject*, Ogre::Vector3, Ogre::Vector3>(&MGE::PathFinder::findPath),
 			DOC(MGE, PathFinder, findPath, 2)
 		)
@@ -0,0 +1,283 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "physics/PathFinderPool.h"
+#include "config.h" // for PATHFINDER_SUBTHREAD
+
+#include "LogSystem.h"
+#include "Engine.h"
+#include "ConfigParser.h"
+
+#include "physics/PathFinder.h"
+
+#include <algorithm>
+
+#ifdef MGE_DEBUG_PATHFINDER_VISUAL_GRID
+#include "ScriptsSystem.h"
+#endif
+
+/**
+@page XMLSyntax_MainConfig
+
+@subsection XMLNode_PathFinderPool \<PathFinderPool\>
+
+@c \<PathFinderPool\> is used for setup pool of pathfinding worker threads (see @ref MGE::PathFinderPool). It have following (optional) subnodes:
+	- @c \<WorkerThreads\> - number of worker threads, default: -1 (half of hardware threads, at least one),
+	                         0 for synchronous (in main thread) path searching
+	- @c \<MaxQueueSize\>  - maximum number of waiting path search requests, 0 for no limit, default: 64
+
+When this node is not used, path searching is done synchronously during move initialisation.
+*/
+
+MGE_CONFIG_PARSER_MODULE_FOR_XMLTAG(PathFinderPool) {
+	return new MGE::PathFinderPool(
+		xmlNode.child("WorkerThreads").text().as_int(-1),
+		xmlNode.child("MaxQueueSize").text().as_uint(64)
+	);
+}
+
+
+MGE::PathFinderPool::PathFinderPool(int workersCount, unsigned int maxQueueSize_) :
+	maxQueueSize(maxQueueSize_),
+	stopWorkers(false)
+{
+	LOG_HEADER("Create PathFinderPool");
+	
+	#ifdef PATHFINDER_SUBTHREAD
+	if (workersCount < 0) {
+		workersCount = std::max(1u, std::thread::hardware_concurrency() / 2);
+	}
+	#else
+	workersCount = 0;
+	#endif
+	
+	LOG_INFO("PathFinderPool", "Use " << workersCount << " worker threads, max queue size is " << maxQueueSize);
+	
+	if (workersCount == 0) {
+		pathFinders.push_back(new MGE::PathFinder());
+	} else {
+		for (int i=0; i<workersCount; ++i) {
+			pathFinders.push_back(new MGE::PathFinder());
+			workers.emplace_back(&MGE::PathFinderPool::workerLoop, this, pathFinders.back());
+		}
+	}
+	
+	MGE::Engine::getPtr()->mainLoopListeners.addListener(this, PRE_RENDER_ACTIONS-1); // must be before ActionExecutor (for set ready flag in the same frame)
+}
+
+MGE::PathFinderPool::~PathFinderPool() {
+	LOG_INFO("PathFinderPool", "Destroy PathFinderPool");
+	
+	MGE::Engine::getPtr()->mainLoopListeners.remListener(this);
+	
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopWorkers = true;
+		for (auto& iter : pendingRequests) {
+			iter.second->canceled = true;
+		}
+		pendingRequests.clear();
+		finishedRequests.clear();
+		for (auto& iter : runningRequests) {
+			iter->canceled = true;
+		}
+	}
+	requestCondition.notify_all();
+	
+	for (auto& iter : workers) {
+		iter.join();
+	}
+	
+	for (auto& iter : pathFinders) {
+		delete iter;
+	}
+}
+
+
+MGE::PathFinderPool::RequestHandle MGE::PathFinderPool::findPath(
+	MGE::World3DObject* object,
+	const Ogre::Vector3& start, const Ogre::Vector3& finish,
+	CompletionCallback&& onComplete,
+	int priority,
+	const RequestHandle& after
+) {
+	RequestHandle request = std::make_shared<Request>(object, start, finish, priority, std::move(onComplete));
+	queueRequest(request, after);
+	return request;
+}
+
+MGE::PathFinderPool::RequestHandle MGE::PathFinderPool::runTask(
+	TaskFunction&& task,
+	CompletionCallback&& onComplete,
+	int priority
+) {
+	RequestHandle request = std::make_shared<Request>(nullptr, Ogre::Vector3::ZERO, Ogre::Vector3::ZERO, priority, std::move(onComplete));
+	request->task = std::move(task);
+	queueRequest(request, nullptr);
+	return request;
+}
+
+void MGE::PathFinderPool::queueRequest(const RequestHandle& request, const RequestHandle& after) {
+	if (workers.empty()) {
+		#ifdef MGE_DEBUG_PATHFINDER_VISUAL_GRID
+		{
+			MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
+			MGE::ScriptsSystem::getPtr()->getGlobalsDict()["visualPathFinder"] = pybind11::cast(pathFinders.front(), pybind11::return_value_policy::reference); // pool keeps ownership
+		}
+		#endif
+		
+		// in synchronous mode @a after is already done
+		execute(pathFinders.front(), request.get());
+		std::lock_guard<std::mutex> lock(mutex);
+		request->state = Request::DONE;
+		finishedRequests.push_back(request);
+		return;
+	}
+	
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (after && after->state != Request::DONE) {
+			request->state      = Request::WAITING;
+			request->waitingFor = after.get();
+			after->dependents.push_back(request);
+			return;
+		}
+		
+		if (maxQueueSize && pendingRequests.size() >= maxQueueSize) {
+			auto lowest = std::prev(pendingRequests.end());
+			if (lowest->first < request->priority) {
+				LOG_WARNING("PathFinderPool", "Requests queue is full, evict request with priority=" << lowest->first);
+				lowest->second->status = MGE::PathFinder::QUEUE_FULL;
+				lowest->second->state  = Request::DONE;
+				finishedRequests.push_back(lowest->second);
+				pendingRequests.erase(lowest);
+				releaseDependents(finishedRequests.back().get());
+			} else {
+				LOG_WARNING("PathFinderPool", "Requests queue is full, reject request with priority=" << request->priority);
+				request->status = MGE::PathFinder::QUEUE_FULL;
+				request->state  = Request::DONE;
+				finishedRequests.push_back(request);
+				return;
+			}
+		}
+		pendingRequests.insert(std::make_pair(request->priority, request));
+	}
+	requestCondition.notify_all();
+}
+
+void MGE::PathFinderPool::releaseDependents(Request* request) {
+	// dependents was accepted when was added, so they are not limited by maxQueueSize
+	for (auto& iter : request->dependents) {
+		iter->waitingFor = nullptr;
+		if (iter->canceled)
+			continue;
+		iter->state = Request::QUEUED;
+		pendingRequests.insert(std::make_pair(iter->priority, std::move(iter)));
+	}
+	request->dependents.clear();
+}
+
+void MGE::PathFinderPool::cancel(const RequestHandle& request) {
+	std::unique_lock<std::mutex> lock(mutex);
+	request->canceled = true;
+	
+	if (request->state == Request::WAITING) {
+		auto& dependents = request->waitingFor->dependents;
+		dependents.erase(std::remove(dependents.begin(), dependents.end(), request), dependents.end());
+		request->waitingFor = nullptr;
+		request->state      = Request::DONE;
+	} else if (request->state == Request::QUEUED) {
+		auto range = pendingRequests.equal_range(request->priority);
+		for (auto iter = range.first; iter != range.second; ++iter) {
+			if (iter->second == request) {
+				pendingRequests.erase(iter);
+				break;
+			}
+		}
+		request->state = Request::DONE;
+		releaseDependents(request.get());
+		lock.unlock();
+		requestCondition.notify_all();
+	} else if (request->state == Request::RUNNING) {
+		finishCondition.wait(lock, [&request]{ return request->state != Request::RUNNING; });
+	}
+	// finished requests stay in finishedRequests, but update() skip canceled requests
+}
+
+bool MGE::PathFinderPool::update(float gameTimeStep, float realTimeStep) {
+	std::vector<RequestHandle> requests;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (finishedRequests.empty())
+			return true;
+		requests.swap(finishedRequests);
+	}
+	
+	// callbacks are called without lock, so they can call findPath() and cancel()
+	for (auto& iter : requests) {
+		if (!iter->canceled && iter->onComplete) {
+			iter->onComplete(iter->status, iter->points);
+		}
+	}
+	
+	return true;
+}
+
+
+void MGE::PathFinderPool::workerLoop(MGE::PathFinder* pathFinder) {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		requestCondition.wait(lock, [this]{ return stopWorkers || !pendingRequests.empty(); });
+		if (stopWorkers)
+			return;
+		
+		RequestHandle request = pendingRequests.begin()->second;
+		pendingRequests.erase(pendingRequests.begin());
+		request->state = Request::RUNNING;
+		runningRequests.insert(request.get());
+		
+		lock.unlock();
+		execute(pathFinder, request.get());
+		lock.lock();
+		
+		runningRequests.erase(request.get());
+		request->state = Request::DONE;
+		releaseDependents(request.get());
+		if (!request->canceled) {
+			finishedRequests.push_back(std::move(request));
+		}
+		finishCondition.notify_all();
+		requestCondition.notify_all();
+	}
+}
+
+void MGE::PathFinderPool::execute(MGE::PathFinder* pathFinder, Request* request) {
+	try {
+		if (request->task)
+			request->status = request->task(&request->canceled);
+		else
+			request->status = pathFinder->findPath(request->object, request->start, request->finish, request->points, &request->canceled);
+	} catch (std::exception& e) {
+		LOG_ERROR("PathFinderPool", "Exception in " << (request->task ? "task" : "findPath") << ": " << e.what());
+		request->status = MGE::PathFinder::NOT_AVAILABLE;
+	}
+}
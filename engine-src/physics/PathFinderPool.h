@@ -0,0 +1,274 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma   once
+
+#include "BaseClasses.h"
+#include "MainLoopListener.h"
+#include "ModuleBase.h"
+
+namespace MGE { struct World3DObject; class PathFinder; }
+
+#include <OgreVector3.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace MGE {
+
+/// @addtogroup Physics
+/// @{
+/// @file
+
+/**
+ * @brief Pool of pathfinding worker threads.
+ * 
+ * Path search requests are queued (bounded queue, ordered by priority) and processed by fixed number of worker threads
+ * (each worker has own @ref MGE::PathFinder instance). Results are collected in completion queue and delivered
+ * to requesters (by call completion callback) in main thread via @ref update.
+ * 
+ * Requests can be canceled at any time via @ref cancel – cancellation is cooperative: @ref MGE::PathFinder::findPath
+ * checks request cancel flag in each iteration of A* loop.
+ * 
+ * Pool can also run other pathfinding related tasks (e.g. flow field computation, see @ref runTask) and path search
+ * can wait for finish of such task (see @a after argument of @ref findPath) without blocking any worker thread.
+ * 
+ * See too: @ref PathFinding
+ */
+class PathFinderPool :
+	public MGE::Module,
+	public MGE::MainLoopListener,
+	public MGE::Singleton<PathFinderPool>
+{
+public:
+	/// Standard priorities of path search requests (requests with higher value are processed first).
+	enum Priority {
+		/// low priority (e.g. background or speculative search)
+		LOW_PRIORITY    = 0,
+		/// default priority
+		NORMAL_PRIORITY = 10,
+		/// high priority (e.g. move ordered by player)
+		HIGH_PRIORITY   = 20,
+	};
+	
+	/**
+	 * @brief Type of completion callback function, called in main thread (from @ref update) when path search is finished.
+	 * 
+	 * @param status  return code of @ref MGE::PathFinder::findPath (see @ref MGE::PathFinder::ReturnCodes)
+	 * @param points  found path (callback can move data from this list)
+	 */
+	typedef std::function<void(int16_t status, std::list<Ogre::Vector3>& points)> CompletionCallback;
+	
+	/**
+	 * @brief Type of task function executed by worker thread (see @ref runTask).
+	 * 
+	 * @param cancelFlag  pointer to request cancellation flag (task should check it periodically)
+	 * 
+	 * @return status (e.g. value from @ref MGE::PathFinder::ReturnCodes) passed to completion callback
+	 */
+	typedef std::function<int16_t(const std::atomic<bool>* cancelFlag)> TaskFunction;
+	
+	/**
+	 * @brief Single path search request.
+	 */
+	struct Request {
+		/// moving object
+		MGE::World3DObject* object;
+		
+		/// start point
+		Ogre::Vector3       start;
+		
+		/// destination point
+		Ogre::Vector3       finish;
+		
+		/// request priority
+		int                 priority;
+		
+		/// completion callback
+		CompletionCallback  onComplete;
+		
+		/// when not empty, task executed instead of path search (see @ref runTask)
+		TaskFunction        task;
+		
+		/// found path
+		std::list<Ogre::Vector3> points;
+		
+		/// search status (return code of @ref MGE::PathFinder::findPath)
+		int16_t             status;
+		
+		/// cancellation flag (checked by @ref MGE::PathFinder::findPath)
+		std::atomic<bool>   canceled;
+		
+		/// request processing state
+		enum State { WAITING, QUEUED, RUNNING, DONE } state;
+		
+		/// request for which finish this request is waiting (in WAITING state)
+		Request*            waitingFor;
+		
+		/// requests waiting for finish of this request (they are queued when this request is done)
+		std::vector<std::shared_ptr<Request>> dependents;
+		
+		/// constructor
+		Request(MGE::World3DObject* _object, const Ogre::Vector3& _start, const Ogre::Vector3& _finish, int _priority, CompletionCallback&& _onComplete) :
+			object(_object), start(_start), finish(_finish), priority(_priority), onComplete(std::move(_onComplete)),
+			status(0), canceled(false), state(QUEUED), waitingFor(nullptr)
+		{}
+	};
+	
+	/// Handle of path search request (used to cancel request).
+	typedef std::shared_ptr<Request> RequestHandle;
+	
+	/**
+	 * @brief Queue path search request.
+	 * 
+	 * @param object      pointer to "3D World Interface" of the moving object
+	 * @param start       start point
+	 * @param finish      stop point
+	 * @param onComplete  callback function called (in main thread) when path search is finished
+	 * @param priority    request priority, see @ref Priority
+	 * @param after       when not NULL, request is queued only after finish of this request (e.g. computation of flow field
+	 *                    which can be used by this path search, see @ref MGE::FlowFieldCache::getPending)
+	 * 
+	 * @return handle to request (for use with @ref cancel)
+	 * 
+	 * @note When request queue is full, then queued request with lowest priority (lower than @a priority) is evicted
+	 *       or (when there is no such request) new request is rejected. In both cases the dropped request is finished
+	 *       with @ref MGE::PathFinder::QUEUE_FULL status.
+	 */
+	RequestHandle findPath(
+		MGE::World3DObject* object,
+		const Ogre::Vector3& start, const Ogre::Vector3& finish,
+		CompletionCallback&& onComplete,
+		int priority = NORMAL_PRIORITY,
+		const RequestHandle& after = nullptr
+	);
+	
+	/**
+	 * @brief Queue task request (executed by worker thread like path search request).
+	 * 
+	 * @param task        task function
+	 * @param onComplete  callback function called (in main thread) when task is finished, can be empty
+	 * @param priority    request priority, see @ref Priority
+	 * 
+	 * @return handle to request (for use with @ref cancel and as @a after argument of @ref findPath)
+	 * 
+	 * @note When there is no worker threads, task is executed synchronously.
+	 */
+	RequestHandle runTask(
+		TaskFunction&& task,
+		CompletionCallback&& onComplete,
+		int priority = NORMAL_PRIORITY
+	);
+	
+	/**
+	 * @brief Cancel path search request – completion callback of this request will not be called.
+	 * 
+	 * @param request  handle to request returned by @ref findPath
+	 * 
+	 * @note When request is processing by worker thread, function waits for the worker to stop (it is only
+	 *       single A* iteration), so after return @a request->object will not be used by pool.
+	 */
+	void cancel(const RequestHandle& request);
+	
+	/**
+	 * @brief Deliver results of finished requests (call completion callbacks).
+	 * 
+	 * @copydoc MGE::MainLoopListener::update
+	 */
+	bool update(float gameTimeStep, float realTimeStep) override;
+	
+	/**
+	 * @brief Return number of worker threads (0 when requests are processing synchronously in @ref findPath).
+	 */
+	FORCE_INLINE unsigned int getWorkersCount() const {
+		return workers.size();
+	}
+	
+	/**
+	 * @brief Constructor – create worker threads.
+	 * 
+	 * @param workersCount  Number of worker threads. When negative use half of ``std::thread::hardware_concurrency()`` (at least one).
+	 *                      When zero all requests will be processed synchronously in @ref findPath.
+	 * @param maxQueueSize  Maximum number of queued (not processing) requests, 0 for no limit.
+	 */
+	PathFinderPool(int workersCount = -1, unsigned int maxQueueSize = 64);
+	
+	/**
+	 * @brief Destructor – cancel all requests, stop and join worker threads.
+	 */
+	~PathFinderPool();
+	
+protected:
+	/// worker threads main function
+	void workerLoop(MGE::PathFinder* pathFinder);
+	
+	/// add @a request to pending queue (or to dependents of @a after) or execute it synchronously when there is no worker threads
+	void queueRequest(const RequestHandle& request, const RequestHandle& after);
+	
+	/// add (not canceled) dependents of @a request to pending queue (@ref mutex must be locked)
+	void releaseDependents(Request* request);
+	
+	/// execute path search or task for @a request (without locking @ref mutex)
+	static void execute(MGE::PathFinder* pathFinder, Request* request);
+	
+	/// queued requests (ordered by priority, FIFO for this same priority)
+	std::multimap<int, RequestHandle, std::greater<int>> pendingRequests;
+	
+	/// finished requests waiting for delivery in @ref update
+	std::vector<RequestHandle> finishedRequests;
+	
+	/// requests currently processing by worker threads
+	std::set<Request*> runningRequests;
+	
+	/// maximum size of @ref pendingRequests (0 for no limit)
+	unsigned int maxQueueSize;
+	
+	/// worker threads
+	std::vector<std::thread> workers;
+	
+	/// path finders used by worker threads (and by synchronous mode)
+	std::vector<MGE::PathFinder*> pathFinders;
+	
+	/// when true workers should exit
+	bool stopWorkers;
+	
+	/// mutex for @ref pendingRequests, @ref finishedRequests, @ref runningRequests, @ref stopWorkers and requests state
+	std::mutex mutex;
+	
+	/// condition variable used to wake up workers when new request is queued
+	std::condition_variable requestCondition;
+	
+	/// condition variable used to notify @ref cancel about finish of running request
+	std::condition_variable finishCondition;
+};
+
+/// @}
+
+}
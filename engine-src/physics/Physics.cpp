@@ -26,15 +26,23 @@ Inspired by:
 
 #include "physics/Physics.h"
 
+#include "with.h"
+
 #include "ConfigParser.h"
 #include "SceneLoader.h"
 #include "StoreRestoreSystem.h"
+#include "Profiler.h"
 
 #include "data/structs/BaseActor.h"
 #include "physics/utils/HexagonalGrid.h"
-// #include "system/ScriptsSystem.h"
+#include "ScriptsSystem.h"
 #include "physics/Raycast.h"
 #include "physics/PathFinder.h"
+#include "physics/FlowField.h"
+#include "physics/utils/CoarseNavigationGrid.h"
+#include "physics/utils/NavigationField.h"
+#include "physics/utils/PathCache.h"
+#include "physics/utils/OgreColisionBoundingBox.h"
 #include "physics/utils/WorldSizeInfo.h"
 #include "data/utils/OgreSceneObjectInfo.h"
 
@@ -53,7 +61,8 @@ Inspired by:
 #endif
 
 #include <OgreEntity.h>
-#include <pybind11/gil.h>
+
+#include <algorithm>
 
 MGE::Physics::AnyHolder::~AnyHolder() {
 	LOG_DEBUG("delete physics object from any"); /// @todo TODO.4: TEST is this called while destroying node?
@@ -65,15 +74,25 @@ MGE::Physics::AnyHolder::~AnyHolder() {
 
 @subsection XMLNode_Physics \<Physics\>
 
-@c \<Physics\> is used for setup <b>Physics</b>. This node do not contain any subnodes nor attributes.
+@c \<Physics\> is used for setup <b>Physics</b>. This node can have following subnodes:
+  - @c \<TickRate\> number of simulation steps per second of game time (fixed time step), when 0 use variable time step
+    (one simulation step per frame), default 0 (fixed time step is opt-in, e.g. 60)
+  - @c \<MaxSubSteps\> maximum number of simulation steps in single frame (when simulation is more behind game time,
+    excess time is dropped), default 4
+  - @c \<Interpolation\> when true (default) transforms of dynamic objects written to Ogre are interpolated between
+    two last simulation steps (used only with fixed time step)
 */
 
 MGE_CONFIG_PARSER_MODULE_FOR_XMLTAG(Physics) {
-	return new MGE::Physics();
+	return new MGE::Physics(
+		xmlNode.child("TickRate").text().as_float(0),
+		xmlNode.child("MaxSubSteps").text().as_int(4),
+		xmlNode.child("Interpolation").text().as_bool(true)
+	);
 }
 
 
-MGE::Physics::Physics::Physics() :
+MGE::Physics::Physics::Physics(float tickRate, int maxSubSteps, bool interpolation) :
 	MGE::Unloadable(900)
 	, ogreTerrain(NULL)
 	, bulletWorld(NULL)
@@ -99,10 +118,24 @@ MGE::Physics::Physics::Physics() :
 		"physics", reinterpret_cast<MGE::SceneLoader::SceneNodesCreateFunction>(MGE::Physics::Physics::processPhysicsXMLNode)
 	);
 	#endif
+	
+	setTimeStepMode(tickRate, maxSubSteps, interpolation);
+}
+
+void MGE::Physics::Physics::setTimeStepMode(float tickRate, int maxSteps, bool interpolation) {
+	LOG_INFO("Physics", "Set time step mode: tickRate=" << tickRate << " maxSubSteps=" << maxSteps << " interpolation=" << interpolation);
+	fixedTimeStep    = tickRate > 0 ? 1.0f / tickRate : 0.0f;
+	maxSubSteps      = std::max(maxSteps, 1);
+	useInterpolation = interpolation;
+	timeAccumulator  = 0;
 }
 
 MGE::Physics::Physics::~Physics(void) {
 	unload();
+	delete MGE::CoarseNavigationGrid::getPtr();
+	delete MGE::NavigationField::getPtr();
+	delete MGE::FlowFieldCache::getPtr();
+	delete MGE::PathCache::getPtr();
 	
 	MGE::ConfigParser::getPtr()->remConfigParseListener(MGE::Physics::Physics::processWorldSizeXMLNode);
 	MGE::ConfigParser::getPtr()->remConfigParseListener(MGE::Physics::Physics::processTerrainXMLNode);
@@ -126,6 +159,15 @@ bool MGE::Physics::Physics::unload() {
 	
 	destroyBullet();
 	ogre2bullet.clearAll();
+	
+	if (MGE::CoarseNavigationGrid::getPtr())
+		MGE::CoarseNavigationGrid::getPtr()->clear();
+	if (MGE::NavigationField::getPtr())
+		MGE::NavigationField::getPtr()->clear();
+	if (MGE::FlowFieldCache::getPtr())
+		MGE::FlowFieldCache::getPtr()->clear();
+	if (MGE::PathCache::getPtr())
+		MGE::PathCache::getPtr()->clear();
 	return true;
 }
 
@@ -278,11 +320,39 @@ void MGE::Physics::Physics::clearDynamicsWorld(void) {
 
 bool MGE::Physics::Physics::update(float gameTimeStep, float realTimeStep) {
 #ifdef USE_BULLET
-	pybind11::gil_scoped_release();
-	ogre2bullet.updateAll();
+	// release GIL while syncing and stepping simulation (allow python threads to run),
+	// callbacks calling python code must use MGE_SCRIPTS_SYSTEM_GET_SCOPED_GIL
+	MGE_SCRIPTS_SYSTEM_RELEASE_SCOPED_GIL
+	{
+		MGE_PROFILER_ZONE("Physics::syncOgreToBullet");
+		ogre2bullet.updateAll();
+	}
 	
-	if (bulletWorld && gameTimeStep != 0)
-		bulletWorld->stepSimulation(gameTimeStep, 10);
+	if (bulletWorld && gameTimeStep != 0) {
+		MGE_PROFILER_ZONE("Physics::stepSimulation");
+		if (fixedTimeStep > 0) {
+			timeAccumulator += gameTimeStep;
+			
+			int steps = static_cast<int>(timeAccumulator / fixedTimeStep);
+			if (steps > maxSubSteps) {
+				LOG_VERBOSE("Physics", "simulation is " << steps << " steps behind, drop " << (steps - maxSubSteps) << " steps");
+				timeAccumulator -= (steps - maxSubSteps) * fixedTimeStep;
+				steps = maxSubSteps;
+			}
+			
+			for (int i=0; i<steps; ++i) {
+				if (useInterpolation && i == steps - 1)
+					ogre2bullet.storePreviousTransforms();
+				bulletWorld->stepSimulation(fixedTimeStep, 0);
+				timeAccumulator -= fixedTimeStep;
+			}
+			
+			if (useInterpolation)
+				ogre2bullet.interpolateAll(std::clamp(timeAccumulator / fixedTimeStep, 0.0f, 1.0f));
+		} else {
+			bulletWorld->stepSimulation(gameTimeStep, 10);
+		}
+	}
 	
 	#ifdef MGE_DEBUG_PHYSICS_DRAW
 	if ( debugDraw->getDebugMode() ) {
@@ -520,6 +590,12 @@ void MGE::Physics::Physics::deletePhysicsObject(btCollisionObject* physicsBody)
 #endif
 }
 
+void MGE::Physics::Physics::markTransformDirty(Ogre::Node* node) {
+#ifdef USE_BULLET
+	WITH_NOT_NULL(MGE::Physics::Physics::getPtr())->ogre2bullet.markDirty(node);
+#endif
+}
+
 /**
 @page XMLSyntax_MapAndSceneConfig
 
@@ -589,6 +665,19 @@ void MGE::Physics::Physics::processPhysicsXMLNode(
 		- @c size        grid size (distance between hexagon) used to init @ref MGE::HexagonalGridPoint
 		- @c pathFinderLimit  number of open-nodes iteration in MGE::PathFinder::findPath
 		- @c freeSpeceSearchLimit  number of iteration in @ref MGE::RayCast::findFreePosition
+		- @c clusterSize  size (in grid cells) of clusters of coarse navigation grid used for long-distance pathfinding
+		                  (see @ref MGE::CoarseNavigationGrid), 0 to disable coarse grid, default 16
+		- @c clusterMaxSlope  maximum slope (height difference / distance) between neighboring cells of coarse grid, default 1.0
+		- @c clusterPrebuild  when true coarse grid is built for whole world (see @c \<min\> and @c \<max\>) at map load time,
+		                      otherwise clusters are built on first use, default false
+		- @c navigationField  when true cache ground height, static collision objects and triggers for grid cells
+		                      (see @ref MGE::NavigationField) and use it in pathfinding for early rejection of edges
+		                      (accepted edges are still swept with mover bounding box against static collision objects), default true
+		- @c navigationFieldActors  when true pathfinding using navigation field also checks collisions with actors
+		                      (in this sweep), default true
+		- @c flowFieldMaxCells  maximum number of cells in flow field computed for group move orders (see @ref MGE::FlowFieldCache),
+		                      0 to disable flow fields, default 100000 (flow fields require enabled navigation field)
+		- @c pathCacheSize  maximum number of paths in LRU cache of found paths (see @ref MGE::PathCache), 0 to disable path cache, default 256
 */
 
 MGE::Module* MGE::Physics::Physics::processWorldSizeXMLNode(const pugi::xml_node& xmlNode, const MGE::LoadingContext* context) {
@@ -608,6 +697,81 @@ MGE::Module* MGE::Physics::Physics::processWorldSizeXMLNode(const pugi::xml_node
 	MGE::PathFinder::iterationLimit = xmlNode.child("searchGrid").attribute("pathFinderLimit").as_int(MGE::PathFinder::iterationLimit);
 	MGE::RayCast::defaultIterationLimit = xmlNode.child("searchGrid").attribute("freeSpeceSearchLimit").as_int(MGE::RayCast::defaultIterationLimit);
 	
+	Ogre::SceneManager* scnMgr = context->scnMgr;
+	
+	if (!MGE::NavigationField::getPtr())
+		new MGE::NavigationField();
+	if (xmlNode.child("searchGrid").attribute("navigationField").as_bool(true)) {
+		MGE::NavigationField::getPtr()->configure(
+			[scnMgr](const MGE::HexagonalGridPoint& cell, MGE::NavigationField::ProbeResult& result) {
+				Ogre::Vector3 point = cell.toOgre();
+				result.hasGround = MGE::RayCast::getGroundHeight(scnMgr, point);
+				if (!result.hasGround)
+					return;
+				result.groundHeight = point.y;
+				
+				// static (not actor) collision objects make cell not walkable, actors are checked by path finder
+				std::list<Ogre::MovableObject*> objects;
+				point.y += MGE::HexagonalGridPoint::distanceY;
+				MGE::OgreColisionBoundingBox::isFreeSphere(
+					scnMgr, point, MGE::HexagonalGridPoint::halfDistanceY,
+					MGE::QueryFlags::COLLISION_OBJECT | MGE::QueryFlags::TRIGGER, &objects
+				);
+				for (auto& object : objects) {
+					MGE::BaseActor* actor = MGE::BaseActor::get(object);
+					if (object->getQueryFlags() & MGE::QueryFlags::COLLISION_OBJECT) {
+						if (!actor)
+							result.blocked = true;
+					} else if (actor) {
+						result.triggers.push_back(actor);
+					}
+				}
+			},
+			xmlNode.child("searchGrid").attribute("navigationFieldActors").as_bool(true)
+		);
+	} else {
+		MGE::NavigationField::getPtr()->clear();
+	}
+	
+	delete MGE::FlowFieldCache::getPtr();
+	new MGE::FlowFieldCache(xmlNode.child("searchGrid").attribute("flowFieldMaxCells").as_uint(100000));
+	
+	delete MGE::PathCache::getPtr();
+	if (size_t pathCacheSize = xmlNode.child("searchGrid").attribute("pathCacheSize").as_uint(256))
+		new MGE::PathCache(pathCacheSize);
+	
+	if (!MGE::CoarseNavigationGrid::getPtr())
+		new MGE::CoarseNavigationGrid();
+	MGE::CoarseNavigationGrid::getPtr()->configure(
+		xmlNode.child("searchGrid").attribute("clusterSize").as_int(16),
+		xmlNode.child("searchGrid").attribute("clusterMaxSlope").as_float(1.0),
+		[scnMgr](const MGE::HexagonalGridPoint& cell, float& groundHeight) {
+			// use cached data when navigation field is enabled
+			MGE::NavigationField* field = MGE::NavigationField::getPtr();
+			if (field && field->isEnabled()) {
+				MGE::NavigationField::CellInfo info = field->getCell(cell);
+				groundHeight = info.groundHeight;
+				return info.isWalkable();
+			}
+			
+			Ogre::Vector3 point = cell.toOgre();
+			auto res = MGE::RayCast::searchVertical(
+				scnMgr, point.x, point.z, MGE::QueryFlags::GROUND | MGE::QueryFlags::COLLISION_OBJECT
+			);
+			if (!res->hasGround)
+				return false;
+			groundHeight = res->groundPoint.y;
+			
+			// static (not actor) collision objects make cell not walkable, actors are checked during refinement on fine grid
+			for (auto& hit : res->hitObjects) {
+				if (!hit.gameObject && hit.ogreObject && (hit.ogreObject->getQueryFlags() & MGE::QueryFlags::COLLISION_OBJECT))
+					return false;
+			}
+			return true;
+		},
+		xmlNode.child("searchGrid").attribute("clusterPrebuild").as_bool(false)
+	);
+	
 	#if defined(USE_BULLET) && defined(MGE_DEBUG_PHYSICS_DRAW)
 	MGE::Physics::Physics::getPtr()->createDebugDraw( context->scnMgr );
 	#endif
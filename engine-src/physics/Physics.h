@@ -101,6 +101,17 @@ public:
 	 */
 	bool update(float gameTimeStep, float realTimeStep) override;
 	
+	/**
+	 * @brief set simulation stepping mode
+	 * 
+	 * @param tickRate       number of simulation steps per second (of game time), when zero use variable time step
+	 *                       (one simulation step per frame, with length equal to frame game time)
+	 * @param maxSubSteps    maximum number of simulation steps in single frame (catch-up budget), when simulation is
+	 *                       more behind game time, excess time is dropped (simulation slows down)
+	 * @param interpolation  when true write to Ogre transforms of dynamic objects interpolated between two last simulation steps
+	 */
+	void setTimeStepMode(float tickRate, int maxSubSteps, bool interpolation);
+	
 	/**
 	 * @brief return pointer to DynamicsWorld
 	 */
@@ -174,6 +185,16 @@ public:
 	 */
 	static void deletePhysicsObject(btCollisionObject* physicsBody);
 	
+	/**
+	 * @brief mark transform of @a node (and all its descendants) as changed, so attached physics objects will be updated in next @ref update
+	 * 
+	 * @note Static physics objects are not checked every frame, so this must be called after change transform of its
+	 *       scene node (or its ancestor). Engine API (e.g. @ref MGE::World3DObject::setWorldPosition) do this automatically,
+	 *       but changes made directly via Ogre::Node API (also from Python) are not synchronised without this call
+	 *       (in scripts use @ref MGE::World3DObject::updateCachedTransform).
+	 */
+	static void markTransformDirty(Ogre::Node* node);
+	
 	/**
 	 * @brief create object physic based on XML config node
 	 * 
@@ -242,8 +263,10 @@ public:
 	 * @brief constructor -  create physics system
 	 * 
 	 * @note  after creating system required initializing via @ref configure()
+	 * 
+	 * @copydetails setTimeStepMode
 	 */
-	Physics();
+	Physics(float tickRate = 0, int maxSubSteps = 4, bool interpolation = true);
 	
 private:
 	/// destructor
@@ -264,6 +287,18 @@ private:
 	/// transform updater from Ogre to Bullet
 	MGE::OgreToBullet ogre2bullet;
 	
+	/// length of single simulation step in fixed time step mode, zero in variable time step mode
+	float fixedTimeStep;
+	
+	/// maximum number of simulation steps in single frame
+	int maxSubSteps;
+	
+	/// use interpolation of transforms in fixed time step mode
+	bool useInterpolation;
+	
+	/// game time not simulated yet (less than fixedTimeStep, except frames exceeding maxSubSteps)
+	float timeAccumulator;
+	
 	#ifdef USE_BULLET
 		btAxisSweep3* bulletBroadphase;
 		btDefaultCollisionConfiguration* bulletCollisionConfig;
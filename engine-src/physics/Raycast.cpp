@@ -94,6 +94,37 @@ void MGE::RayCast::Results::addResult(Ogre::SceneQueryResult& queryResult) {
 }
 
 
+size_t MGE::RayCast::getGroundHeights(Ogre::SceneManager* scnMgr, std::span<Ogre::Vector3> points, std::span<uint8_t> hasGround) {
+	static thread_local std::vector<MGE::OgreRayCast::RayQuery> rays;
+	static thread_local std::vector<MGE::OgreRayCast::RayHit>   hits;
+	
+	Ogre::Real maxY = MGE::WorldSizeInfo::getWorldMax().y;
+	Ogre::Real minY = MGE::WorldSizeInfo::getWorldMin().y;
+	
+	rays.clear();
+	for (auto& point : points) {
+		rays.push_back({ Ogre::Ray( Ogre::Vector3(point.x, maxY, point.z), Ogre::Vector3::NEGATIVE_UNIT_Y ), maxY - minY, MGE::QueryFlags::GROUND });
+	}
+	hits.resize(rays.size());
+	MGE::OgreRayCast::searchOnRays(scnMgr, rays, hits);
+	
+	// like getGroundHeight() (search with onlyFirst) - use only first hit and only when it is Item or Entity
+	size_t groundCount = 0;
+	for (size_t i = 0; i < points.size(); ++i) {
+		const Ogre::MovableObject* object = hits[i].object;
+		bool ground = object && (
+			object->getMovableType() == Ogre::ItemFactory::FACTORY_TYPE_NAME || object->getMovableType() == Ogre::v1::EntityFactory::FACTORY_TYPE_NAME
+		);
+		if (ground) {
+			points[i].y = hits[i].point.y;
+			++groundCount;
+		}
+		if (i < hasGround.size())
+			hasGround[i] = ground;
+	}
+	return groundCount;
+}
+
 void MGE::RayCast::searchOnBulletRay(MGE::RayCast::ResultsBase* results, const Ogre::Ray& ray, const Ogre::Vector3& rayTo, uint32_t searchMask, bool onlyFirst) {
 #ifdef USE_BULLET
 	if (MGE::Physics::Physics::getPtr()->getDynamicsWorld()) {
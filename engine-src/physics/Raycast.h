@@ -416,6 +416,19 @@ namespace RayCast {
 		}
 	}
 	
+	/**
+	 * @brief search for ground at all @a points and get ground heights (update y component in @a points with found ground)
+	 * 
+	 * Batched variant of @ref getGroundHeight - use single scene query for all points (see @ref MGE::OgreRayCast::searchOnRays).
+	 * 
+	 * @param[in]      scnMgr     pointer to SceneManager on which we do search
+	 * @param[in,out]  points     points to get ground height
+	 * @param[out]     hasGround  when not empty, i-th element is set to 1 when found ground for i-th point, 0 otherwise
+	 * 
+	 * @return number of points with found ground
+	 */
+	size_t getGroundHeights( Ogre::SceneManager* scnMgr, std::span<Ogre::Vector3> points, std::span<uint8_t> hasGround = {} );
+	
 	/**
 	 * @brief find free position for placing object near the point
 	 * 
@@ -98,6 +98,7 @@ void MGE::TimerSet::addTimer(unsigned int period, const std::string_view& script
 
 int MGE::TimerSet::runTimer(TimerInstance* timer, int behind) {
 	DEBUG2_LOG("run timer: " << timer->name << " / " << timer->scriptName);
+	MGE::ScriptsSystem::ProfilingCallerScope profilingCaller("TimeSystem");
 	
 	bool callbackRet = false;
 	while( behind >= 0 ) {
@@ -0,0 +1,644 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "physics/utils/CoarseNavigationGrid.h"
+
+#include "LogSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+MGE::CoarseNavigationGrid::CoarseNavigationGrid() :
+	clusterSize(0),
+	maxSlope(1.0f),
+	prebuild(false),
+	generation(0)
+{
+	LOG_INFO("Create CoarseNavigationGrid");
+}
+
+MGE::CoarseNavigationGrid::~CoarseNavigationGrid() {
+	LOG_INFO("Destroy CoarseNavigationGrid");
+}
+
+void MGE::CoarseNavigationGrid::configure(int _clusterSize, float _maxSlope, CellProbe&& _probe, bool _prebuild) {
+	std::unique_lock<std::shared_mutex> lock(mutex);
+	LOG_INFO("Configure CoarseNavigationGrid with clusterSize=" << _clusterSize << " maxSlope=" << _maxSlope << " prebuild=" << _prebuild);
+	
+	clusters.clear();
+	borders.clear();
+	nodes.clear();
+	freeNodes.clear();
+	++generation;
+	
+	maxSlope    = _maxSlope;
+	prebuild    = _prebuild;
+	probe       = std::move(_probe);
+	clusterSize = (_clusterSize >= 4 && probe) ? _clusterSize : 0;
+}
+
+void MGE::CoarseNavigationGrid::clear() {
+	std::unique_lock<std::shared_mutex> lock(mutex);
+	LOG_INFO("Clear CoarseNavigationGrid");
+	
+	clusterSize = 0;
+	probe       = nullptr;
+	
+	clusters.clear();
+	borders.clear();
+	nodes.clear();
+	freeNodes.clear();
+	++generation;
+}
+
+bool MGE::CoarseNavigationGrid::isLongPath(const Ogre::Vector3& start, const Ogre::Vector3& finish) const {
+	if (!isEnabled())
+		return false;
+	
+	MGE::HexagonalGridPoint startCell(start), finishCell(finish);
+	return std::abs(toClusterCoord(startCell.a) - toClusterCoord(finishCell.a)) > 1 ||
+	       std::abs(toClusterCoord(startCell.b) - toClusterCoord(finishCell.b)) > 1;
+}
+
+size_t MGE::CoarseNavigationGrid::getBuiltClustersCount() {
+	std::shared_lock<std::shared_mutex> lock(mutex);
+	size_t count = 0;
+	for (auto& iter : clusters) {
+		if (iter.second.built)
+			++count;
+	}
+	return count;
+}
+
+size_t MGE::CoarseNavigationGrid::getNodesCount() {
+	std::shared_lock<std::shared_mutex> lock(mutex);
+	return nodes.size() - freeNodes.size();
+}
+
+
+/*--------------------- cells and nodes ---------------------*/
+
+MGE::CoarseNavigationGrid::Cluster& MGE::CoarseNavigationGrid::getCluster(uint32_t key) {
+	Cluster& cluster = clusters[key];
+	if (cluster.cells.empty())
+		cluster.cells.resize(clusterSize * clusterSize, Cell{0, Cell::UNKNOWN});
+	return cluster;
+}
+
+MGE::CoarseNavigationGrid::Cell& MGE::CoarseNavigationGrid::getCellSlot(const MGE::HexagonalGridPoint& point) {
+	int16_t ca = toClusterCoord(point.a), cb = toClusterCoord(point.b);
+	Cluster& cluster = getCluster(MGE::SearchHashMap<uint32_t, int>::packPoint(ca, cb));
+	return cluster.cells[(point.a - ca * clusterSize) + (point.b - cb * clusterSize) * clusterSize];
+}
+
+const MGE::CoarseNavigationGrid::Cell& MGE::CoarseNavigationGrid::getCell(const MGE::HexagonalGridPoint& point) const {
+	static const Cell unknownCell{0, Cell::UNKNOWN};
+	
+	int16_t ca = toClusterCoord(point.a), cb = toClusterCoord(point.b);
+	auto iter = clusters.find(MGE::SearchHashMap<uint32_t, int>::packPoint(ca, cb));
+	if (iter == clusters.end() || iter->second.cells.empty())
+		return unknownCell;
+	return iter->second.cells[(point.a - ca * clusterSize) + (point.b - cb * clusterSize) * clusterSize];
+}
+
+bool MGE::CoarseNavigationGrid::isBuilt(uint32_t key) const {
+	auto iter = clusters.find(key);
+	return iter != clusters.end() && iter->second.built;
+}
+
+float MGE::CoarseNavigationGrid::getStepCost(const MGE::HexagonalGridPoint& from, const MGE::HexagonalGridPoint& to, int mode) const {
+	const Cell& fromCell = getCell(from);
+	const Cell& toCell   = getCell(to);
+	if (fromCell.state != Cell::WALKABLE || toCell.state != Cell::WALKABLE)
+		return -1;
+	
+	float cost = from.getNeighborCost(mode);
+	if (std::abs(toCell.height - fromCell.height) > maxSlope * cost)
+		return -1;
+	
+	return cost;
+}
+
+uint32_t MGE::CoarseNavigationGrid::createNode(const MGE::HexagonalGridPoint& cell, uint32_t cluster) {
+	uint32_t id;
+	if (freeNodes.empty()) {
+		id = nodes.size();
+		nodes.emplace_back();
+	} else {
+		id = freeNodes.back();
+		freeNodes.pop_back();
+	}
+	
+	Node& node     = nodes[id];
+	node.id        = id;
+	node.cell      = cell;
+	node.cluster   = cluster;
+	node.used      = true;
+	node.edges.clear();
+	return id;
+}
+
+void MGE::CoarseNavigationGrid::releaseNode(uint32_t id) {
+	nodes[id].used = false;
+	nodes[id].edges.clear();
+	freeNodes.push_back(id);
+}
+
+
+/*--------------------- abstract graph building ---------------------*/
+
+void MGE::CoarseNavigationGrid::buildBorder(uint32_t keyA, uint32_t keyB) {
+	if (keyA > keyB)
+		std::swap(keyA, keyB);
+	
+	uint64_t borderKey = MGE::SearchHashMap<uint64_t, int>::packPair(keyA, keyB);
+	if (borders.count(borderKey))
+		return;
+	std::vector<uint32_t>& borderNodes = borders[borderKey];
+	
+	MGE::Point16 clusterA(static_cast<int32_t>(keyA));
+	
+	// find transitions (pair of neighboring cells in different clusters with possible step in least one direction)
+	struct Transition {
+		MGE::HexagonalGridPoint from, to;
+		float costForward, costBackward;
+		int   group;
+	};
+	std::vector<Transition> transitions;
+	
+	for (int16_t b = 0; b < clusterSize; ++b) {
+		for (int16_t a = 0; a < clusterSize; ++a) {
+			// neighbors can be up to 2 cells away (see MGE::HexagonalGridPoint::neighborOffset), so skip cluster interior
+			if (a >= 2 && a < clusterSize - 2 && b >= 2 && b < clusterSize - 2)
+				continue;
+			
+			MGE::HexagonalGridPoint cell(clusterA.a * clusterSize + a, clusterA.b * clusterSize + b);
+			int bIndex = cell.getBIndex();
+			for (int i=0; i<cell.getNeighborCount(); ++i) {
+				MGE::HexagonalGridPoint neighbor = cell.getNeighbor(i, bIndex);
+				if (getClusterKey(neighbor) != keyB)
+					continue;
+				
+				int   mode         = cell.getNeighborMode(i);
+				float costForward  = getStepCost(cell, neighbor, mode);
+				float costBackward = getStepCost(neighbor, cell, mode);
+				if (costForward >= 0 || costBackward >= 0)
+					transitions.push_back({cell, neighbor, costForward, costBackward, -1});
+			}
+		}
+	}
+	
+	// group transitions into entrances – connected sets of transitions with neighboring (or the same) source cells
+	int groupsCount = 0;
+	for (size_t i=0; i<transitions.size(); ++i) {
+		if (transitions[i].group >= 0)
+			continue;
+		
+		transitions[i].group = groupsCount;
+		std::vector<size_t> stack = {i};
+		while (!stack.empty()) {
+			const MGE::HexagonalGridPoint& cell = transitions[stack.back()].from;
+			stack.pop_back();
+			for (size_t j=0; j<transitions.size(); ++j) {
+				if (transitions[j].group >= 0)
+					continue;
+				const MGE::HexagonalGridPoint& other = transitions[j].from;
+				if (std::abs(other.a - cell.a) <= 1 && std::abs(other.b - cell.b) <= 2) {
+					transitions[j].group = groupsCount;
+					stack.push_back(j);
+				}
+			}
+		}
+		++groupsCount;
+	}
+	
+	// for each entrance select transition closest to entrance center and create nodes for it
+	for (int g=0; g<groupsCount; ++g) {
+		float sumA = 0, sumB = 0;
+		int   count = 0;
+		for (auto& t : transitions) {
+			if (t.group == g) {
+				sumA += t.from.a;
+				sumB += t.from.b;
+				++count;
+			}
+		}
+		
+		const Transition* best = nullptr;
+		float bestDist = 0;
+		for (auto& t : transitions) {
+			if (t.group != g)
+				continue;
+			float dist = std::abs(t.from.a - sumA / count) + std::abs(t.from.b - sumB / count);
+			// prefer transitions possible in both directions
+			if (t.costForward < 0 || t.costBackward < 0)
+				dist += clusterSize;
+			if (!best || dist < bestDist) {
+				best     = &t;
+				bestDist = dist;
+			}
+		}
+		
+		uint32_t nodeA = createNode(best->from, keyA);
+		uint32_t nodeB = createNode(best->to,   keyB);
+		if (best->costForward >= 0)
+			nodes[nodeA].edges.push_back({nodeB, best->costForward, true});
+		if (best->costBackward >= 0)
+			nodes[nodeB].edges.push_back({nodeA, best->costBackward, true});
+		
+		getCluster(keyA).nodes.push_back(nodeA);
+		getCluster(keyB).nodes.push_back(nodeB);
+		borderNodes.push_back(nodeA);
+		borderNodes.push_back(nodeB);
+	}
+}
+
+void MGE::CoarseNavigationGrid::buildCluster(uint32_t key) {
+	if (getCluster(key).built)
+		return;
+	
+	// create borders with all (8) neighboring clusters
+	MGE::Point16 clusterCoord(static_cast<int32_t>(key));
+	for (int db = -1; db <= 1; ++db) {
+		for (int da = -1; da <= 1; ++da) {
+			if (da || db)
+				buildBorder(key, MGE::SearchHashMap<uint32_t, int>::packPoint(clusterCoord.a + da, clusterCoord.b + db));
+		}
+	}
+	
+	// (re)calculate intra cluster edges
+	Cluster& cluster = getCluster(key);
+	std::vector<MGE::HexagonalGridPoint> targets;
+	for (uint32_t id : cluster.nodes)
+		targets.push_back(nodes[id].cell);
+	
+	std::vector<float> costs;
+	for (uint32_t id : cluster.nodes) {
+		auto& edges = nodes[id].edges;
+		edges.erase(std::remove_if(edges.begin(), edges.end(), [](const Edge& e) { return !e.inter; }), edges.end());
+		
+		searchInCluster(nodes[id].cell, false, targets, costs);
+		for (size_t i=0; i<cluster.nodes.size(); ++i) {
+			if (costs[i] >= 0 && cluster.nodes[i] != id)
+				edges.push_back({cluster.nodes[i], costs[i], false});
+		}
+	}
+	
+	cluster.built = true;
+	LOG_DEBUG("CoarseNavigationGrid: built cluster " << clusterCoord << " with " << cluster.nodes.size() << " entrances");
+}
+
+void MGE::CoarseNavigationGrid::collectUnknownCells(uint32_t key, std::vector<MGE::HexagonalGridPoint>& cells) const {
+	// building borders use neighbors of cluster cells, they can be up to 2 cells away (see MGE::HexagonalGridPoint::neighborOffset)
+	MGE::Point16 clusterCoord(static_cast<int32_t>(key));
+	int size = clusterSize;
+	for (int b = clusterCoord.b * size - 2; b < (clusterCoord.b + 1) * size + 2; ++b) {
+		for (int a = clusterCoord.a * size - 2; a < (clusterCoord.a + 1) * size + 2; ++a) {
+			MGE::HexagonalGridPoint cell(a, b);
+			if (getCell(cell).state == Cell::UNKNOWN)
+				cells.push_back(cell);
+		}
+	}
+}
+
+bool MGE::CoarseNavigationGrid::ensureBuilt(const std::vector<uint32_t>& keys) {
+	// probe results are dropped when data was invalidated during probing, so retry few times
+	for (int attempt = 0; attempt < 4; ++attempt) {
+		std::vector<MGE::HexagonalGridPoint> points;
+		CellProbe probeFunc;
+		uint32_t  probeGeneration;
+		{
+			std::shared_lock<std::shared_mutex> lock(mutex);
+			if (!isEnabled())
+				return false;
+			
+			bool allBuilt = true;
+			for (uint32_t key : keys) {
+				if (!isBuilt(key)) {
+					allBuilt = false;
+					collectUnknownCells(key, points);
+				}
+			}
+			if (allBuilt)
+				return true;
+			
+			probeFunc       = probe;
+			probeGeneration = generation;
+		}
+		
+		// probe without lock (it can use scene queries), so workers can probe different cells in parallel
+		std::vector<Cell> results(points.size());
+		for (size_t i=0; i<points.size(); ++i) {
+			results[i].state = probeFunc(points[i], results[i].height) ? Cell::WALKABLE : Cell::BLOCKED;
+		}
+		
+		std::unique_lock<std::shared_mutex> lock(mutex);
+		if (probeGeneration != generation)
+			continue;
+		
+		// cells could be probed by other thread in meantime – keep its results
+		for (size_t i=0; i<points.size(); ++i) {
+			Cell& cell = getCellSlot(points[i]);
+			if (cell.state == Cell::UNKNOWN)
+				cell = results[i];
+		}
+		for (uint32_t key : keys) {
+			buildCluster(key);
+		}
+		return true;
+	}
+	
+	LOG_WARNING("CoarseNavigationGrid: can't build clusters – data was invalidated during each probing attempt");
+	return false;
+}
+
+void MGE::CoarseNavigationGrid::searchInCluster(const MGE::HexagonalGridPoint& from, bool reverse, const std::vector<MGE::HexagonalGridPoint>& targets, std::vector<float>& costs) const {
+	int16_t ca = toClusterCoord(from.a), cb = toClusterCoord(from.b);
+	int     size = clusterSize;
+	auto    toIndex = [ca, cb, size](const MGE::HexagonalGridPoint& p) {
+		return (p.a - ca * size) + (p.b - cb * size) * size;
+	};
+	
+	std::vector<float> dist(size * size, -1);
+	std::priority_queue<std::pair<float, int>, std::vector<std::pair<float, int>>, std::greater<std::pair<float, int>>> queue;
+	
+	dist[toIndex(from)] = 0;
+	queue.emplace(0, toIndex(from));
+	while (!queue.empty()) {
+		auto [currDist, currIndex] = queue.top();
+		queue.pop();
+		if (currDist > dist[currIndex])
+			continue;
+		
+		MGE::HexagonalGridPoint cell(ca * size + currIndex % size, cb * size + currIndex / size);
+		int bIndex = cell.getBIndex();
+		for (int i=0; i<cell.getNeighborCount(); ++i) {
+			MGE::HexagonalGridPoint neighbor = cell.getNeighbor(i, bIndex);
+			if (toClusterCoord(neighbor.a) != ca || toClusterCoord(neighbor.b) != cb)
+				continue;
+			
+			int   mode = cell.getNeighborMode(i);
+			float cost = reverse ? getStepCost(neighbor, cell, mode) : getStepCost(cell, neighbor, mode);
+			if (cost < 0)
+				continue;
+			
+			int   neighborIndex = toIndex(neighbor);
+			float newDist       = currDist + cost;
+			if (dist[neighborIndex] < 0 || newDist < dist[neighborIndex]) {
+				dist[neighborIndex] = newDist;
+				queue.emplace(newDist, neighborIndex);
+			}
+		}
+	}
+	
+	costs.resize(targets.size());
+	for (size_t i=0; i<targets.size(); ++i) {
+		costs[i] = dist[toIndex(targets[i])];
+	}
+}
+
+void MGE::CoarseNavigationGrid::invalidateCluster(uint32_t key) {
+	auto clusterIter = clusters.find(key);
+	if (clusterIter == clusters.end())
+		return;
+	
+	// remove borders of this cluster (and its nodes from neighbors)
+	MGE::Point16 clusterCoord(static_cast<int32_t>(key));
+	for (int db = -1; db <= 1; ++db) {
+		for (int da = -1; da <= 1; ++da) {
+			if (!da && !db)
+				continue;
+			
+			uint32_t neighborKey = MGE::SearchHashMap<uint32_t, int>::packPoint(clusterCoord.a + da, clusterCoord.b + db);
+			auto borderIter = borders.find(MGE::SearchHashMap<uint64_t, int>::packPair(std::min(key, neighborKey), std::max(key, neighborKey)));
+			if (borderIter == borders.end())
+				continue;
+			
+			auto neighborIter = clusters.find(neighborKey);
+			if (neighborIter != clusters.end()) {
+				// neighbor's nodes on this border will be released below, so remove them from neighbor
+				auto& neighborNodes = neighborIter->second.nodes;
+				for (uint32_t id : borderIter->second) {
+					if (nodes[id].cluster == neighborKey)
+						neighborNodes.erase(std::remove(neighborNodes.begin(), neighborNodes.end(), id), neighborNodes.end());
+				}
+				// intra cluster edges of neighbor must be recalculated
+				neighborIter->second.built = false;
+			}
+			
+			for (uint32_t id : borderIter->second)
+				releaseNode(id);
+			borders.erase(borderIter);
+		}
+	}
+	
+	clusters.erase(clusterIter);
+}
+
+void MGE::CoarseNavigationGrid::forEachCluster(const Ogre::Vector3& min, const Ogre::Vector3& max, const std::function<void(uint32_t key)>& func) const {
+	// cells are selected by rounding, so extend area by one cell on each side
+	MGE::HexagonalGridPoint minCell(min), maxCell(max);
+	int16_t caMin = toClusterCoord(std::min(minCell.a, maxCell.a) - 1), caMax = toClusterCoord(std::max(minCell.a, maxCell.a) + 1);
+	int16_t cbMin = toClusterCoord(std::min(minCell.b, maxCell.b) - 1), cbMax = toClusterCoord(std::max(minCell.b, maxCell.b) + 1);
+	
+	for (int cb = cbMin; cb <= cbMax; ++cb) {
+		for (int ca = caMin; ca <= caMax; ++ca) {
+			func(MGE::SearchHashMap<uint32_t, int>::packPoint(ca, cb));
+		}
+	}
+}
+
+void MGE::CoarseNavigationGrid::invalidateArea(const Ogre::Vector3& min, const Ogre::Vector3& max) {
+	std::unique_lock<std::shared_mutex> lock(mutex);
+	if (!isEnabled())
+		return;
+	
+	++generation;
+	LOG_INFO("CoarseNavigationGrid: invalidate area from " << min << " to " << max);
+	forEachCluster(min, max, [this](uint32_t key) { invalidateCluster(key); });
+}
+
+void MGE::CoarseNavigationGrid::build(const Ogre::Vector3& min, const Ogre::Vector3& max) {
+	if (!isEnabled())
+		return;
+	
+	LOG_INFO("CoarseNavigationGrid: build area from " << min << " to " << max);
+	std::vector<uint32_t> keys;
+	forEachCluster(min, max, [&keys](uint32_t key) { keys.push_back(key); });
+	ensureBuilt(keys);
+	LOG_INFO("CoarseNavigationGrid: build finished with " << getBuiltClustersCount() << " clusters and " << getNodesCount() << " nodes");
+}
+
+
+/*--------------------- abstract graph search ---------------------*/
+
+bool MGE::CoarseNavigationGrid::findPath(
+	const Ogre::Vector3& start, const Ogre::Vector3& finish,
+	std::vector<Ogre::Vector3>& waypoints,
+	const std::atomic<bool>* cancelFlag
+) {
+	waypoints.clear();
+	if (!isEnabled())
+		return false;
+	
+	MGE::HexagonalGridPoint startCell(start), finishCell(finish);
+	std::vector<uint32_t> toBuild = { getClusterKey(startCell), getClusterKey(finishCell) };
+	
+	// abstract graph is built lazily – search stops expanding on not built clusters, so build them and repeat search
+	while (true) {
+		if (!ensureBuilt(toBuild))
+			return false;
+		if (cancelFlag && cancelFlag->load(std::memory_order_relaxed))
+			return false;
+		
+		std::shared_lock<std::shared_mutex> lock(mutex);
+		if (!isEnabled())
+			return false;
+		
+		toBuild.clear();
+		bool found = search(startCell, finishCell, waypoints, toBuild, cancelFlag);
+		if (toBuild.empty()) {
+			LOG_INFO("CoarseNavigationGrid: findPath from " << startCell << " to " << finishCell << (found ? " found path with " : " not found path, ") << waypoints.size() << " waypoints");
+			return found;
+		}
+		waypoints.clear();
+	}
+}
+
+bool MGE::CoarseNavigationGrid::search(
+	const MGE::HexagonalGridPoint& startCell, const MGE::HexagonalGridPoint& finishCell,
+	std::vector<Ogre::Vector3>& waypoints, std::vector<uint32_t>& toBuild,
+	const std::atomic<bool>* cancelFlag
+) const {
+	uint32_t startCluster  = getClusterKey(startCell);
+	uint32_t finishCluster = getClusterKey(finishCell);
+	
+	// clusters could be invalidated after ensureBuilt()
+	for (uint32_t key : {startCluster, finishCluster}) {
+		if (!isBuilt(key))
+			toBuild.push_back(key);
+	}
+	if (!toBuild.empty())
+		return false;
+	
+	// connect start and finish cells to entrances of its clusters (via virtual nodes)
+	const std::vector<uint32_t>& startEntrances = clusters.at(startCluster).nodes;
+	std::vector<MGE::HexagonalGridPoint> targets;
+	for (uint32_t id : startEntrances)
+		targets.push_back(nodes[id].cell);
+	if (startCluster == finishCluster)
+		targets.push_back(finishCell);
+	std::vector<float> startCosts;
+	searchInCluster(startCell, false, targets, startCosts);
+	
+	const std::vector<uint32_t>& finishEntrances = clusters.at(finishCluster).nodes;
+	targets.clear();
+	for (uint32_t id : finishEntrances)
+		targets.push_back(nodes[id].cell);
+	std::vector<float> finishCosts;
+	searchInCluster(finishCell, true, targets, finishCosts);
+	
+	// A* on abstract graph (with local search data, so searches can run in parallel)
+	std::unordered_map<uint32_t, SearchNode> searchNodes;
+	MGE::IndexedBinaryHeap<SearchNode, &SearchNode::totalCost, &SearchNode::heapIndex> openNodes;
+	
+	auto getNodeCell = [&](uint32_t id) -> const MGE::HexagonalGridPoint& {
+		return (id == START_NODE) ? startCell : ((id == FINISH_NODE) ? finishCell : nodes[id].cell);
+	};
+	auto openNode = [&](uint32_t id, uint32_t parent, float costFromStart) {
+		auto [iter, inserted] = searchNodes.try_emplace(id);
+		SearchNode& node = iter->second;
+		if (inserted) {
+			node.id        = id;
+			node.closed    = false;
+			node.heapIndex = -1;
+		} else if (node.closed || costFromStart >= node.costFromStart) {
+			return;
+		}
+		node.costFromStart = costFromStart;
+		node.totalCost     = costFromStart + costEstimate(getNodeCell(id), finishCell);
+		node.parent        = parent;
+		openNodes.update(&node);
+	};
+	
+	openNode(START_NODE, START_NODE, 0);
+	
+	bool found = false;
+	while (!openNodes.empty()) {
+		if (cancelFlag && cancelFlag->load(std::memory_order_relaxed))
+			break;
+		
+		SearchNode* currNode = openNodes.pop();
+		currNode->closed = true;
+		
+		if (currNode->id == FINISH_NODE) {
+			found = true;
+			break;
+		}
+		
+		if (currNode->id == START_NODE) {
+			for (size_t i=0; i<startEntrances.size(); ++i) {
+				if (startCosts[i] >= 0)
+					openNode(startEntrances[i], START_NODE, startCosts[i]);
+			}
+			if (startCluster == finishCluster && startCosts.back() >= 0)
+				openNode(FINISH_NODE, START_NODE, startCosts.back());
+			continue;
+		}
+		
+		// abstract graph is built lazily – cluster must be built before use edges of its node
+		const Node& node = nodes[currNode->id];
+		if (!isBuilt(node.cluster)) {
+			if (std::find(toBuild.begin(), toBuild.end(), node.cluster) == toBuild.end())
+				toBuild.push_back(node.cluster);
+			continue;
+		}
+		
+		for (auto& edge : node.edges) {
+			openNode(edge.target, currNode->id, currNode->costFromStart + edge.cost);
+		}
+		
+		if (node.cluster == finishCluster) {
+			for (size_t i=0; i<finishEntrances.size(); ++i) {
+				if (finishEntrances[i] == currNode->id && finishCosts[i] >= 0)
+					openNode(FINISH_NODE, currNode->id, currNode->costFromStart + finishCosts[i]);
+			}
+		}
+	}
+	
+	// get waypoints – entry points of subsequent clusters on found path
+	if (found && toBuild.empty()) {
+		for (uint32_t id = searchNodes[FINISH_NODE].parent; id != START_NODE; id = searchNodes[id].parent) {
+			const Node& node = nodes[id];
+			uint32_t parent = searchNodes[id].parent;
+			if ((parent == START_NODE ? startCluster : nodes[parent].cluster) != node.cluster) {
+				Ogre::Vector3 point = node.cell.toOgre();
+				point.y = getCell(node.cell).height;
+				waypoints.push_back(point);
+			}
+		}
+		std::reverse(waypoints.begin(), waypoints.end());
+	}
+	
+	return found;
+}
@@ -0,0 +1,343 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma   once
+
+#include "BaseClasses.h"
+
+#include "physics/utils/HexagonalGrid.h"
+#include "physics/utils/SearchContainers.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace MGE {
+
+/// @addtogroup Physics
+/// @{
+/// @file
+
+/**
+ * @brief Hierarchical (HPA* style) coarse navigation layer over @ref MGE::HexagonalGridPoint grid, used for long-distance pathfinding.
+ * 
+ * Hexagonal grid is split into square (in grid coordinates) clusters of @a clusterSize × @a clusterSize cells.
+ * On each border between two clusters there are entrances (pair of nodes – one on each side of the border)
+ * and inside each cluster there are precomputed path costs between all its entrances.
+ * Long queries are answered by A* search on this (small) abstract graph, result is list of waypoints
+ * (entry points of subsequent clusters) that should be refined by fine grid search (see @ref MGE::PathFinder::findPath).
+ * 
+ * Walkability and ground height of cells are read from map data via @ref CellProbe (e.g. ground raycast) and cached.
+ * Clusters (with its borders) are built lazily – on first query using them, and after change of obstacles
+ * only clusters affected by @ref invalidateArea are rebuilt.
+ * 
+ * Coarse layer is independent of moving object (its size, collisions with actors, etc.) – this is checked
+ * during fine refinement.
+ * 
+ * All public functions are thread safe (path finding workers can use this object in parallel).
+ * Searches on already built clusters run in parallel (under shared lock), cells are probed without lock
+ * and only adding probe results and building clusters require exclusive lock.
+ */
+class CoarseNavigationGrid :
+	public MGE::Singleton<CoarseNavigationGrid>
+{
+public:
+	/**
+	 * @brief Type of function used to read map data for single grid cell.
+	 * 
+	 * @param[in]  cell          grid cell to check
+	 * @param[out] groundHeight  ground height at @a cell center
+	 * 
+	 * @return true when cell is walkable
+	 */
+	typedef std::function<bool(const MGE::HexagonalGridPoint& cell, float& groundHeight)> CellProbe;
+	
+	/**
+	 * @brief Configure (and enable) coarse grid, remove all cached data.
+	 * 
+	 * @param clusterSize  cluster size (in grid cells), when lower than 4 coarse grid is disabled
+	 * @param maxSlope     maximum slope (height difference / distance) for step between neighboring cells
+	 * @param probe        function used to read map data for grid cells
+	 * @param prebuild     when true clusters should be built at map load time (see @ref build) instead of on first use
+	 */
+	void configure(int clusterSize, float maxSlope, CellProbe&& probe, bool prebuild = false);
+	
+	/**
+	 * @brief Return true when clusters should be built at map load time.
+	 */
+	inline bool usePrebuild() const {
+		return prebuild;
+	}
+	
+	/**
+	 * @brief Build abstract graph for all clusters overlapping (x,z) area from @a min to @a max (e.g. whole map at load time).
+	 */
+	void build(const Ogre::Vector3& min, const Ogre::Vector3& max);
+	
+	/**
+	 * @brief Remove all cached data and disable coarse grid (until next @ref configure).
+	 */
+	void clear();
+	
+	/**
+	 * @brief Return true when coarse grid is configured and enabled.
+	 */
+	inline bool isEnabled() const {
+		return clusterSize > 0;
+	}
+	
+	/**
+	 * @brief Return true when path between @a start and @a finish should use coarse search
+	 *        (coarse grid is enabled and points are not in the same or neighboring clusters).
+	 */
+	bool isLongPath(const Ogre::Vector3& start, const Ogre::Vector3& finish) const;
+	
+	/**
+	 * @brief Find path on coarse grid.
+	 * 
+	 * @param[in]  start       start point
+	 * @param[in]  finish      stop point
+	 * @param[out] waypoints   intermediate points of found path (with ground height in y coordinate),
+	 *                         without @a start and @a finish
+	 * @param[in]  cancelFlag  pointer to cancellation flag (checked in each iteration of A* loop), can be NULL
+	 * 
+	 * @return true when path was found
+	 */
+	bool findPath(
+		const Ogre::Vector3& start, const Ogre::Vector3& finish,
+		std::vector<Ogre::Vector3>& waypoints,
+		const std::atomic<bool>* cancelFlag = nullptr
+	);
+	
+	/**
+	 * @brief Mark area as changed (e.g. building or obstacle was added / removed / moved),
+	 *        clusters overlapping this area will be rebuilt on next query using them.
+	 * 
+	 * @param min  minimum (x,z) corner of changed area
+	 * @param max  maximum (x,z) corner of changed area
+	 */
+	void invalidateArea(const Ogre::Vector3& min, const Ogre::Vector3& max);
+	
+	/**
+	 * @brief Return number of clusters with built abstract graph.
+	 */
+	size_t getBuiltClustersCount();
+	
+	/**
+	 * @brief Return number of abstract graph nodes (entrances sides).
+	 */
+	size_t getNodesCount();
+	
+	/// constructor
+	CoarseNavigationGrid();
+	
+	/// destructor
+	~CoarseNavigationGrid();
+	
+protected:
+	/// cached cell info
+	struct Cell {
+		/// ground height
+		float   height;
+		/// cell state
+		enum State : uint8_t { UNKNOWN = 0, WALKABLE, BLOCKED } state;
+	};
+	
+	/// edge of abstract graph
+	struct Edge {
+		/// target node id
+		uint32_t target;
+		/// path cost
+		float    cost;
+		/// true for edge between clusters (entrance edge), false for intra cluster edge
+		bool     inter;
+	};
+	
+	/// node of abstract graph
+	struct Node {
+		/// id of this node (index in @ref nodes)
+		uint32_t          id;
+		/// grid cell of this node
+		MGE::HexagonalGridPoint cell;
+		/// key of cluster with this node
+		uint32_t          cluster;
+		/// output edges
+		std::vector<Edge> edges;
+		/// true when node is used (not on @ref freeNodes list)
+		bool              used;
+	};
+	
+	/// A* search data of abstract graph node (local for each search, so searches can run in parallel)
+	struct SearchNode {
+		/// id of node (index in @ref nodes or @ref START_NODE / @ref FINISH_NODE)
+		uint32_t          id;
+		/// cost from start
+		float             costFromStart;
+		/// estimate total cost (priority in open list)
+		float             totalCost;
+		/// parent node id
+		uint32_t          parent;
+		/// position in open list heap
+		int32_t           heapIndex;
+		/// node was closed
+		bool              closed;
+	};
+	
+	/// id of (virtual) search start node
+	static constexpr uint32_t START_NODE  = UINT32_MAX - 1;
+	
+	/// id of (virtual) search finish node
+	static constexpr uint32_t FINISH_NODE = UINT32_MAX;
+	
+	/// cluster data
+	struct Cluster {
+		/// cached cells info (@ref clusterSize × @ref clusterSize array)
+		std::vector<Cell>     cells;
+		/// ids of nodes (entrances) in this cluster
+		std::vector<uint32_t> nodes;
+		/// true when intra cluster edges are computed (and all borders with neighbors exist)
+		bool                  built = false;
+	};
+	
+	/// cluster size in cells, 0 when coarse grid is disabled
+	std::atomic<int> clusterSize;
+	
+	/// maximum slope for step between neighboring cells
+	float maxSlope;
+	
+	/// build clusters at map load time
+	bool prebuild;
+	
+	/// function used to read map data
+	CellProbe probe;
+	
+	/// clusters data, key is packed cluster coordinates
+	std::unordered_map<uint32_t, Cluster> clusters;
+	
+	/// ids of entrance nodes on clusters borders, key is packed pair of (sorted) cluster keys
+	std::unordered_map<uint64_t, std::vector<uint32_t>> borders;
+	
+	/// abstract graph nodes (std::deque to keep references valid when adding nodes)
+	std::deque<Node> nodes;
+	
+	/// ids of unused nodes
+	std::vector<uint32_t> freeNodes;
+	
+	/// incremented on each configure / invalidation, used to drop results of probes started before it
+	uint32_t generation;
+	
+	/// mutex for all data (shared for searching on built clusters, exclusive for updates)
+	std::shared_mutex mutex;
+	
+	
+	/// return cluster coordinate for grid coordinate @a v
+	inline int16_t toClusterCoord(int16_t v) const {
+		return (v >= 0) ? (v / clusterSize) : ((v + 1) / clusterSize - 1);
+	}
+	
+	/// return cluster key for grid @a cell
+	inline uint32_t getClusterKey(const MGE::HexagonalGridPoint& cell) const {
+		return MGE::SearchHashMap<uint32_t, int>::packPoint(toClusterCoord(cell.a), toClusterCoord(cell.b));
+	}
+	
+	/// return (created if need) cluster data for cluster @a key
+	Cluster& getCluster(uint32_t key);
+	
+	/// return (created if need) cached cell info slot
+	Cell& getCellSlot(const MGE::HexagonalGridPoint& cell);
+	
+	/// return cached cell info (with UNKNOWN state when cell was not probed yet)
+	const Cell& getCell(const MGE::HexagonalGridPoint& cell) const;
+	
+	/// return cost of step between neighboring cells (@a mode is neighbor mode), negative when step is not possible
+	float getStepCost(const MGE::HexagonalGridPoint& from, const MGE::HexagonalGridPoint& to, int mode) const;
+	
+	/// return true when cluster @a key is built
+	bool isBuilt(uint32_t key) const;
+	
+	/// create (or reuse) node
+	uint32_t createNode(const MGE::HexagonalGridPoint& cell, uint32_t cluster);
+	
+	/// release node
+	void releaseNode(uint32_t id);
+	
+	/// create entrances on border between clusters @a keyA and @a keyB (if not exist yet)
+	void buildBorder(uint32_t keyA, uint32_t keyB);
+	
+	/// create all borders and intra cluster edges for cluster @a key (if not built yet), all cells used by it must be already probed
+	void buildCluster(uint32_t key);
+	
+	/// add to @a cells not probed cells used by building cluster @a key (cells of this cluster and 2 cells wide strip around it)
+	void collectUnknownCells(uint32_t key, std::vector<MGE::HexagonalGridPoint>& cells) const;
+	
+	/**
+	 * @brief Build clusters @a keys (if not built yet).
+	 * 
+	 * Missing cells are probed without lock, next clusters are built under exclusive lock.
+	 * Must be called without lock.
+	 * 
+	 * @return false when coarse grid is disabled or data was repeatedly invalidated during probing
+	 */
+	bool ensureBuilt(const std::vector<uint32_t>& keys);
+	
+	/**
+	 * @brief Run A* search on abstract graph (must be called with at least shared lock).
+	 * 
+	 * Search do not expand nodes in not built clusters, keys of those clusters are added to @a toBuild
+	 * – when @a toBuild is not empty results are not valid and search should be repeated after build those clusters.
+	 * 
+	 * @return true when path was found
+	 */
+	bool search(
+		const MGE::HexagonalGridPoint& startCell, const MGE::HexagonalGridPoint& finishCell,
+		std::vector<Ogre::Vector3>& waypoints, std::vector<uint32_t>& toBuild,
+		const std::atomic<bool>* cancelFlag
+	) const;
+	
+	/**
+	 * @brief Run Dijkstra search limited to cluster with @a from cell.
+	 * 
+	 * @param from     start cell
+	 * @param reverse  when true calculate costs of paths from cluster cells to @a from (instead of from @a from to cluster cells)
+	 * @param targets  cells to find costs
+	 * @param costs    output costs for @a targets (negative for not reachable)
+	 */
+	void searchInCluster(const MGE::HexagonalGridPoint& from, bool reverse, const std::vector<MGE::HexagonalGridPoint>& targets, std::vector<float>& costs) const;
+	
+	/// remove data (cells cache, borders, nodes) for cluster @a key and mark neighbors as not built
+	void invalidateCluster(uint32_t key);
+	
+	/// call @a func for key of each cluster overlapping (x,z) area from @a min to @a max (extended by one cell on each side)
+	void forEachCluster(const Ogre::Vector3& min, const Ogre::Vector3& max, const std::function<void(uint32_t key)>& func) const;
+	
+	/// A* heuristic – distance between cells
+	inline static float costEstimate(const MGE::HexagonalGridPoint& a, const MGE::HexagonalGridPoint& b) {
+		return a.toOgre().distance(b.toOgre());
+	}
+};
+
+/// @}
+
+}
@@ -0,0 +1,193 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "physics/utils/NavigationField.h"
+#include "physics/utils/CoarseNavigationGrid.h"
+#include "physics/FlowField.h"
+#include "physics/utils/PathCache.h"
+
+#include "LogSystem.h"
+
+#include <algorithm>
+
+MGE::NavigationField::NavigationField() :
+	enabled(false),
+	checkActorsCollisions(true),
+	generation(0)
+{
+	LOG_INFO("Create NavigationField");
+}
+
+MGE::NavigationField::~NavigationField() {
+	LOG_INFO("Destroy NavigationField");
+}
+
+void MGE::NavigationField::configure(CellProbe&& _probe, bool _checkActors) {
+	std::unique_lock<std::shared_mutex> lock(mutex);
+	LOG_INFO("Configure NavigationField with checkActors=" << _checkActors);
+	
+	tiles.clear();
+	triggerSetsIndex.clear();
+	++generation;
+	
+	probe                 = std::move(_probe);
+	checkActorsCollisions = _checkActors;
+	enabled               = static_cast<bool>(probe);
+}
+
+void MGE::NavigationField::clear() {
+	std::unique_lock<std::shared_mutex> lock(mutex);
+	LOG_INFO("Clear NavigationField");
+	
+	enabled = false;
+	probe   = nullptr;
+	
+	tiles.clear();
+	triggerSetsIndex.clear();
+	++generation;
+}
+
+size_t MGE::NavigationField::getTilesCount() {
+	std::shared_lock<std::shared_mutex> lock(mutex);
+	return tiles.size();
+}
+
+size_t MGE::NavigationField::getTriggerSetsCount() {
+	std::shared_lock<std::shared_mutex> lock(mutex);
+	return triggerSetsIndex.size();
+}
+
+MGE::NavigationField::CellInfo MGE::NavigationField::getCell(const MGE::HexagonalGridPoint& point) {
+	int16_t  ta    = toTileCoord(point.a), tb = toTileCoord(point.b);
+	uint32_t key   = getTileKey(ta, tb);
+	int      index = getCellIndex(point, ta, tb);
+	
+	CellProbe probeFunc;
+	uint32_t  probeGeneration;
+	{
+		std::shared_lock<std::shared_mutex> lock(mutex);
+		auto iter = tiles.find(key);
+		if (iter != tiles.end() && (iter->second->cells[index].flags & CellInfo::PROBED))
+			return iter->second->cells[index];
+		
+		if (!enabled)
+			return CellInfo{0, 0, nullptr};
+		
+		probeFunc       = probe;
+		probeGeneration = generation;
+	}
+	
+	// probe without lock (it can use scene queries), so workers can probe different cells in parallel
+	ProbeResult result;
+	probeFunc(point, result);
+	
+	CellInfo cell{result.groundHeight, CellInfo::PROBED, nullptr};
+	if (result.hasGround)
+		cell.flags |= CellInfo::GROUND;
+	if (result.blocked)
+		cell.flags |= CellInfo::BLOCKED;
+	
+	std::unique_lock<std::shared_mutex> lock(mutex);
+	
+	if (!result.triggers.empty()) {
+		std::sort(result.triggers.begin(), result.triggers.end());
+		result.triggers.erase(std::unique(result.triggers.begin(), result.triggers.end()), result.triggers.end());
+		
+		auto& sharedSet = triggerSetsIndex[result.triggers];
+		cell.triggers = sharedSet.lock();
+		if (!cell.triggers) {
+			cell.triggers = std::make_shared<const std::vector<MGE::BaseActor*>>(std::move(result.triggers));
+			sharedSet = cell.triggers;
+		}
+	}
+	
+	// store result only when area was not invalidated during probing
+	if (probeGeneration == generation) {
+		std::unique_ptr<Tile>& tile = tiles[key];
+		if (!tile) {
+			tile.reset(new Tile());
+			std::fill(std::begin(tile->cells), std::end(tile->cells), CellInfo{0, 0, nullptr});
+		}
+		tile->cells[index] = cell;
+	}
+	
+	return cell;
+}
+
+void MGE::NavigationField::build(const Ogre::Vector3& min, const Ogre::Vector3& max) {
+	if (!isEnabled())
+		return;
+	
+	LOG_INFO("NavigationField: build area from " << min << " to " << max);
+	
+	MGE::HexagonalGridPoint minCell(min), maxCell(max);
+	int16_t aMin = std::min(minCell.a, maxCell.a), aMax = std::max(minCell.a, maxCell.a);
+	int16_t bMin = std::min(minCell.b, maxCell.b), bMax = std::max(minCell.b, maxCell.b);
+	for (int b = bMin; b <= bMax; ++b) {
+		for (int a = aMin; a <= aMax; ++a) {
+			getCell(MGE::HexagonalGridPoint(a, b));
+		}
+	}
+	
+	LOG_INFO("NavigationField: build finished with " << getTilesCount() << " tiles");
+}
+
+void MGE::NavigationField::invalidateArea(const Ogre::Vector3& min, const Ogre::Vector3& max) {
+	std::unique_lock<std::shared_mutex> lock(mutex);
+	if (isEnabled()) {
+		LOG_DEBUG("NavigationField: invalidate area from " << min << " to " << max);
+		
+		// cells are selected by rounding, so extend area by one cell on each side
+		MGE::HexagonalGridPoint minCell(min), maxCell(max);
+		int16_t taMin = toTileCoord(std::min(minCell.a, maxCell.a) - 1), taMax = toTileCoord(std::max(minCell.a, maxCell.a) + 1);
+		int16_t tbMin = toTileCoord(std::min(minCell.b, maxCell.b) - 1), tbMax = toTileCoord(std::max(minCell.b, maxCell.b) + 1);
+		for (int tb = tbMin; tb <= tbMax; ++tb) {
+			for (int ta = taMin; ta <= taMax; ++ta) {
+				tiles.erase(getTileKey(ta, tb));
+			}
+		}
+		++generation;
+		
+		// drop sets of triggers not used by any cell (e.g. contains pointer to removed trigger)
+		for (auto iter = triggerSetsIndex.begin(); iter != triggerSetsIndex.end();) {
+			if (iter->second.expired())
+				iter = triggerSetsIndex.erase(iter);
+			else
+				++iter;
+		}
+	}
+	lock.unlock();
+	
+	// derived data must be invalidated even when field is disabled
+	
+	MGE::CoarseNavigationGrid* coarseGrid = MGE::CoarseNavigationGrid::getPtr();
+	if (coarseGrid)
+		coarseGrid->invalidateArea(min, max);
+	
+	MGE::FlowFieldCache* flowFieldCache = MGE::FlowFieldCache::getPtr();
+	if (flowFieldCache)
+		flowFieldCache->invalidateArea(min, max);
+	
+	MGE::PathCache* pathCache = MGE::PathCache::getPtr();
+	if (pathCache)
+		pathCache->invalidateArea(min, max);
+}
@@ -0,0 +1,235 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma   once
+
+#include "BaseClasses.h"
+
+#include "physics/utils/HexagonalGrid.h"
+#include "physics/utils/SearchContainers.h"
+
+namespace MGE { struct BaseActor; }
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace MGE {
+
+/// @addtogroup Physics
+/// @{
+/// @file
+
+/**
+ * @brief Cached per-map field of static navigation data (ground height, static passability, triggers) over @ref MGE::HexagonalGridPoint cells.
+ * 
+ * Used by @ref MGE::PathFinder (and @ref MGE::CoarseNavigationGrid) to replace scene queries on each A* edge check by array reads.
+ * Cells are stored in square (in grid coordinates) tiles of @ref tileSize × @ref tileSize cells, created on first use.
+ * Each cell is probed (via @ref CellProbe, e.g. ground raycast and sphere query) on first read and cached until @ref invalidateArea
+ * for area containing it or @ref clear.
+ * 
+ * Cell data is probed only at cell center, so it is only early rejection – mover size, obstacles between cells centers
+ * and moving actors still must be checked by caller (@ref MGE::PathFinder sweeps mover AABB along each accepted edge, see also @ref checkActors).
+ * 
+ * Area is invalidated by triggers and actors on create / destroy and by @ref MGE::World3DObject::setWorldPosition.
+ * 
+ * All public functions are thread safe (path finding workers can use this object in parallel).
+ */
+class NavigationField :
+	public MGE::Singleton<NavigationField>
+{
+public:
+	/// result of probing single cell by @ref CellProbe
+	struct ProbeResult {
+		/// ground height at cell center
+		float groundHeight = 0;
+		/// true when ground was found
+		bool  hasGround    = false;
+		/// true when cell is occupied by static (not actor) collision object
+		bool  blocked      = false;
+		/// trigger actors overlapping cell
+		std::vector<MGE::BaseActor*> triggers;
+	};
+	
+	/**
+	 * @brief Type of function used to read map data for single grid cell.
+	 * 
+	 * @param[in]  cell    grid cell to check
+	 * @param[out] result  probe result (initialised to default values)
+	 */
+	typedef std::function<void(const MGE::HexagonalGridPoint& cell, ProbeResult& result)> CellProbe;
+	
+	/// cached cell info
+	struct CellInfo {
+		/// flags values
+		enum Flags : uint8_t {
+			/// cell was probed (info is valid)
+			PROBED  = (1 << 0),
+			/// ground was found in this cell
+			GROUND  = (1 << 1),
+			/// cell is occupied by static collision object
+			BLOCKED = (1 << 2),
+		};
+		
+		/// ground height at cell center
+		float   groundHeight;
+		
+		/// bitmask of @ref Flags
+		uint8_t flags;
+		
+		/// trigger actors overlapping cell (NULL when none), shared between cells with the same set of triggers
+		std::shared_ptr<const std::vector<MGE::BaseActor*>> triggers;
+		
+		/// return true when ground was found in this cell
+		inline bool hasGround() const {
+			return flags & GROUND;
+		}
+		
+		/// return true when cell is occupied by static collision object
+		inline bool isBlocked() const {
+			return flags & BLOCKED;
+		}
+		
+		/// return true when cell has ground and is not occupied by static collision object
+		inline bool isWalkable() const {
+			return (flags & (GROUND | BLOCKED)) == GROUND;
+		}
+	};
+	
+	/// tile size (in grid cells)
+	static constexpr int tileSize = 32;
+	
+	/**
+	 * @brief Configure (and enable) field, remove all cached data.
+	 * 
+	 * @param probe        function used to read map data for grid cells
+	 * @param checkActors  value for @ref checkActors
+	 */
+	void configure(CellProbe&& probe, bool checkActors = true);
+	
+	/**
+	 * @brief Remove all cached data and disable field (until next @ref configure).
+	 */
+	void clear();
+	
+	/**
+	 * @brief Return true when field is configured and enabled.
+	 */
+	inline bool isEnabled() const {
+		return enabled;
+	}
+	
+	/**
+	 * @brief Return true when path finder (using this field) should still check collisions with actors via scene queries.
+	 */
+	inline bool checkActors() const {
+		return checkActorsCollisions;
+	}
+	
+	/**
+	 * @brief Return (probed if need) info for grid @a cell.
+	 */
+	CellInfo getCell(const MGE::HexagonalGridPoint& cell);
+	
+	/**
+	 * @brief Probe all not cached cells in (x,z) area from @a min to @a max (e.g. whole map at load time).
+	 */
+	void build(const Ogre::Vector3& min, const Ogre::Vector3& max);
+	
+	/**
+	 * @brief Mark area as changed (e.g. static object or trigger was added / removed / moved),
+	 *        tiles overlapping this area will be re-probed on next read.
+	 * 
+	 * Also invalidate this area in @ref MGE::CoarseNavigationGrid, @ref MGE::FlowFieldCache and @ref MGE::PathCache (also when this field is disabled).
+	 * 
+	 * @param min  minimum (x,z) corner of changed area
+	 * @param max  maximum (x,z) corner of changed area
+	 */
+	void invalidateArea(const Ogre::Vector3& min, const Ogre::Vector3& max);
+	
+	/**
+	 * @brief Return number of allocated tiles.
+	 */
+	size_t getTilesCount();
+	
+	/**
+	 * @brief Return number of unique sets of triggers (used by cached cells or by callers of @ref getCell).
+	 */
+	size_t getTriggerSetsCount();
+	
+	/// constructor
+	NavigationField();
+	
+	/// destructor
+	~NavigationField();
+	
+protected:
+	/// single tile of field
+	struct Tile {
+		/// cells info (@ref tileSize × @ref tileSize array)
+		CellInfo cells[tileSize * tileSize];
+	};
+	
+	/// true when field is configured
+	std::atomic<bool> enabled;
+	
+	/// when true path finder should check collisions with actors via scene queries
+	std::atomic<bool> checkActorsCollisions;
+	
+	/// function used to read map data
+	CellProbe probe;
+	
+	/// tiles, key is packed tile coordinates
+	std::unordered_map<uint32_t, std::unique_ptr<Tile>> tiles;
+	
+	/// map trigger set → shared copy of this set used by cells (expired entries are pruned in @ref invalidateArea)
+	std::map<std::vector<MGE::BaseActor*>, std::weak_ptr<const std::vector<MGE::BaseActor*>>> triggerSetsIndex;
+	
+	/// incremented on each invalidation, used to drop results of probes started before invalidation
+	uint32_t generation;
+	
+	/// mutex for all data (shared for reading cached cells, exclusive for updates)
+	std::shared_mutex mutex;
+	
+	/// return tile coordinate for grid coordinate @a v
+	inline static int16_t toTileCoord(int16_t v) {
+		return (v >= 0) ? (v / tileSize) : ((v + 1) / tileSize - 1);
+	}
+	
+	/// return tile key for tile coordinates
+	inline static uint32_t getTileKey(int16_t ta, int16_t tb) {
+		return MGE::SearchHashMap<uint32_t, int>::packPoint(ta, tb);
+	}
+	
+	/// return index of @a cell in tile with coordinates @a ta, @a tb
+	inline static int getCellIndex(const MGE::HexagonalGridPoint& cell, int16_t ta, int16_t tb) {
+		return (cell.a - ta * tileSize) + (cell.b - tb * tileSize) * tileSize;
+	}
+};
+
+/// @}
+
+}
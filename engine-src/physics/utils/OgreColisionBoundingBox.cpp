@@ -24,6 +24,8 @@ Inspired by:
 */
 
 #include "physics/utils/OgreColisionBoundingBox.h"
+#include "physics/utils/OgreSceneQueryPool.h"
+#include "physics/utils/OrientedBoundingBox.h"
 
 #include "LogSystem.h"
 #include "data/utils/OgreUtils.h"
@@ -33,6 +35,8 @@ Inspired by:
 #include <OgreEntity.h>
 #include <OgreRay.h>
 
+#include <cmath>
+
 #ifdef MGE_DEBUG_FREEPATH_VISUAL
 	#include "rendering/markers/VisualMarkers.h"
 #endif
@@ -79,7 +83,7 @@ void MGE::OgreColisionBoundingBox::_getLocalAABB( const Ogre::SceneNode* node, O
 }
 
 bool MGE::OgreColisionBoundingBox::isFreeSphere(Ogre::SceneManager* scnMgr, const Ogre::Vector3& position, Ogre::Real radius, int queryMask, std::list<Ogre::MovableObject*>* collisionObjects) {
-	Ogre::SphereSceneQuery* volScnQuery = scnMgr->createSphereQuery( Ogre::Sphere(position, radius), queryMask );
+	auto volScnQuery = MGE::OgreSceneQueryPool::getSphereQuery( scnMgr, Ogre::Sphere(position, radius), queryMask );
 	Ogre::SceneQueryResult& result = volScnQuery->execute();
 	
 	bool ret = result.movables.empty();
@@ -95,7 +99,6 @@ bool MGE::OgreColisionBoundingBox::isFreeSphere(Ogre::SceneManager* scnMgr, cons
 		}
 	}
 	
-	scnMgr->destroyQuery(volScnQuery);
 	return ret;
 }
 
@@ -118,8 +121,27 @@ bool MGE::OgreColisionBoundingBox::isFreePosition(
 	world_aabb.transformAffine(xform);
 	
 	// 2. do scene query with world AABB
-	Ogre::AxisAlignedBoxSceneQuery* volScnQuery = node->getCreator()->createAABBQuery(world_aabb, queryMask);
+	auto volScnQuery = MGE::OgreSceneQueryPool::getAABBQuery(node->getCreator(), world_aabb, queryMask);
 	Ogre::SceneQueryResult& queryResult = volScnQuery->execute();
+	
+	// 3. filter results of scene query and collect their oriented bounding boxes
+	//    (buffers are reused between calls, isFreePosition can be called from PathFinder threads so they are thread_local)
+	static thread_local std::vector<Ogre::MovableObject*>  candidates;
+	static thread_local std::vector<uint8_t>               candidatesCollision;
+	static thread_local MGE::OrientedBoundingBoxBatch      candidatesOBB;
+	static thread_local std::vector<size_t>                candidatesOBBIndex;
+	static thread_local std::vector<uint8_t>               candidatesOBBCollision;
+	candidates.clear();
+	candidatesCollision.clear();
+	candidatesOBB.clear();
+	candidatesOBBIndex.clear();
+	
+	#ifdef MGE_DEBUG_INTERSECTS_VISUAL
+	bool useOBB = false;
+	#else
+	bool useOBB = !aabb.isNull() && !aabb.isInfinite();
+	#endif
+	
 	for(auto iter: queryResult.movables) {
 		// 3a. check each results of scene query - base tests
 		Ogre::SceneNode* iterNode = iter->getParentSceneNode();
@@ -130,24 +152,61 @@ bool MGE::OgreColisionBoundingBox::isFreePosition(
 		if (MGE::OgreUtils::isChildOfNode(iterNode, node))
 			continue;
 		
-		// 3b. check each results of scene query - oriented bounding box check
+		candidates.push_back(iter);
+		candidatesCollision.resize(candidates.size());
 		Ogre::Aabb aabb2 = iter->getLocalAabb();
-		if (intersects( aabb, node, newPosition, newOrientation, newScale, Ogre::AxisAlignedBox(aabb2.getMinimum(), aabb2.getMaximum()), iterNode )) {
+		
+		// candidates with infinite or NaN local AABB are not batched (SAT on such box always report collision),
+		// they are checked by intersects() as without OBB batch
+		bool finiteAABB = true;
+		for (int i=0; i<3; ++i)
+			finiteAABB = finiteAABB && std::isfinite(aabb2.mCenter[i]) && std::isfinite(aabb2.mHalfSize[i]);
+		
+		if (useOBB && finiteAABB) {
+			candidatesOBBIndex.push_back(candidates.size() - 1);
+			candidatesOBB.push_back(MGE::OrientedBoundingBox(
+				aabb2.mCenter, aabb2.mHalfSize,
+				iterNode->_getDerivedPosition(), iterNode->_getDerivedOrientation(), iterNode->_getDerivedScale()
+			));
+		} else {
+			candidatesCollision.back() = intersects(
+				aabb, node, newPosition, newOrientation, newScale, Ogre::AxisAlignedBox(aabb2.getMinimum(), aabb2.getMaximum()), iterNode
+			);
+			if (candidatesCollision.back() && !collisionObjects)
+				break;
+		}
+	}
+	
+	// 3b. oriented bounding box check for all batched candidates at once
+	if (candidatesOBB.size()) {
+		candidatesOBBCollision.resize(candidatesOBB.size());
+		candidatesOBB.intersects(
+			MGE::OrientedBoundingBox(aabb.getCenter(), aabb.getHalfSize(), newPosition, newOrientation, newScale),
+			candidatesOBBCollision.data()
+		);
+		for (size_t i = 0; i < candidatesOBBIndex.size(); ++i)
+			candidatesCollision[candidatesOBBIndex[i]] = candidatesOBBCollision[i];
+	}
+	
+	// 4. collect results
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		if (candidatesCollision[i]) {
 			#ifdef MGE_DEBUG_IS_FREE_POSITION
-			LOG_VERBOSE( "collision with: " << iterNode->getName() );
+			LOG_VERBOSE( "collision with: " << candidates[i]->getParentSceneNode()->getName() );
 			#endif
 			ret = false;
 			if (collisionObjects) {
-				collisionObjects->push_back(iter);
+				collisionObjects->push_back(candidates[i]);
 			} else {
 				break;
 			}
 		}
 		#ifdef MGE_DEBUG_IS_FREE_POSITION
-		LOG_VERBOSE( "non-real collision with: " << iterNode->getName() );
+		else {
+			LOG_VERBOSE( "non-real collision with: " << candidates[i]->getParentSceneNode()->getName() );
+		}
 		#endif
 	}
-	node->getCreator()->destroyQuery(volScnQuery);
 	
 	return ret;
 }
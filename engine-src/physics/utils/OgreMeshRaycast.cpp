@@ -40,6 +40,9 @@ Inspired by:
 
 #include "LogSystem.h"
 
+#include <mutex>
+#include <unordered_map>
+
 MGE::OgreMeshRaycast::Results MGE::OgreMeshRaycast::entityHitTest(
 	Ogre::Ray mouseRay,
 	const Ogre::Matrix4& toWorld,
@@ -89,6 +92,82 @@ MGE::OgreMeshRaycast::Results MGE::OgreMeshRaycast::entityHitTest(
 	return results;
 }
 
+MGE::OgreMeshRaycast::Results MGE::OgreMeshRaycast::entityHitTest(
+	Ogre::Ray mouseRay,
+	const Ogre::Matrix4& toLocal,
+	const MGE::MeshGeometry& geometry,
+	bool positiveSide,
+	bool negativeSide
+) {
+	// direction is not normalised, so ray distance in LOCAL space is the same as in WORLD space
+	Ogre::Matrix4 toLocalRotScale = toLocal;
+	toLocalRotScale.setTrans(Ogre::Vector3::ZERO);
+	mouseRay.setOrigin(toLocal * mouseRay.getOrigin());
+	mouseRay.setDirection(toLocalRotScale * mouseRay.getDirection());
+	
+	Results results;
+	std::pair<int, Ogre::Real> hit = geometry.bvh.intersects(
+		mouseRay, geometry.vertices, geometry.indices, positiveSide, negativeSide
+	);
+	if (hit.first >= 0) {
+		results.index    = hit.first;
+		results.distance = hit.second;
+		results.hitPoint = mouseRay.getPoint(results.distance);
+	}
+	
+	return results;
+}
+
+namespace {
+	struct MeshGeometryCacheEntry {
+		/// mesh name (for detect reuse of mesh pointer by other mesh)
+		Ogre::String                        name;
+		/// true when geometry was read with UVs
+		bool                                withUVs;
+		/// cached geometry
+		std::shared_ptr<MGE::MeshGeometry>  geometry;
+	};
+	std::mutex                                                  meshGeometryCacheMutex;
+	std::unordered_map<const void*, MeshGeometryCacheEntry>     meshGeometryCache;
+}
+
+MGE::MeshGeometryPtr MGE::OgreMeshRaycast::getMeshGeometry(Ogre::MovableObject* mo, bool withUVs) {
+	const void*         mesh;
+	const Ogre::String* meshName;
+	if (mo->getMovableType() == Ogre::ItemFactory::FACTORY_TYPE_NAME) {
+		Ogre::Mesh* meshV2 = static_cast<Ogre::Item*>(mo)->getMesh().get();
+		mesh     = meshV2;
+		meshName = &meshV2->getName();
+	} else if (mo->getMovableType() == Ogre::v1::EntityFactory::FACTORY_TYPE_NAME) {
+		Ogre::v1::Mesh* meshV1 = static_cast<Ogre::v1::Entity*>(mo)->getMesh().get();
+		mesh     = meshV1;
+		meshName = &meshV1->getName();
+	} else {
+		LOG_WARNING("getMeshGeometry: unsupported movable type " << mo->getMovableType());
+		return nullptr;
+	}
+	
+	std::lock_guard<std::mutex> lock(meshGeometryCacheMutex);
+	
+	MeshGeometryCacheEntry& entry = meshGeometryCache[mesh];
+	if (entry.geometry && entry.name == *meshName && (entry.withUVs || !withUVs))
+		return entry.geometry;
+	
+	auto geometry = std::make_shared<MGE::MeshGeometry>();
+	getMeshInformation(mo, &geometry->vertices, &geometry->indices, withUVs ? &geometry->UVs : NULL, false);
+	geometry->bvh.build(geometry->vertices, geometry->indices);
+	
+	entry.name     = *meshName;
+	entry.withUVs  = withUVs;
+	entry.geometry = geometry;
+	return geometry;
+}
+
+void MGE::OgreMeshRaycast::clearMeshGeometryCache() {
+	std::lock_guard<std::mutex> lock(meshGeometryCacheMutex);
+	meshGeometryCache.clear();
+}
+
 Ogre::Vector2 MGE::OgreMeshRaycast::getTexturePoint(
 	const Results& hitTest,
 	const std::vector<Ogre::Vector3>& vertices,
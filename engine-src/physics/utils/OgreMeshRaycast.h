@@ -28,12 +28,38 @@ SOFTWARE.
 #include <OgreItem.h>
 #include <OgreSceneNode.h>
 
+#include "physics/utils/TriangleBVH.h"
+
+#include <memory>
+
 namespace MGE {
 
 /// @addtogroup Physics
 /// @{
 /// @file
 
+/**
+ * @brief CPU side copy of mesh geometry (in mesh LOCAL space) with BVH for raycasting, shared by all instances of mesh
+ * 
+ * @note see @ref MGE::OgreMeshRaycast::getMeshGeometry
+ */
+struct MeshGeometry {
+	/// all vertices
+	std::vector<Ogre::Vector3> vertices;
+	
+	/// vertex indices (each 3 elements describe one triangle)
+	std::vector<int>           indices;
+	
+	/// vertex UV coords (empty when not requested in @ref MGE::OgreMeshRaycast::getMeshGeometry)
+	std::vector<Ogre::Vector2> UVs;
+	
+	/// bounding volume hierarchy for @ref vertices and @ref indices
+	MGE::TriangleBVH           bvh;
+};
+
+/// shared pointer to (const) @ref MGE::MeshGeometry
+typedef std::shared_ptr<const MeshGeometry> MeshGeometryPtr;
+
 /**
  * @brief Raycasting to the polygon level
  */
@@ -207,6 +233,70 @@ public:
 		}
 	}
 	
+	/**
+	 * @brief get (cached) geometry of mesh used by @a mo
+	 * 
+	 * Geometry is read from (GPU) buffers only on first call for given mesh, next calls (also for other
+	 * Items / Entities using the same mesh) return the same object. BVH is build together with geometry.
+	 * 
+	 * @param mo              ogre movable object (Item or Entity) to get mesh
+	 * @param withUVs         when true returned geometry will have UVs
+	 * 
+	 * @return pointer to geometry or NULL when @a mo is not Item or Entity
+	 * 
+	 * @note cached geometry is not updated on mesh modification, use @ref clearMeshGeometryCache after it
+	 */
+	static MGE::MeshGeometryPtr getMeshGeometry(Ogre::MovableObject* mo, bool withUVs = false);
+	
+	/**
+	 * @brief clear cache used by @ref getMeshGeometry
+	 * 
+	 * @note geometry will be freed when all users release returned pointers
+	 */
+	static void clearMeshGeometryCache();
+	
+	/**
+	 * @brief do polygon level raycast test (using BVH), version for cached mesh geometry
+	 * 
+	 * @param mouseRay        ray (in WORLD space) used to doing test
+	 * @param toLocal         transform matrix from WORLD space to parent node of testing mesh space
+	 * @param geometry        mesh geometry (from @ref getMeshGeometry)
+	 * @param positiveSide    when true accept hit to positive (front) side of triangle
+	 * @param negativeSide    when true accept hit to negative (back) side of triangle
+	 * 
+	 * @note hitPoint in return @ref Results will be in LOCAL transform space, distance will be in WORLD ray units
+	 */
+	static Results entityHitTest(
+		Ogre::Ray mouseRay,
+		const Ogre::Matrix4& toLocal,
+		const MGE::MeshGeometry& geometry,
+		bool positiveSide,
+		bool negativeSide
+	);
+	
+	/**
+	 * @brief do polygon level raycast test (using BVH), version for cached mesh geometry
+	 * 
+	 * @param mouseRay        ray (in WORLD space) used to doing test
+	 * @param mo              ogre movable object owned tested mesh
+	 * @param geometry        mesh geometry (from @ref getMeshGeometry)
+	 * @param positiveSide    when true accept hit to positive (front) side of triangle
+	 * @param negativeSide    when true accept hit to negative (back) side of triangle
+	 * 
+	 * @note hitPoint in return @ref Results will be in LOCAL transform space, distance will be in WORLD ray units
+	 */
+	static inline Results entityHitTest(
+		Ogre::Ray mouseRay,
+		Ogre::MovableObject* mo,
+		const MGE::MeshGeometry& geometry,
+		bool positiveSide,
+		bool negativeSide
+	) {
+		return MGE::OgreMeshRaycast::entityHitTest(
+			mouseRay, mo->getParentSceneNode()->_getFullTransform().inverse(), geometry, positiveSide, negativeSide
+		);
+	}
+	
 	/**
 	 * @brief get texture point based on results of entityHitTest()
 	 * 
@@ -221,6 +311,19 @@ public:
 		const std::vector<int>& indices,
 		const std::vector<Ogre::Vector2>& UVs
 	);
+	
+	/**
+	 * @brief get texture point based on results of entityHitTest() on cached mesh geometry
+	 * 
+	 * @param hitTest         results of @ref entityHitTest
+	 * @param geometry        mesh geometry (from @ref getMeshGeometry with UVs)
+	 */
+	static inline Ogre::Vector2 getTexturePoint(
+		const Results& hitTest,
+		const MGE::MeshGeometry& geometry
+	) {
+		return getTexturePoint(hitTest, geometry.vertices, geometry.indices, geometry.UVs);
+	}
 };
 
 /// @}
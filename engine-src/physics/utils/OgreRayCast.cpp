@@ -25,6 +25,13 @@ Based on:
 
 #include "physics/utils/OgreRayCast.h"
 #include "physics/utils/OgreColisionBoundingBox.h"
+#include "physics/utils/OgreSceneQueryPool.h"
+
+#include <OgreMovableObject.h>
+#include <OgreMath.h>
+
+#include <stdexcept>
+#include <vector>
 
 #ifdef USE_BULLET
 #include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
@@ -49,8 +56,7 @@ void MGE::OgreRayCast::searchOnRay(MGE::OgreRayCast::ResultsBase* results, Ogre:
 	
 	// search Ogre objects
 	DEBUG2_LOG(" - search Ogre objects");
-	Ogre::RaySceneQuery* rayScnQuery = scnMgr->createRayQuery(ray, searchMask);
-	rayScnQuery->setSortByDistance(true);
+	auto rayScnQuery = MGE::OgreSceneQueryPool::getRayQuery(scnMgr, ray, searchMask, true);
 	Ogre::RaySceneQueryResult& result = rayScnQuery->execute();
 	
 	for(auto& iter : result) {
@@ -61,7 +67,6 @@ void MGE::OgreRayCast::searchOnRay(MGE::OgreRayCast::ResultsBase* results, Ogre:
 				return;
 		}
 	}
-	scnMgr->destroyQuery(rayScnQuery);
 	
 	// search Orge terrain
 	#if 0  /// @todo TODO.9: [Terrain] no terrain support in Ogre >= 2.1
@@ -97,19 +102,80 @@ void MGE::OgreRayCast::searchOnArea(MGE::OgreRayCast::ResultsBase* results, Ogre
 	Ogre::PlaneBoundedVolumeList volList;
 	volList.push_back(vol);
 	
-	Ogre::PlaneBoundedVolumeListSceneQuery* volScnQuery = scnMgr->createPlaneBoundedVolumeQuery(volList, typeMask);
+	auto volScnQuery = MGE::OgreSceneQueryPool::getVolumeQuery(scnMgr, volList, typeMask);
 	results->addResult( volScnQuery->execute() );
-	scnMgr->destroyQuery(volScnQuery);
 }
 
 void MGE::OgreRayCast::searchOnRadius(MGE::OgreRayCast::ResultsBase* results, Ogre::SceneManager* scnMgr, float radius, const Ogre::Vector3& point, unsigned int typeMask) {
 	DEBUG2_LOG("search ogre object on radius " << radius << " from " << point);
 	
-	Ogre::Sphere sphere(point, radius);
-	
-	Ogre::SphereSceneQuery* volScnQuery = scnMgr->createSphereQuery(sphere, typeMask);
+	auto volScnQuery = MGE::OgreSceneQueryPool::getSphereQuery(scnMgr, Ogre::Sphere(point, radius), typeMask);
 	results->addResult( volScnQuery->execute() );
-	scnMgr->destroyQuery(volScnQuery);
+}
+
+size_t MGE::OgreRayCast::intersectRays(std::span<const RayQuery> rays, std::span<const RayCandidate> candidates, std::span<RayHit> hits) {
+	if (hits.size() < rays.size())
+		throw std::logic_error("intersectRays: hits span is smaller than rays span");
+	
+	for (size_t i = 0; i < rays.size(); ++i) {
+		hits[i] = { nullptr, Ogre::Vector3::ZERO, Ogre::Math::POS_INFINITY };
+	}
+	
+	// check each candidate against each ray, keep nearest hit
+	for (auto& candidate : candidates) {
+		for (size_t i = 0; i < rays.size(); ++i) {
+			if (!(candidate.queryFlags & rays[i].searchMask))
+				continue;
+			
+			std::pair<bool, Ogre::Real> hit = Ogre::Math::intersects(rays[i].ray, candidate.box);
+			if (hit.first && hit.second <= rays[i].maxDistance && hit.second < hits[i].distance) {
+				hits[i].object   = candidate.object;
+				hits[i].distance = hit.second;
+			}
+		}
+	}
+	
+	// calculate hit points
+	size_t hitsCount = 0;
+	for (size_t i = 0; i < rays.size(); ++i) {
+		if (hits[i].object) {
+			hits[i].point = rays[i].ray.getPoint(hits[i].distance);
+			++hitsCount;
+		}
+	}
+	return hitsCount;
+}
+
+size_t MGE::OgreRayCast::searchOnRays(Ogre::SceneManager* scnMgr, std::span<const RayQuery> rays, std::span<RayHit> hits) {
+	DEBUG2_LOG("search ogre object on " << rays.size() << " rays");
+	
+	if (hits.size() < rays.size())
+		throw std::logic_error("searchOnRays: hits span is smaller than rays span");
+	
+	// 1. get bounding box of all rays and sum of search masks
+	Ogre::AxisAlignedBox bounds;
+	uint32_t searchMask = 0;
+	for (auto& query : rays) {
+		bounds.merge( query.ray.getOrigin() );
+		bounds.merge( query.ray.getPoint(query.maxDistance) );
+		searchMask |= query.searchMask;
+	}
+	if (!searchMask)
+		return intersectRays(rays, {}, hits);
+	
+	// 2. single scene query for all rays
+	auto volScnQuery = MGE::OgreSceneQueryPool::getAABBQuery(scnMgr, bounds, searchMask);
+	Ogre::SceneQueryResult& result = volScnQuery->execute();
+	
+	static thread_local std::vector<RayCandidate> candidates;
+	candidates.clear();
+	for (auto& movable : result.movables) {
+		Ogre::Aabb worldAabb = movable->getWorldAabb();
+		candidates.push_back({ movable, movable->getQueryFlags(), Ogre::AxisAlignedBox(worldAabb.getMinimum(), worldAabb.getMaximum()) });
+	}
+	
+	// 3. check each result against each ray
+	return intersectRays(rays, candidates, hits);
 }
 
 std::pair<bool, Ogre::Vector3> MGE::OgreRayCast::findFreePosition(const Ogre::SceneNode* node, const Ogre::AxisAlignedBox& aabb, int queryMask, Ogre::Real step, int count) {
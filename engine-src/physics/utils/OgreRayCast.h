@@ -26,9 +26,12 @@ SOFTWARE.
 #include "data/property/Any.h"
 #include "LogSystem.h"
 
+#include <OgreAxisAlignedBox.h>
 #include <OgreRay.h>
 #include <OgreSceneQuery.h>
 
+#include <span>
+
 class btCollisionObject;
 
 namespace MGE {
@@ -121,6 +124,80 @@ namespace OgreRayCast {
 		uint32_t searchMask
 	);
 	
+	/// single ray for batched search (see @ref searchOnRays)
+	struct RayQuery {
+		/// searching ray (start point and direction vector)
+		Ogre::Ray   ray;
+		
+		/// max distance (along @ref ray) for searching
+		Ogre::Real  maxDistance;
+		
+		/// mask for reduce searching to specyfic object types, see @ref MGE::QueryFlags
+		uint32_t    searchMask;
+	};
+	
+	/// result of single ray in batched search (see @ref searchOnRays)
+	struct RayHit {
+		/// nearest hit object (NULL when nothing was hit)
+		const Ogre::MovableObject*  object;
+		
+		/// world position of hit point (at @ref object bounding box)
+		Ogre::Vector3               point;
+		
+		/// distance from ray origin to @ref point
+		Ogre::Real                  distance;
+	};
+	
+	/// object tested against rays in batched search (see @ref intersectRays)
+	struct RayCandidate {
+		/// tested object (returned in @ref RayHit::object)
+		const Ogre::MovableObject*  object;
+		
+		/// query flags of @ref object (compared with @ref RayQuery::searchMask)
+		uint32_t                    queryFlags;
+		
+		/// world bounding box of @ref object
+		Ogre::AxisAlignedBox        box;
+	};
+	
+	/**
+	 * @brief find nearest of @a candidates for each of @a rays (used by @ref searchOnRays to test scene query results)
+	 * 
+	 * Candidate is tested against ray only when its query flags match ray search mask,
+	 * and it's hit only when intersection with its bounding box is not farther than ray max distance.
+	 * 
+	 * @param[in]  rays           rays to search (with per ray max distance and search mask)
+	 * @param[in]  candidates     objects to test
+	 * @param[out] hits           results for each ray (i-th element is result for i-th ray), must have at least @a rays size
+	 *                            (throw std::logic_error otherwise), elements after @a rays size are not modified
+	 * 
+	 * @return number of rays with hit
+	 */
+	size_t intersectRays(
+		std::span<const RayQuery> rays,
+		std::span<const RayCandidate> candidates,
+		std::span<RayHit> hits
+	);
+	
+	/**
+	 * @brief search nearest ogre object for each of @a rays - batched variant of @ref searchOnRay with @a onlyFirst == true
+	 * 
+	 * Do single scene query (with bounding box of all rays) for all rays and test each ray against results of this query.
+	 * Like ogre ray scene query, hits are tested against world bounding boxes of objects (see @ref intersectRays).
+	 * 
+	 * @param[in]  scnMgr         pointer to SceneManager on which we do search
+	 * @param[in]  rays           rays to search (with per ray max distance and search mask)
+	 * @param[out] hits           results for each ray (i-th element is result for i-th ray), must have at least @a rays size
+	 *                            (throw std::logic_error otherwise), elements after @a rays size are not modified
+	 * 
+	 * @return number of rays with hit
+	 */
+	size_t searchOnRays(
+		Ogre::SceneManager* scnMgr,
+		std::span<const RayQuery> rays,
+		std::span<RayHit> hits
+	);
+	
 	/**
 	 * @brief find free position for placing object near the point
 	 * 
@@ -211,9 +288,8 @@ namespace OgreRayCast {
 		bool onlyFirst = false,
 		bool vertical = false
 	) {
-		auto results = new ResultsWithFilter<ListType,AnyElementType>(filterID, filteredList);
-		searchOnRay(results, scnMgr, ray, rayTo, searchMask, onlyFirst, vertical);
-		delete results;
+		ResultsWithFilter<ListType,AnyElementType> results(filterID, filteredList);
+		searchOnRay(&results, scnMgr, ray, rayTo, searchMask, onlyFirst, vertical);
 	}
 	
 	/**
@@ -240,9 +316,8 @@ namespace OgreRayCast {
 		const Ogre::Vector3& point,
 		uint32_t searchMask
 	) {
-		auto results = new ResultsWithFilter<ListType,AnyElementType>(filterID, filteredList);
-		searchOnRadius(results, scnMgr, radius, point, searchMask);
-		delete results;
+		ResultsWithFilter<ListType,AnyElementType> results(filterID, filteredList);
+		searchOnRadius(&results, scnMgr, radius, point, searchMask);
 	}
 	
 	/**
@@ -267,9 +342,8 @@ namespace OgreRayCast {
 		const std::vector<Ogre::Ray>& rays,
 		uint32_t searchMask
 	) {
-		auto results = new ResultsWithFilter<ListType,AnyElementType>(filterID, filteredList);
-		searchOnArea(results, scnMgr, rays, searchMask);
-		delete results;
+		ResultsWithFilter<ListType,AnyElementType> results(filterID, filteredList);
+		searchOnArea(&results, scnMgr, rays, searchMask);
 	}
 	
 	
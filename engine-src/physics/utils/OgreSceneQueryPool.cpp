@@ -0,0 +1,247 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "physics/utils/OgreSceneQueryPool.h"
+
+#include <shared_mutex>
+#include <unordered_set>
+
+class MGE::OgreSceneQueryPool::Registry : public Ogre::SceneManager::Listener {
+public:
+	/// return registry instance
+	static Registry& get() {
+		static Registry registry;
+		return registry;
+	}
+	
+	/// mutex for all registry data (shared for taking / returning queries, exclusive for modifications)
+	std::shared_mutex mutex;
+	
+	/// SceneManagers with enabled queries pooling
+	std::unordered_set<Ogre::SceneManager*> sceneManagers;
+	
+	/// pools of all (living) threads
+	std::unordered_set<OgreSceneQueryPool*> threadPools;
+	
+	/// free queries from pools of exited threads
+	std::unordered_map<Ogre::SceneManager*, Queries> orphaned;
+	
+	/// @copydoc Ogre::SceneManager::Listener::sceneManagerDestroyed
+	void sceneManagerDestroyed(Ogre::SceneManager* source) override {
+		// do not call source->removeListener() here - SceneManager is iterating over listeners list now
+		std::unique_lock<std::shared_mutex> lock(mutex);
+		sceneManagers.erase(source);
+		
+		for (auto pool : threadPools) {
+			std::lock_guard<std::mutex> poolLock(pool->mutex);
+			auto iter = pool->pools.find(source);
+			if (iter != pool->pools.end()) {
+				iter->second.destroy(source);
+				pool->pools.erase(iter);
+			}
+		}
+		
+		auto iter = orphaned.find(source);
+		if (iter != orphaned.end()) {
+			iter->second.destroy(source);
+			orphaned.erase(iter);
+		}
+	}
+	
+	/// destructor
+	~Registry() {
+		// registered SceneManagers are still alive (destroyed are removed in sceneManagerDestroyed)
+		for (auto& iter : orphaned)
+			iter.second.destroy(iter.first);
+		for (auto scnMgr : sceneManagers)
+			scnMgr->removeListener(this);
+	}
+};
+
+namespace {
+	template <typename QueryType> inline void destroyAll(Ogre::SceneManager* scnMgr, std::vector<QueryType*>& freeQueries) {
+		for (auto query : freeQueries)
+			scnMgr->destroyQuery(query);
+		freeQueries.clear();
+	}
+	
+	template <typename QueryType> inline void appendAll(std::vector<QueryType*>& dst, std::vector<QueryType*>& src) {
+		dst.insert(dst.end(), src.begin(), src.end());
+		src.clear();
+	}
+}
+
+void MGE::OgreSceneQueryPool::Queries::append(Queries& other) {
+	appendAll(ray,    other.ray);
+	appendAll(sphere, other.sphere);
+	appendAll(aabb,   other.aabb);
+	appendAll(volume, other.volume);
+}
+
+void MGE::OgreSceneQueryPool::Queries::destroy(Ogre::SceneManager* scnMgr) {
+	destroyAll(scnMgr, ray);
+	destroyAll(scnMgr, sphere);
+	destroyAll(scnMgr, aabb);
+	destroyAll(scnMgr, volume);
+}
+
+void MGE::OgreSceneQueryPool::registerSceneManager(Ogre::SceneManager* scnMgr) {
+	Registry& registry = Registry::get();
+	std::unique_lock<std::shared_mutex> lock(registry.mutex);
+	if (registry.sceneManagers.insert(scnMgr).second)
+		scnMgr->addListener(&registry);
+}
+
+MGE::OgreSceneQueryPool& MGE::OgreSceneQueryPool::getPool() {
+	static thread_local OgreSceneQueryPool pool;
+	return pool;
+}
+
+MGE::OgreSceneQueryPool::OgreSceneQueryPool() {
+	Registry& registry = Registry::get();
+	std::unique_lock<std::shared_mutex> lock(registry.mutex);
+	registry.threadPools.insert(this);
+}
+
+MGE::OgreSceneQueryPool::~OgreSceneQueryPool() {
+	// thread exit can't call SceneManager functions (SceneManager is owned by main thread),
+	// so free queries are destroyed by registry together with its SceneManager
+	Registry& registry = Registry::get();
+	std::unique_lock<std::shared_mutex> lock(registry.mutex);
+	registry.threadPools.erase(this);
+	
+	std::lock_guard<std::mutex> poolLock(mutex);
+	for (auto& iter : pools)
+		registry.orphaned[iter.first].append(iter.second);
+	pools.clear();
+}
+
+template <typename QueryType> QueryType* MGE::OgreSceneQueryPool::take(
+	Ogre::SceneManager* scnMgr, std::vector<QueryType*> Queries::* list
+) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto iter = pools.find(scnMgr);
+	if (iter == pools.end() || (iter->second.*list).empty())
+		return nullptr;
+	
+	QueryType* query = (iter->second.*list).back();
+	(iter->second.*list).pop_back();
+	return query;
+}
+
+template <typename QueryType> void MGE::OgreSceneQueryPool::put(
+	Ogre::SceneManager* scnMgr, QueryType* query, std::vector<QueryType*> Queries::* list
+) {
+	Registry& registry = Registry::get();
+	std::shared_lock<std::shared_mutex> lock(registry.mutex);
+	if (registry.sceneManagers.count(scnMgr)) {
+		std::lock_guard<std::mutex> poolLock(mutex);
+		(pools[scnMgr].*list).push_back(query);
+	} else {
+		// not registered (or already destroyed) SceneManager, so we don't pool this query
+		// and can't use scnMgr->destroyQuery() (it only delete query anyway)
+		OGRE_DELETE query;
+	}
+}
+
+MGE::OgreSceneQueryPool::Lease<Ogre::RaySceneQuery> MGE::OgreSceneQueryPool::getRayQuery(
+	Ogre::SceneManager* scnMgr, const Ogre::Ray& ray, uint32_t queryMask, bool sortByDistance, uint16_t maxResults
+) {
+	OgreSceneQueryPool& pool = getPool();
+	Ogre::RaySceneQuery* query = pool.take(scnMgr, &Queries::ray);
+	if (query) {
+		query->setRay(ray);
+		query->setQueryMask(queryMask);
+	} else {
+		query = scnMgr->createRayQuery(ray, queryMask);
+	}
+	query->setSortByDistance(sortByDistance, maxResults);
+	return Lease<Ogre::RaySceneQuery>(&pool, scnMgr, query);
+}
+
+MGE::OgreSceneQueryPool::Lease<Ogre::SphereSceneQuery> MGE::OgreSceneQueryPool::getSphereQuery(
+	Ogre::SceneManager* scnMgr, const Ogre::Sphere& sphere, uint32_t queryMask
+) {
+	OgreSceneQueryPool& pool = getPool();
+	Ogre::SphereSceneQuery* query = pool.take(scnMgr, &Queries::sphere);
+	if (query) {
+		query->setSphere(sphere);
+		query->setQueryMask(queryMask);
+	} else {
+		query = scnMgr->createSphereQuery(sphere, queryMask);
+	}
+	return Lease<Ogre::SphereSceneQuery>(&pool, scnMgr, query);
+}
+
+MGE::OgreSceneQueryPool::Lease<Ogre::AxisAlignedBoxSceneQuery> MGE::OgreSceneQueryPool::getAABBQuery(
+	Ogre::SceneManager* scnMgr, const Ogre::AxisAlignedBox& box, uint32_t queryMask
+) {
+	OgreSceneQueryPool& pool = getPool();
+	Ogre::AxisAlignedBoxSceneQuery* query = pool.take(scnMgr, &Queries::aabb);
+	if (query) {
+		query->setBox(box);
+		query->setQueryMask(queryMask);
+	} else {
+		query = scnMgr->createAABBQuery(box, queryMask);
+	}
+	return Lease<Ogre::AxisAlignedBoxSceneQuery>(&pool, scnMgr, query);
+}
+
+MGE::OgreSceneQueryPool::Lease<Ogre::PlaneBoundedVolumeListSceneQuery> MGE::OgreSceneQueryPool::getVolumeQuery(
+	Ogre::SceneManager* scnMgr, const Ogre::PlaneBoundedVolumeList& volumes, uint32_t queryMask
+) {
+	OgreSceneQueryPool& pool = getPool();
+	Ogre::PlaneBoundedVolumeListSceneQuery* query = pool.take(scnMgr, &Queries::volume);
+	if (query) {
+		query->setVolumes(volumes);
+		query->setQueryMask(queryMask);
+	} else {
+		query = scnMgr->createPlaneBoundedVolumeQuery(volumes, queryMask);
+	}
+	return Lease<Ogre::PlaneBoundedVolumeListSceneQuery>(&pool, scnMgr, query);
+}
+
+void MGE::OgreSceneQueryPool::release(Ogre::SceneManager* scnMgr, Ogre::RaySceneQuery* query) {
+	put(scnMgr, query, &Queries::ray);
+}
+
+void MGE::OgreSceneQueryPool::release(Ogre::SceneManager* scnMgr, Ogre::SphereSceneQuery* query) {
+	put(scnMgr, query, &Queries::sphere);
+}
+
+void MGE::OgreSceneQueryPool::release(Ogre::SceneManager* scnMgr, Ogre::AxisAlignedBoxSceneQuery* query) {
+	put(scnMgr, query, &Queries::aabb);
+}
+
+void MGE::OgreSceneQueryPool::release(Ogre::SceneManager* scnMgr, Ogre::PlaneBoundedVolumeListSceneQuery* query) {
+	put(scnMgr, query, &Queries::volume);
+}
+
+void MGE::OgreSceneQueryPool::clear(Ogre::SceneManager* scnMgr) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto iter = pools.find(scnMgr);
+	if (iter == pools.end())
+		return;
+	
+	iter->second.destroy(scnMgr);
+	pools.erase(iter);
+}
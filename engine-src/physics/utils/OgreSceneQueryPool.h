@@ -0,0 +1,207 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma   once
+#include "config.h"
+
+#include <OgreSceneManager.h>
+#include <OgreSceneQuery.h>
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace MGE {
+
+/// @addtogroup Physics
+/// @{
+/// @file
+
+/**
+ * @brief per-thread pool of reusable Ogre scene queries
+ * 
+ * Scene queries (and their internal result buffers) are created on first use for given SceneManager
+ * and returned to pool (not destroyed) when @ref Lease goes out of scope.
+ * 
+ * Queries are pooled only for SceneManagers registered via @ref registerSceneManager (done by
+ * @ref MGE::RenderingSystem::createSceneManager), for others queries are destroyed on @ref Lease destroy.
+ * Single (shared by all threads) registry is registered as Ogre::SceneManager::Listener of registered SceneManagers
+ * and destroys all queries (from all threads pools) of SceneManager together with this SceneManager.
+ * So only thread registering SceneManager (main thread) modify its listeners list – workers only
+ * lock registry (shared) and own pool.
+ * 
+ * Free queries of exiting thread are moved to registry and destroyed together with theirs SceneManager
+ * (so thread exit do not call any SceneManager function).
+ * 
+ * Example: \code{.cpp}
+ *   auto query = MGE::OgreSceneQueryPool::getSphereQuery(scnMgr, Ogre::Sphere(point, radius), mask);
+ *   Ogre::SceneQueryResult& result = query->execute();
+ * \endcode
+ * 
+ * @note Lease must not outlive SceneManager used to obtain it.
+ * @note SceneManager should not be destroyed while other thread use queries from it (this is Ogre requirement anyway).
+ */
+class OgreSceneQueryPool {
+public:
+	/**
+	 * @brief RAII owner of query object taken from pool, return query to pool on destroy
+	 */
+	template <typename QueryType> class Lease {
+	public:
+		/// access to leased query
+		QueryType* operator->() const { return query; }
+		
+		/// return leased query
+		QueryType* get() const { return query; }
+		
+		/// destructor - return query to pool
+		~Lease() {
+			if (query)
+				pool->release(scnMgr, query);
+		}
+		
+		/// move constructor
+		Lease(Lease&& other) : pool(other.pool), scnMgr(other.scnMgr), query(other.query) {
+			other.query = nullptr;
+		}
+		
+		Lease(const Lease&) = delete;
+		Lease& operator=(const Lease&) = delete;
+		Lease& operator=(Lease&&) = delete;
+		
+	protected:
+		friend class OgreSceneQueryPool;
+		
+		/// constructor
+		Lease(OgreSceneQueryPool* _pool, Ogre::SceneManager* _scnMgr, QueryType* _query) :
+			pool(_pool), scnMgr(_scnMgr), query(_query) { }
+		
+		/// pool owned @ref query
+		OgreSceneQueryPool* pool;
+		
+		/// SceneManager used to create @ref query
+		Ogre::SceneManager* scnMgr;
+		
+		/// leased query
+		QueryType*          query;
+	};
+	
+	/**
+	 * @brief get ray query for @a scnMgr configured with @a ray and @a queryMask
+	 * 
+	 * @param[in]  scnMgr          pointer to SceneManager on which we do search
+	 * @param[in]  ray             searching ray
+	 * @param[in]  queryMask       mask of QueryFlags for filter results
+	 * @param[in]  sortByDistance  sort results by distance from ray origin
+	 * @param[in]  maxResults      when sorting, limit results number to this value (0 means no limit)
+	 */
+	static Lease<Ogre::RaySceneQuery> getRayQuery(
+		Ogre::SceneManager* scnMgr, const Ogre::Ray& ray, uint32_t queryMask,
+		bool sortByDistance = false, uint16_t maxResults = 0
+	);
+	
+	/**
+	 * @brief get sphere query for @a scnMgr configured with @a sphere and @a queryMask
+	 */
+	static Lease<Ogre::SphereSceneQuery> getSphereQuery(
+		Ogre::SceneManager* scnMgr, const Ogre::Sphere& sphere, uint32_t queryMask
+	);
+	
+	/**
+	 * @brief get axis aligned box query for @a scnMgr configured with @a box and @a queryMask
+	 */
+	static Lease<Ogre::AxisAlignedBoxSceneQuery> getAABBQuery(
+		Ogre::SceneManager* scnMgr, const Ogre::AxisAlignedBox& box, uint32_t queryMask
+	);
+	
+	/**
+	 * @brief get plane bounded volumes query for @a scnMgr configured with @a volumes and @a queryMask
+	 */
+	static Lease<Ogre::PlaneBoundedVolumeListSceneQuery> getVolumeQuery(
+		Ogre::SceneManager* scnMgr, const Ogre::PlaneBoundedVolumeList& volumes, uint32_t queryMask
+	);
+	
+	/**
+	 * @brief enable pooling queries for @a scnMgr (register registry as listener of @a scnMgr)
+	 * 
+	 * @note Must be called from thread owning @a scnMgr (main thread), before use @a scnMgr queries in other threads.
+	 */
+	static void registerSceneManager(Ogre::SceneManager* scnMgr);
+	
+	/**
+	 * @brief return pool for current thread
+	 */
+	static OgreSceneQueryPool& getPool();
+	
+	/**
+	 * @brief destroy all (not leased) queries created for @a scnMgr in this thread pool
+	 */
+	void clear(Ogre::SceneManager* scnMgr);
+	
+	/// destructor, move free queries to registry
+	~OgreSceneQueryPool();
+	
+protected:
+	/// constructor, add pool to registry
+	OgreSceneQueryPool();
+	
+	/// free (not leased) queries for single SceneManager
+	struct Queries {
+		std::vector<Ogre::RaySceneQuery*>                    ray;
+		std::vector<Ogre::SphereSceneQuery*>                 sphere;
+		std::vector<Ogre::AxisAlignedBoxSceneQuery*>         aabb;
+		std::vector<Ogre::PlaneBoundedVolumeListSceneQuery*> volume;
+		
+		/// move all queries from @a other to this
+		void append(Queries& other);
+		
+		/// destroy all queries
+		void destroy(Ogre::SceneManager* scnMgr);
+	};
+	
+	/// shared by all threads registry of registered SceneManagers and threads pools
+	class Registry;
+	
+	/// map of SceneManager to its free queries
+	std::unordered_map<Ogre::SceneManager*, Queries> pools;
+	
+	/// mutex for @ref pools (registry locks it when destroy SceneManager or when thread exit)
+	std::mutex mutex;
+	
+	/// return free query from @a list of @a scnMgr queries or NULL when there is no free query
+	template <typename QueryType> QueryType* take(Ogre::SceneManager* scnMgr, std::vector<QueryType*> Queries::* list);
+	
+	/// return @a query to @a list of @a scnMgr queries or destroy it when @a scnMgr is not registered
+	template <typename QueryType> void put(Ogre::SceneManager* scnMgr, QueryType* query, std::vector<QueryType*> Queries::* list);
+	
+	/// @{
+	/// return @a query to pool
+	void release(Ogre::SceneManager* scnMgr, Ogre::RaySceneQuery* query);
+	void release(Ogre::SceneManager* scnMgr, Ogre::SphereSceneQuery* query);
+	void release(Ogre::SceneManager* scnMgr, Ogre::AxisAlignedBoxSceneQuery* query);
+	void release(Ogre::SceneManager* scnMgr, Ogre::PlaneBoundedVolumeListSceneQuery* query);
+	/// @}
+};
+
+/// @}
+
+}
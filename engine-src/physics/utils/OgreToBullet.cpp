@@ -27,75 +27,290 @@ SOFTWARE.
 
 #include "LogSystem.h"
 
-void MGE::OgreToBullet::updateAll() {
-	for (auto& iter : nodes) {
-		auto& phyObj = iter.first;
-		auto& info   = iter.second;
-		
-		// check change on Ogre-side transform matrix
-		const Ogre::Matrix4& newFullTransform = info.node->_getFullTransform();
-		if (newFullTransform == info.transform)
-			continue;
-		info.transform = newFullTransform;
-		
-		
-		// is scale change ?
-		bool  force = false;
-		const Ogre::Vector3& scale = info.node->_getDerivedScale();
-		{
-			btVector3 newScale  = BtOgre::Convert::toBullet(scale);
-			btVector3 diffScale = phyObj->getCollisionShape()->getLocalScaling() - newScale;
-			if ( diffScale.x() > EPSION1 || diffScale.x() < -EPSION1 || diffScale.y() > EPSION1 || diffScale.y() < -EPSION1 || diffScale.z() > EPSION1 || diffScale.z() < -EPSION1 ) {
-				phyObj->getCollisionShape()->setLocalScaling(newScale);
-				force = true;
+void MGE::OgreToBullet::addObj(btCollisionObject* obj, Ogre::Node* node, const Ogre::Vector3& offset) {
+	auto res = nodes.insert( {obj, {node, node->_getFullTransform(), offset}} );
+	if (!res.second)
+		return;
+	
+	PhyInfo& info = res.first->second;
+	info.isStatic = obj->isStaticObject();
+	info.isDirty  = false;
+	if (!info.isStatic) {
+		polledObjects.push_back( {obj, &info} );
+	} else {
+		objByNode.emplace(node, obj);
+		linkAncestors(info);
+	}
+	
+	resetInterpolation(obj);
+}
+
+void MGE::OgreToBullet::remObj(btCollisionObject* obj) {
+	auto iter = nodes.find(obj);
+	if (iter == nodes.end())
+		return;
+	
+	if (!iter->second.isStatic) {
+		for (auto& polled : polledObjects) {
+			if (polled.first == obj) {
+				polled = polledObjects.back();
+				polledObjects.pop_back();
+				break;
 			}
 		}
+	}
+	
+	if (iter->second.isStatic) {
+		auto range = objByNode.equal_range(iter->second.node);
+		for (auto nodeIter = range.first; nodeIter != range.second; ++nodeIter) {
+			if (nodeIter->second == obj) {
+				objByNode.erase(nodeIter);
+				break;
+			}
+		}
+		unlinkAncestors(iter->second);
+	}
+	
+	// removed object can be still on dirtyObjects list, it will be skipped in updateAll()
+	nodes.erase(iter);
+}
+
+void MGE::OgreToBullet::clearAll() {
+	nodes.clear();
+	objByNode.clear();
+	staticAncestors.clear();
+	staticParents.clear();
+	polledObjects.clear();
+	dirtyObjects.clear();
+}
+
+void MGE::OgreToBullet::linkAncestors(PhyInfo& info) {
+	Ogre::Node* node = info.node;
+	for (Ogre::Node* parent = node->getParent(); parent; node = parent, parent = parent->getParent()) {
+		staticParents[node] = parent;
+		info.ancestors.push_back(parent);
+		++staticAncestors[parent];
+	}
+	staticParents[node] = nullptr;
+}
+
+void MGE::OgreToBullet::unlinkAncestors(PhyInfo& info) {
+	for (auto& parent : info.ancestors) {
+		auto ancestorIter = staticAncestors.find(parent);
+		if (ancestorIter != staticAncestors.end() && --ancestorIter->second == 0) {
+			staticAncestors.erase(ancestorIter);
+			if (objByNode.find(parent) == objByNode.end())
+				staticParents.erase(parent);
+		}
+	}
+	info.ancestors.clear();
+	
+	if (objByNode.find(info.node) == objByNode.end() && staticAncestors.find(info.node) == staticAncestors.end())
+		staticParents.erase(info.node);
+}
+
+void MGE::OgreToBullet::syncAncestors(Ogre::Node* node) {
+	// walk live parents chain while nodes are in cached static tree
+	for (; node; node = node->getParent()) {
+		auto parentIter = staticParents.find(node);
+		if (parentIter == staticParents.end())
+			return;
+		if (parentIter->second == node->getParent())
+			continue;
 		
-		// get scaled offset as Bullet transform
-		btTransform  transformOffset(
-			btQuaternion::getIdentity(),
-			BtOgre::Convert::toBullet( info.offset * scale )
-		);
-		
-		// calculate full transform from Ogre state
-		btTransform newTransform(
-			BtOgre::Convert::toBullet( info.node->_getDerivedOrientation() ),
-			BtOgre::Convert::toBullet( info.node->_getDerivedPosition() )
-		);
-		newTransform *= transformOffset;
-		
-		// for RigidBody use RigidBodyState
-		BtOgre::RigidBodyState* state = NULL;
-		if (phyObj->getInternalType() == btCollisionObject::CO_RIGID_BODY) {
-			state = static_cast<BtOgre::RigidBodyState*>(static_cast<btRigidBody*>(phyObj)->getMotionState());
+		// node was reparented – collect static objects from its subtree (internal structure of subtree is still cached)
+		std::vector<btCollisionObject*> objects;
+		std::vector<Ogre::Node*>        stack = {node};
+		while (!stack.empty()) {
+			Ogre::Node* curr = stack.back();
+			stack.pop_back();
+			auto range = objByNode.equal_range(curr);
+			for (auto iter = range.first; iter != range.second; ++iter)
+				objects.push_back(iter->second);
+			if (staticAncestors.find(curr) == staticAncestors.end())
+				continue;
+			auto childIter = curr->getChildIterator();
+			while(childIter.hasMoreElements())
+				stack.push_back( childIter.getNext() );
 		}
 		
-		// get current state of physics
-		btTransform currentTransform;
-		if (state)
-			state->getWorldTransform(currentTransform);
-		else
-			currentTransform = phyObj->getWorldTransform();
+		LOG_DEBUG("OgreToBullet: refresh ancestors of " << objects.size() << " static objects after reparent of node " << node->getName());
+		for (auto& obj : objects) {
+			PhyInfo& info = nodes.find(obj)->second;
+			unlinkAncestors(info);
+			linkAncestors(info);
+		}
+		return;
+	}
+}
+
+void MGE::OgreToBullet::markDirty(Ogre::Node* node) {
+	if (objByNode.empty())
+		return;
+	
+	syncAncestors(node);
+	markDirtyRecursive(node);
+}
+
+void MGE::OgreToBullet::markDirtyRecursive(Ogre::Node* node) {
+	auto range = objByNode.equal_range(node);
+	for (auto iter = range.first; iter != range.second; ++iter) {
+		PhyInfo& info = nodes.find(iter->second)->second;
+		if (!info.isDirty) {
+			info.isDirty = true;
+			dirtyObjects.push_back(iter->second);
+		}
+	}
+	
+	// physics objects attached to child nodes are moved too (but skip subtrees without static physics objects)
+	if (staticAncestors.find(node) == staticAncestors.end())
+		return;
+	auto childIter = node->getChildIterator();
+	while(childIter.hasMoreElements()) {
+		markDirtyRecursive( childIter.getNext() );
+	}
+}
+
+void MGE::OgreToBullet::updateAll() {
+	for (auto& obj : dirtyObjects) {
+		auto iter = nodes.find(obj);
+		if (iter == nodes.end())
+			continue;
+		iter->second.isDirty = false;
+		update(iter->first, iter->second, true);
+	}
+	dirtyObjects.clear();
+	
+	for (auto& iter : polledObjects) {
+		update(iter.first, *iter.second, false);
+	}
+}
+
+void MGE::OgreToBullet::update(btCollisionObject* phyObj, PhyInfo& info, bool updateCachedTransform) {
+	// check change on Ogre-side transform matrix
+	// (marked object can be checked before Ogre update cached transforms, so for it force update - otherwise change will be lost)
+	const Ogre::Matrix4& newFullTransform = updateCachedTransform ? info.node->_getFullTransformUpdated() : info.node->_getFullTransform();
+	if (newFullTransform == info.transform)
+		return;
+	info.transform = newFullTransform;
+	
+	
+	// is scale change ?
+	bool  force = false;
+	const Ogre::Vector3& scale = info.node->_getDerivedScale();
+	{
+		btVector3 newScale  = BtOgre::Convert::toBullet(scale);
+		btVector3 diffScale = phyObj->getCollisionShape()->getLocalScaling() - newScale;
+		if ( diffScale.x() > EPSION1 || diffScale.x() < -EPSION1 || diffScale.y() > EPSION1 || diffScale.y() < -EPSION1 || diffScale.z() > EPSION1 || diffScale.z() < -EPSION1 ) {
+			phyObj->getCollisionShape()->setLocalScaling(newScale);
+			force = true;
+		}
+	}
+	
+	// get scaled offset as Bullet transform
+	btTransform  transformOffset(
+		btQuaternion::getIdentity(),
+		BtOgre::Convert::toBullet( info.offset * scale )
+	);
+	
+	// calculate full transform from Ogre state
+	btTransform newTransform(
+		BtOgre::Convert::toBullet( info.node->_getDerivedOrientation() ),
+		BtOgre::Convert::toBullet( info.node->_getDerivedPosition() )
+	);
+	newTransform *= transformOffset;
+	
+	// skip transforms written to Ogre by interpolateAll (this is not Ogre-side change)
+	if (!force && info.hasWritten && isNearlyEqual(info.written, newTransform)) {
+		return;
+	}
+	
+	// for RigidBody use RigidBodyState
+	BtOgre::RigidBodyState* state = NULL;
+	if (phyObj->getInternalType() == btCollisionObject::CO_RIGID_BODY) {
+		state = static_cast<BtOgre::RigidBodyState*>(static_cast<btRigidBody*>(phyObj)->getMotionState());
+	}
+	
+	// get current state of physics
+	btTransform currentTransform;
+	if (state)
+		state->getWorldTransform(currentTransform);
+	else
+		currentTransform = phyObj->getWorldTransform();
+	
+	// compare with calculated newTransform to cancel small changes
+	if (!force && isNearlyEqual(currentTransform, newTransform)) {
+		return;
+	}
+	
+	//LOG_DEBUG("nodeUpdated: " << info.node->getName());
+	
+	// update only when need
+	if (state) {
+		state->setWorldTransformNoUpdate(newTransform);
+	}
+	phyObj->setWorldTransform(newTransform);
+	//phyObj->activate();
+	
+	// object was moved from Ogre side, so don't interpolate from old position
+	info.previous   = newTransform;
+	info.hasWritten = false;
+}
+
+void MGE::OgreToBullet::storePreviousTransforms() {
+	for (auto& iter : polledObjects) {
+		if (isDynamic(iter.first))
+			iter.second->previous = iter.first->getWorldTransform();
+	}
+}
+
+void MGE::OgreToBullet::interpolateAll(float alpha) {
+	for (auto& iter : polledObjects) {
+		auto& phyObj = iter.first;
+		auto& info   = *iter.second;
 		
-		// compare with calculated newTransform to cancel small changes
-		btVector3 posDiff = currentTransform.getOrigin() - newTransform.getOrigin();
-		btScalar  rotDiff = currentTransform.getRotation().dot(newTransform.getRotation());
+		if (!isDynamic(phyObj))
+			continue;
 		
-		if (
-			(!force) &&
-			posDiff.x() < EPSION1 && posDiff.x() > -EPSION1 && posDiff.y() < EPSION1 && posDiff.y() > -EPSION1 && posDiff.z() < EPSION1 && posDiff.z() > -EPSION1 &&
-			(rotDiff > EPSION2 || rotDiff < -EPSION2)
-		) {
-			return;
-		}
+		// interpolate between previous and current Bullet transform
+		const btTransform& current = phyObj->getWorldTransform();
+		btTransform interpolated(
+			info.previous.getRotation().slerp(current.getRotation(), alpha),
+			info.previous.getOrigin().lerp(current.getOrigin(), alpha)
+		);
 		
-		//LOG_DEBUG("nodeUpdated: " << info.node->getName() << "  " << posDiff.x() << ", " << posDiff.y() << ", " << posDiff.z() << "   " << rotDiff);
+		if (info.hasWritten && interpolated == info.written)
+			continue;
+		info.written    = interpolated;
+		info.hasWritten = true;
 		
-		// update only when need
-		if (state) {
-			state->setWorldTransformNoUpdate(newTransform);
-		}
-		phyObj->setWorldTransform(newTransform);
-		//phyObj->activate();
+		// remove (scaled) offset and write to Ogre node
+		interpolated *= btTransform(
+			btQuaternion::getIdentity(),
+			BtOgre::Convert::toBullet( -info.offset * info.node->_getDerivedScale() )
+		);
+		info.node->_setDerivedOrientation( BtOgre::Convert::toOgre(interpolated.getRotation()) );
+		info.node->_setDerivedPosition( BtOgre::Convert::toOgre(interpolated.getOrigin()) );
+	}
+}
+
+void MGE::OgreToBullet::resetInterpolation(btCollisionObject* obj) {
+	auto iter = nodes.find(obj);
+	if (iter != nodes.end()) {
+		iter->second.previous   = obj->getWorldTransform();
+		iter->second.hasWritten = false;
 	}
 }
+
+bool MGE::OgreToBullet::isDynamic(const btCollisionObject* obj) {
+	return obj->getInternalType() == btCollisionObject::CO_RIGID_BODY && !obj->isStaticOrKinematicObject();
+}
+
+bool MGE::OgreToBullet::isNearlyEqual(const btTransform& a, const btTransform& b) {
+	btVector3 posDiff = a.getOrigin() - b.getOrigin();
+	btScalar  rotDiff = a.getRotation().dot(b.getRotation());
+	
+	return
+		posDiff.x() < EPSION1 && posDiff.x() > -EPSION1 && posDiff.y() < EPSION1 && posDiff.y() > -EPSION1 && posDiff.z() < EPSION1 && posDiff.z() > -EPSION1 &&
+		(rotDiff > EPSION2 || rotDiff < -EPSION2);
+}
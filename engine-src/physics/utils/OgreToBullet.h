@@ -26,7 +26,10 @@ SOFTWARE.
 #include <OgreMatrix4.h>
 #include <OgreVector3.h>
 
+#include <LinearMath/btTransform.h>
+
 #include <unordered_map>
+#include <vector>
 
 class btCollisionObject;
 
@@ -38,36 +41,128 @@ namespace MGE {
 
 /**
  * @brief Propagation transforms (position, rotations, scale) from Ogre to Bullet
+ *        and (interpolated) transforms of dynamic objects from Bullet to Ogre
  * 
  * This class is for make setPosition(), setOrientation and similar on Ogre::Node working with Bullet physic object
  * 
+ * In fixed time step mode (see @ref MGE::Physics) @ref interpolateAll write to Ogre nodes transforms interpolated between
+ * previous (stored by @ref storePreviousTransforms) and current Bullet transforms, so rendering is smooth independent of
+ * simulation tick rate. Transforms written in this way are not propagated back to Bullet by @ref updateAll.
+ * 
+ * To avoid per frame checking of all physics objects, static objects are checked only when marked by @ref markDirty
+ * (this is done by engine API for changing transforms, see e.g. @ref MGE::World3DObject::setWorldPosition).
+ * 
+ * @warning Static objects moved directly via Ogre::Node API (in C++ or in Python scripts, e.g. @c getOgreSceneNode().setPosition())
+ *          are NOT synchronised with Bullet until @ref MGE::Physics::Physics::markTransformDirty (in scripts:
+ *          @ref MGE::World3DObject::updateCachedTransform) is called for moved node (or its ancestor).
+ * 
  * @note We don't use Ogre::Node listener interface because Ogre 2.1 call Ogre::Node::Listener::nodeUpdated() every frame,
  *       regardless of transforms changes or not. So do this in this way.
  */
 class OgreToBullet {
 public:
-	inline void addObj(btCollisionObject* obj, Ogre::Node* node, const Ogre::Vector3& offset) {
-		nodes.insert( {obj, {node, node->_getFullTransform(), offset}} );
-	}
+	/// register physics object @a obj attached to scene @a node
+	void addObj(btCollisionObject* obj, Ogre::Node* node, const Ogre::Vector3& offset);
+	
+	/// unregister physics object @a obj
+	void remObj(btCollisionObject* obj);
 	
-	inline void remObj(btCollisionObject* obj) {
-		nodes.erase(obj);
-	}
+	/// unregister all physics objects
+	void clearAll();
 	
-	inline void clearAll() {
-		nodes.clear();
-	}
+	/**
+	 * @brief mark transform of @a node and all its descendants as changed
+	 * 
+	 * Static physics objects attached to marked nodes will be checked (and updated when need) in next @ref updateAll call.
+	 * Only subtrees containing static physics objects are visited.
+	 * 
+	 * @note Static objects are checked ONLY after mark, so this must be called after change transform of node
+	 *       (or its ancestor) with static physics object. Other objects are checked in every @ref updateAll call.
+	 * @note Ancestors of static objects nodes are cached (for skip subtrees without static objects). Cache is verified
+	 *       against live parents chain of @a node (and refreshed for reparented subtree) on each call, so after reparent
+	 *       markDirty must be called for reparented node (or its descendant), not only for its new ancestor.
+	 */
+	void markDirty(Ogre::Node* node);
 	
+	/// propagate Ogre-side transform changes to Bullet (for marked and not static objects)
 	void updateAll();
 	
+	/// store current Bullet transforms of dynamic objects as previous (call before last simulation step in frame)
+	void storePreviousTransforms();
+	
+	/**
+	 * @brief write to Ogre nodes of dynamic objects transforms interpolated between previous and current Bullet transforms
+	 * 
+	 * @param alpha  interpolation factor (0 → previous transform, 1 → current transform)
+	 */
+	void interpolateAll(float alpha);
+	
 protected:
 	struct PhyInfo {
 		Ogre::Node*        node;
 		Ogre::Matrix4      transform;
 		Ogre::Vector3      offset;
+		/// Bullet transform before last simulation step
+		btTransform        previous;
+		/// transform written to Ogre node by @ref interpolateAll (in Bullet coordinates, with offset)
+		btTransform        written;
+		/// true when @a written is valid
+		bool               hasWritten;
+		/// true when object is static (is not checked in every @ref updateAll call)
+		bool               isStatic;
+		/// true when object is on @ref dirtyObjects list
+		bool               isDirty;
+		/// ancestors of @a node counted in @ref staticAncestors (only for static objects, refreshed on reparent)
+		std::vector<Ogre::Node*> ancestors;
 	};
+	
+	/**
+	 * @brief propagate Ogre-side transform changes of single object to Bullet
+	 * 
+	 * @param phyObj                 physics object
+	 * @param info                   physics object info
+	 * @param updateCachedTransform  when true update Ogre node cached transform before use it
+	 */
+	void update(btCollisionObject* phyObj, PhyInfo& info, bool updateCachedTransform);
+	
+	/// add ancestors of static object @a info node to @ref staticAncestors and @ref staticParents
+	void linkAncestors(PhyInfo& info);
+	
+	/// remove ancestors of static object @a info node from @ref staticAncestors and @ref staticParents
+	void unlinkAncestors(PhyInfo& info);
+	
+	/// check cached parents of @a node and its ancestors against live parents chain, refresh reparented subtree
+	void syncAncestors(Ogre::Node* node);
+	
+	/// implementation of @ref markDirty (without @ref syncAncestors)
+	void markDirtyRecursive(Ogre::Node* node);
+	
+	/// set previous transform of @a obj to its current transform and forget written transform
+	void resetInterpolation(btCollisionObject* obj);
+	
+	/// return true when @a obj is dynamic (not static nor kinematic) rigid body
+	static bool isDynamic(const btCollisionObject* obj);
+	
+	/// return true when @a a and @a b transforms are equal with EPSION1 / EPSION2 tolerance
+	static bool isNearlyEqual(const btTransform& a, const btTransform& b);
 	std::unordered_map<btCollisionObject*, PhyInfo> nodes;
 	
+	/// map scene node to attached static physics objects (for @ref markDirty), single node can have multiple physics objects
+	std::unordered_multimap<Ogre::Node*, btCollisionObject*> objByNode;
+	
+	/// map scene node to number of static physics objects attached to its descendants (for stop @ref markDirty recursion)
+	std::unordered_map<Ogre::Node*, uint32_t> staticAncestors;
+	
+	/// map scene node with static physics objects in its subtree (including itself) to its parent at time of caching
+	/// (for detect reparent in @ref syncAncestors)
+	std::unordered_map<Ogre::Node*, Ogre::Node*> staticParents;
+	
+	/// not static objects (checked in every @ref updateAll call), pointers to @ref nodes elements (stable on rehash)
+	std::vector<std::pair<btCollisionObject*, PhyInfo*>> polledObjects;
+	
+	/// objects marked by @ref markDirty since last @ref updateAll call
+	std::vector<btCollisionObject*> dirtyObjects;
+	
 	static constexpr float EPSION1 = 0.001;
 	static constexpr float EPSION2 = 0.99999f;
 };
@@ -0,0 +1,265 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "physics/utils/OrientedBoundingBox.h"
+
+#include <cmath>
+
+#if !defined MGE_NO_SIMD && defined __AVX__
+	#define MGE_OBB_USE_AVX
+#endif
+#if !defined MGE_NO_SIMD && (defined __SSE2__ || defined _M_X64)
+	#define MGE_OBB_USE_SSE
+#endif
+#if defined MGE_OBB_USE_AVX || defined MGE_OBB_USE_SSE
+	#include <immintrin.h>
+#endif
+
+MGE::OrientedBoundingBox::OrientedBoundingBox(
+	const Ogre::Vector3& localCenter, const Ogre::Vector3& localHalfSize,
+	const Ogre::Vector3& position, const Ogre::Quaternion& orientation, const Ogre::Vector3& scale
+) {
+	orientation.ToAxes(axis[0], axis[1], axis[2]);
+	center   = position + orientation * (scale * localCenter);
+	halfSize = Ogre::Vector3(
+		std::fabs(scale.x * localHalfSize.x), std::fabs(scale.y * localHalfSize.y), std::fabs(scale.z * localHalfSize.z)
+	);
+}
+
+MGE::OrientedBoundingBox::OrientedBoundingBox(const Ogre::AxisAlignedBox& aabb) :
+	center(aabb.getCenter()), axis{Ogre::Vector3::UNIT_X, Ogre::Vector3::UNIT_Y, Ogre::Vector3::UNIT_Z}, halfSize(aabb.getHalfSize())
+{ }
+
+namespace {
+	using Fields = MGE::OrientedBoundingBoxBatch::Fields;
+	
+	/// added to absolute values of rotation matrix elements to avoid false separation on (near) parallel edges
+	constexpr float EPSILON = 1e-6f;
+	
+	/// box tested against all boxes in batch
+	struct SingleBox {
+		float c[3];
+		float a[3][3];
+		float h[3];
+		
+		SingleBox(const MGE::OrientedBoundingBox& box) {
+			for (int i=0; i<3; ++i) {
+				c[i] = box.center[i];
+				h[i] = box.halfSize[i];
+				for (int k=0; k<3; ++k)
+					a[i][k] = box.axis[i][k];
+			}
+		}
+	};
+	
+	/// scalar implementation of operations used by separatingAxisTest()
+	struct ScalarOps {
+		static constexpr size_t width = 1;
+		typedef float Value;
+		typedef bool  Mask;
+		static inline Value load(const float* p)          { return *p; }
+		static inline Value set(float x)                  { return x; }
+		static inline Value add(Value a, Value b)         { return a + b; }
+		static inline Value sub(Value a, Value b)         { return a - b; }
+		static inline Value mul(Value a, Value b)         { return a * b; }
+		static inline Value abs(Value a)                  { return std::fabs(a); }
+		static inline Mask  greater(Value a, Value b)     { return a > b; }
+		static inline Mask  orMask(Mask a, Mask b)        { return a || b; }
+		static inline void  storeNot(Mask m, uint8_t* out) { *out = !m; }
+	};
+	
+	#ifdef MGE_OBB_USE_SSE
+	/// SSE implementation of operations used by separatingAxisTest()
+	struct SSEOps {
+		static constexpr size_t width = 4;
+		typedef __m128 Value;
+		typedef __m128 Mask;
+		static inline Value load(const float* p)          { return _mm_loadu_ps(p); }
+		static inline Value set(float x)                  { return _mm_set1_ps(x); }
+		static inline Value add(Value a, Value b)         { return _mm_add_ps(a, b); }
+		static inline Value sub(Value a, Value b)         { return _mm_sub_ps(a, b); }
+		static inline Value mul(Value a, Value b)         { return _mm_mul_ps(a, b); }
+		static inline Value abs(Value a)                  { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+		static inline Mask  greater(Value a, Value b)     { return _mm_cmpgt_ps(a, b); }
+		static inline Mask  orMask(Mask a, Mask b)        { return _mm_or_ps(a, b); }
+		static inline void  storeNot(Mask m, uint8_t* out) {
+			int bits = _mm_movemask_ps(m);
+			for (size_t k=0; k<width; ++k)
+				out[k] = !((bits >> k) & 1);
+		}
+	};
+	#endif
+	
+	#ifdef MGE_OBB_USE_AVX
+	/// AVX implementation of operations used by separatingAxisTest()
+	struct AVXOps {
+		static constexpr size_t width = 8;
+		typedef __m256 Value;
+		typedef __m256 Mask;
+		static inline Value load(const float* p)          { return _mm256_loadu_ps(p); }
+		static inline Value set(float x)                  { return _mm256_set1_ps(x); }
+		static inline Value add(Value a, Value b)         { return _mm256_add_ps(a, b); }
+		static inline Value sub(Value a, Value b)         { return _mm256_sub_ps(a, b); }
+		static inline Value mul(Value a, Value b)         { return _mm256_mul_ps(a, b); }
+		static inline Value abs(Value a)                  { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+		static inline Mask  greater(Value a, Value b)     { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+		static inline Mask  orMask(Mask a, Mask b)        { return _mm256_or_ps(a, b); }
+		static inline void  storeNot(Mask m, uint8_t* out) {
+			int bits = _mm256_movemask_ps(m);
+			for (size_t k=0; k<width; ++k)
+				out[k] = !((bits >> k) & 1);
+		}
+	};
+	#endif
+	
+	/**
+	 * @brief separating axis test of box @a a with Ops::width boxes from @a data (starting at index @a n)
+	 * 
+	 * @tparam Ops           struct with implementation of vector operations
+	 * @tparam axisAlignedA  when true, assume @a a axes are WORLD axes (skip rotation of @a a)
+	 */
+	template <typename Ops, bool axisAlignedA> inline void separatingAxisTest(
+		const SingleBox& a, const float* const* data, size_t n, uint8_t* results
+	) {
+		typedef typename Ops::Value Value;
+		
+		// 1. get rotation matrix expressing boxes b in a coordinate frame and translation vector in a coordinate frame
+		Value b[3][3], hb[3], d[3], R[3][3], absR[3][3], t[3];
+		for (int j=0; j<3; ++j) {
+			for (int k=0; k<3; ++k)
+				b[j][k] = Ops::load(data[Fields::A0X + 3*j + k] + n);
+			hb[j] = Ops::load(data[Fields::HX + j] + n);
+			d[j]  = Ops::sub(Ops::load(data[Fields::CX + j] + n), Ops::set(a.c[j]));
+		}
+		
+		const Value epsilon = Ops::set(EPSILON);
+		for (int i=0; i<3; ++i) {
+			if constexpr (axisAlignedA) {
+				for (int j=0; j<3; ++j)
+					R[i][j] = b[j][i];
+				t[i] = d[i];
+			} else {
+				Value ax = Ops::set(a.a[i][0]), ay = Ops::set(a.a[i][1]), az = Ops::set(a.a[i][2]);
+				for (int j=0; j<3; ++j)
+					R[i][j] = Ops::add(Ops::add(Ops::mul(ax, b[j][0]), Ops::mul(ay, b[j][1])), Ops::mul(az, b[j][2]));
+				t[i] = Ops::add(Ops::add(Ops::mul(ax, d[0]), Ops::mul(ay, d[1])), Ops::mul(az, d[2]));
+			}
+			for (int j=0; j<3; ++j)
+				absR[i][j] = Ops::add(Ops::abs(R[i][j]), epsilon);
+		}
+		
+		const Value ha[3] = { Ops::set(a.h[0]), Ops::set(a.h[1]), Ops::set(a.h[2]) };
+		typename Ops::Mask separated = Ops::greater(epsilon, epsilon);
+		
+		// 2. test axes of a
+		for (int i=0; i<3; ++i) {
+			Value rb = Ops::add(Ops::add(Ops::mul(hb[0], absR[i][0]), Ops::mul(hb[1], absR[i][1])), Ops::mul(hb[2], absR[i][2]));
+			separated = Ops::orMask(separated, Ops::greater(Ops::abs(t[i]), Ops::add(ha[i], rb)));
+		}
+		
+		// 3. test axes of b
+		for (int j=0; j<3; ++j) {
+			Value ra = Ops::add(Ops::add(Ops::mul(ha[0], absR[0][j]), Ops::mul(ha[1], absR[1][j])), Ops::mul(ha[2], absR[2][j]));
+			Value tj = Ops::add(Ops::add(Ops::mul(t[0], R[0][j]), Ops::mul(t[1], R[1][j])), Ops::mul(t[2], R[2][j]));
+			separated = Ops::orMask(separated, Ops::greater(Ops::abs(tj), Ops::add(ra, hb[j])));
+		}
+		
+		// 4. test cross products of a and b axes
+		for (int i=0; i<3; ++i) {
+			int i1 = (i+1)%3, i2 = (i+2)%3;
+			for (int j=0; j<3; ++j) {
+				int j1 = (j+1)%3, j2 = (j+2)%3;
+				Value ra = Ops::add(Ops::mul(ha[i1], absR[i2][j]), Ops::mul(ha[i2], absR[i1][j]));
+				Value rb = Ops::add(Ops::mul(hb[j1], absR[i][j2]), Ops::mul(hb[j2], absR[i][j1]));
+				Value tij = Ops::sub(Ops::mul(t[i2], R[i1][j]), Ops::mul(t[i1], R[i2][j]));
+				separated = Ops::orMask(separated, Ops::greater(Ops::abs(tij), Ops::add(ra, rb)));
+			}
+		}
+		
+		Ops::storeNot(separated, results);
+	}
+	
+	template <bool axisAlignedA> inline void intersectsBatch(
+		const SingleBox& a, const std::vector<float>* data, size_t count, uint8_t* results
+	) {
+		const float* fields[Fields::FIELDS_COUNT];
+		for (int f=0; f<Fields::FIELDS_COUNT; ++f)
+			fields[f] = data[f].data();
+		
+		size_t n = 0;
+		#ifdef MGE_OBB_USE_AVX
+		for (; n + AVXOps::width <= count; n += AVXOps::width)
+			separatingAxisTest<AVXOps, axisAlignedA>(a, fields, n, results + n);
+		#endif
+		#ifdef MGE_OBB_USE_SSE
+		for (; n + SSEOps::width <= count; n += SSEOps::width)
+			separatingAxisTest<SSEOps, axisAlignedA>(a, fields, n, results + n);
+		#endif
+		for (; n < count; ++n)
+			separatingAxisTest<ScalarOps, axisAlignedA>(a, fields, n, results + n);
+	}
+}
+
+bool MGE::OrientedBoundingBox::intersects(const MGE::OrientedBoundingBox& other) const {
+	float values[Fields::FIELDS_COUNT] = {
+		other.center.x,  other.center.y,  other.center.z,
+		other.axis[0].x, other.axis[0].y, other.axis[0].z,
+		other.axis[1].x, other.axis[1].y, other.axis[1].z,
+		other.axis[2].x, other.axis[2].y, other.axis[2].z,
+		other.halfSize.x, other.halfSize.y, other.halfSize.z
+	};
+	const float* fields[Fields::FIELDS_COUNT];
+	for (int f=0; f<Fields::FIELDS_COUNT; ++f)
+		fields[f] = values + f;
+	
+	uint8_t result;
+	separatingAxisTest<ScalarOps, false>(SingleBox(*this), fields, 0, &result);
+	return result;
+}
+
+void MGE::OrientedBoundingBoxBatch::push_back(const MGE::OrientedBoundingBox& box) {
+	for (int i=0; i<3; ++i) {
+		data[CX + i].push_back(box.center[i]);
+		data[A0X + i].push_back(box.axis[0][i]);
+		data[A1X + i].push_back(box.axis[1][i]);
+		data[A2X + i].push_back(box.axis[2][i]);
+		data[HX + i].push_back(box.halfSize[i]);
+	}
+}
+
+void MGE::OrientedBoundingBoxBatch::clear() {
+	for (auto& field : data)
+		field.clear();
+}
+
+void MGE::OrientedBoundingBoxBatch::reserve(size_t count) {
+	for (auto& field : data)
+		field.reserve(count);
+}
+
+void MGE::OrientedBoundingBoxBatch::intersects(const MGE::OrientedBoundingBox& box, uint8_t* results) const {
+	intersectsBatch<false>(SingleBox(box), data, size(), results);
+}
+
+void MGE::OrientedBoundingBoxBatch::intersects(const Ogre::AxisAlignedBox& box, uint8_t* results) const {
+	intersectsBatch<true>(SingleBox(MGE::OrientedBoundingBox(box)), data, size(), results);
+}
@@ -0,0 +1,137 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma   once
+#include "config.h"
+
+#include <OgreVector3.h>
+#include <OgreQuaternion.h>
+#include <OgreAxisAlignedBox.h>
+
+#include <vector>
+#include <cstdint>
+
+namespace MGE {
+
+/// @addtogroup Physics
+/// @{
+/// @file
+
+/**
+ * @brief Oriented Bounding Box in WORLD space
+ */
+struct OrientedBoundingBox {
+	/// centre of box
+	Ogre::Vector3 center;
+	
+	/// box (unit length) axes
+	Ogre::Vector3 axis[3];
+	
+	/// half of box size along each of @ref axis
+	Ogre::Vector3 halfSize;
+	
+	/// default constructor (uninitialised box)
+	OrientedBoundingBox() = default;
+	
+	/**
+	 * @brief create OBB from box in LOCAL space and LOCAL to WORLD transform
+	 * 
+	 * @param[in] localCenter    centre of box in LOCAL space
+	 * @param[in] localHalfSize  half size of box in LOCAL space
+	 * @param[in] position       position of LOCAL space origin (in WORLD space)
+	 * @param[in] orientation    orientation of LOCAL space (in WORLD space)
+	 * @param[in] scale          scale of LOCAL space
+	 */
+	OrientedBoundingBox(
+		const Ogre::Vector3& localCenter, const Ogre::Vector3& localHalfSize,
+		const Ogre::Vector3& position, const Ogre::Quaternion& orientation, const Ogre::Vector3& scale
+	);
+	
+	/**
+	 * @brief create OBB from (finite) Axis Aligned Bounding Box in WORLD space
+	 */
+	OrientedBoundingBox(const Ogre::AxisAlignedBox& aabb);
+	
+	/**
+	 * @brief return true when this box intersects (or touches) @a other box
+	 * 
+	 * Use separating axis test (15 axes) in WORLD space.
+	 */
+	bool intersects(const OrientedBoundingBox& other) const;
+};
+
+/**
+ * @brief structure-of-arrays set of Oriented Bounding Boxes for batched intersection tests
+ * 
+ * Intersection tests are done by separating axis test for multiple boxes at once using AVX (8 boxes)
+ * or SSE (4 boxes) instructions (when available at compile time and not disabled by MGE_NO_SIMD)
+ * with scalar fallback.
+ */
+class OrientedBoundingBoxBatch {
+public:
+	/// add @a box to batch
+	void push_back(const OrientedBoundingBox& box);
+	
+	/// remove all boxes from batch (without releasing memory)
+	void clear();
+	
+	/// reserve memory for @a count boxes
+	void reserve(size_t count);
+	
+	/// return number of boxes in batch
+	size_t size() const {
+		return data[CX].size();
+	}
+	
+	/**
+	 * @brief check intersection of @a box with all boxes in batch
+	 * 
+	 * @param[in]  box      box to test
+	 * @param[out] results  array of size() elements, i-th element is set to 1 when @a box intersects i-th box in batch, 0 otherwise
+	 */
+	void intersects(const OrientedBoundingBox& box, uint8_t* results) const;
+	
+	/**
+	 * @brief check intersection of Axis Aligned Bounding Box (in WORLD space) @a box with all boxes in batch
+	 * 
+	 * @copydetails intersects(const OrientedBoundingBox&, uint8_t*) const
+	 */
+	void intersects(const Ogre::AxisAlignedBox& box, uint8_t* results) const;
+	
+	/// indexes of fields in @ref data
+	enum Fields {
+		CX, CY, CZ,
+		A0X, A0Y, A0Z,
+		A1X, A1Y, A1Z,
+		A2X, A2Y, A2Z,
+		HX, HY, HZ,
+		FIELDS_COUNT
+	};
+	
+protected:
+	/// boxes data as structure of arrays
+	std::vector<float> data[FIELDS_COUNT];
+};
+
+/// @}
+
+}
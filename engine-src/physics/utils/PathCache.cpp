@@ -0,0 +1,260 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "physics/utils/PathCache.h"
+
+#include "LogSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+MGE::PathCache::PathCache(size_t _maxEntries) :
+	versionCounter(0),
+	maxEntries(_maxEntries)
+{
+	LOG_INFO("Create PathCache with maxEntries=" << maxEntries);
+}
+
+MGE::PathCache::LookupResult MGE::PathCache::get(uint32_t moverType, const Ogre::Vector3& start, const Ogre::Vector3& finish, std::list<Ogre::Vector3>& points) {
+	uint32_t startCell  = getCellKey(start);
+	uint32_t finishCell = getCellKey(finish);
+	
+	std::lock_guard<std::mutex> lock(mutex);
+	
+	// start and finish in the same cell is handled by path finder without search, so it's never cached
+	if (!moverType || startCell == finishCell || entries.empty()) {
+		++stats.misses;
+		return MISS;
+	}
+	
+	// exact match
+	auto iter = byCells.find(getCellsKey(moverType, startCell, finishCell));
+	if (iter != byCells.end()) {
+		EntryIterator entry = iter->second;
+		if (entry->moverType == moverType && entry->startCell == startCell && entry->finishCell == finishCell) {
+			if (isValid(*entry)) {
+				entries.splice(entries.begin(), entries, entry);
+				points.assign(entry->points.begin(), entry->points.end());
+				++stats.hits;
+				return HIT;
+			}
+			erase(entry);
+			++stats.invalidated;
+		}
+	}
+	
+	// start point on cached path to the same finish cell – use remaining part of this path
+	auto range = byFinish.equal_range(getCellTypeKey(moverType, finishCell));
+	for (auto it = range.first; it != range.second;) {
+		EntryIterator entry = (it++)->second;
+		int segment = findSegment(entry->points, start);
+		if (segment < 0)
+			continue;
+		if (!isValid(*entry)) {
+			erase(entry);
+			++stats.invalidated;
+			continue;
+		}
+		
+		points.clear();
+		points.push_back( MGE::HexagonalGridPoint(start).toOgre() );
+		for (size_t i = segment + 1; i < entry->points.size(); ++i) {
+			if (i == static_cast<size_t>(segment + 1) && getCellKey(entry->points[i]) == startCell)
+				continue;
+			points.push_back( entry->points[i] );
+		}
+		entries.splice(entries.begin(), entries, entry);
+		++stats.partialHits;
+		return PARTIAL_HIT;
+	}
+	
+	// finish point on cached path from the same start cell – use initial part of this path
+	range = byStart.equal_range(getCellTypeKey(moverType, startCell));
+	for (auto it = range.first; it != range.second;) {
+		EntryIterator entry = (it++)->second;
+		int segment = findSegment(entry->points, finish);
+		if (segment < 0)
+			continue;
+		if (!isValid(*entry)) {
+			erase(entry);
+			++stats.invalidated;
+			continue;
+		}
+		
+		points.assign(entry->points.begin(), entry->points.begin() + segment + 1);
+		if (getCellKey(points.back()) != finishCell)
+			points.push_back( MGE::HexagonalGridPoint(finish).toOgre() );
+		entries.splice(entries.begin(), entries, entry);
+		++stats.partialHits;
+		return PARTIAL_HIT;
+	}
+	
+	++stats.misses;
+	return MISS;
+}
+
+void MGE::PathCache::put(uint32_t moverType, const Ogre::Vector3& start, const Ogre::Vector3& finish, const std::list<Ogre::Vector3>& points, float moverRadius, uint64_t version) {
+	if (!moverType || !maxEntries || points.size() < 2)
+		return;
+	
+	Entry entry;
+	entry.moverType  = moverType;
+	entry.startCell  = getCellKey(start);
+	entry.finishCell = getCellKey(finish);
+	entry.version    = version;
+	if (entry.startCell == entry.finishCell)
+		return;
+	entry.points.assign(points.begin(), points.end());
+	
+	// regions crossed by path extended by mover size (and one grid cell for cells rounding),
+	// sampling step is not greater than margin, so sampled areas cover whole path
+	float margin = moverRadius + MGE::HexagonalGridPoint::distanceY;
+	Ogre::Vector3 marginVector(margin, 0, margin);
+	for (size_t i = 1; i < entry.points.size(); ++i) {
+		Ogre::Vector3 from = entry.points[i-1], to = entry.points[i];
+		from.y = to.y = 0;
+		int steps = std::max(1, static_cast<int>(std::ceil(from.distance(to) / margin)));
+		for (int j = (i == 1) ? 0 : 1; j <= steps; ++j) {
+			Ogre::Vector3 point = from + (to - from) * (static_cast<float>(j) / steps);
+			addRegions(point - marginVector, point + marginVector, entry.regions);
+		}
+	}
+	std::sort(entry.regions.begin(), entry.regions.end());
+	entry.regions.erase(std::unique(entry.regions.begin(), entry.regions.end()), entry.regions.end());
+	
+	std::lock_guard<std::mutex> lock(mutex);
+	
+	// map was changed during path search
+	if (!isValid(entry))
+		return;
+	
+	uint64_t key = getCellsKey(moverType, entry.startCell, entry.finishCell);
+	auto iter = byCells.find(key);
+	if (iter != byCells.end())
+		erase(iter->second);
+	
+	entries.push_front(std::move(entry));
+	byCells[key] = entries.begin();
+	byFinish.emplace(getCellTypeKey(moverType, entries.front().finishCell), entries.begin());
+	byStart.emplace(getCellTypeKey(moverType, entries.front().startCell), entries.begin());
+	
+	while (entries.size() > maxEntries)
+		erase(std::prev(entries.end()));
+}
+
+uint64_t MGE::PathCache::getVersion() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return versionCounter;
+}
+
+void MGE::PathCache::invalidateArea(const Ogre::Vector3& min, const Ogre::Vector3& max) {
+	// cells are selected by rounding, so extend area by one cell on each side
+	Ogre::Vector3 cellVector(MGE::HexagonalGridPoint::distanceY, 0, MGE::HexagonalGridPoint::distanceY);
+	std::vector<uint32_t> regions;
+	addRegions(min - cellVector, max + cellVector, regions);
+	
+	std::lock_guard<std::mutex> lock(mutex);
+	LOG_INFO("PathCache: invalidate area from " << min << " to " << max << " (" << regions.size() << " regions)");
+	
+	++versionCounter;
+	for (auto& region : regions)
+		regionVersions[region] = versionCounter;
+}
+
+void MGE::PathCache::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	LOG_INFO("Clear PathCache");
+	
+	entries.clear();
+	byCells.clear();
+	byFinish.clear();
+	byStart.clear();
+	regionVersions.clear();
+	// versionCounter is not reset – path searches started before clear() must not be cached as valid
+}
+
+size_t MGE::PathCache::size() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return entries.size();
+}
+
+MGE::PathCache::Stats MGE::PathCache::getStats() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
+
+void MGE::PathCache::addRegions(const Ogre::Vector3& min, const Ogre::Vector3& max, std::vector<uint32_t>& regions) {
+	MGE::HexagonalGridPoint minCell(min), maxCell(max);
+	int16_t raMin = toRegionCoord(std::min(minCell.a, maxCell.a)), raMax = toRegionCoord(std::max(minCell.a, maxCell.a));
+	int16_t rbMin = toRegionCoord(std::min(minCell.b, maxCell.b)), rbMax = toRegionCoord(std::max(minCell.b, maxCell.b));
+	for (int rb = rbMin; rb <= rbMax; ++rb) {
+		for (int ra = raMin; ra <= raMax; ++ra) {
+			uint32_t key = (static_cast<uint32_t>(static_cast<uint16_t>(ra)) << 16) | static_cast<uint16_t>(rb);
+			if (regions.empty() || regions.back() != key)
+				regions.push_back(key);
+		}
+	}
+}
+
+bool MGE::PathCache::isValid(const Entry& entry) const {
+	for (auto& region : entry.regions) {
+		auto iter = regionVersions.find(region);
+		if (iter != regionVersions.end() && iter->second > entry.version)
+			return false;
+	}
+	return true;
+}
+
+void MGE::PathCache::erase(EntryIterator entry) {
+	auto iter = byCells.find(getCellsKey(entry->moverType, entry->startCell, entry->finishCell));
+	if (iter != byCells.end() && iter->second == entry)
+		byCells.erase(iter);
+	
+	auto eraseFrom = [entry](std::unordered_multimap<uint64_t, EntryIterator>& index, uint64_t key) {
+		auto range = index.equal_range(key);
+		for (auto it = range.first; it != range.second; ++it) {
+			if (it->second == entry) {
+				index.erase(it);
+				return;
+			}
+		}
+	};
+	eraseFrom(byFinish, getCellTypeKey(entry->moverType, entry->finishCell));
+	eraseFrom(byStart,  getCellTypeKey(entry->moverType, entry->startCell));
+	
+	entries.erase(entry);
+}
+
+int MGE::PathCache::findSegment(const std::vector<Ogre::Vector3>& points, const Ogre::Vector3& point) {
+	float maxDistance2 = MGE::HexagonalGridPoint::halfDistanceY * MGE::HexagonalGridPoint::halfDistanceY;
+	for (size_t i = 1; i < points.size(); ++i) {
+		float dx = points[i].x - points[i-1].x, dz = points[i].z - points[i-1].z;
+		float px = point.x - points[i-1].x,     pz = point.z - points[i-1].z;
+		float len2 = dx * dx + dz * dz;
+		float t = (len2 > 0) ? std::clamp((px * dx + pz * dz) / len2, 0.0f, 1.0f) : 0.0f;
+		px -= t * dx;
+		pz -= t * dz;
+		if (px * px + pz * pz <= maxDistance2)
+			return i - 1;
+	}
+	return -1;
+}
@@ -0,0 +1,233 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma   once
+
+#include "BaseClasses.h"
+
+#include "physics/utils/HexagonalGrid.h"
+
+#include <OgreVector3.h>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace MGE {
+
+/// @addtogroup Physics
+/// @{
+/// @file
+
+/**
+ * @brief LRU cache of paths found by @ref MGE::PathFinder.
+ * 
+ * Paths are keyed by start and finish @ref MGE::HexagonalGridPoint cells and mover type (see @ref MGE::World3DObject::getMoverType),
+ * so repeated orders between the same points (e.g. vehicles driving between depots and targets) cost a lookup instead of a search.
+ * 
+ * Cached path is also reused for partial matches (with the same mover type):
+ *   @li when start point lies on cached path to the same finish cell – remaining part of cached path is returned
+ *   @li when finish point lies on cached path from the same start cell – initial part of cached path is returned
+ * 
+ * Invalidation is based on region versions: world is split into square (in grid coordinates) regions of @ref regionSize × @ref regionSize cells,
+ * @ref invalidateArea sets version of regions overlapping changed area to new value of global version counter and cached path
+ * is valid only when none of regions crossed by it (extended by mover size) was changed after path search started.
+ * 
+ * All public functions are thread safe (path finding workers can use this object in parallel).
+ * 
+ * See too: @ref PathFinding
+ */
+class PathCache :
+	public MGE::Singleton<PathCache>
+{
+public:
+	/// region size (in grid cells)
+	static constexpr int regionSize = 32;
+	
+	/// values returned by @ref get
+	enum LookupResult {
+		/// path not found in cache
+		MISS = 0,
+		/// found path with the same start and finish cells
+		HIT,
+		/// found part of longer cached path
+		PARTIAL_HIT
+	};
+	
+	/**
+	 * @brief Find cached path.
+	 * 
+	 * @param[in]  moverType  mover type (see @ref MGE::World3DObject::getMoverType), 0 means object not using path cache
+	 * @param[in]  start      start point
+	 * @param[in]  finish     finish point
+	 * @param[out] points     reference to std::list of points to write found path (not modified on @ref MISS)
+	 * 
+	 * @return @ref LookupResult value
+	 */
+	LookupResult get(uint32_t moverType, const Ogre::Vector3& start, const Ogre::Vector3& finish, std::list<Ogre::Vector3>& points);
+	
+	/**
+	 * @brief Put path to cache.
+	 * 
+	 * @param[in]  moverType    mover type (see @ref MGE::World3DObject::getMoverType), 0 means object not using path cache
+	 * @param[in]  start        start point
+	 * @param[in]  finish       finish point
+	 * @param[in]  points       found path
+	 * @param[in]  moverRadius  (horizontal) radius of mover, used to determine regions which modification can invalidate this path
+	 * @param[in]  version      value of @ref getVersion from before path search, path is not valid when any of its regions
+	 *                          was changed after this version
+	 */
+	void put(uint32_t moverType, const Ogre::Vector3& start, const Ogre::Vector3& finish, const std::list<Ogre::Vector3>& points, float moverRadius, uint64_t version);
+	
+	/**
+	 * @brief Return current value of region versions counter (to use as @a version argument of @ref put).
+	 */
+	uint64_t getVersion();
+	
+	/**
+	 * @brief Mark regions overlapping area as changed (invalidate cached paths crossing this area).
+	 * 
+	 * @param min  minimum corner of changed area
+	 * @param max  maximum corner of changed area
+	 */
+	void invalidateArea(const Ogre::Vector3& min, const Ogre::Vector3& max);
+	
+	/**
+	 * @brief Remove all cached paths and region versions.
+	 */
+	void clear();
+	
+	/**
+	 * @brief Return number of cached paths.
+	 */
+	size_t size();
+	
+	/// cache statistics
+	struct Stats {
+		/// number of @ref HIT results
+		uint64_t hits = 0;
+		/// number of @ref PARTIAL_HIT results
+		uint64_t partialHits = 0;
+		/// number of @ref MISS results
+		uint64_t misses = 0;
+		/// number of cached paths removed due to changed regions
+		uint64_t invalidated = 0;
+	};
+	
+	/**
+	 * @brief Return cache statistics.
+	 */
+	Stats getStats();
+	
+	/**
+	 * @brief Constructor.
+	 * 
+	 * @param maxEntries  maximum number of cached paths (least recently used paths are removed when exceeded)
+	 */
+	PathCache(size_t maxEntries = 256);
+	
+protected:
+	/// cached path
+	struct Entry {
+		/// mover type
+		uint32_t moverType;
+		/// packed start cell
+		uint32_t startCell;
+		/// packed finish cell
+		uint32_t finishCell;
+		/// value of version counter from before path search
+		uint64_t version;
+		/// path points
+		std::vector<Ogre::Vector3> points;
+		/// (sorted) keys of regions crossed by path
+		std::vector<uint32_t> regions;
+	};
+	
+	/// cached paths, most recently used first
+	std::list<Entry> entries;
+	
+	/// type of iterator to @ref entries
+	typedef std::list<Entry>::iterator EntryIterator;
+	
+	/// cached paths, key is packed (mover type, start cell, finish cell)
+	std::unordered_map<uint64_t, EntryIterator> byCells;
+	
+	/// cached paths, key is packed (mover type, finish cell), used for start on path matches
+	std::unordered_multimap<uint64_t, EntryIterator> byFinish;
+	
+	/// cached paths, key is packed (mover type, start cell), used for finish on path matches
+	std::unordered_multimap<uint64_t, EntryIterator> byStart;
+	
+	/// regions versions (last change), key is packed region coordinates
+	std::unordered_map<uint32_t, uint64_t> regionVersions;
+	
+	/// regions versions counter
+	uint64_t versionCounter;
+	
+	/// maximum number of cached paths
+	size_t maxEntries;
+	
+	/// statistics
+	Stats stats;
+	
+	/// mutex for all above members
+	std::mutex mutex;
+	
+	/// return packed cell for point @a p
+	inline static uint32_t getCellKey(const Ogre::Vector3& p) {
+		MGE::HexagonalGridPoint cell(p);
+		return (static_cast<uint32_t>(static_cast<uint16_t>(cell.a)) << 16) | static_cast<uint16_t>(cell.b);
+	}
+	
+	/// return key for @ref byCells
+	inline static uint64_t getCellsKey(uint32_t moverType, uint32_t startCell, uint32_t finishCell) {
+		// mover type is mixed into cells pair (collisions are detected by comparing entry members)
+		return ((static_cast<uint64_t>(startCell) << 32) | finishCell) ^ (static_cast<uint64_t>(moverType) * 0x9E3779B97F4A7C15ull);
+	}
+	
+	/// return key for @ref byFinish and @ref byStart
+	inline static uint64_t getCellTypeKey(uint32_t moverType, uint32_t cell) {
+		return (static_cast<uint64_t>(moverType) << 32) | cell;
+	}
+	
+	/// return region coordinate for grid coordinate @a v
+	inline static int16_t toRegionCoord(int16_t v) {
+		return (v >= 0) ? (v / regionSize) : ((v + 1) / regionSize - 1);
+	}
+	
+	/// add keys of regions overlapping area (in world coordinates) to @a regions
+	static void addRegions(const Ogre::Vector3& min, const Ogre::Vector3& max, std::vector<uint32_t>& regions);
+	
+	/// return true when none of regions of @a entry was changed after entry version
+	bool isValid(const Entry& entry) const;
+	
+	/// remove @a entry from cache
+	void erase(EntryIterator entry);
+	
+	/// return index of first point of segment of @a points passing (in XZ plane) within half of grid cell from @a point, or -1 when not found
+	static int findSegment(const std::vector<Ogre::Vector3>& points, const Ogre::Vector3& point);
+};
+
+/// @}
+
+}
@@ -0,0 +1,370 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma   once
+
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+namespace MGE {
+
+/// @addtogroup Physics
+/// @{
+/// @file
+
+/**
+ * @brief Chunked object pool for search algorithms (A* nodes, etc.).
+ * 
+ * Objects are allocated in fixed size chunks, so pointers to them are stable until @ref clear.
+ * @ref clear do not free memory, so the same arena reused for next search do not call allocator at all
+ * (after reaching the size of the biggest search).
+ * 
+ * @tparam T          type of stored objects, must be default constructible and copy assignable
+ *                    (objects are not destroyed on @ref clear, they are overwritten by next @ref create)
+ * @tparam chunkSize  number of objects in single chunk
+ */
+template <typename T, size_t chunkSize = 1024>
+class SearchArena {
+public:
+	/**
+	 * @brief Get new object from arena, initialised as @c T(args...).
+	 */
+	template <typename... Args> inline T* create(Args&&... args) {
+		if (used == chunks.size() * chunkSize)
+			chunks.emplace_back(new T[chunkSize]);
+		T* ret = &chunks[used / chunkSize][used % chunkSize];
+		*ret = T(std::forward<Args>(args)...);
+		++used;
+		return ret;
+	}
+	
+	/**
+	 * @brief Mark all objects as unused (keep allocated memory).
+	 */
+	inline void clear() {
+		used = 0;
+	}
+	
+	/**
+	 * @brief Number of objects created after last @ref clear.
+	 */
+	inline size_t size() const {
+		return used;
+	}
+	
+	/**
+	 * @brief Number of objects that can be created without memory allocation.
+	 */
+	inline size_t capacity() const {
+		return chunks.size() * chunkSize;
+	}
+	
+protected:
+	/// allocated chunks
+	std::vector< std::unique_ptr<T[]> > chunks;
+	
+	/// number of used objects
+	size_t used = 0;
+};
+
+/**
+ * @brief Binary min-heap of pointers to objects storing its own priority and position in heap.
+ * 
+ * Position in heap stored in object allows @ref update (decrease-key and increase-key) in O(log n)
+ * without duplicated entries in heap.
+ * 
+ * @tparam T         type of objects (heap store @c T*)
+ * @tparam priority  pointer to @c float member of @a T with priority (lower value is returned first by @ref pop)
+ * @tparam heapIndex pointer to @c int32_t member of @a T used to store position in heap (-1 when object is not in heap)
+ */
+template <typename T, float T::*priority, int32_t T::*heapIndex>
+class IndexedBinaryHeap {
+public:
+	/**
+	 * @brief Add @a obj to heap or update its position (when it's already in heap).
+	 * 
+	 * Call it after change of @a obj->*priority.
+	 */
+	inline void update(T* obj) {
+		if (obj->*heapIndex < 0) {
+			heap.push_back(obj);
+			siftUp(heap.size() - 1);
+			return;
+		}
+		size_t i = static_cast<size_t>(obj->*heapIndex);
+		if (i > 0 && heap[(i - 1) / 2]->*priority > obj->*priority) {
+			siftUp(i);
+		} else {
+			siftDown(i);
+		}
+	}
+	
+	/**
+	 * @brief Return object with the lowest priority value (without removing it from heap).
+	 */
+	inline T* top() const {
+		return heap.front();
+	}
+	
+	/**
+	 * @brief Remove and return object with the lowest priority value.
+	 */
+	inline T* pop() {
+		T* ret = heap.front();
+		ret->*heapIndex = -1;
+		T* last = heap.back();
+		heap.pop_back();
+		if (!heap.empty()) {
+			heap[0] = last;
+			last->*heapIndex = 0;
+			siftDown(0);
+		}
+		return ret;
+	}
+	
+	/**
+	 * @brief Remove @a obj from heap (if it's in heap).
+	 */
+	inline void remove(T* obj) {
+		if (obj->*heapIndex < 0)
+			return;
+		size_t i = static_cast<size_t>(obj->*heapIndex);
+		obj->*heapIndex = -1;
+		T* last = heap.back();
+		heap.pop_back();
+		if (last != obj) {
+			heap[i] = last;
+			last->*heapIndex = static_cast<int32_t>(i);
+			update(last);
+		}
+	}
+	
+	/// return true when heap is empty
+	inline bool empty() const {
+		return heap.empty();
+	}
+	
+	/// return number of objects in heap
+	inline size_t size() const {
+		return heap.size();
+	}
+	
+	/**
+	 * @brief Remove all objects from heap (keep allocated memory).
+	 * 
+	 * @note This do not reset @a heapIndex in removed objects.
+	 */
+	inline void clear() {
+		heap.clear();
+	}
+	
+protected:
+	/// heap array
+	std::vector<T*> heap;
+	
+	/// move element at position @a i toward root while it has lower priority than its parent
+	inline void siftUp(size_t i) {
+		T* obj = heap[i];
+		while (i > 0) {
+			size_t p = (i - 1) / 2;
+			if (!(obj->*priority < heap[p]->*priority))
+				break;
+			heap[i] = heap[p];
+			heap[i]->*heapIndex = static_cast<int32_t>(i);
+			i = p;
+		}
+		heap[i] = obj;
+		obj->*heapIndex = static_cast<int32_t>(i);
+	}
+	
+	/// move element at position @a i toward leaves while it has higher priority than its children
+	inline void siftDown(size_t i) {
+		T* obj = heap[i];
+		size_t size = heap.size();
+		while (true) {
+			size_t c = 2 * i + 1;
+			if (c >= size)
+				break;
+			if (c + 1 < size && heap[c + 1]->*priority < heap[c]->*priority)
+				++c;
+			if (!(heap[c]->*priority < obj->*priority))
+				break;
+			heap[i] = heap[c];
+			heap[i]->*heapIndex = static_cast<int32_t>(i);
+			i = c;
+		}
+		heap[i] = obj;
+		obj->*heapIndex = static_cast<int32_t>(i);
+	}
+};
+
+/**
+ * @brief Open addressing (linear probing) hash map with integer keys, optimised for search algorithms.
+ * 
+ * @li @ref clear is O(1) – it only increments generation counter (slot is used when its generation is equal to current one),
+ *     so the same map reused for next search do not need clearing / reallocating memory.
+ * @li Removing single elements is not supported.
+ * 
+ * @tparam KeyType    unsigned integer key type (e.g. @ref MGE::Point16 packed to @c uint32_t by @ref packPoint)
+ * @tparam ValueType  type of stored value, must be default constructible and copy assignable
+ */
+template <typename KeyType, typename ValueType>
+class SearchHashMap {
+public:
+	/**
+	 * @brief Return pointer to value for @a key or NULL when @a key is not in map.
+	 */
+	inline ValueType* find(KeyType key) {
+		if (slots.empty())
+			return nullptr;
+		for (size_t i = getSlot(key); ; i = (i + 1) & mask) {
+			Slot& slot = slots[i];
+			if (slot.generation != generation)
+				return nullptr;
+			if (slot.key == key)
+				return &slot.value;
+		}
+	}
+	
+	/**
+	 * @brief Return pointer to (const) value for @a key or NULL when @a key is not in map.
+	 */
+	inline const ValueType* find(KeyType key) const {
+		return const_cast<SearchHashMap*>(this)->find(key);
+	}
+	
+	/**
+	 * @brief Return reference to value for @a key, when @a key is not in map add it with default value.
+	 * 
+	 * @param      key       key to find or insert
+	 * @param[out] inserted  set to true when key was inserted, false when found
+	 */
+	inline ValueType& get(KeyType key, bool& inserted) {
+		if ((used + 1) * 4 > slots.size() * 3)
+			rehash(slots.empty() ? 1024 : slots.size() * 2);
+		for (size_t i = getSlot(key); ; i = (i + 1) & mask) {
+			Slot& slot = slots[i];
+			if (slot.generation != generation) {
+				slot.generation = generation;
+				slot.key        = key;
+				slot.value      = ValueType();
+				++used;
+				inserted        = true;
+				return slot.value;
+			}
+			if (slot.key == key) {
+				inserted = false;
+				return slot.value;
+			}
+		}
+	}
+	
+	/**
+	 * @brief Set value for @a key (insert or overwrite).
+	 */
+	inline void set(KeyType key, const ValueType& value) {
+		bool inserted;
+		get(key, inserted) = value;
+	}
+	
+	/**
+	 * @brief Remove all elements from map (keep allocated memory).
+	 */
+	inline void clear() {
+		used = 0;
+		if (++generation == 0) {
+			// generation counter overflow – reset all slots
+			for (auto& slot : slots)
+				slot.generation = 0;
+			generation = 1;
+		}
+	}
+	
+	/// return number of elements in map
+	inline size_t size() const {
+		return used;
+	}
+	
+	/**
+	 * @brief Pack two 16 bit coordinates to single 32 bit key.
+	 */
+	inline static constexpr uint32_t packPoint(int16_t a, int16_t b) {
+		return static_cast<uint16_t>(a) | (static_cast<uint32_t>(static_cast<uint16_t>(b)) << 16);
+	}
+	
+	/**
+	 * @brief Pack two 32 bit keys to single 64 bit key.
+	 */
+	inline static constexpr uint64_t packPair(uint32_t a, uint32_t b) {
+		return a | (static_cast<uint64_t>(b) << 32);
+	}
+	
+protected:
+	/// hash map slot
+	struct Slot {
+		/// generation of slot, when not equal to @ref generation slot is empty
+		uint32_t  generation = 0;
+		/// key
+		KeyType   key;
+		/// value
+		ValueType value;
+	};
+	
+	/// slots array (size is power of 2)
+	std::vector<Slot> slots;
+	
+	/// @ref slots size - 1
+	size_t mask = 0;
+	
+	/// number of used slots
+	size_t used = 0;
+	
+	/// current generation
+	uint32_t generation = 1;
+	
+	/// return first slot index for @a key
+	inline size_t getSlot(KeyType key) const {
+		// Fibonacci hashing – spread sequential grid coordinates over whole table
+		return static_cast<size_t>((static_cast<uint64_t>(key) * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & mask;
+	}
+	
+	/// resize slots array to @a newSize (must be power of 2) and move current elements to it
+	void rehash(size_t newSize) {
+		std::vector<Slot> oldSlots(newSize);
+		oldSlots.swap(slots);
+		mask = newSize - 1;
+		uint32_t oldGeneration = generation;
+		generation = 1;
+		used = 0;
+		for (auto& slot : oldSlots) {
+			if (slot.generation == oldGeneration) {
+				bool inserted;
+				get(slot.key, inserted) = slot.value;
+			}
+		}
+	}
+};
+
+/// @}
+
+}
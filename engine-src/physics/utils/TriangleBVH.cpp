@@ -0,0 +1,261 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "physics/utils/TriangleBVH.h"
+
+#include <OgreMath.h>
+
+#include <algorithm>
+#include <limits>
+
+struct MGE::TriangleBVH::BuildInfo {
+	std::vector<Ogre::Vector3> centroids;
+	std::vector<Ogre::Vector3> mins;
+	std::vector<Ogre::Vector3> maxs;
+};
+
+namespace {
+	inline Ogre::Real halfArea(const Ogre::Vector3& min, const Ogre::Vector3& max) {
+		Ogre::Vector3 d = max - min;
+		return d.x * d.y + d.y * d.z + d.z * d.x;
+	}
+	
+	struct Bin {
+		Ogre::Vector3 min = Ogre::Vector3(std::numeric_limits<Ogre::Real>::max());
+		Ogre::Vector3 max = Ogre::Vector3(std::numeric_limits<Ogre::Real>::lowest());
+		uint32_t      count = 0;
+		
+		void add(const Ogre::Vector3& bMin, const Ogre::Vector3& bMax) {
+			min.makeFloor(bMin);
+			max.makeCeil(bMax);
+		}
+	};
+	
+	/// return ray distance to enter box or -1 when ray don't hit box (before @a maxDistance)
+	inline Ogre::Real slabTest(
+		const Ogre::Vector3& origin, const Ogre::Vector3& invDir,
+		const Ogre::Vector3& min, const Ogre::Vector3& max, Ogre::Real maxDistance
+	) {
+		Ogre::Real tMin = 0, tMax = maxDistance;
+		for (int i=0; i<3; ++i) {
+			Ogre::Real t1 = (min[i] - origin[i]) * invDir[i];
+			Ogre::Real t2 = (max[i] - origin[i]) * invDir[i];
+			// NaN (0 * inf for ray in slab plane) is ignored by std::min / std::max with this argument order
+			tMin = std::max(tMin, std::min(t1, t2));
+			tMax = std::min(tMax, std::max(t1, t2));
+		}
+		return tMin <= tMax ? tMin : -1;
+	}
+}
+
+void MGE::TriangleBVH::build(const std::vector<Ogre::Vector3>& vertices, const std::vector<int>& indices) {
+	nodes.clear();
+	triangles.clear();
+	
+	uint32_t trianglesCount = indices.size() / 3;
+	if (!trianglesCount)
+		return;
+	
+	BuildInfo info;
+	info.centroids.resize(trianglesCount);
+	info.mins.resize(trianglesCount);
+	info.maxs.resize(trianglesCount);
+	triangles.resize(trianglesCount);
+	for (uint32_t i=0; i<trianglesCount; ++i) {
+		const Ogre::Vector3& v0 = vertices[indices[3*i]];
+		const Ogre::Vector3& v1 = vertices[indices[3*i+1]];
+		const Ogre::Vector3& v2 = vertices[indices[3*i+2]];
+		info.mins[i] = v0; info.mins[i].makeFloor(v1); info.mins[i].makeFloor(v2);
+		info.maxs[i] = v0; info.maxs[i].makeCeil(v1);  info.maxs[i].makeCeil(v2);
+		info.centroids[i] = (info.mins[i] + info.maxs[i]) * 0.5;
+		triangles[i] = i;
+	}
+	
+	nodes.reserve(2 * trianglesCount / maxLeafSize + 1);
+	buildNode(info, 0, trianglesCount);
+	
+	// store index of first vertex index (in indices) instead of triangle number
+	for (auto& t : triangles)
+		t *= 3;
+}
+
+uint32_t MGE::TriangleBVH::buildNode(BuildInfo& info, uint32_t first, uint32_t count) {
+	uint32_t nodeIndex = nodes.size();
+	nodes.emplace_back();
+	
+	Ogre::Vector3 min(std::numeric_limits<Ogre::Real>::max()), max(std::numeric_limits<Ogre::Real>::lowest());
+	Ogre::Vector3 cMin = min, cMax = max;
+	for (uint32_t i=first; i<first+count; ++i) {
+		uint32_t t = triangles[i];
+		min.makeFloor(info.mins[t]);
+		max.makeCeil(info.maxs[t]);
+		cMin.makeFloor(info.centroids[t]);
+		cMax.makeCeil(info.centroids[t]);
+	}
+	nodes[nodeIndex].min = min;
+	nodes[nodeIndex].max = max;
+	nodes[nodeIndex].first = first;
+	nodes[nodeIndex].count = count;
+	
+	if (count <= maxLeafSize)
+		return nodeIndex;
+	
+	// select split axis (the largest centroids extent)
+	Ogre::Vector3 extent = cMax - cMin;
+	int axis = 0;
+	if (extent.y > extent[axis]) axis = 1;
+	if (extent.z > extent[axis]) axis = 2;
+	
+	if (extent[axis] <= std::numeric_limits<Ogre::Real>::epsilon()) {
+		// all centroids in the same point ... can't split
+		return nodeIndex;
+	}
+	
+	// binning
+	Bin bins[binsCount];
+	Ogre::Real scale = binsCount / extent[axis];
+	auto getBin = [&](uint32_t t) {
+		int b = static_cast<int>((info.centroids[t][axis] - cMin[axis]) * scale);
+		return std::min(b, binsCount - 1);
+	};
+	for (uint32_t i=first; i<first+count; ++i) {
+		uint32_t t = triangles[i];
+		Bin& bin = bins[getBin(t)];
+		++bin.count;
+		bin.add(info.mins[t], info.maxs[t]);
+	}
+	
+	// evaluate SAH cost for split after each bin
+	Ogre::Real rightCost[binsCount];
+	Bin acc;
+	for (int b=binsCount-1; b>0; --b) {
+		acc.count += bins[b].count;
+		acc.add(bins[b].min, bins[b].max);
+		rightCost[b] = acc.count ? acc.count * halfArea(acc.min, acc.max) : 0;
+	}
+	
+	int bestSplit = -1;
+	Ogre::Real bestCost = std::numeric_limits<Ogre::Real>::max();
+	acc = Bin();
+	for (int b=0; b<binsCount-1; ++b) {
+		acc.count += bins[b].count;
+		acc.add(bins[b].min, bins[b].max);
+		if (!acc.count || acc.count == count)
+			continue;
+		Ogre::Real cost = acc.count * halfArea(acc.min, acc.max) + rightCost[b+1];
+		if (cost < bestCost) {
+			bestCost = cost;
+			bestSplit = b;
+		}
+	}
+	
+	uint32_t* begin = triangles.data() + first;
+	uint32_t* end   = begin + count;
+	uint32_t* mid;
+	if (bestSplit >= 0) {
+		// leaf cost (in triangle intersection units) vs split cost (traversal + children intersections)
+		Ogre::Real leafCost = count * halfArea(min, max);
+		if (count <= 2 * maxLeafSize && bestCost + halfArea(min, max) >= leafCost)
+			return nodeIndex;
+		mid = std::partition(begin, end, [&](uint32_t t) { return getBin(t) <= bestSplit; });
+	} else {
+		mid = begin + count / 2;
+		std::nth_element(begin, mid, end, [&](uint32_t a, uint32_t b) { return info.centroids[a][axis] < info.centroids[b][axis]; });
+	}
+	
+	uint32_t leftCount = mid - begin;
+	buildNode(info, first, leftCount);
+	uint32_t right = buildNode(info, first + leftCount, count - leftCount);
+	
+	nodes[nodeIndex].first = right;
+	nodes[nodeIndex].count = 0;
+	return nodeIndex;
+}
+
+std::pair<int, Ogre::Real> MGE::TriangleBVH::intersects(
+	const Ogre::Ray& ray,
+	const std::vector<Ogre::Vector3>& vertices,
+	const std::vector<int>& indices,
+	bool positiveSide,
+	bool negativeSide
+) const {
+	std::pair<int, Ogre::Real> result(-1, std::numeric_limits<Ogre::Real>::max());
+	if (nodes.empty())
+		return result;
+	
+	const Ogre::Vector3& origin = ray.getOrigin();
+	const Ogre::Vector3& direction = ray.getDirection();
+	Ogre::Vector3 invDir(1 / direction.x, 1 / direction.y, 1 / direction.z);
+	
+	if (slabTest(origin, invDir, nodes[0].min, nodes[0].max, result.second) < 0)
+		return result;
+	
+	static thread_local std::vector<uint32_t> stack;
+	stack.clear();
+	uint32_t nodeIndex = 0;
+	
+	while (true) {
+		const Node& node = nodes[nodeIndex];
+		if (node.count) {
+			for (uint32_t i=node.first; i<node.first+node.count; ++i) {
+				uint32_t t = triangles[i];
+				std::pair<bool, Ogre::Real> hit = Ogre::Math::intersects(
+					ray, vertices[indices[t]], vertices[indices[t+1]], vertices[indices[t+2]],
+					positiveSide, negativeSide
+				);
+				if (hit.first && hit.second < result.second) {
+					result.first  = t;
+					result.second = hit.second;
+				}
+			}
+		} else {
+			uint32_t   left  = nodeIndex + 1;
+			uint32_t   right = node.first;
+			Ogre::Real tLeft  = slabTest(origin, invDir, nodes[left].min,  nodes[left].max,  result.second);
+			Ogre::Real tRight = slabTest(origin, invDir, nodes[right].min, nodes[right].max, result.second);
+			if (tLeft >= 0 && tRight >= 0) {
+				// visit nearest child first, push the second one
+				if (tRight < tLeft)
+					std::swap(left, right);
+				stack.push_back(right);
+				nodeIndex = left;
+				continue;
+			} else if (tLeft >= 0) {
+				nodeIndex = left;
+				continue;
+			} else if (tRight >= 0) {
+				nodeIndex = right;
+				continue;
+			}
+		}
+		
+		// pop node (skipping these behind the best hit)
+		while (true) {
+			if (stack.empty())
+				return result;
+			nodeIndex = stack.back();
+			stack.pop_back();
+			if (slabTest(origin, invDir, nodes[nodeIndex].min, nodes[nodeIndex].max, result.second) >= 0)
+				break;
+		}
+	}
+}
@@ -0,0 +1,116 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma   once
+#include "config.h"
+
+#include <OgreRay.h>
+
+#include <vector>
+#include <cstdint>
+
+namespace MGE {
+
+/// @addtogroup Physics
+/// @{
+/// @file
+
+/**
+ * @brief Bounding volume hierarchy (built with surface area heuristic) for raycasting to triangle mesh
+ * 
+ * BVH store only triangles order and bounding boxes, vertices and indices are passed to @ref intersects
+ * and must be the same as used in @ref build.
+ */
+class TriangleBVH {
+public:
+	/**
+	 * @brief (re)build BVH for triangles described by @a vertices and @a indices
+	 * 
+	 * @param vertices        vector of vertices
+	 * @param indices         vector of indices (each 3 elements describe one triangle)
+	 */
+	void build(const std::vector<Ogre::Vector3>& vertices, const std::vector<int>& indices);
+	
+	/**
+	 * @brief find nearest triangle hit by @a ray
+	 * 
+	 * @param ray             ray (in @a vertices space) used to doing test
+	 * @param vertices        vector of vertices (the same as used in @ref build)
+	 * @param indices         vector of indices (the same as used in @ref build)
+	 * @param positiveSide    when true accept hit to positive (front) side of triangle
+	 * @param negativeSide    when true accept hit to negative (back) side of triangle
+	 * 
+	 * @return pair of index in @a indices for first vertex of hit triangle (-1 when no hit) and ray distance to hit point
+	 */
+	std::pair<int, Ogre::Real> intersects(
+		const Ogre::Ray& ray,
+		const std::vector<Ogre::Vector3>& vertices,
+		const std::vector<int>& indices,
+		bool positiveSide,
+		bool negativeSide
+	) const;
+	
+	/// return true when BVH is empty (not build or build for empty mesh)
+	bool empty() const {
+		return nodes.empty();
+	}
+	
+	/// return number of BVH nodes
+	size_t size() const {
+		return nodes.size();
+	}
+	
+protected:
+	/// BVH node
+	struct Node {
+		/// bounding box minimum
+		Ogre::Vector3 min;
+		/// bounding box maximum
+		Ogre::Vector3 max;
+		/// for leaf: index in @ref triangles of first triangle, for inner node: index of right child (left child is next node)
+		uint32_t      first;
+		/// for leaf: number of triangles, for inner node: 0
+		uint32_t      count;
+	};
+	
+	/// BVH nodes (root is first)
+	std::vector<Node>     nodes;
+	
+	/// triangles (index of first vertex index in indices) ordered by leafs
+	std::vector<uint32_t> triangles;
+	
+	/// max triangles in leaf
+	static constexpr uint32_t maxLeafSize = 4;
+	
+	/// number of bins used for surface area heuristic
+	static constexpr int binsCount = 12;
+	
+	/// helper struct for build
+	struct BuildInfo;
+	
+	/// build subtree for @a count triangles starting from @a first in @ref triangles, return index of created node
+	uint32_t buildNode(BuildInfo& info, uint32_t first, uint32_t count);
+};
+
+/// @}
+
+}
@@ -30,11 +30,11 @@ SOFTWARE.
 #include "rendering/CameraNode.h"
 
 #include "Engine.h"
+#include "ScriptsSystem.h"
 #include "data/utils/OgreResources.h"
 #include "data/utils/OgreSceneObjectInfo.h"
 
 #include <OgreRenderQueue.h>
-#include <pybind11/gil.h>
 
 //////////////   init and destroy RenderingSystem   //////////////
 
@@ -81,7 +81,20 @@ MGE::RenderingSystem::RenderingSystem(
 	LOG_INFO("RenderingSystem", "Create Ogre root, plugin_cfg=" << plugin_cfg << " ogre_cfg=" << ogre_cfg);
 	ogreRoot = new Ogre::Root(0, plugin_cfg, ogre_cfg, "");
 	
-	if(ogreRoot->restoreConfig() || ogreRoot->showConfigDialog()) {
+	if (MGE::Engine::getPtr()->isHeadless()) {
+		// headless mode - use NULL render system (no window, no GPU)
+		Ogre::RenderSystem* renderSystem = ogreRoot->getRenderSystemByName("NULL Rendering Subsystem");
+		if (!renderSystem) {
+			LOG_INFO("RenderingSystem", "NULL render system not loaded from plugin_cfg, try load RenderSystem_NULL plugin");
+			ogreRoot->loadPlugin("RenderSystem_NULL", true, nullptr);
+			renderSystem = ogreRoot->getRenderSystemByName("NULL Rendering Subsystem");
+		}
+		if (!renderSystem) {
+			throw std::logic_error("Headless mode require Ogre RenderSystem_NULL plugin");
+		}
+		ogreRoot->setRenderSystem(renderSystem);
+		renderWindow = ogreRoot->initialise(true, window_name);
+	} else if(ogreRoot->restoreConfig() || ogreRoot->showConfigDialog()) {
 		renderWindow = ogreRoot->initialise(true, window_name);
 	} else {
 		throw std::logic_error("Unable load graphics config file ...");
@@ -291,8 +304,13 @@ void MGE::RenderingSystem::destroyLoadingSceneManager() {
 //////////////   utils   //////////////
 
 bool MGE::RenderingSystem::update(float gameTimeStep, float realTimeStep) {
-	pybind11::gil_scoped_release();
-	if (!renderOneFrame())
+	bool renderOk;
+	{
+		// release GIL while rendering (allow python threads to run), shutDown() is called outside this scope
+		MGE_SCRIPTS_SYSTEM_RELEASE_SCOPED_GIL
+		renderOk = renderOneFrame();
+	}
+	if (!renderOk)
 		MGE::Engine::getPtr()->shutDown();
 	return true;
 }
@@ -29,6 +29,7 @@ SOFTWARE.
 
 #include "MainLoopListener.h"
 #include "ModuleBase.h"
+#include "physics/utils/OgreSceneQueryPool.h"
 
 namespace MGE { class CameraNode; }
 
@@ -90,6 +91,9 @@ public:
 			
 			LOG_INFO("SceneManager", "Successfully created with: name=" << scnMgr->getName() << " type=" << scnMgr->getTypeName() << " numWorkerThreads=" << numWorkerThreads << " (" << scnMgr << ")");
 			
+			// enable reusing scene queries (also in pathfinding workers) for this SceneManager
+			MGE::OgreSceneQueryPool::registerSceneManager(scnMgr);
+			
 			return scnMgr;
 		}
 		
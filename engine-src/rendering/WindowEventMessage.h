@@ -35,13 +35,21 @@ namespace MGE {
  */
 struct WindowEventMsg : MGE::EventMsg  {
 	/// message type string
-	inline static const std::string_view MsgType = "WindowEvent"sv;
+	inline static constexpr std::string_view MsgType = "WindowEvent"sv;
+	
+	/// message type ID
+	inline static constexpr uint32_t MsgTypeID = MGE::EventMsg::hashType(MsgType);
 	
 	/// @copydoc MGE::EventMsg::getType
 	const std::string_view getType() const override final {
 		return MsgType;
 	}
 	
+	/// @copydoc MGE::EventMsg::getTypeID
+	uint32_t getTypeID() const override final {
+		return MsgTypeID;
+	}
+	
 	enum EventSubType {
 		Resized, ///< window resized event
 		Closed,  ///< window closed event
@@ -0,0 +1,199 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE CoarseNavigationGrid
+#include <boost/test/unit_test.hpp>
+
+#include "physics/utils/CoarseNavigationGrid.h"
+#include "LogSystem.h"
+
+#include <queue>
+#include <set>
+
+namespace MGE {
+	Log* defaultLog = nullptr;
+	
+	struct Globals {
+		Globals()   {
+			defaultLog = new Log();
+		}
+		~Globals()  {
+			delete defaultLog;
+		}
+	};
+}
+
+using namespace  MGE;
+
+BOOST_GLOBAL_FIXTURE( Globals );
+
+struct TestWorld {
+	std::set<int32_t> blocked;
+	MGE::CoarseNavigationGrid grid;
+	
+	TestWorld(int clusterSize = 8) {
+		MGE::HexagonalGridPoint::init(1.0);
+		grid.configure(clusterSize, 1.0, [this](const MGE::HexagonalGridPoint& cell, float& height) {
+			height = 0;
+			return std::abs(cell.a) < 100 && std::abs(cell.b) < 100 && !blocked.count(cell);
+		});
+	}
+	
+	/// vertical wall at column @a a with gap between @a gapMin and @a gapMax rows
+	void addWall(int16_t a, int16_t gapMin, int16_t gapMax) {
+		for (int16_t b = -100; b < 100; ++b) {
+			if (b < gapMin || b > gapMax) {
+				blocked.insert(MGE::HexagonalGridPoint(a, b));
+				blocked.insert(MGE::HexagonalGridPoint(a + 1, b));
+			}
+		}
+	}
+	
+	/// check fine grid connectivity between two points (BFS limited to @a maxSteps cells)
+	bool isReachable(const Ogre::Vector3& from, const Ogre::Vector3& to, size_t maxSteps = 5000) {
+		MGE::HexagonalGridPoint start(from), finish(to);
+		std::set<int32_t> visited = {start};
+		std::queue<MGE::HexagonalGridPoint> queue;
+		queue.push(start);
+		while (!queue.empty() && visited.size() < maxSteps) {
+			MGE::HexagonalGridPoint cell = queue.front();
+			queue.pop();
+			if (cell == finish)
+				return true;
+			for (int i=0; i<cell.getNeighborCount(); ++i) {
+				MGE::HexagonalGridPoint next = cell.getNeighbor(i);
+				if (std::abs(next.a) >= 100 || std::abs(next.b) >= 100 || blocked.count(next) || visited.count(next))
+					continue;
+				visited.insert(next);
+				queue.push(next);
+			}
+		}
+		return false;
+	}
+	
+	static Ogre::Vector3 toOgre(int16_t a, int16_t b) {
+		return MGE::HexagonalGridPoint(a, b).toOgre();
+	}
+};
+
+BOOST_AUTO_TEST_CASE( long_path_with_wall ) {
+	TestWorld world;
+	world.addWall(30, 40, 45);
+	
+	Ogre::Vector3 start = TestWorld::toOgre(0, 0), finish = TestWorld::toOgre(70, -10);
+	BOOST_CHECK( world.grid.isLongPath(start, finish) );
+	BOOST_CHECK( !world.grid.isLongPath(start, TestWorld::toOgre(9, 9)) );
+	
+	std::vector<Ogre::Vector3> waypoints;
+	BOOST_REQUIRE( world.grid.findPath(start, finish, waypoints) );
+	BOOST_REQUIRE( !waypoints.empty() );
+	
+	// each segment is reachable on fine grid and path go through gap in wall
+	bool crossGap = false;
+	Ogre::Vector3 prev = start;
+	waypoints.push_back(finish);
+	for (auto& point : waypoints) {
+		MGE::HexagonalGridPoint cell(point);
+		BOOST_CHECK( !world.blocked.count(cell) );
+		BOOST_CHECK( world.isReachable(prev, point) );
+		if (cell.a >= 30 && cell.a <= 33 && cell.b >= 35 && cell.b <= 50)
+			crossGap = true;
+		prev = point;
+	}
+	BOOST_CHECK( crossGap );
+	
+	// clusters are built lazily – not whole map is built
+	BOOST_CHECK_GT( world.grid.getBuiltClustersCount(), 0 );
+	BOOST_CHECK_LT( world.grid.getBuiltClustersCount(), 25 * 25 );
+}
+
+BOOST_AUTO_TEST_CASE( unreachable_target ) {
+	TestWorld world;
+	for (int16_t a = 45; a <= 55; ++a) {
+		for (int16_t b = 45; b <= 55; ++b) {
+			if (a < 47 || a > 53 || b < 47 || b > 53)
+				world.blocked.insert(MGE::HexagonalGridPoint(a, b));
+		}
+	}
+	
+	std::vector<Ogre::Vector3> waypoints;
+	BOOST_CHECK( !world.grid.findPath(TestWorld::toOgre(0, 0), TestWorld::toOgre(50, 50), waypoints) );
+	BOOST_CHECK( waypoints.empty() );
+	BOOST_CHECK( world.grid.findPath(TestWorld::toOgre(0, 0), TestWorld::toOgre(60, 50), waypoints) );
+}
+
+BOOST_AUTO_TEST_CASE( invalidate_area ) {
+	TestWorld world;
+	world.addWall(30, 40, 45);
+	
+	Ogre::Vector3 start = TestWorld::toOgre(0, 0), finish = TestWorld::toOgre(70, 0);
+	std::vector<Ogre::Vector3> waypoints;
+	BOOST_CHECK( world.grid.findPath(start, finish, waypoints) );
+	
+	// close the gap – without invalidation cached data is used
+	for (int16_t b = 40; b <= 45; ++b) {
+		world.blocked.insert(MGE::HexagonalGridPoint(30, b));
+		world.blocked.insert(MGE::HexagonalGridPoint(31, b));
+	}
+	BOOST_CHECK( world.grid.findPath(start, finish, waypoints) );
+	
+	world.grid.invalidateArea(TestWorld::toOgre(30, 40), TestWorld::toOgre(31, 45));
+	BOOST_CHECK( !world.grid.findPath(start, finish, waypoints) );
+	
+	// open new gap
+	for (int16_t b = -5; b <= 0; ++b) {
+		world.blocked.erase(MGE::HexagonalGridPoint(30, b));
+		world.blocked.erase(MGE::HexagonalGridPoint(31, b));
+	}
+	world.grid.invalidateArea(TestWorld::toOgre(30, -5), TestWorld::toOgre(31, 0));
+	BOOST_REQUIRE( world.grid.findPath(start, finish, waypoints) );
+	for (auto& point : waypoints)
+		BOOST_CHECK( !world.blocked.count(MGE::HexagonalGridPoint(point)) );
+	
+	world.grid.clear();
+	BOOST_CHECK( !world.grid.isEnabled() );
+	BOOST_CHECK_EQUAL( world.grid.getNodesCount(), 0 );
+	BOOST_CHECK( !world.grid.findPath(start, finish, waypoints) );
+}
+
+BOOST_AUTO_TEST_CASE( prebuild ) {
+	TestWorld world;
+	world.addWall(30, 40, 45);
+	
+	// 8x8 cells clusters, area from -21 to 21 (extended by one cell) => clusters from -3 to 2 => 6x6 clusters
+	world.grid.build(TestWorld::toOgre(-20, -20), TestWorld::toOgre(20, 20));
+	BOOST_CHECK_EQUAL( world.grid.getBuiltClustersCount(), 6 * 6 );
+	size_t nodesCount = world.grid.getNodesCount();
+	BOOST_CHECK_GT( nodesCount, 0 );
+	
+	// path inside built area do not create new nodes (except temporary start and finish nodes)
+	std::vector<Ogre::Vector3> waypoints;
+	BOOST_CHECK( world.grid.findPath(TestWorld::toOgre(-18, -18), TestWorld::toOgre(18, 18), waypoints) );
+	BOOST_CHECK_EQUAL( world.grid.getNodesCount(), nodesCount );
+	
+	// invalidated clusters are rebuilt with the same result
+	world.grid.invalidateArea(TestWorld::toOgre(0, 0), TestWorld::toOgre(1, 1));
+	BOOST_CHECK_LT( world.grid.getNodesCount(), nodesCount );
+	world.grid.build(TestWorld::toOgre(-20, -20), TestWorld::toOgre(20, 20));
+	BOOST_CHECK_EQUAL( world.grid.getNodesCount(), nodesCount );
+}
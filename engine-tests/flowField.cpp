@@ -0,0 +1,155 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE FlowField
+#include <boost/test/unit_test.hpp>
+
+#include "physics/FlowField.h"
+#include "physics/PathFinder.h"
+#include "LogSystem.h"
+
+#include <set>
+
+namespace MGE {
+	Log* defaultLog = nullptr;
+	
+	struct Globals {
+		Globals()   {
+			defaultLog = new Log();
+		}
+		~Globals()  {
+			delete defaultLog;
+		}
+	};
+}
+
+using namespace  MGE;
+
+BOOST_GLOBAL_FIXTURE( Globals );
+
+struct TestWorld {
+	std::set<int32_t> blocked;
+	int stepsCount = 0;
+	
+	TestWorld() {
+		MGE::HexagonalGridPoint::init(1.0);
+	}
+	
+	/// vertical wall at column @a a with gap between @a gapMin and @a gapMax rows
+	void addWall(int16_t a, int16_t gapMin, int16_t gapMax) {
+		for (int16_t b = -100; b < 100; ++b) {
+			if (b < gapMin || b > gapMax) {
+				blocked.insert(MGE::HexagonalGridPoint(a, b));
+				blocked.insert(MGE::HexagonalGridPoint(a + 1, b));
+			}
+		}
+	}
+	
+	MGE::FlowField::StepCostFunction stepCost() {
+		return [this](const MGE::HexagonalGridPoint& from, const MGE::HexagonalGridPoint& to, int mode, float& fromHeight) {
+			++stepsCount;
+			fromHeight = 1.0;
+			if (std::abs(from.a) >= 100 || std::abs(from.b) >= 100 || blocked.count(from))
+				return -1.0f;
+			return from.getNeighborCost(mode);
+		};
+	}
+	
+	static Ogre::Vector3 toOgre(int16_t a, int16_t b) {
+		return MGE::HexagonalGridPoint(a, b).toOgre();
+	}
+};
+
+BOOST_AUTO_TEST_CASE( group_paths ) {
+	TestWorld world;
+	world.addWall(20, 30, 35);
+	
+	Ogre::Vector3 goal = TestWorld::toOgre(40, 0);
+	std::vector<Ogre::Vector3> starts = {TestWorld::toOgre(0, 0), TestWorld::toOgre(2, 5), TestWorld::toOgre(-3, -8)};
+	
+	MGE::FlowField field(goal);
+	BOOST_CHECK_EQUAL( field.compute(starts, world.stepCost(), 100000), MGE::PathFinder::PATH_OK );
+	int stepsCount = world.stepsCount;
+	
+	for (auto& start : starts) {
+		BOOST_REQUIRE( field.contains(start) );
+		BOOST_CHECK_GT( field.getCost(start), 0 );
+		
+		std::list<Ogre::Vector3> points;
+		BOOST_REQUIRE_EQUAL( field.getPath(start, points), MGE::PathFinder::PATH_OK );
+		BOOST_CHECK( points.front() == start );
+		BOOST_CHECK( points.back() == goal );
+		
+		// path go through gap in wall, turn points are on walkable cells with ground height
+		bool crossGap = false;
+		for (auto iter = std::next(points.begin()); iter != std::prev(points.end()); ++iter) {
+			MGE::HexagonalGridPoint cell(*iter);
+			BOOST_CHECK( !world.blocked.count(cell) );
+			BOOST_CHECK_EQUAL( iter->y, 1.0 );
+			if (cell.a >= 19 && cell.a <= 22 && cell.b >= 30 && cell.b <= 35)
+				crossGap = true;
+		}
+		BOOST_CHECK( crossGap );
+		
+		// direction on start point goes towards lower cost
+		Ogre::Vector3 direction = field.getDirection(start);
+		BOOST_CHECK_CLOSE( direction.length(), 1.0, 0.01 );
+		BOOST_CHECK_LT( field.getCost(start + direction * MGE::HexagonalGridPoint::distanceY * 1.5), field.getCost(start) );
+	}
+	
+	// paths for all movers are read from field, without new step cost calculations
+	BOOST_CHECK_EQUAL( world.stepsCount, stepsCount );
+	BOOST_CHECK( field.getDirection(goal) == Ogre::Vector3::ZERO );
+	
+	BOOST_CHECK( field.intersects(TestWorld::toOgre(10, 10), TestWorld::toOgre(12, 12)) );
+	BOOST_CHECK( !field.intersects(TestWorld::toOgre(-90, -90), TestWorld::toOgre(-80, -80)) );
+}
+
+BOOST_AUTO_TEST_CASE( limits ) {
+	TestWorld world;
+	Ogre::Vector3 goal = TestWorld::toOgre(0, 0);
+	
+	// unreachable start (enclosed by wall)
+	for (int16_t a = 45; a <= 55; ++a) {
+		for (int16_t b = 45; b <= 55; ++b) {
+			if (a < 47 || a > 53 || b < 47 || b > 53)
+				world.blocked.insert(MGE::HexagonalGridPoint(a, b));
+		}
+	}
+	MGE::FlowField field(goal);
+	BOOST_CHECK_EQUAL( field.compute({TestWorld::toOgre(10, 10), TestWorld::toOgre(50, 50)}, world.stepCost(), 100000), MGE::PathFinder::NOT_AVAILABLE );
+	BOOST_CHECK( field.contains(TestWorld::toOgre(10, 10)) );
+	BOOST_CHECK( !field.contains(TestWorld::toOgre(50, 50)) );
+	std::list<Ogre::Vector3> points;
+	BOOST_CHECK_EQUAL( field.getPath(TestWorld::toOgre(50, 50), points), MGE::PathFinder::NOT_AVAILABLE );
+	
+	// cells limit
+	BOOST_CHECK_EQUAL( field.compute({TestWorld::toOgre(80, 80)}, world.stepCost(), 500), MGE::PathFinder::TOO_MANY_STEPS );
+	BOOST_CHECK_LE( field.getCellsCount(), 500 + 12 );
+	BOOST_CHECK( !field.contains(TestWorld::toOgre(80, 80)) );
+	
+	// start on goal cell
+	BOOST_CHECK_EQUAL( field.compute({goal}, world.stepCost(), 500), MGE::PathFinder::PATH_OK );
+	BOOST_CHECK_EQUAL( field.getPath(goal, points), MGE::PathFinder::PATH_OK );
+	BOOST_CHECK_EQUAL( points.size(), 2 );
+}
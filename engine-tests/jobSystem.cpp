@@ -0,0 +1,108 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE JobSystem
+#include <boost/test/unit_test.hpp>
+
+#include "JobSystem.h"
+#include "LogSystem.h"
+
+namespace MGE {
+	Log* defaultLog = nullptr;
+	
+	struct Globals {
+		Globals()   {
+			defaultLog = new Log();
+		}
+		~Globals()  {
+			delete defaultLog;
+		}
+	};
+}
+
+using namespace  MGE;
+
+BOOST_GLOBAL_FIXTURE( Globals );
+
+BOOST_AUTO_TEST_CASE( jobs_group_barrier ) {
+	MGE::JobSystem jobSystem(3);
+	std::atomic<int> counter(0);
+	std::vector<int> results(1000, 0);
+	
+	MGE::JobSystem::JobsGroup group;
+	for (int i=0; i<1000; ++i) {
+		jobSystem.run([&counter, &results, i]{ results[i] = i * 2; ++counter; }, &group);
+	}
+	jobSystem.wait(&group);
+	
+	BOOST_CHECK_EQUAL(counter.load(), 1000);
+	for (int i=0; i<1000; ++i) {
+		BOOST_CHECK_EQUAL(results[i], i * 2);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( nested_jobs ) {
+	MGE::JobSystem jobSystem(2);
+	std::atomic<int> counter(0);
+	
+	MGE::JobSystem::JobsGroup group;
+	for (int i=0; i<10; ++i) {
+		jobSystem.run([&jobSystem, &counter]{
+			MGE::JobSystem::JobsGroup subGroup;
+			for (int j=0; j<10; ++j) {
+				jobSystem.run([&counter]{ ++counter; }, &subGroup);
+			}
+			jobSystem.wait(&subGroup);
+		}, &group);
+	}
+	jobSystem.wait(&group);
+	
+	BOOST_CHECK_EQUAL(counter.load(), 100);
+}
+
+BOOST_AUTO_TEST_CASE( exception_from_job ) {
+	MGE::JobSystem jobSystem(2);
+	std::atomic<int> counter(0);
+	
+	MGE::JobSystem::JobsGroup group;
+	jobSystem.run([]{ throw std::runtime_error("job error"); }, &group);
+	for (int i=0; i<10; ++i) {
+		jobSystem.run([&counter]{ ++counter; }, &group);
+	}
+	BOOST_CHECK_THROW(jobSystem.wait(&group), std::runtime_error);
+	BOOST_CHECK_EQUAL(counter.load(), 10);
+}
+
+BOOST_AUTO_TEST_CASE( no_workers ) {
+	MGE::JobSystem jobSystem(0);
+	int counter = 0;
+	
+	MGE::JobSystem::JobsGroup group;
+	for (int i=0; i<10; ++i) {
+		jobSystem.run([&counter]{ ++counter; }, &group);
+	}
+	jobSystem.wait(&group);
+	
+	BOOST_CHECK_EQUAL(jobSystem.getWorkersCount(), 0u);
+	BOOST_CHECK_EQUAL(counter, 10);
+}
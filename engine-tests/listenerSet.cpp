@@ -135,3 +135,150 @@ BOOST_AUTO_TEST_CASE( functor_listener ) {
 	BOOST_CHECK_EQUAL(c, 4); // function_4 call  as last
 	BOOST_CHECK_EQUAL(z, false); // all call function returned false
 }
+
+//////////////////////////////////////////////////////////////////////
+
+struct FlatListenerClass;
+typedef MGE::ClassPtrListenerSet<FlatListenerClass, int, int, MGE::FlatListenerMap> FlatListenerSet;
+std::vector<int> callOrder;
+
+struct FlatListenerClass {
+	int id;
+	FlatListenerSet* set = nullptr;
+	FlatListenerClass* toAdd = nullptr;
+	FlatListenerClass* toRemove = nullptr;
+	
+	bool call() {
+		callOrder.push_back(id);
+		if (toRemove) {
+			set->remListener(toRemove);
+			toRemove = nullptr;
+		}
+		if (toAdd) {
+			set->addListener(toAdd, 0);
+			toAdd = nullptr;
+		}
+		return false;
+	}
+};
+
+BOOST_AUTO_TEST_CASE( flat_listener_order ) {
+	FlatListenerSet myListener;
+	FlatListenerClass l[5] = {{1}, {2}, {3}, {4}, {5}};
+	myListener.addListener(&l[0], 20);
+	myListener.addListener(&l[1], 10);
+	myListener.addListener(&l[2], 20);
+	myListener.addListener(&l[3], 10);
+	myListener.addListener(&l[4], 15);
+	z = myListener.addListener(&l[2], 20); // duplicated registration
+	
+	BOOST_CHECK_EQUAL(z, false);
+	BOOST_CHECK_EQUAL(myListener.listeners.size(), 5);
+	
+	callOrder.clear();
+	myListener.callAll(&FlatListenerClass::call);
+	BOOST_CHECK(callOrder == std::vector<int>({2, 4, 5, 1, 3})); // sorted by key, registration order for equal keys
+	
+	callOrder.clear();
+	myListener.callAllWithKey(20, &FlatListenerClass::call);
+	BOOST_CHECK(callOrder == std::vector<int>({1, 3}));
+	
+	myListener.remListener(&l[1]);
+	myListener.remListener(&l[0], 10); // wrong key => no remove
+	callOrder.clear();
+	myListener.callAll(&FlatListenerClass::call);
+	BOOST_CHECK(callOrder == std::vector<int>({4, 5, 1, 3}));
+}
+
+BOOST_AUTO_TEST_CASE( flat_listener_modify_in_call ) {
+	FlatListenerSet myListener;
+	FlatListenerClass l[4] = {{1}, {2}, {3}, {4}};
+	for (auto& x : l)
+		x.set = &myListener;
+	myListener.addListener(&l[0], 10);
+	myListener.addListener(&l[1], 20);
+	myListener.addListener(&l[2], 30);
+	
+	// l1 remove itself and l3 (not yet called), add l4 (with key 0, called since next iteration)
+	l[0].toRemove = &l[0];
+	l[1].toRemove = &l[2];
+	l[1].toAdd    = &l[3];
+	callOrder.clear();
+	myListener.callAll(&FlatListenerClass::call);
+	BOOST_CHECK(callOrder == std::vector<int>({1, 2}));
+	BOOST_CHECK_EQUAL(myListener.listeners.size(), 2);
+	
+	callOrder.clear();
+	myListener.callAll(&FlatListenerClass::call);
+	BOOST_CHECK(callOrder == std::vector<int>({4, 2}));
+	
+	// add and remove the same listener during single iteration
+	l[3].toAdd    = &l[0];
+	l[1].toRemove = &l[0];
+	callOrder.clear();
+	z = myListener.callFirst(&FlatListenerClass::call);
+	BOOST_CHECK_EQUAL(z, false);
+	BOOST_CHECK(callOrder == std::vector<int>({4, 2}));
+	BOOST_CHECK_EQUAL(myListener.listeners.size(), 2);
+	
+	// add during iteration is stored after already registered listeners with the same key
+	l[3].toAdd    = &l[0];
+	myListener.callAll(&FlatListenerClass::call);
+	callOrder.clear();
+	myListener.callAll(&FlatListenerClass::call);
+	BOOST_CHECK(callOrder == std::vector<int>({4, 1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE( flat_listener_lock_modifications ) {
+	FlatListenerSet myListener;
+	FlatListenerClass l[2] = {{1}, {2}};
+	myListener.addListener(&l[0], 10);
+	
+	{
+		auto guard = myListener.listeners.lockModifications();
+		BOOST_CHECK_THROW(myListener.addListener(&l[1], 20), std::logic_error);
+		BOOST_CHECK_THROW(myListener.remListener(&l[0]), std::logic_error);
+		BOOST_CHECK_THROW(myListener.remListener(&l[0], 10), std::logic_error);
+		
+		// calling listeners is allowed
+		callOrder.clear();
+		myListener.callAll(&FlatListenerClass::call);
+		BOOST_CHECK(callOrder == std::vector<int>({1}));
+	}
+	
+	BOOST_CHECK_EQUAL(myListener.addListener(&l[1], 20), true);
+	myListener.remListener(&l[0]);
+	callOrder.clear();
+	myListener.callAll(&FlatListenerClass::call);
+	BOOST_CHECK(callOrder == std::vector<int>({2}));
+}
+
+BOOST_AUTO_TEST_CASE( flat_listener_function ) {
+	const int call_value = 19;
+	a = b = c = 0;
+	
+	MGE::FunctionListenerSet<CmdDelegate, std::string_view, std::string, MGE::FlatListenerMap> myListener;
+	myListener.addListener(function_1, "b");
+	myListener.addListener(function_2, "c");
+	myListener.addListener(function_3, "a");
+	
+	z = myListener.callFirst(call_value);
+	BOOST_CHECK_EQUAL(c, 3);
+	BOOST_CHECK_EQUAL(z, true);
+	
+	myListener.callAll(call_value);
+	BOOST_CHECK_EQUAL(a, call_value);
+	BOOST_CHECK_EQUAL(b, 2 * call_value);
+	BOOST_CHECK_EQUAL(c, 2);
+	
+	z = myListener.callFirstWithKey("b", call_value);
+	BOOST_CHECK_EQUAL(c, 1);
+	BOOST_CHECK_EQUAL(z, false);
+	
+	int count = 0;
+	for (auto&& [key, listener] : MGE::Range(myListener.listeners, "c")) {
+		BOOST_CHECK_EQUAL(listener, function_2);
+		++count;
+	}
+	BOOST_CHECK_EQUAL(count, 1);
+}
@@ -0,0 +1,195 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE LogSystem
+#include <boost/test/unit_test.hpp>
+
+#include "LogSystem.h"
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace MGE {
+	Log* defaultLog = nullptr;
+	
+	struct Globals {
+		Globals()   {
+			defaultLog = new Log(
+				(std::filesystem::temp_directory_path() / "mge-test-logSystem.log").string(),
+				true, false, false
+			);
+		}
+		~Globals()  {
+			delete defaultLog;
+		}
+	};
+}
+
+using namespace  MGE;
+
+BOOST_GLOBAL_FIXTURE( Globals );
+
+std::vector<std::string> readLogLines() {
+	defaultLog->waitForWrite();
+	std::vector<std::string> lines;
+	std::ifstream file(defaultLog->getLogFilePath());
+	for (std::string line; std::getline(file, line);)
+		lines.push_back(line);
+	return lines;
+}
+
+BOOST_AUTO_TEST_CASE( level_filtering ) {
+	int evaluations = 0;
+	auto countEvaluation = [&evaluations]() { return ++evaluations; };
+	
+	defaultLog->setLevel(Log::Warning);
+	LOG_INFO("Test", "filtered " << countEvaluation());
+	LOG_WARNING("Test", "not filtered " << countEvaluation());
+	BOOST_CHECK_EQUAL(evaluations, 1);
+	
+	defaultLog->setCategoryLevel("Verbose", Log::Verbose);
+	LOG_VERBOSE("Verbose", "not filtered " << countEvaluation());
+	LOG_VERBOSE("Test", "filtered " << countEvaluation());
+	BOOST_CHECK_EQUAL(evaluations, 2);
+	BOOST_CHECK_EQUAL(defaultLog->getCategoryLevel("Test"), Log::Warning);
+	
+	defaultLog->setCategoryLevel("Test", Log::Error);
+	LOG_WARNING("Test", "filtered " << countEvaluation());
+	BOOST_CHECK_EQUAL(evaluations, 2);
+	
+	defaultLog->resetCategoryLevel("Test");
+	defaultLog->resetCategoryLevel("Verbose");
+	defaultLog->setLevel(Log::Debug);
+	LOG_VERBOSE("Test", "not filtered " << countEvaluation());
+	BOOST_CHECK_EQUAL(evaluations, 3);
+	
+	BOOST_CHECK_EQUAL(Log::stringToLogLevel("Verbose"), Log::Verbose);
+	BOOST_CHECK_EQUAL(Log::stringToLogLevel("xyz", Log::Info), Log::Info);
+}
+
+BOOST_AUTO_TEST_CASE( async_multi_thread ) {
+	defaultLog->setAsyncMode(true, 64);
+	BOOST_CHECK(defaultLog->isAsyncMode());
+	
+	std::vector<std::thread> threads;
+	for (int t=0; t<4; ++t) {
+		threads.emplace_back([t]() {
+			for (int i=0; i<1000; ++i) {
+				// split single line into multiple stream operations
+				LOG_INFO("Thread", "T" << t << " " << std::hex << i << std::dec << " " << "end");
+			}
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+	
+	auto lines = readLogLines();
+	std::map<std::string, int> counts;
+	for (auto& line : lines) {
+		if (line.compare(0, 9, "[Thread] ") != 0)
+			continue;
+		BOOST_CHECK_MESSAGE(line.size() > 4 && line.compare(line.size() - 4, 4, " end") == 0, "Mixed line: " << line);
+		++counts[line.substr(9, 2)];
+	}
+	BOOST_CHECK_EQUAL(counts.size(), 4);
+	for (auto& iter : counts)
+		BOOST_CHECK_EQUAL(iter.second, 1000);
+	
+	defaultLog->setAsyncMode(false);
+	BOOST_CHECK(!defaultLog->isAsyncMode());
+}
+
+BOOST_AUTO_TEST_CASE( line_assembly ) {
+	defaultLog->setAsyncMode(true);
+	
+	// partial line is not written until end of line
+	defaultLog->logLevel(Log::Warning, "Partial") << "first part, " << std::flush;
+	LOG_INFO("Other", "second part");
+	
+	auto lines = readLogLines();
+	BOOST_CHECK_EQUAL(lines.back(), "WARNING: [Partial] first part, second part");
+	
+	defaultLog->setAsyncMode(false);
+}
+
+BOOST_AUTO_TEST_CASE( multi_line_time_stamps ) {
+	auto path = (std::filesystem::temp_directory_path() / "mge-test-logSystem-timeStamps.log").string();
+	
+	for (bool async : {false, true}) {
+		{
+			Log log(path, true, false, true);
+			log.setAsyncMode(async);
+			log.logMultiLine("first\nsecond\nthird", Log::Warning, "Multi");
+			log.logLevel(Log::Info, "Stream") << "line 1\nline 2\nline 3" << std::endl;
+			log.logHeader("header");
+		}
+		
+		std::vector<std::string> lines;
+		std::ifstream file(path);
+		for (std::string line; std::getline(file, line);)
+			lines.push_back(line);
+		
+		// each line starts with time stamp ("seconds.microseconds ")
+		std::vector<std::string> texts;
+		for (auto& line : lines) {
+			size_t pos = line.find(' ');
+			BOOST_REQUIRE_MESSAGE(pos != std::string::npos && pos > 7 && line[pos - 7] == '.', "No time stamp in line: " << line);
+			texts.push_back(line.substr(pos + 1));
+		}
+		BOOST_REQUIRE_EQUAL(texts.size(), 10);
+		BOOST_CHECK_EQUAL(texts[0], "WARNING: [Multi] first");
+		BOOST_CHECK_EQUAL(texts[1], "WARNING: [Multi] second");
+		BOOST_CHECK_EQUAL(texts[2], "WARNING: [Multi] third");
+		BOOST_CHECK_EQUAL(texts[3], "[Stream] line 1");
+		BOOST_CHECK_EQUAL(texts[4], "line 2");
+		BOOST_CHECK_EQUAL(texts[5], "line 3");
+		BOOST_CHECK_EQUAL(texts[8], "++++  header  ++++");
+	}
+	std::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE( flush_on_crash ) {
+	defaultLog->setAsyncMode(true, 64);
+	for (int i=0; i<200; ++i)
+		LOG_INFO("Crash", "line " << i);
+	
+	// messages are written by calling thread and log is switched to synchronous mode
+	defaultLog->flushOnCrash();
+	BOOST_CHECK(!defaultLog->isAsyncMode());
+	LOG_INFO("Crash", "after flush");
+	
+	auto lines = readLogLines();
+	int count = 0;
+	for (auto& line : lines) {
+		if (line.compare(0, 8, "[Crash] ") == 0)
+			++count;
+	}
+	BOOST_CHECK_EQUAL(count, 201);
+	BOOST_CHECK_EQUAL(lines.back(), "[Crash] after flush");
+	
+	// writer thread is detached (not joined), give it time to exit before log destruction
+	std::this_thread::sleep_for(std::chrono::milliseconds(300));
+}
@@ -28,6 +28,8 @@ SOFTWARE.
 #include "ScriptsSystem.h"
 #include "LogSystem.h"
 
+#include <thread>
+
 namespace MGE {
 	Log* defaultLog = nullptr;
 	ScriptsSystem* scriptsSystem = nullptr;
@@ -105,3 +107,262 @@ mm.sendMessage(y)
 	BOOST_CHECK_EQUAL(odb1_check, 2);
 	BOOST_CHECK_EQUAL(odb2_check, 1);
 }
+
+namespace {
+	struct TestMsg : MGE::EventMsg  {
+		inline static constexpr std::string_view MsgType = "TestMsg";
+		inline static constexpr uint32_t MsgTypeID = MGE::EventMsg::hashType(MsgType);
+		const std::string_view getType() const override final {
+			return MsgType;
+		}
+		uint32_t getTypeID() const override final {
+			return MsgTypeID;
+		}
+	};
+	
+	std::vector<void*> received;
+	
+	void testReceiver(const MGE::EventMsg*, void* owner) {
+		received.push_back(owner);
+	}
+	
+	void* ptr(intptr_t x) {
+		return reinterpret_cast<void*>(x);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( MessagesSystem_RegisterUnregister ) {
+	MGE::MessagesSystem msgSys;
+	received.clear();
+	
+	// registrations differing only in one field are different (strict weak ordering of receivers)
+	BOOST_CHECK( msgSys.registerReceiver(TestMsg::MsgType, &testReceiver, ptr(2), ptr(1), nullptr) );
+	BOOST_CHECK( msgSys.registerReceiver(TestMsg::MsgType, &testReceiver, ptr(1), ptr(2), nullptr) );
+	BOOST_CHECK( msgSys.registerReceiver(TestMsg::MsgType, &testReceiver, ptr(1), ptr(1), nullptr) );
+	BOOST_CHECK( msgSys.registerReceiver(TestMsg::MsgType, &testReceiver, ptr(3), nullptr, nullptr) );
+	BOOST_CHECK( ! msgSys.registerReceiver(TestMsg::MsgType, &testReceiver, ptr(1), ptr(2), nullptr) );
+	
+	msgSys.sendMessage( TestMsg() );
+	BOOST_CHECK_EQUAL( received.size(), 4 );
+	
+	// unregister all registration of owner 1
+	msgSys.unregisterReceiver(ptr(1), nullptr, true);
+	received.clear();
+	msgSys.sendMessage( TestMsg() );
+	BOOST_CHECK( received == std::vector<void*>({ptr(2), ptr(3)}) );
+	
+	msgSys.unregisterReceiver(TestMsg::MsgType, &testReceiver, ptr(2), ptr(1), nullptr);
+	msgSys.unregisterReceiver(ptr(3));
+	received.clear();
+	msgSys.sendMessage( TestMsg() );
+	BOOST_CHECK( received.empty() );
+}
+
+BOOST_AUTO_TEST_CASE( MessagesSystem_SenderFilter ) {
+	MGE::MessagesSystem msgSys;
+	received.clear();
+	int senderA, senderB;
+	
+	msgSys.registerReceiver(TestMsg::MsgType, &testReceiver, ptr(1), nullptr, &senderA);
+	msgSys.registerReceiver(TestMsg::MsgType, &testReceiver, ptr(2), nullptr, nullptr);
+	
+	// sender must be passed also by rvalue overload
+	msgSys.sendMessage( TestMsg(), &senderB );
+	BOOST_CHECK( received == std::vector<void*>({ptr(2)}) );
+	
+	received.clear();
+	msgSys.sendMessage( TestMsg(), &senderA );
+	BOOST_CHECK_EQUAL( received.size(), 2 );
+}
+
+BOOST_AUTO_TEST_CASE( MessagesSystem_ChangesDuringSending ) {
+	MGE::MessagesSystem msgSys;
+	received.clear();
+	
+	// first receiver unregister second receiver and register new one
+	msgSys.registerReceiver(TestMsg::MsgType, [&msgSys](const MGE::EventMsg* msg, void* owner) {
+		received.push_back(owner);
+		msgSys.unregisterReceiver(ptr(2));
+		msgSys.registerReceiver(TestMsg::MsgType, &testReceiver, ptr(3));
+	}, ptr(1));
+	msgSys.registerReceiver(TestMsg::MsgType, &testReceiver, ptr(2));
+	
+	msgSys.sendMessage( TestMsg() );
+	BOOST_CHECK( received == std::vector<void*>({ptr(1)}) );
+	
+	received.clear();
+	msgSys.sendMessage( TestMsg() );
+	BOOST_CHECK( received == std::vector<void*>({ptr(1), ptr(3)}) );
+}
+
+BOOST_AUTO_TEST_CASE( MessagesSystem_ManyTypes ) {
+	MGE::MessagesSystem msgSys;
+	received.clear();
+	
+	// force dispatch table resize
+	for (int i = 0; i < 200; ++i) {
+		msgSys.registerReceiver("Msg_" + std::to_string(i), &testReceiver, ptr(i + 1));
+	}
+	msgSys.registerReceiver(TestMsg::MsgType, &testReceiver, ptr(1000));
+	
+	msgSys.sendMessage( TestMsg() );
+	BOOST_CHECK( received == std::vector<void*>({ptr(1000)}) );
+	
+	static_assert( TestMsg::MsgTypeID == MGE::EventMsg::hashType("TestMsg") );
+}
+
+namespace {
+	template <const std::string_view& Name> struct NamedMsg : MGE::EventMsg  {
+		inline static constexpr uint32_t MsgTypeID = MGE::EventMsg::hashType(Name);
+		const std::string_view getType() const override final {
+			return Name;
+		}
+		uint32_t getTypeID() const override final {
+			return MsgTypeID;
+		}
+	};
+	
+	// "costarring" and "liquid" have the same FNV-1a hash
+	constexpr std::string_view CollisionNameA = "costarring";
+	constexpr std::string_view CollisionNameB = "liquid";
+	typedef NamedMsg<CollisionNameA> CollisionMsgA;
+	typedef NamedMsg<CollisionNameB> CollisionMsgB;
+}
+
+BOOST_AUTO_TEST_CASE( MessagesSystem_TypeIDCollision ) {
+	static_assert( CollisionMsgA::MsgTypeID == CollisionMsgB::MsgTypeID );
+	
+	MGE::MessagesSystem msgSys;
+	received.clear();
+	
+	BOOST_CHECK( msgSys.registerReceiver(CollisionNameA, &testReceiver, ptr(1)) );
+	BOOST_CHECK( msgSys.registerReceiver(CollisionNameB, &testReceiver, ptr(2)) );
+	
+	msgSys.sendMessage( CollisionMsgA() );
+	BOOST_CHECK( received == std::vector<void*>({ptr(1)}) );
+	
+	received.clear();
+	msgSys.sendMessage( CollisionMsgB() );
+	BOOST_CHECK( received == std::vector<void*>({ptr(2)}) );
+	
+	// queued messages of colliding types are not grouped (nor coalesced) together
+	received.clear();
+	msgSys.postMessage( CollisionMsgA(), nullptr, true );
+	msgSys.postMessage( CollisionMsgB(), nullptr, true );
+	BOOST_CHECK_EQUAL( msgSys.dispatchQueuedMessages(), 2 );
+	BOOST_CHECK( received == std::vector<void*>({ptr(1), ptr(2)}) );
+	
+	msgSys.unregisterReceiver(CollisionNameA, &testReceiver, ptr(1));
+	received.clear();
+	msgSys.sendMessage( CollisionMsgA() );
+	msgSys.sendMessage( CollisionMsgB() );
+	BOOST_CHECK( received == std::vector<void*>({ptr(2)}) );
+}
+
+namespace {
+	struct ValueMsg : MGE::EventMsg  {
+		inline static constexpr std::string_view MsgType = "ValueMsg";
+		inline static constexpr uint32_t MsgTypeID = MGE::EventMsg::hashType(MsgType);
+		const std::string_view getType() const override final {
+			return MsgType;
+		}
+		uint32_t getTypeID() const override final {
+			return MsgTypeID;
+		}
+		int value;
+		ValueMsg(int v) : value(v) {}
+	};
+	
+	std::vector<int> receivedValues;
+	
+	void valueReceiver(const MGE::EventMsg* msg, void*) {
+		receivedValues.push_back(static_cast<const ValueMsg*>(msg)->value);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( MessagesSystem_Queue ) {
+	MGE::MessagesSystem msgSys;
+	received.clear();
+	receivedValues.clear();
+	int senderA, senderB;
+	
+	msgSys.registerReceiver(ValueMsg::MsgType, &valueReceiver, ptr(1));
+	msgSys.registerReceiver(TestMsg::MsgType, &testReceiver, ptr(2));
+	
+	msgSys.postMessage( ValueMsg(1) );
+	msgSys.postMessage( TestMsg() );
+	msgSys.postMessage( ValueMsg(2), &senderA, true );
+	msgSys.postMessage( ValueMsg(3), &senderB, true );
+	msgSys.postMessage( ValueMsg(4), &senderA, true ); // replace ValueMsg(2)
+	msgSys.postMessage( ValueMsg(5) );
+	
+	// nothing is delivered before dispatch
+	BOOST_CHECK( receivedValues.empty() );
+	
+	BOOST_CHECK_EQUAL( msgSys.dispatchQueuedMessages(), 5 );
+	BOOST_CHECK( receivedValues == std::vector<int>({1, 3, 4, 5}) );
+	BOOST_CHECK_EQUAL( received.size(), 1 );
+	
+	BOOST_CHECK_EQUAL( msgSys.dispatchQueuedMessages(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( MessagesSystem_QueueBatch ) {
+	MGE::MessagesSystem msgSys;
+	int senderA, senderB;
+	std::vector<std::vector<int>> batches, filteredBatches;
+	
+	msgSys.registerBatchReceiver(ValueMsg::MsgType, [&batches](std::span<const MGE::EventMsg* const> msgs, void*) {
+		batches.emplace_back();
+		for (auto msg : msgs)
+			batches.back().push_back(static_cast<const ValueMsg*>(msg)->value);
+	}, ptr(1));
+	msgSys.registerBatchReceiver(ValueMsg::MsgType, [&filteredBatches, &msgSys](std::span<const MGE::EventMsg* const> msgs, void*) {
+		filteredBatches.emplace_back();
+		for (auto msg : msgs)
+			filteredBatches.back().push_back(static_cast<const ValueMsg*>(msg)->value);
+		// posted during dispatch – delivered on next dispatch
+		msgSys.postMessage( ValueMsg(100) );
+	}, ptr(2), nullptr, &senderA);
+	
+	msgSys.postMessage( ValueMsg(1), &senderA );
+	msgSys.postMessage( ValueMsg(2), &senderB );
+	msgSys.postMessage( ValueMsg(3) );
+	msgSys.dispatchQueuedMessages();
+	
+	BOOST_CHECK( batches == std::vector<std::vector<int>>({{1, 2, 3}}) );
+	BOOST_CHECK( filteredBatches == std::vector<std::vector<int>>({{1, 3}}) );
+	
+	// synchronous message is single element batch
+	msgSys.sendMessage( ValueMsg(4) );
+	BOOST_CHECK( batches.back() == std::vector<int>({4}) );
+	
+	// messages posted by second receiver on both deliveries (message without sender pass all filters)
+	msgSys.unregisterReceiver(ptr(2));
+	msgSys.dispatchQueuedMessages();
+	BOOST_CHECK( batches.back() == std::vector<int>({100, 100}) );
+}
+
+BOOST_AUTO_TEST_CASE( MessagesSystem_QueueThreads ) {
+	MGE::MessagesSystem msgSys;
+	int count = 0;
+	msgSys.registerBatchReceiver(ValueMsg::MsgType, [&count](std::span<const MGE::EventMsg* const> msgs, void*) {
+		count += msgs.size();
+	}, ptr(1));
+	
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&msgSys]() {
+			for (int i = 0; i < 1000; ++i)
+				msgSys.postMessage( ValueMsg(i) );
+		});
+	}
+	size_t delivered = 0;
+	while (delivered < 4000) {
+		delivered += msgSys.dispatchQueuedMessages();
+	}
+	for (auto& thread : threads)
+		thread.join();
+	
+	BOOST_CHECK_EQUAL( delivered, 4000 );
+	BOOST_CHECK_EQUAL( count, 4000 );
+}
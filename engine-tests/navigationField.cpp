@@ -0,0 +1,162 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE NavigationField
+#include <boost/test/unit_test.hpp>
+
+#include "physics/utils/NavigationField.h"
+#include "physics/utils/CoarseNavigationGrid.h"
+#include "LogSystem.h"
+
+#include <set>
+
+namespace MGE {
+	Log* defaultLog = nullptr;
+	
+	struct Globals {
+		Globals()   {
+			defaultLog = new Log();
+		}
+		~Globals()  {
+			delete defaultLog;
+		}
+	};
+}
+
+using namespace  MGE;
+
+BOOST_GLOBAL_FIXTURE( Globals );
+
+struct TestWorld {
+	std::set<int32_t> blocked;
+	std::set<int32_t> withTrigger;
+	MGE::BaseActor*   triggers[2];
+	int               probeCount = 0;
+	MGE::NavigationField field;
+	
+	TestWorld() {
+		MGE::HexagonalGridPoint::init(1.0);
+		triggers[0] = reinterpret_cast<MGE::BaseActor*>(0x1000);
+		triggers[1] = reinterpret_cast<MGE::BaseActor*>(0x2000);
+		field.configure([this](const MGE::HexagonalGridPoint& cell, MGE::NavigationField::ProbeResult& result) {
+			++probeCount;
+			if (std::abs(cell.a) >= 100 || std::abs(cell.b) >= 100)
+				return;
+			result.hasGround    = true;
+			result.groundHeight = 0.5 * cell.a;
+			result.blocked      = blocked.count(cell);
+			if (withTrigger.count(cell)) {
+				result.triggers.push_back(triggers[1]);
+				result.triggers.push_back(triggers[0]);
+				result.triggers.push_back(triggers[1]);
+			}
+		});
+	}
+	
+	static Ogre::Vector3 toOgre(int16_t a, int16_t b) {
+		return MGE::HexagonalGridPoint(a, b).toOgre();
+	}
+};
+
+BOOST_AUTO_TEST_CASE( cache_cells ) {
+	TestWorld world;
+	world.blocked.insert(MGE::HexagonalGridPoint(3, 4));
+	
+	auto cell = world.field.getCell(MGE::HexagonalGridPoint(10, -7));
+	BOOST_CHECK( cell.hasGround() );
+	BOOST_CHECK( cell.isWalkable() );
+	BOOST_CHECK_EQUAL( cell.groundHeight, 5 );
+	BOOST_CHECK( cell.triggers == nullptr );
+	BOOST_CHECK_EQUAL( world.probeCount, 1 );
+	
+	// second read do not probe
+	cell = world.field.getCell(MGE::HexagonalGridPoint(10, -7));
+	BOOST_CHECK_EQUAL( cell.groundHeight, 5 );
+	BOOST_CHECK_EQUAL( world.probeCount, 1 );
+	
+	cell = world.field.getCell(MGE::HexagonalGridPoint(3, 4));
+	BOOST_CHECK( cell.hasGround() );
+	BOOST_CHECK( cell.isBlocked() );
+	BOOST_CHECK( !cell.isWalkable() );
+	
+	cell = world.field.getCell(MGE::HexagonalGridPoint(120, 0));
+	BOOST_CHECK( !cell.hasGround() );
+	BOOST_CHECK( !cell.isWalkable() );
+	BOOST_CHECK_EQUAL( world.probeCount, 3 );
+	
+	// (10,-7) and (3,4) are in different tiles (negative coordinates), (120,0) in third
+	BOOST_CHECK_EQUAL( world.field.getTilesCount(), 3 );
+}
+
+BOOST_AUTO_TEST_CASE( triggers_sets ) {
+	TestWorld world;
+	world.withTrigger.insert(MGE::HexagonalGridPoint(1, 1));
+	world.withTrigger.insert(MGE::HexagonalGridPoint(50, 1));
+	
+	auto cellA = world.field.getCell(MGE::HexagonalGridPoint(1, 1));
+	auto cellB = world.field.getCell(MGE::HexagonalGridPoint(50, 1));
+	BOOST_REQUIRE( cellA.triggers != nullptr );
+	BOOST_CHECK( cellA.triggers == cellB.triggers );
+	BOOST_REQUIRE_EQUAL( cellA.triggers->size(), 2 );
+	BOOST_CHECK( cellA.triggers->at(0) == world.triggers[0] );
+	BOOST_CHECK( cellA.triggers->at(1) == world.triggers[1] );
+	BOOST_CHECK_EQUAL( world.field.getTriggerSetsCount(), 1 );
+	
+	// trigger removed from (1,1) – cell (50,1) still use the set, set held by caller stay valid
+	world.withTrigger.erase(MGE::HexagonalGridPoint(1, 1));
+	world.field.invalidateArea(TestWorld::toOgre(1, 1), TestWorld::toOgre(1, 1));
+	BOOST_CHECK( world.field.getCell(MGE::HexagonalGridPoint(1, 1)).triggers == nullptr );
+	BOOST_CHECK_EQUAL( world.field.getTriggerSetsCount(), 1 );
+	BOOST_CHECK_EQUAL( cellA.triggers->size(), 2 );
+	
+	// set not used by any cell is dropped on next invalidation
+	world.withTrigger.clear();
+	cellA.triggers.reset();
+	cellB.triggers.reset();
+	world.field.invalidateArea(TestWorld::toOgre(50, 1), TestWorld::toOgre(50, 1));
+	BOOST_CHECK( world.field.getCell(MGE::HexagonalGridPoint(50, 1)).triggers == nullptr );
+	BOOST_CHECK_EQUAL( world.field.getTriggerSetsCount(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( invalidate_area ) {
+	TestWorld world;
+	world.field.build(TestWorld::toOgre(0, 0), TestWorld::toOgre(40, 40));
+	int probeCount = world.probeCount;
+	BOOST_CHECK_EQUAL( probeCount, 41 * 41 );
+	BOOST_CHECK_EQUAL( world.field.getTilesCount(), 2 * 2 );
+	
+	world.blocked.insert(MGE::HexagonalGridPoint(35, 35));
+	BOOST_CHECK( world.field.getCell(MGE::HexagonalGridPoint(35, 35)).isWalkable() );
+	
+	// invalidation remove only tiles overlapping area
+	world.field.invalidateArea(TestWorld::toOgre(35, 35), TestWorld::toOgre(36, 36));
+	BOOST_CHECK_EQUAL( world.field.getTilesCount(), 3 );
+	BOOST_CHECK( world.field.getCell(MGE::HexagonalGridPoint(35, 35)).isBlocked() );
+	BOOST_CHECK( world.field.getCell(MGE::HexagonalGridPoint(5, 5)).isWalkable() );
+	BOOST_CHECK_EQUAL( world.probeCount, probeCount + 1 );
+	
+	world.field.clear();
+	BOOST_CHECK( !world.field.isEnabled() );
+	BOOST_CHECK_EQUAL( world.field.getTilesCount(), 0 );
+	BOOST_CHECK( !world.field.getCell(MGE::HexagonalGridPoint(5, 5)).hasGround() );
+}
@@ -0,0 +1,141 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OgreRayCast
+#include <boost/test/unit_test.hpp>
+
+#include "physics/utils/OgreRayCast.h"
+
+#include <stdexcept>
+
+namespace MGE {
+	Log* defaultLog = nullptr;
+	
+	struct Globals {
+		Globals()   {
+			defaultLog = new Log();
+		}
+		~Globals()  {
+			delete defaultLog;
+		}
+	};
+}
+
+using namespace  MGE;
+
+BOOST_GLOBAL_FIXTURE( Globals );
+
+/// objects are used only as identifiers (never dereferenced)
+static const Ogre::MovableObject* objectA = reinterpret_cast<const Ogre::MovableObject*>(0x10);
+static const Ogre::MovableObject* objectB = reinterpret_cast<const Ogre::MovableObject*>(0x20);
+
+/// vertical ray from @a y down, at (x,z) = (0,0)
+static OgreRayCast::RayQuery verticalRay(Ogre::Real y, Ogre::Real maxDistance, uint32_t searchMask) {
+	return { Ogre::Ray(Ogre::Vector3(0, y, 0), Ogre::Vector3::NEGATIVE_UNIT_Y), maxDistance, searchMask };
+}
+
+/// unit box with top at height @a top
+static OgreRayCast::RayCandidate box(const Ogre::MovableObject* object, uint32_t queryFlags, Ogre::Real top) {
+	return { object, queryFlags, Ogre::AxisAlignedBox(Ogre::Vector3(-0.5, top - 1, -0.5), Ogre::Vector3(0.5, top, 0.5)) };
+}
+
+BOOST_AUTO_TEST_CASE( hits_span_contract ) {
+	std::vector<OgreRayCast::RayQuery>     rays = { verticalRay(10, 20, 0x1), verticalRay(10, 20, 0x1) };
+	std::vector<OgreRayCast::RayCandidate> candidates = { box(objectA, 0x1, 0) };
+	
+	// hits smaller than rays
+	std::vector<OgreRayCast::RayHit> hits(1);
+	BOOST_CHECK_THROW( OgreRayCast::intersectRays(rays, candidates, hits), std::logic_error );
+	BOOST_CHECK_THROW( OgreRayCast::searchOnRays(nullptr, rays, hits), std::logic_error );
+	
+	// hits bigger than rays – extra elements are not modified
+	hits.assign(3, { objectB, Ogre::Vector3(1, 2, 3), 5 });
+	BOOST_CHECK_EQUAL( OgreRayCast::intersectRays(rays, candidates, hits), 2 );
+	BOOST_CHECK( hits[0].object == objectA );
+	BOOST_CHECK( hits[1].object == objectA );
+	BOOST_CHECK( hits[2].object == objectB );
+	BOOST_CHECK_EQUAL( hits[2].point, Ogre::Vector3(1, 2, 3) );
+	BOOST_CHECK_EQUAL( hits[2].distance, 5 );
+	
+	// empty rays
+	BOOST_CHECK_EQUAL( OgreRayCast::intersectRays({}, candidates, {}), 0 );
+	
+	// no candidates – previous results are cleared
+	BOOST_CHECK_EQUAL( OgreRayCast::intersectRays(rays, {}, hits), 0 );
+	BOOST_CHECK( hits[0].object == nullptr );
+	BOOST_CHECK( hits[1].object == nullptr );
+}
+
+BOOST_AUTO_TEST_CASE( nearest_hit ) {
+	std::vector<OgreRayCast::RayQuery>     rays = { verticalRay(10, 20, 0x1) };
+	std::vector<OgreRayCast::RayHit>       hits(1);
+	
+	// nearest candidate is selected independent of candidates order
+	for (int i = 0; i < 2; ++i) {
+		std::vector<OgreRayCast::RayCandidate> candidates = { box(objectA, 0x1, 0), box(objectB, 0x1, 4) };
+		if (i)
+			std::swap(candidates[0], candidates[1]);
+		
+		BOOST_CHECK_EQUAL( OgreRayCast::intersectRays(rays, candidates, hits), 1 );
+		BOOST_CHECK( hits[0].object == objectB );
+		BOOST_CHECK_CLOSE( hits[0].distance, 6, 1e-3 );
+		BOOST_CHECK_CLOSE( hits[0].point.y, 4, 1e-3 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( per_ray_masks ) {
+	std::vector<OgreRayCast::RayCandidate> candidates = { box(objectA, 0x1, 0), box(objectB, 0x2, 4) };
+	std::vector<OgreRayCast::RayQuery>     rays = {
+		verticalRay(10, 20, 0x1), // skip nearer objectB
+		verticalRay(10, 20, 0x2),
+		verticalRay(10, 20, 0x3), // nearest from both
+		verticalRay(10, 20, 0x4), // no matching objects
+	};
+	std::vector<OgreRayCast::RayHit> hits(rays.size());
+	
+	BOOST_CHECK_EQUAL( OgreRayCast::intersectRays(rays, candidates, hits), 3 );
+	BOOST_CHECK( hits[0].object == objectA );
+	BOOST_CHECK_CLOSE( hits[0].point.y, 0, 1e-3 );
+	BOOST_CHECK( hits[1].object == objectB );
+	BOOST_CHECK( hits[2].object == objectB );
+	BOOST_CHECK( hits[3].object == nullptr );
+}
+
+BOOST_AUTO_TEST_CASE( per_ray_max_distance ) {
+	std::vector<OgreRayCast::RayCandidate> candidates = { box(objectA, 0x1, 0), box(objectB, 0x1, 4) };
+	std::vector<OgreRayCast::RayQuery>     rays = {
+		verticalRay(10, 5,  0x1), // too short for objectB (at distance 6)
+		verticalRay(10, 6,  0x1), // max distance is inclusive
+		verticalRay(3,  20, 0x1), // start inside objectB
+		verticalRay(10, 20, 0x1),
+	};
+	std::vector<OgreRayCast::RayHit> hits(rays.size());
+	
+	BOOST_CHECK_EQUAL( OgreRayCast::intersectRays(rays, candidates, hits), 3 );
+	BOOST_CHECK( hits[0].object == nullptr );
+	BOOST_CHECK( hits[1].object == objectB );
+	BOOST_CHECK( hits[2].object == objectB );
+	BOOST_CHECK_CLOSE( hits[2].distance + 1, 1, 1e-3 );
+	BOOST_CHECK( hits[3].object == objectB );
+	BOOST_CHECK_CLOSE( hits[3].distance, 6, 1e-3 );
+}
@@ -0,0 +1,144 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OrientedBoundingBox
+#include <boost/test/unit_test.hpp>
+
+#include "physics/utils/OrientedBoundingBox.h"
+
+#include <random>
+
+/// reference implementation - explicit separating axis test on (non zero) cross products
+bool referenceIntersects(const MGE::OrientedBoundingBox& a, const MGE::OrientedBoundingBox& b) {
+	std::vector<Ogre::Vector3> axes;
+	for (int i=0; i<3; ++i) {
+		axes.push_back(a.axis[i]);
+		axes.push_back(b.axis[i]);
+		for (int j=0; j<3; ++j) {
+			Ogre::Vector3 cross = a.axis[i].crossProduct(b.axis[j]);
+			if (cross.squaredLength() > 1e-8)
+				axes.push_back(cross);
+		}
+	}
+	
+	Ogre::Vector3 d = b.center - a.center;
+	for (auto& axis : axes) {
+		Ogre::Real ra = 0, rb = 0;
+		for (int i=0; i<3; ++i) {
+			ra += a.halfSize[i] * std::fabs(a.axis[i].dotProduct(axis));
+			rb += b.halfSize[i] * std::fabs(b.axis[i].dotProduct(axis));
+		}
+		if (std::fabs(d.dotProduct(axis)) > ra + rb)
+			return false;
+	}
+	return true;
+}
+
+struct RandomBoxes {
+	std::mt19937 gen;
+	std::uniform_real_distribution<float> pos, size, angle;
+	
+	RandomBoxes() : gen(1234), pos(-6, 6), size(0.1, 3), angle(-3.14, 3.14) {}
+	
+	MGE::OrientedBoundingBox get() {
+		Ogre::Vector3 axis(pos(gen), pos(gen), pos(gen));
+		axis.normalise();
+		return MGE::OrientedBoundingBox(
+			Ogre::Vector3::ZERO, Ogre::Vector3(size(gen), size(gen), size(gen)),
+			Ogre::Vector3(pos(gen), pos(gen), pos(gen)), Ogre::Quaternion(Ogre::Radian(angle(gen)), axis), Ogre::Vector3(1, -2, 1)
+		);
+	}
+};
+
+BOOST_AUTO_TEST_CASE( simple_cases ) {
+	MGE::OrientedBoundingBox a(
+		Ogre::Vector3::ZERO, Ogre::Vector3::UNIT_SCALE, Ogre::Vector3::ZERO, Ogre::Quaternion::IDENTITY, Ogre::Vector3::UNIT_SCALE
+	);
+	Ogre::Quaternion rot45(Ogre::Degree(45), Ogre::Vector3::UNIT_Z);
+	
+	// rotated box corner at x = 2.5 - sqrt(2) > 1
+	MGE::OrientedBoundingBox b(Ogre::Vector3::ZERO, Ogre::Vector3::UNIT_SCALE, Ogre::Vector3(2.5, 0, 0), rot45, Ogre::Vector3::UNIT_SCALE);
+	BOOST_CHECK(!a.intersects(b));
+	BOOST_CHECK(!b.intersects(a));
+	
+	// rotated box corner at x = 2.3 - sqrt(2) < 1
+	MGE::OrientedBoundingBox c(Ogre::Vector3::ZERO, Ogre::Vector3::UNIT_SCALE, Ogre::Vector3(2.3, 0, 0), rot45, Ogre::Vector3::UNIT_SCALE);
+	BOOST_CHECK(a.intersects(c));
+	BOOST_CHECK(c.intersects(a));
+	
+	// local box centre is scaled and rotated
+	MGE::OrientedBoundingBox d(
+		Ogre::Vector3(0, 0, 2), Ogre::Vector3(0.5, 0.5, 0.5), Ogre::Vector3::ZERO, Ogre::Quaternion(Ogre::Degree(90), Ogre::Vector3::UNIT_Y), Ogre::Vector3(2, 2, 2)
+	);
+	BOOST_CHECK_SMALL(d.center.distance(Ogre::Vector3(4, 0, 0)), 1e-4f);
+	BOOST_CHECK(!a.intersects(d));
+	BOOST_CHECK(MGE::OrientedBoundingBox(Ogre::AxisAlignedBox(Ogre::Vector3(2.5, -1, -1), Ogre::Vector3(3.5, 1, 1))).intersects(d));
+}
+
+BOOST_AUTO_TEST_CASE( random_boxes ) {
+	RandomBoxes random;
+	int hits = 0, errors = 0;
+	for (int i=0; i<20000; ++i) {
+		auto a = random.get(), b = random.get();
+		bool ref = referenceIntersects(a, b);
+		hits += ref;
+		if (a.intersects(b) != ref || b.intersects(a) != ref)
+			++errors;
+	}
+	BOOST_CHECK_EQUAL(errors, 0);
+	BOOST_CHECK_MESSAGE(hits > 1000, "too few intersections to make a meaningful test: " << hits);
+}
+
+BOOST_AUTO_TEST_CASE( batch ) {
+	RandomBoxes random;
+	std::vector<MGE::OrientedBoundingBox> boxes;
+	MGE::OrientedBoundingBoxBatch batch;
+	for (int i=0; i<1003; ++i) { // not multiple of SIMD width, so scalar tail is tested too
+		boxes.push_back(random.get());
+		batch.push_back(boxes.back());
+	}
+	BOOST_CHECK_EQUAL(batch.size(), boxes.size());
+	
+	std::vector<uint8_t> results(batch.size());
+	int errors = 0;
+	for (int k=0; k<20; ++k) {
+		auto box = random.get();
+		batch.intersects(box, results.data());
+		for (size_t i=0; i<boxes.size(); ++i) {
+			if (results[i] != box.intersects(boxes[i]))
+				++errors;
+		}
+	}
+	BOOST_CHECK_EQUAL(errors, 0);
+	
+	Ogre::AxisAlignedBox aabb(Ogre::Vector3(-2, -2, -2), Ogre::Vector3(3, 1, 2));
+	batch.intersects(aabb, results.data());
+	for (size_t i=0; i<boxes.size(); ++i) {
+		if (results[i] != MGE::OrientedBoundingBox(aabb).intersects(boxes[i]))
+			++errors;
+	}
+	BOOST_CHECK_EQUAL(errors, 0);
+	
+	batch.clear();
+	BOOST_CHECK_EQUAL(batch.size(), 0);
+}
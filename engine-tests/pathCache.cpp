@@ -0,0 +1,164 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE PathCache
+#include <boost/test/unit_test.hpp>
+
+#include "physics/utils/PathCache.h"
+#include "LogSystem.h"
+
+namespace MGE {
+	Log* defaultLog = nullptr;
+	
+	struct Globals {
+		Globals()   {
+			defaultLog = new Log();
+			MGE::HexagonalGridPoint::init(1.0);
+		}
+		~Globals()  {
+			delete defaultLog;
+		}
+	};
+}
+
+using namespace  MGE;
+
+BOOST_GLOBAL_FIXTURE( Globals );
+
+static Ogre::Vector3 cellPoint(float x, float z) {
+	return MGE::HexagonalGridPoint(Ogre::Vector3(x, 0, z)).toOgre();
+}
+
+static bool sameCell(const Ogre::Vector3& a, const Ogre::Vector3& b) {
+	return static_cast<int32_t>(MGE::HexagonalGridPoint(a)) == static_cast<int32_t>(MGE::HexagonalGridPoint(b));
+}
+
+// L-shaped path: (0,0) → (40,0) → (40,40)
+static std::list<Ogre::Vector3> testPath() {
+	return { cellPoint(0, 0), cellPoint(40, 0), cellPoint(40, 40) };
+}
+
+BOOST_AUTO_TEST_CASE( exact_hit ) {
+	MGE::PathCache cache;
+	std::list<Ogre::Vector3> path = testPath(), points;
+	
+	BOOST_CHECK_EQUAL( cache.get(1, path.front(), path.back(), points), MGE::PathCache::MISS );
+	cache.put(1, path.front(), path.back(), path, 0.5, cache.getVersion());
+	BOOST_CHECK_EQUAL( cache.size(), 1 );
+	
+	// the same cells (but not exactly the same points)
+	BOOST_CHECK_EQUAL( cache.get(1, path.front() + Ogre::Vector3(0.1, 0, 0.1), path.back(), points), MGE::PathCache::HIT );
+	BOOST_CHECK( points == path );
+	
+	// other mover type
+	BOOST_CHECK_EQUAL( cache.get(2, path.front(), path.back(), points), MGE::PathCache::MISS );
+	
+	// mover type 0 is not cached
+	cache.put(0, path.front(), path.back(), path, 0.5, cache.getVersion());
+	BOOST_CHECK_EQUAL( cache.size(), 1 );
+	BOOST_CHECK_EQUAL( cache.get(0, path.front(), path.back(), points), MGE::PathCache::MISS );
+	
+	MGE::PathCache::Stats stats = cache.getStats();
+	BOOST_CHECK_EQUAL( stats.hits, 1 );
+	BOOST_CHECK_EQUAL( stats.misses, 3 );
+}
+
+BOOST_AUTO_TEST_CASE( partial_hit ) {
+	MGE::PathCache cache;
+	std::list<Ogre::Vector3> path = testPath(), points;
+	cache.put(1, path.front(), path.back(), path, 0.5, cache.getVersion());
+	
+	// start on first segment, the same finish – remaining part of path
+	Ogre::Vector3 start = cellPoint(20, 0);
+	BOOST_CHECK_EQUAL( cache.get(1, start, path.back(), points), MGE::PathCache::PARTIAL_HIT );
+	BOOST_REQUIRE_EQUAL( points.size(), 3 );
+	BOOST_CHECK( sameCell(points.front(), start) );
+	BOOST_CHECK( sameCell(*std::next(points.begin()), cellPoint(40, 0)) );
+	BOOST_CHECK( sameCell(points.back(), path.back()) );
+	
+	// start on turn point – no duplicated point
+	BOOST_CHECK_EQUAL( cache.get(1, cellPoint(40, 0), path.back(), points), MGE::PathCache::PARTIAL_HIT );
+	BOOST_CHECK_EQUAL( points.size(), 2 );
+	
+	// the same start, finish on second segment – initial part of path
+	Ogre::Vector3 finish = cellPoint(40, 20);
+	BOOST_CHECK_EQUAL( cache.get(1, path.front(), finish, points), MGE::PathCache::PARTIAL_HIT );
+	BOOST_REQUIRE_EQUAL( points.size(), 3 );
+	BOOST_CHECK( sameCell(points.front(), path.front()) );
+	BOOST_CHECK( sameCell(points.back(), finish) );
+	
+	// start not on path
+	BOOST_CHECK_EQUAL( cache.get(1, cellPoint(20, 10), path.back(), points), MGE::PathCache::MISS );
+	
+	BOOST_CHECK_EQUAL( cache.getStats().partialHits, 3 );
+}
+
+BOOST_AUTO_TEST_CASE( invalidation ) {
+	MGE::PathCache cache;
+	std::list<Ogre::Vector3> path = testPath(), points;
+	cache.put(1, path.front(), path.back(), path, 0.5, cache.getVersion());
+	
+	// change far from path
+	cache.invalidateArea(Ogre::Vector3(-200, 0, -200), Ogre::Vector3(-190, 0, -190));
+	BOOST_CHECK_EQUAL( cache.get(1, path.front(), path.back(), points), MGE::PathCache::HIT );
+	
+	// change on path
+	cache.invalidateArea(Ogre::Vector3(39, 0, 30), Ogre::Vector3(41, 0, 31));
+	BOOST_CHECK_EQUAL( cache.get(1, path.front(), path.back(), points), MGE::PathCache::MISS );
+	BOOST_CHECK_EQUAL( cache.size(), 0 );
+	BOOST_CHECK_EQUAL( cache.getStats().invalidated, 1 );
+	
+	// change during path search
+	uint64_t version = cache.getVersion();
+	cache.invalidateArea(Ogre::Vector3(10, 0, -1), Ogre::Vector3(11, 0, 1));
+	cache.put(1, path.front(), path.back(), path, 0.5, version);
+	BOOST_CHECK_EQUAL( cache.size(), 0 );
+	
+	// path found after change
+	cache.put(1, path.front(), path.back(), path, 0.5, cache.getVersion());
+	BOOST_CHECK_EQUAL( cache.get(1, path.front(), path.back(), points), MGE::PathCache::HIT );
+}
+
+BOOST_AUTO_TEST_CASE( lru ) {
+	MGE::PathCache cache(2);
+	std::list<Ogre::Vector3> points;
+	std::list<Ogre::Vector3> paths[3] = {
+		{ cellPoint(0, 0),  cellPoint(10, 0) },
+		{ cellPoint(0, 20), cellPoint(10, 20) },
+		{ cellPoint(0, 40), cellPoint(10, 40) },
+	};
+	
+	cache.put(1, paths[0].front(), paths[0].back(), paths[0], 0.5, cache.getVersion());
+	cache.put(1, paths[1].front(), paths[1].back(), paths[1], 0.5, cache.getVersion());
+	BOOST_CHECK_EQUAL( cache.get(1, paths[0].front(), paths[0].back(), points), MGE::PathCache::HIT );
+	
+	// paths[1] is least recently used
+	cache.put(1, paths[2].front(), paths[2].back(), paths[2], 0.5, cache.getVersion());
+	BOOST_CHECK_EQUAL( cache.size(), 2 );
+	BOOST_CHECK_EQUAL( cache.get(1, paths[1].front(), paths[1].back(), points), MGE::PathCache::MISS );
+	BOOST_CHECK_EQUAL( cache.get(1, paths[0].front(), paths[0].back(), points), MGE::PathCache::HIT );
+	BOOST_CHECK_EQUAL( cache.get(1, paths[2].front(), paths[2].back(), points), MGE::PathCache::HIT );
+	
+	cache.clear();
+	BOOST_CHECK_EQUAL( cache.size(), 0 );
+}
@@ -0,0 +1,145 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Profiler
+#include <boost/test/unit_test.hpp>
+
+#include "Profiler.h"
+#include "LogSystem.h"
+
+#include <sstream>
+#include <thread>
+
+namespace MGE {
+	Log* defaultLog = nullptr;
+	
+	struct Globals {
+		Globals()   {
+			defaultLog = new Log();
+		}
+		~Globals()  {
+			delete defaultLog;
+		}
+	};
+}
+
+using namespace  MGE;
+
+BOOST_GLOBAL_FIXTURE( Globals );
+
+namespace {
+	struct ListenerExample {};
+}
+
+BOOST_AUTO_TEST_CASE( disabled_profiler ) {
+	MGE::Profiler profiler(4, false);
+	
+	profiler.beginFrame();
+	{
+		MGE_PROFILER_ZONE("disabled");
+	}
+	profiler.endFrame();
+	
+	BOOST_CHECK_EQUAL(profiler.getFramesCount(), 0);
+	BOOST_CHECK(profiler.getFrame(0) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE( nested_zones ) {
+	MGE::Profiler profiler(4, true);
+	
+	profiler.beginFrame();
+	{
+		MGE_PROFILER_ZONE("outer");
+		{
+			MGE_PROFILER_ZONE("inner");
+		}
+		MGE::Profiler::ZoneScope zone(typeid(ListenerExample).name(), true);
+	}
+	profiler.endFrame();
+	
+	BOOST_REQUIRE_EQUAL(profiler.getFramesCount(), 1);
+	auto frame = profiler.getFrame(0);
+	BOOST_REQUIRE_EQUAL(frame->zones.size(), 3);
+	
+	// zones are stored in order of finishing
+	BOOST_CHECK_EQUAL(profiler.getZoneName(frame->zones[0]), "inner");
+	BOOST_CHECK_EQUAL(frame->zones[0].depth, 1);
+	BOOST_CHECK_NE(profiler.getZoneName(frame->zones[1]).find("ListenerExample"), std::string_view::npos);
+	BOOST_CHECK_EQUAL(frame->zones[1].depth, 1);
+	BOOST_CHECK_EQUAL(profiler.getZoneName(frame->zones[2]), "outer");
+	BOOST_CHECK_EQUAL(frame->zones[2].depth, 0);
+	
+	BOOST_CHECK_LE(frame->zones[2].start, frame->zones[0].start);
+	BOOST_CHECK_GE(frame->zones[2].end, frame->zones[0].end);
+	BOOST_CHECK_LE(frame->start, frame->zones[2].start);
+	BOOST_CHECK_GE(frame->end, frame->zones[2].end);
+}
+
+BOOST_AUTO_TEST_CASE( ring_buffer ) {
+	MGE::Profiler profiler(3, true);
+	
+	for (int i=0; i<5; ++i) {
+		profiler.beginFrame();
+		profiler.endFrame();
+	}
+	
+	BOOST_CHECK_EQUAL(profiler.getFramesCount(), 3);
+	BOOST_CHECK_EQUAL(profiler.getFrame(0)->number, 5);
+	BOOST_CHECK_EQUAL(profiler.getFrame(2)->number, 3);
+	BOOST_CHECK(profiler.getFrame(3) == nullptr);
+	
+	profiler.clear();
+	BOOST_CHECK_EQUAL(profiler.getFramesCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( threads_and_export ) {
+	MGE::Profiler profiler(8, true);
+	
+	profiler.beginFrame();
+	{
+		MGE_PROFILER_ZONE("main \"thread\"");
+		std::thread worker([]{ MGE_PROFILER_ZONE("worker"); });
+		worker.join();
+	}
+	profiler.endFrame();
+	
+	auto frame = profiler.getFrame(0);
+	BOOST_REQUIRE_EQUAL(frame->zones.size(), 2);
+	for (auto& zone : frame->zones) {
+		if (profiler.getZoneName(zone) == "worker")
+			BOOST_CHECK_EQUAL(zone.thread, 1);
+		else
+			BOOST_CHECK_EQUAL(zone.thread, 0);
+	}
+	
+	std::ostringstream trace;
+	profiler.writeChromeTrace(trace);
+	BOOST_CHECK_NE(trace.str().find("\"traceEvents\""), std::string::npos);
+	BOOST_CHECK_NE(trace.str().find("\"name\": \"worker\""), std::string::npos);
+	BOOST_CHECK_NE(trace.str().find("\"name\": \"main \\\"thread\\\"\""), std::string::npos);
+	BOOST_CHECK_NE(trace.str().find("\"name\": \"Frame 1\""), std::string::npos);
+	
+	std::ostringstream summary;
+	profiler.writeSummary(summary);
+	BOOST_CHECK_NE(summary.str().find("worker"), std::string::npos);
+}
@@ -0,0 +1,158 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE PrototypeFactory
+#include <boost/test/unit_test.hpp>
+
+#include "data/structs/factories/PrototypeFactory.h"
+#include "LogSystem.h"
+
+#include <OgreRoot.h>
+#include <OgreLogManager.h>
+#include <OgreResourceGroupManager.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace MGE {
+	Log* defaultLog = nullptr;
+}
+
+/// PrototypeFactory with public destructor (for use in tests)
+struct TestPrototypeFactory : MGE::PrototypeFactory {
+	using MGE::PrototypeFactory::filesCache;
+	using MGE::PrototypeFactory::prototypesCache;
+	~TestPrototypeFactory() = default;
+};
+
+struct Globals {
+	Ogre::LogManager*     ogreLogManager;
+	Ogre::Root*           ogreRoot;
+	TestPrototypeFactory* factory;
+	
+	static std::filesystem::path dir;
+	static std::filesystem::path file;
+	
+	static void writePrototypes(const char* value) {
+		std::ofstream out(file);
+		out << "<Prototypes>"
+		    << "<ActorPrototype name=\"A\"><Value>" << value << "</Value></ActorPrototype>"
+		    << "<ActorPrototype name=\"B\"><Value>b</Value></ActorPrototype>"
+		    << "</Prototypes>";
+	}
+	
+	Globals() {
+		MGE::defaultLog = new MGE::Log();
+		
+		ogreLogManager = new Ogre::LogManager();
+		ogreLogManager->createLog("", true, false, true);
+		ogreRoot = new Ogre::Root(0, "", "", "");
+		
+		dir  = std::filesystem::temp_directory_path() / "mge-test-prototypeFactory";
+		file = dir / "prototypes.xml";
+		std::filesystem::create_directories(dir);
+		writePrototypes("a");
+		Ogre::ResourceGroupManager::getSingleton().addResourceLocation(dir.string(), "FileSystem", "TestPrototypes");
+		
+		factory = new TestPrototypeFactory();
+	}
+	
+	~Globals() {
+		delete factory;
+		delete ogreRoot;
+		delete ogreLogManager;
+		std::filesystem::remove_all(dir);
+		delete MGE::defaultLog;
+	}
+};
+std::filesystem::path Globals::dir;
+std::filesystem::path Globals::file;
+
+BOOST_GLOBAL_FIXTURE( Globals );
+
+TestPrototypeFactory* getFactory() {
+	return static_cast<TestPrototypeFactory*>(MGE::PrototypeFactory::getPtr());
+}
+
+const MGE::ResourceLocationInfo protoA("A", "prototypes.xml", "TestPrototypes");
+const MGE::ResourceLocationInfo protoB("B", "prototypes.xml", "TestPrototypes");
+
+BOOST_AUTO_TEST_CASE( repeated_lookup_reuses_document ) {
+	getFactory()->clearPrototypeXMLCache();
+	
+	auto first = getFactory()->getPrototypeXML(&protoA);
+	BOOST_REQUIRE(first);
+	BOOST_CHECK_EQUAL(first.node.child("Value").text().as_string(), "a");
+	
+	auto second = getFactory()->getPrototypeXML(&protoA);
+	BOOST_CHECK(second.document == first.document);
+	BOOST_CHECK(second.node == first.node);
+	
+	// other prototype from the same file use the same parsed document
+	auto other = getFactory()->getPrototypeXML(&protoB);
+	BOOST_REQUIRE(other);
+	BOOST_CHECK(other.document == first.document);
+	BOOST_CHECK_EQUAL(getFactory()->filesCache.size(), 1u);
+	BOOST_CHECK_EQUAL(getFactory()->prototypesCache.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE( missing_prototype ) {
+	MGE::ResourceLocationInfo missing("C", "prototypes.xml", "TestPrototypes");
+	BOOST_CHECK(!getFactory()->getPrototypeXML(&missing));
+}
+
+BOOST_AUTO_TEST_CASE( file_change_invalidates ) {
+	getFactory()->clearPrototypeXMLCache();
+	
+	auto before = getFactory()->getPrototypeXML(&protoA);
+	BOOST_REQUIRE(before);
+	
+	// modification time resolution can be coarse, so set it explicitly
+	auto modificationTime = std::filesystem::last_write_time(Globals::file);
+	Globals::writePrototypes("changed");
+	std::filesystem::last_write_time(Globals::file, modificationTime + std::chrono::seconds(2));
+	
+	auto after = getFactory()->getPrototypeXML(&protoA);
+	BOOST_REQUIRE(after);
+	BOOST_CHECK(after.document != before.document);
+	BOOST_CHECK_EQUAL(after.node.child("Value").text().as_string(), "changed");
+	
+	// old node is still valid while its document is held
+	BOOST_CHECK_EQUAL(before.node.child("Value").text().as_string(), "a");
+	
+	Globals::writePrototypes("a");
+}
+
+BOOST_AUTO_TEST_CASE( clear_invalidates ) {
+	auto before = getFactory()->getPrototypeXML(&protoA);
+	BOOST_REQUIRE(before);
+	
+	getFactory()->clearPrototypeXMLCache();
+	BOOST_CHECK(getFactory()->filesCache.empty());
+	BOOST_CHECK(getFactory()->prototypesCache.empty());
+	
+	auto after = getFactory()->getPrototypeXML(&protoA);
+	BOOST_REQUIRE(after);
+	BOOST_CHECK(after.document != before.document);
+	BOOST_CHECK_EQUAL(after.node.child("Value").text().as_string(), "a");
+}
@@ -27,6 +27,8 @@ SOFTWARE.
 #include "ScriptsSystem.h"
 #include "LogSystem.h"
 
+#include <sstream>
+
 namespace MGE {
 	Log* defaultLog = nullptr;
 	ScriptsSystem* scriptsSystem = nullptr;
@@ -175,3 +177,55 @@ BOOST_AUTO_TEST_CASE( runObject ) {
 	BOOST_CHECK_MESSAGE(w, "Error in ed.getC(2)");
 	BOOST_CHECK_EQUAL(w.cast<int>(), 17-2);
 }
+
+BOOST_AUTO_TEST_CASE( runObject_cache ) {
+	scriptsSystem->runString("def cachedFun(x):\n  return x+1\n");
+	BOOST_CHECK_EQUAL(scriptsSystem->runObjectWithCast("cachedFun", -1, 1), 2);
+	BOOST_CHECK_EQUAL(scriptsSystem->runObjectWithCast("cachedFun", -1, 2), 3);
+	
+	// redefinition via runString must invalidate cache
+	scriptsSystem->runString("def cachedFun(x):\n  return x+10\n");
+	BOOST_CHECK_EQUAL(scriptsSystem->runObjectWithCast("cachedFun", -1, 1), 11);
+	
+	// rebinding in eval mode does not invalidate cache ... so we need manual invalidation
+	scriptsSystem->runString("globals().__setitem__('cachedFun', lambda x: x+100)", Py_eval_input);
+	BOOST_CHECK_EQUAL(scriptsSystem->runObjectWithCast("cachedFun", -1, 1), 11);
+	scriptsSystem->invalidateObjectsCache();
+	BOOST_CHECK_EQUAL(scriptsSystem->runObjectWithCast("cachedFun", -1, 1), 101);
+	
+	// unresolved names are not cached
+	BOOST_CHECK_EQUAL(scriptsSystem->runObjectWithCast("notYetDefinedFun", -1, 1), -1);
+	scriptsSystem->getGlobalsDict()["notYetDefinedFun"] = scriptsSystem->getObject("cachedFun");
+	BOOST_CHECK_EQUAL(scriptsSystem->runObjectWithCast("notYetDefinedFun", -1, 1), 101);
+}
+
+BOOST_AUTO_TEST_CASE( profiling ) {
+	scriptsSystem->runString("def profiledFun(x):\n  return x*2\n");
+	scriptsSystem->clearProfilingStats();
+	
+	// calls while profiling is disabled are not recorded
+	scriptsSystem->runObjectWithCast("profiledFun", -1, 1);
+	std::ostringstream summary;
+	scriptsSystem->writeProfilingSummary(summary);
+	BOOST_CHECK_EQUAL(summary.str(), "scripts profiling is disabled\n");
+	
+	scriptsSystem->setProfilingEnabled(true);
+	BOOST_CHECK_EQUAL(scriptsSystem->runObjectWithCast("profiledFun", -1, 1), 2);
+	{
+		MGE::ScriptsSystem::ProfilingCallerScope profilingCaller("Trigger");
+		scriptsSystem->runObjectWithCast("profiledFun", -1, 2);
+		scriptsSystem->runObjectWithVoid("profiledFun", 3);
+	}
+	scriptsSystem->setProfilingEnabled(false);
+	
+	std::ostringstream csv;
+	scriptsSystem->writeProfilingCSV(csv);
+	std::string csvStr = csv.str();
+	BOOST_CHECK_MESSAGE(csvStr.find("Other,\"profiledFun\",1,") != std::string::npos, csvStr);
+	BOOST_CHECK_MESSAGE(csvStr.find("Trigger,\"profiledFun\",2,") != std::string::npos, csvStr);
+	
+	scriptsSystem->clearProfilingStats();
+	csv.str("");
+	scriptsSystem->writeProfilingCSV(csv);
+	BOOST_CHECK_EQUAL(csv.str(), "caller,function,calls,total_ms,avg_ms,max_ms\n");
+}
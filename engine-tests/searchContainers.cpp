@@ -0,0 +1,156 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE SearchContainers
+#include <boost/test/unit_test.hpp>
+
+#include "physics/utils/SearchContainers.h"
+
+#include <map>
+#include <random>
+#include <set>
+
+struct Node {
+	float   priority;
+	int32_t heapIndex;
+	int     id;
+	
+	Node(int i = 0, float p = 0) : priority(p), heapIndex(-1), id(i) {}
+};
+
+typedef MGE::IndexedBinaryHeap<Node, &Node::priority, &Node::heapIndex> Heap;
+
+BOOST_AUTO_TEST_CASE( arena ) {
+	MGE::SearchArena<Node, 16> arena;
+	std::vector<Node*> nodes;
+	for (int i=0; i<100; ++i)
+		nodes.push_back(arena.create(i, i * 0.5f));
+	BOOST_CHECK_EQUAL( arena.size(), 100 );
+	BOOST_CHECK_EQUAL( arena.capacity(), 112 );
+	
+	// pointers are stable after adding next chunks
+	for (int i=0; i<100; ++i)
+		BOOST_CHECK_EQUAL( nodes[i]->id, i );
+	
+	// clear keep memory
+	arena.clear();
+	BOOST_CHECK_EQUAL( arena.size(), 0 );
+	Node* node = arena.create(7);
+	BOOST_CHECK_EQUAL( node, nodes[0] );
+	BOOST_CHECK_EQUAL( node->id, 7 );
+	BOOST_CHECK_EQUAL( node->heapIndex, -1 );
+	BOOST_CHECK_EQUAL( arena.capacity(), 112 );
+}
+
+BOOST_AUTO_TEST_CASE( heap_order ) {
+	std::mt19937 gen(1234);
+	std::uniform_real_distribution<float> dist(0, 1000);
+	
+	std::vector<Node> nodes;
+	for (int i=0; i<1000; ++i)
+		nodes.emplace_back(i, dist(gen));
+	
+	Heap heap;
+	for (auto& node : nodes)
+		heap.update(&node);
+	BOOST_CHECK_EQUAL( heap.size(), 1000 );
+	
+	// decrease and increase keys of nodes already in heap
+	for (int i=0; i<1000; i+=3) {
+		nodes[i].priority = (i % 2) ? nodes[i].priority / 2 : nodes[i].priority * 2;
+		heap.update(&nodes[i]);
+	}
+	BOOST_CHECK_EQUAL( heap.size(), 1000 );
+	
+	// remove some nodes
+	for (int i=1; i<1000; i+=10) {
+		heap.remove(&nodes[i]);
+		BOOST_CHECK_EQUAL( nodes[i].heapIndex, -1 );
+	}
+	heap.remove(&nodes[1]);
+	BOOST_CHECK_EQUAL( heap.size(), 900 );
+	
+	std::multiset<float> expected;
+	for (auto& node : nodes)
+		if (node.id % 10 != 1)
+			expected.insert(node.priority);
+	
+	for (float priority : expected) {
+		BOOST_REQUIRE( !heap.empty() );
+		BOOST_CHECK_EQUAL( heap.top()->priority, priority );
+		Node* node = heap.pop();
+		BOOST_CHECK_EQUAL( node->priority, priority );
+		BOOST_CHECK_EQUAL( node->heapIndex, -1 );
+	}
+	BOOST_CHECK( heap.empty() );
+}
+
+BOOST_AUTO_TEST_CASE( hash_map ) {
+	MGE::SearchHashMap<uint32_t, int> map;
+	std::map<uint32_t, int> expected;
+	
+	BOOST_CHECK( map.find(7) == nullptr );
+	
+	for (int16_t a=-50; a<50; ++a) {
+		for (int16_t b=-50; b<50; b+=3) {
+			uint32_t key = MGE::SearchHashMap<uint32_t, int>::packPoint(a, b);
+			map.set(key, a * b);
+			expected[key] = a * b;
+		}
+	}
+	BOOST_CHECK_EQUAL( map.size(), expected.size() );
+	
+	for (auto& iter : expected) {
+		int* val = map.find(iter.first);
+		BOOST_REQUIRE( val );
+		BOOST_CHECK_EQUAL( *val, iter.second );
+	}
+	BOOST_CHECK( map.find(MGE::SearchHashMap<uint32_t, int>::packPoint(-50, -49)) == nullptr );
+	
+	bool inserted;
+	map.get(MGE::SearchHashMap<uint32_t, int>::packPoint(0, 1), inserted) = 13;
+	BOOST_CHECK( !inserted );
+	BOOST_CHECK_EQUAL( *map.find(MGE::SearchHashMap<uint32_t, int>::packPoint(0, 1)), 13 );
+	
+	// clear and reuse
+	map.clear();
+	BOOST_CHECK_EQUAL( map.size(), 0 );
+	for (auto& iter : expected)
+		BOOST_CHECK( map.find(iter.first) == nullptr );
+	
+	int& val = map.get(0xffffffff, inserted);
+	BOOST_CHECK( inserted );
+	BOOST_CHECK_EQUAL( val, 0 );
+	BOOST_CHECK_EQUAL( map.size(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( hash_map_64bit_keys ) {
+	MGE::SearchHashMap<uint64_t, int> map;
+	for (uint32_t i=0; i<5000; ++i)
+		map.set(MGE::SearchHashMap<uint64_t, int>::packPair(i, i * 7919), i);
+	for (uint32_t i=0; i<5000; ++i) {
+		BOOST_REQUIRE( map.find(MGE::SearchHashMap<uint64_t, int>::packPair(i, i * 7919)) );
+		BOOST_CHECK_EQUAL( *map.find(MGE::SearchHashMap<uint64_t, int>::packPair(i, i * 7919)), i );
+		BOOST_CHECK( !map.find(MGE::SearchHashMap<uint64_t, int>::packPair(i * 7919, i + 1)) || i == 0 );
+	}
+}
@@ -0,0 +1,152 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE SpatialHashGrid
+#include <boost/test/unit_test.hpp>
+
+#include "data/utils/SpatialHashGrid.h"
+
+#include <random>
+#include <set>
+
+typedef MGE::SpatialHashGrid<int> Grid;
+
+struct TestData {
+	std::vector<Ogre::Vector3> points;
+	Grid grid;
+	
+	TestData(int count, float cellSize = 4.0f) : grid(cellSize) {
+		std::mt19937 gen(1234);
+		std::uniform_real_distribution<float> distXZ(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> distY(-5.0f, 5.0f);
+		for (int i=0; i<count; ++i) {
+			points.emplace_back(distXZ(gen), distY(gen), distXZ(gen));
+			grid.update(i, points.back());
+		}
+	}
+	
+	std::multiset<int> linearRadius(const Ogre::Vector3& point, float range) const {
+		std::multiset<int> ret;
+		for (size_t i=0; i<points.size(); ++i) {
+			if (points[i].squaredDistance(point) < range * range)
+				ret.insert(i);
+		}
+		return ret;
+	}
+	
+	static std::multiset<int> toSet(const Grid::Results& results) {
+		std::multiset<int> ret;
+		for (auto& iter : results)
+			ret.insert(iter.value);
+		return ret;
+	}
+};
+
+BOOST_AUTO_TEST_CASE( radius_query ) {
+	TestData data(2000);
+	Grid::Results results;
+	
+	for (float range : {0.5f, 3.0f, 10.0f, 37.0f, 500.0f}) {
+		for (const Ogre::Vector3& point : {Ogre::Vector3(0, 0, 0), Ogre::Vector3(-95, 2, 41), Ogre::Vector3(300, 0, 300)}) {
+			data.grid.findInRadius(point, range, results);
+			BOOST_CHECK( TestData::toSet(results) == data.linearRadius(point, range) );
+			for (size_t i=1; i<results.size(); ++i)
+				BOOST_CHECK_LE( results[i-1].squaredDistance, results[i].squaredDistance );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( box_query ) {
+	TestData data(2000);
+	Grid::Results results;
+	
+	Ogre::Vector3 minPoint(-20, -1, -7), maxPoint(13, 5, 30);
+	data.grid.findInBox(minPoint, maxPoint, results);
+	
+	std::multiset<int> expected;
+	for (size_t i=0; i<data.points.size(); ++i) {
+		const Ogre::Vector3& p = data.points[i];
+		if (p.x >= minPoint.x && p.x <= maxPoint.x && p.y >= minPoint.y && p.y <= maxPoint.y && p.z >= minPoint.z && p.z <= maxPoint.z)
+			expected.insert(i);
+	}
+	BOOST_CHECK( TestData::toSet(results) == expected );
+	BOOST_CHECK( !expected.empty() );
+}
+
+BOOST_AUTO_TEST_CASE( nearest_query ) {
+	TestData data(2000);
+	Grid::Results results;
+	
+	for (const Ogre::Vector3& point : {Ogre::Vector3(1, 0, 1), Ogre::Vector3(99, 0, -99), Ogre::Vector3(-400, 0, 20)}) {
+		for (size_t count : {1, 7, 50}) {
+			data.grid.findNearest(point, count, results);
+			
+			std::vector<float> expected;
+			for (auto& p : data.points)
+				expected.push_back(p.squaredDistance(point));
+			std::sort(expected.begin(), expected.end());
+			
+			BOOST_REQUIRE_EQUAL( results.size(), count );
+			for (size_t i=0; i<count; ++i)
+				BOOST_CHECK_EQUAL( results[i].squaredDistance, expected[i] );
+		}
+	}
+	
+	data.grid.findNearest(Ogre::Vector3(0, 0, 0), 10000, results, 10.0f);
+	BOOST_CHECK( TestData::toSet(results) == data.linearRadius(Ogre::Vector3(0, 0, 0), 10.0f) );
+}
+
+BOOST_AUTO_TEST_CASE( update_and_remove ) {
+	TestData data(500);
+	Grid::Results results;
+	
+	// move some points (inside cell and between cells)
+	for (int i=0; i<500; i+=3) {
+		data.points[i] += Ogre::Vector3(i % 7 - 3.0f, 0, i % 11 - 5.0f);
+		data.grid.update(i, data.points[i]);
+	}
+	BOOST_CHECK_EQUAL( data.grid.size(), 500 );
+	BOOST_CHECK( !data.grid.move(1000, Ogre::Vector3(0, 0, 0)) );
+	BOOST_CHECK_EQUAL( data.grid.size(), 500 );
+	
+	// remove some points
+	for (int i=0; i<500; i+=5) {
+		BOOST_CHECK( data.grid.remove(i) );
+		data.points[i] = Ogre::Vector3(1e6, 1e6, 1e6);
+	}
+	BOOST_CHECK( !data.grid.remove(0) );
+	BOOST_CHECK_EQUAL( data.grid.size(), 400 );
+	
+	data.grid.findInRadius(Ogre::Vector3(10, 0, 10), 40.0f, results);
+	BOOST_CHECK( TestData::toSet(results) == data.linearRadius(Ogre::Vector3(10, 0, 10), 40.0f) );
+	
+	// change cell size
+	data.grid.setCellSize(25.0f);
+	BOOST_CHECK_EQUAL( data.grid.size(), 400 );
+	data.grid.findInRadius(Ogre::Vector3(10, 0, 10), 40.0f, results);
+	BOOST_CHECK( TestData::toSet(results) == data.linearRadius(Ogre::Vector3(10, 0, 10), 40.0f) );
+	
+	data.grid.clear();
+	data.grid.findNearest(Ogre::Vector3(0, 0, 0), 3, results);
+	BOOST_CHECK( results.empty() );
+}
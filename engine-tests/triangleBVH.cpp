@@ -0,0 +1,126 @@
+/*
+Copyright (c) 2024 Robert Ryszard Paciorek <rrp@opcode.eu.org>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE TriangleBVH
+#include <boost/test/unit_test.hpp>
+
+#include "physics/utils/TriangleBVH.h"
+
+#include <OgreMath.h>
+
+#include <random>
+
+/// reference implementation - linear search (as in MGE::OgreMeshRaycast::entityHitTest)
+std::pair<int, Ogre::Real> referenceIntersects(
+	const Ogre::Ray& ray, const std::vector<Ogre::Vector3>& vertices, const std::vector<int>& indices, bool positiveSide, bool negativeSide
+) {
+	std::pair<int, Ogre::Real> result(-1, 0);
+	for (int i = 0; i < static_cast<int>(indices.size()); i += 3) {
+		std::pair<bool, Ogre::Real> hit = Ogre::Math::intersects(ray, vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]], positiveSide, negativeSide);
+		if (hit.first && (result.first < 0 || result.second > hit.second)) {
+			result.first  = i;
+			result.second = hit.second;
+		}
+	}
+	return result;
+}
+
+BOOST_AUTO_TEST_CASE( empty_and_single ) {
+	MGE::TriangleBVH bvh;
+	std::vector<Ogre::Vector3> vertices;
+	std::vector<int> indices;
+	
+	bvh.build(vertices, indices);
+	BOOST_CHECK(bvh.empty());
+	BOOST_CHECK_EQUAL(bvh.intersects(Ogre::Ray(), vertices, indices, true, true).first, -1);
+	
+	vertices = { {-1, -1, 0}, {1, -1, 0}, {0, 1, 0} };
+	indices  = { 0, 1, 2 };
+	bvh.build(vertices, indices);
+	BOOST_CHECK_EQUAL(bvh.size(), 1);
+	
+	auto hit = bvh.intersects(Ogre::Ray(Ogre::Vector3(0, 0, 5), Ogre::Vector3(0, 0, -1)), vertices, indices, true, true);
+	BOOST_CHECK_EQUAL(hit.first, 0);
+	BOOST_CHECK_CLOSE(hit.second, 5, 1e-3);
+	
+	// back side only
+	hit = bvh.intersects(Ogre::Ray(Ogre::Vector3(0, 0, 5), Ogre::Vector3(0, 0, -1)), vertices, indices, false, true);
+	BOOST_CHECK_EQUAL(hit.first, -1);
+	
+	// ray in triangle plane (zero direction component)
+	hit = bvh.intersects(Ogre::Ray(Ogre::Vector3(-5, 0, 0), Ogre::Vector3(1, 0, 0)), vertices, indices, true, true);
+	BOOST_CHECK_EQUAL(hit.first, -1);
+}
+
+BOOST_AUTO_TEST_CASE( random_mesh ) {
+	std::mt19937 gen(4321);
+	std::uniform_real_distribution<float> pos(-50, 50), offset(-1.5, 1.5), dir(-1, 1);
+	
+	std::vector<Ogre::Vector3> vertices;
+	std::vector<int> indices;
+	for (int i=0; i<3000; ++i) {
+		Ogre::Vector3 c(pos(gen), pos(gen), pos(gen) * 0.2);
+		for (int j=0; j<3; ++j) {
+			indices.push_back(vertices.size());
+			vertices.emplace_back(c + Ogre::Vector3(offset(gen), offset(gen), offset(gen)));
+		}
+	}
+	// shared vertices (grid with 2 triangles per cell) and non zero direction scale
+	int base = vertices.size();
+	for (int y=0; y<20; ++y)
+		for (int x=0; x<20; ++x)
+			vertices.emplace_back(x * 5 - 50, y * 5 - 50, 15);
+	for (int y=0; y<19; ++y) {
+		for (int x=0; x<19; ++x) {
+			int v = base + y * 20 + x;
+			indices.insert(indices.end(), { v, v + 1, v + 20,  v + 1, v + 21, v + 20 });
+		}
+	}
+	
+	MGE::TriangleBVH bvh;
+	bvh.build(vertices, indices);
+	BOOST_CHECK(!bvh.empty());
+	
+	int mismatches = 0, hits = 0;
+	for (int i=0; i<2000; ++i) {
+		Ogre::Ray ray(
+			Ogre::Vector3(pos(gen), pos(gen), pos(gen)),
+			Ogre::Vector3(dir(gen), dir(gen), dir(gen)) * (i % 2 ? 1 : 3.5)
+		);
+		if (i % 7 == 0)
+			ray.setDirection(Ogre::Vector3(0, 0, ray.getOrigin().z > 0 ? -1 : 1));
+		
+		bool positiveSide = i % 3 != 1, negativeSide = i % 3 != 2;
+		auto expected = referenceIntersects(ray, vertices, indices, positiveSide, negativeSide);
+		auto result   = bvh.intersects(ray, vertices, indices, positiveSide, negativeSide);
+		
+		if (expected.first >= 0)
+			++hits;
+		if (expected.first != result.first && (expected.first < 0 || result.first < 0 || std::fabs(expected.second - result.second) > 1e-4))
+			++mismatches;
+		else if (expected.first >= 0)
+			BOOST_CHECK_CLOSE(expected.second, result.second, 1e-3);
+	}
+	BOOST_CHECK_EQUAL(mismatches, 0);
+	BOOST_CHECK_GT(hits, 100);
+}